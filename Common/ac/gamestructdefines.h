@@ -64,7 +64,7 @@
 #define OPT_PORTRAITSIDE    31
 #define OPT_STRICTSCRIPTING 32  // don't allow MoveCharacter-style commands
 #define OPT_LEFTTORIGHTEVAL 33  // left-to-right operator evaluation
-#define OPT_COMPRESSSPRITES 34  // sprite compression type (None, RLE, LZW, Deflate)
+#define OPT_COMPRESSSPRITES 34  // sprite compression type (None, RLE, LZW, Deflate, LZ4)
 #define OPT_STRICTSTRINGS   35  // don't allow old-style strings, for reference only
 #define OPT_NEWGUIALPHA     36  // alpha blending method when drawing GUI and controls
 #define OPT_RUNGAMEDLGOPTS  37
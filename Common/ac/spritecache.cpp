@@ -12,6 +12,15 @@
 //
 //=============================================================================
 #include "ac/spritecache.h"
+#include <algorithm>
+#if !defined(AGS_DISABLE_THREADS)
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#endif
 #include "ac/gamestructdefines.h"
 #include "debug/out.h"
 #include "gfx/bitmap.h"
@@ -31,6 +40,10 @@ using namespace AGS::Common;
 // Locked sprites are ones that should not be freed when out of cache space.
 #define SPRCACHEFLAG_LOCKED         0x08
 
+// The prefetched sprites which were not taken by the cache yet
+// may take up to this part of the max cache size (1 / N)
+#define PrefetchReadyShare          4
+
 // High-verbosity sprite cache log
 #if DEBUG_SPRITECACHE
 #define SprCacheLog(...) Debug::Printf(kDbgGroup_SprCache, kDbgMsg_Debug, __VA_ARGS__)
@@ -44,6 +57,178 @@ namespace AGS
 namespace Common
 {
 
+#if !defined(AGS_DISABLE_THREADS)
+
+// Prefetcher loads the requested sprites from the sprite file on a background
+// thread, and keeps them until the cache takes them. The sprite file may be
+// accessed by both the background thread and the cache owner's thread,
+// so all the file reads must be done while holding the file mutex.
+// The loaded sprites are not in the cache yet, so their total size is limited
+// separately: the thread pauses when the limit is reached, and continues
+// after the cache takes some of them.
+class SpriteCache::Prefetcher
+{
+public:
+    struct LoadedSprite
+    {
+        PixelBuffer Pixels;
+        HError      Err;
+    };
+
+    enum TakeResult
+    {
+        kTake_None,     // sprite was not prefetched
+        kTake_Ready,    // sprite was ready
+        kTake_Waited    // sprite was being loaded, and we had to wait for it
+    };
+
+    Prefetcher(SpriteFile &file)
+        : _file(file) {}
+
+    ~Prefetcher()
+    {
+        {
+            std::lock_guard<std::mutex> lk(_mutex);
+            _stop = true;
+            _cvRequest.notify_one();
+        }
+        if (_thread.joinable())
+            _thread.join();
+    }
+
+    std::mutex &GetFileMutex() { return _fileMutex; }
+
+    // Sets the max total size of the loaded sprites which wait for the cache
+    void SetReadyLimit(size_t limit)
+    {
+        std::lock_guard<std::mutex> lk(_mutex);
+        _readyLimit = limit;
+        _cvRequest.notify_one();
+    }
+
+    // Queues sprite for loading; returns false if it's already queued or loaded
+    bool Enqueue(sprkey_t index)
+    {
+        std::lock_guard<std::mutex> lk(_mutex);
+        if (_pending.count(index) > 0 || _ready.count(index) > 0)
+            return false;
+        _queue.push_back(index);
+        _pending.insert(index);
+        if (!_thread.joinable())
+            _thread = std::thread(&Prefetcher::Run, this);
+        _cvRequest.notify_one();
+        return true;
+    }
+
+    // Cancels all requests, waits for the currently loading sprite,
+    // and drops all the loaded sprites
+    void Clear()
+    {
+        std::unique_lock<std::mutex> lk(_mutex);
+        _queue.clear();
+        _cvReady.wait(lk, [this]() { return _loading == NO_SPRITE_INDEX; });
+        _pending.clear();
+        _ready.clear();
+        _readyBytes = 0u;
+    }
+
+    // Takes the prefetched sprite; if the sprite is being loaded right now,
+    // then waits for it. If the sprite is still in queue, then cancels
+    // its request, as the caller will load it faster by itself.
+    TakeResult Take(sprkey_t index, PixelBuffer &pxbuf, HError &err)
+    {
+        std::unique_lock<std::mutex> lk(_mutex);
+        TakeResult result = kTake_Ready;
+        if (_loading == index)
+        {
+            _cvReady.wait(lk, [this, index]() { return _loading != index; });
+            result = kTake_Waited;
+        }
+
+        auto it = _ready.find(index);
+        if (it == _ready.end())
+        {
+            if (_pending.erase(index) > 0)
+                _queue.erase(std::find(_queue.begin(), _queue.end(), index));
+            return kTake_None;
+        }
+        _readyBytes -= it->second.Pixels.GetDataSize();
+        pxbuf = std::move(it->second.Pixels);
+        err = it->second.Err;
+        _ready.erase(it);
+        _cvRequest.notify_one();
+        return result;
+    }
+
+    // Takes all the sprites which are loaded by this time
+    void TakeAllReady(std::vector<std::pair<sprkey_t, LoadedSprite>> &sprites)
+    {
+        std::lock_guard<std::mutex> lk(_mutex);
+        for (auto &ready : _ready)
+            sprites.push_back(std::make_pair(ready.first, std::move(ready.second)));
+        _ready.clear();
+        _readyBytes = 0u;
+        _cvRequest.notify_one();
+    }
+
+private:
+    void Run()
+    {
+        std::unique_lock<std::mutex> lk(_mutex);
+        for (;;)
+        {
+            // NOTE: one sprite is always let through, even if it exceeds the limit
+            _cvRequest.wait(lk, [this]() { return _stop ||
+                (!_queue.empty() && (_readyBytes == 0u || _readyBytes < _readyLimit)); });
+            if (_stop)
+                break;
+
+            const sprkey_t index = _queue.front();
+            _queue.pop_front();
+            _loading = index;
+            lk.unlock();
+
+            LoadedSprite sprite;
+            {
+                std::lock_guard<std::mutex> file_lk(_fileMutex);
+                sprite.Err = _file.LoadSprite(index, sprite.Pixels);
+            }
+
+            lk.lock();
+            _pending.erase(index);
+            _readyBytes += sprite.Pixels.GetDataSize();
+            _ready[index] = std::move(sprite);
+            _loading = NO_SPRITE_INDEX;
+            _cvReady.notify_all();
+        }
+    }
+
+    SpriteFile &_file;
+    std::mutex _fileMutex;
+    // Guards all the following data
+    std::mutex _mutex;
+    std::condition_variable _cvRequest;
+    std::condition_variable _cvReady;
+    std::deque<sprkey_t> _queue;
+    std::unordered_set<sprkey_t> _pending; // queued or loading
+    std::unordered_map<sprkey_t, LoadedSprite> _ready;
+    size_t _readyBytes = 0u; // total size of the loaded sprites
+    size_t _readyLimit = SIZE_MAX;
+    sprkey_t _loading = NO_SPRITE_INDEX;
+    bool _stop = false;
+    std::thread _thread;
+};
+
+#else // AGS_DISABLE_THREADS
+
+// Background loading is not supported
+class SpriteCache::Prefetcher
+{
+};
+
+#endif // AGS_DISABLE_THREADS
+
+
 SpriteCache::SpriteCache(std::vector<SpriteInfo>& sprInfos)
     : ResourceCache(DEFAULTCACHESIZE_KB * 1024u)
     , _sprInfos(sprInfos)
@@ -65,6 +250,8 @@ SpriteCache::SpriteCache(std::vector<SpriteInfo> &sprInfos, const Callbacks &cal
     _placeholder.reset(BitmapHelper::CreateTransparentBitmap(1, 1));
 }
 
+SpriteCache::~SpriteCache() = default;
+
 size_t SpriteCache::GetSpriteSlotCount() const
 {
     return _spriteData.size();
@@ -103,6 +290,7 @@ bool SpriteCache::IsAssetUnloaded(sprkey_t index) const
 
 void SpriteCache::Reset()
 {
+    ResetPrefetch();
     _file.Close();
     ResourceCache::Clear();
     _spriteData.clear();
@@ -302,6 +490,103 @@ void SpriteCache::PrecacheSprite(sprkey_t index)
     SprCacheLog("Precached %d", index);
 }
 
+void SpriteCache::PrecacheSprites(const std::vector<sprkey_t> &indexes)
+{
+    std::vector<sprkey_t> unique_indexes(indexes);
+    std::sort(unique_indexes.begin(), unique_indexes.end());
+    unique_indexes.erase(std::unique(unique_indexes.begin(), unique_indexes.end()), unique_indexes.end());
+
+    std::vector<sprkey_t> load_list;
+    for (const sprkey_t index : unique_indexes)
+    {
+        if (!IsAssetUnloaded(index) || _spriteData[index].IsError())
+            continue; // cannot precache a non-asset sprite, or already loaded one
+        // The sprites which were already prefetched are taken from the prefetcher
+#if !defined(AGS_DISABLE_THREADS)
+        if (_prefetcher)
+        {
+            PixelBuffer pxbuf;
+            HError err = HError::None();
+            if (_prefetcher->Take(index, pxbuf, err) != Prefetcher::kTake_None)
+            {
+                _prefetchStats.Hits++;
+                InitLoadedSprite(index, std::move(pxbuf), err, false);
+                continue;
+            }
+        }
+#endif
+        load_list.push_back(index);
+    }
+    if (load_list.empty())
+        return;
+
+    std::vector<PixelBuffer> sprites;
+    std::vector<HError> errors;
+#if !defined(AGS_DISABLE_THREADS)
+    if (_prefetcher)
+    {
+        std::lock_guard<std::mutex> lk(_prefetcher->GetFileMutex());
+        _file.LoadSprites(load_list, sprites, errors);
+    }
+    else
+#endif
+    {
+        _file.LoadSprites(load_list, sprites, errors);
+    }
+    _prefetchStats.Misses += static_cast<uint32_t>(load_list.size());
+    for (size_t i = 0; i < load_list.size(); ++i)
+        InitLoadedSprite(load_list[i], std::move(sprites[i]), errors[i], false);
+    SprCacheLog("Precached a batch of %zu sprites", load_list.size());
+}
+
+void SpriteCache::PrefetchSprite(sprkey_t index)
+{
+#if !defined(AGS_DISABLE_THREADS)
+    assert(index >= 0); // out of positive range indexes are valid to fail
+    if (!IsAssetUnloaded(index) || _spriteData[index].IsError())
+        return; // cannot prefetch a non-asset sprite, or already loaded one
+
+    if (!_prefetcher)
+        _prefetcher.reset(new Prefetcher(_file));
+    _prefetcher->SetReadyLimit(ResourceCache::GetMaxCacheSize() / PrefetchReadyShare);
+    if (_prefetcher->Enqueue(index))
+    {
+        _prefetchStats.Requested++;
+        SprCacheLog("Prefetch %d", index);
+    }
+#else
+    (void)index;
+#endif
+}
+
+void SpriteCache::UpdatePrefetched()
+{
+#if !defined(AGS_DISABLE_THREADS)
+    if (!_prefetcher)
+        return;
+
+    std::vector<std::pair<sprkey_t, Prefetcher::LoadedSprite>> sprites;
+    _prefetcher->TakeAllReady(sprites);
+    for (auto &sprite : sprites)
+    {
+        const sprkey_t index = sprite.first;
+        // The sprite slot could have been reassigned while the sprite was loading
+        if (!IsAssetUnloaded(index) || _spriteData[index].IsError())
+            continue;
+        _prefetchStats.Hits++;
+        InitLoadedSprite(index, std::move(sprite.second.Pixels), sprite.second.Err, false);
+    }
+#endif
+}
+
+void SpriteCache::ResetPrefetch()
+{
+#if !defined(AGS_DISABLE_THREADS)
+    if (_prefetcher)
+        _prefetcher->Clear();
+#endif
+}
+
 std::unique_ptr<Bitmap> SpriteCache::LoadSpriteNoCache(sprkey_t index)
 {
     // invalid sprite slot
@@ -373,7 +658,42 @@ Bitmap *SpriteCache::LoadSprite(sprkey_t index, bool lock)
     assert((_spriteData[index].Flags & SPRCACHEFLAG_ISASSET) != 0);
 
     PixelBuffer pxbuf;
-    HError err = _file.LoadSprite(index, pxbuf);
+    HError err = HError::None();
+#if !defined(AGS_DISABLE_THREADS)
+    if (_prefetcher)
+    {
+        // Take the sprite from the prefetcher, or load one ourselves;
+        // in the latter case we still have to wait if the background thread
+        // is reading the file at the moment.
+        using namespace std::chrono;
+        const auto tp_start = steady_clock::now();
+        const auto result = _prefetcher->Take(index, pxbuf, err);
+        if (result == Prefetcher::kTake_None)
+        {
+            std::lock_guard<std::mutex> lk(_prefetcher->GetFileMutex());
+            _prefetchStats.StallTime += duration_cast<microseconds>(steady_clock::now() - tp_start);
+            _prefetchStats.Misses++;
+            err = _file.LoadSprite(index, pxbuf);
+        }
+        else
+        {
+            _prefetchStats.StallTime += duration_cast<microseconds>(steady_clock::now() - tp_start);
+            if (result == Prefetcher::kTake_Waited)
+                _prefetchStats.Waits++;
+            else
+                _prefetchStats.Hits++;
+        }
+        return InitLoadedSprite(index, std::move(pxbuf), err, lock);
+    }
+#endif
+
+    _prefetchStats.Misses++;
+    err = _file.LoadSprite(index, pxbuf);
+    return InitLoadedSprite(index, std::move(pxbuf), err, lock);
+}
+
+Bitmap *SpriteCache::InitLoadedSprite(sprkey_t index, PixelBuffer &&pxbuf, const HError &err, bool lock)
+{
     if (!pxbuf)
     {
         Debug::Printf(kDbgGroup_SprCache, kDbgMsg_Warn,
@@ -475,11 +795,13 @@ sprkey_t SpriteCache::TraceTopmostSpriteBack(sprkey_t start_with)
 
 HError SpriteCache::SaveToFile(const String &filename, int store_flags, SpriteCompression compress, SpriteFileIndex &index)
 {
+    ResetPrefetch(); // the sprite file will be read here
     return SaveSpriteFile(filename, PrepareSpriteData(), &_file, store_flags, compress, index);
 }
 
 HError SpriteCache::SaveToFile(std::unique_ptr<Stream> &&out, int store_flags, SpriteCompression compress, SpriteFileIndex& index)
 {
+    ResetPrefetch(); // the sprite file will be read here
     return SaveSpriteFile(std::move(out), PrepareSpriteData(), &_file, store_flags, compress, index);
 }
 
@@ -522,6 +844,7 @@ HError SpriteCache::InitFile(std::unique_ptr<Stream> &&sprite_file,
 
 void SpriteCache::DetachFile()
 {
+    ResetPrefetch();
     _file.Close();
 }
 
@@ -17,6 +17,11 @@
 // SpriteCache provides bitmaps by demand; it uses SpriteFile to load sprites
 // and does MRU (most-recent-use) caching.
 //
+// Asset sprites may be requested for prefetching: these are loaded from
+// the file by a background thread, and handed over to the cache either when
+// requested by the game, or when UpdatePrefetched() is called.
+// Bitmap initialization callbacks are always run on the calling thread.
+//
 // TODO: refactor engine code to allow store and return shared_ptr<Bitmap>.
 //
 // TODO: currently inherits ResourceCache<Bitmap> as protected, because sprites
@@ -36,6 +41,7 @@
 #ifndef __AGS_CN_AC__SPRCACHE_H
 #define __AGS_CN_AC__SPRCACHE_H
 
+#include <chrono>
 #include <functional>
 #include <list>
 #include <memory>
@@ -85,10 +91,21 @@ public:
         PfnPrewriteSprite PrewriteSprite;
     };
 
+    // Sprite prefetching statistics
+    struct PrefetchStats
+    {
+        uint32_t Requested = 0u; // sprites queued for the background loading
+        uint32_t Hits = 0u;   // prefetched sprites which were ready when needed
+        uint32_t Waits = 0u;  // prefetched sprites which had to be waited for
+        uint32_t Misses = 0u; // sprites loaded on the game thread
+        // Time spent by the game thread waiting for the background loader
+        std::chrono::microseconds StallTime = std::chrono::microseconds::zero();
+    };
+
 
     SpriteCache(std::vector<SpriteInfo>& sprInfos);
     SpriteCache(std::vector<SpriteInfo> &sprInfos, const Callbacks &callbacks);
-    virtual ~SpriteCache() = default;
+    virtual ~SpriteCache();
 
     // Loads sprite reference information and inits sprite stream
     HError      InitFile(std::unique_ptr<Stream> &&sprite_file,
@@ -145,6 +162,20 @@ public:
     // Loads sprite using SpriteFile if such index is known,
     // frees the space if cache size reaches the limit
     void        PrecacheSprite(sprkey_t index);
+    // Loads a batch of asset sprites into the cache right away, skipping those
+    // which are already loaded; the sprites are decoded in parallel, using
+    // a number of worker threads, if supported.
+    void        PrecacheSprites(const std::vector<sprkey_t> &indexes);
+    // Queues the asset sprite for loading by the background thread, if it's
+    // not loaded yet; does nothing if the background loading is not supported.
+    // This is only a hint: the sprite is still loaded right away if requested
+    // before the background thread had it ready.
+    void        PrefetchSprite(sprkey_t index);
+    // Puts all the sprites which were already loaded by the background thread
+    // into the cache; this is meant to be called regularly by the game thread.
+    void        UpdatePrefetched();
+    // Gets the sprite prefetching statistics
+    const PrefetchStats &GetPrefetchStats() const { return _prefetchStats; }
     // Loads the sprite if necessary and returns a *copy* of bitmap, passing
     // ownership to the caller. Skips storing the sprite in the cache
     // (unless it was already there).
@@ -187,6 +218,9 @@ public:
     void        SetEmptySprite(sprkey_t index, bool as_asset);
     // Sets max cache size in bytes
     inline void SetMaxCacheSize(size_t size) { ResourceCache::SetMaxCacheSize(size); }
+    // Sets the number of threads to decode the precached sprites with,
+    // 0 means to use as many as there are CPU cores
+    inline void SetDecodeThreadCount(size_t count) { _file.SetDecodeThreadCount(count); }
     // Enable or disable automatic memory freeing done when any (non-locked)
     // items exceed the cache's limit.
     inline void EnableAutoFreeMem(bool enable) { ResourceCache::EnableAutoFreeMem(enable); }
@@ -204,6 +238,10 @@ private:
     sprkey_t    GetFreeIndex();
     // Load sprite from game resource and put into the cache
     Bitmap *    LoadSprite(sprkey_t index, bool lock = false);
+    // Initializes the sprite's bitmap from the loaded pixels and puts into the cache
+    Bitmap *    InitLoadedSprite(sprkey_t index, PixelBuffer &&pxbuf, const HError &err, bool lock);
+    // Stops background loading and drops any prefetched sprites
+    void        ResetPrefetch();
     // Remap the given index to the sprite 0
     void        RemapSpriteToPlaceholder(sprkey_t index);
     // Initialize the empty sprite slot
@@ -254,6 +292,11 @@ private:
 
     Callbacks  _callbacks;
     SpriteFile _file;
+
+    // Background sprite loader, created on demand
+    class Prefetcher;
+    std::unique_ptr<Prefetcher> _prefetcher;
+    PrefetchStats _prefetchStats;
 };
 
 } // namespace Common
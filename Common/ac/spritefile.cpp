@@ -177,6 +177,13 @@ SpriteFile::SpriteFile()
     _curPos = -2;
 }
 
+SpriteFile::~SpriteFile()
+{
+#if !defined(AGS_DISABLE_THREADS)
+    StopWorkers();
+#endif
+}
+
 HError SpriteFile::OpenFile(std::unique_ptr<Stream> &&sprite_file,
     std::unique_ptr<Stream> &&index_file)
 {
@@ -469,6 +476,16 @@ HError SpriteFile::LoadSprite(sprkey_t index, PixelBuffer &sprite)
     SpriteDatHeader hdr;
     ReadSprHeader(hdr, _stream.get(), _version, _compress);
     if (hdr.BPP == 0) return HError::None(); // empty slot, this is normal
+    HError err = DecodeSprite(index, hdr, _stream.get(), sprite);
+    if (!err)
+        return err;
+
+    _curPos = index + 1; // mark correct pos
+    return HError::None();
+}
+
+HError SpriteFile::DecodeSprite(sprkey_t index, const SpriteDatHeader &hdr, Stream *in, PixelBuffer &sprite) const
+{
     if (hdr.BPP < 0 || hdr.Width <= 0 || hdr.Height <= 0)
     {
         return new Error(String::FromFormat("LoadSprite: invalid sprite metrics %d (%dx%d %d-bit).",
@@ -490,11 +507,11 @@ HError SpriteFile::LoadSprite(sprkey_t index, PixelBuffer &sprite)
     { // read palette if format assumes one
         switch (pal_bpp)
         {
-        case 2: for (uint32_t i = 0; i < hdr.PalCount; ++i) { palette[i] = _stream->ReadInt16(); }
+        case 2: for (uint32_t i = 0; i < hdr.PalCount; ++i) { palette[i] = in->ReadInt16(); }
             break;
-        case 3: for (uint32_t i = 0; i < hdr.PalCount; ++i) { palette[i] = _stream->ReadUInt24(); }
+        case 3: for (uint32_t i = 0; i < hdr.PalCount; ++i) { palette[i] = in->ReadUInt24(); }
             break;
-        case 4: for (uint32_t i = 0; i < hdr.PalCount; ++i) { palette[i] = _stream->ReadInt32(); }
+        case 4: for (uint32_t i = 0; i < hdr.PalCount; ++i) { palette[i] = in->ReadInt32(); }
             break;
         default: assert(0); break;
         }
@@ -504,7 +521,7 @@ HError SpriteFile::LoadSprite(sprkey_t index, PixelBuffer &sprite)
     // (Optional) Decompress the image data into the temp buffer
     size_t in_data_size =
         ((_version >= kSprfVersion_StorageFormats) || _compress != kSprCompress_None) ?
-        (uint32_t)_stream->ReadInt32() : (w * h * bpp);
+        (uint32_t)in->ReadInt32() : (w * h * bpp);
     if (hdr.Compress != kSprCompress_None)
     {
         // TODO: rewrite this to only make a choice once the SpriteFile is initialized
@@ -516,11 +533,13 @@ HError SpriteFile::LoadSprite(sprkey_t index, PixelBuffer &sprite)
         bool result;
         switch (hdr.Compress)
         {
-        case kSprCompress_RLE: result = rle_decompress(im_data.Buf, im_data.Size, im_data.BPP, _stream.get());
+        case kSprCompress_RLE: result = rle_decompress(im_data.Buf, im_data.Size, im_data.BPP, in);
+            break;
+        case kSprCompress_LZW: result = lzw_decompress(im_data.Buf, im_data.Size, im_data.BPP, in, in_data_size);
             break;
-        case kSprCompress_LZW: result = lzw_decompress(im_data.Buf, im_data.Size, im_data.BPP, _stream.get(), in_data_size);
+        case kSprCompress_Deflate: result = inflate_decompress(im_data.Buf, im_data.Size, im_data.BPP, in, in_data_size);
             break;
-        case kSprCompress_Deflate: result = inflate_decompress(im_data.Buf, im_data.Size, im_data.BPP, _stream.get(), in_data_size);
+        case kSprCompress_LZ4: result = lz4_decompress(im_data.Buf, im_data.Size, im_data.BPP, in, in_data_size);
             break;
         default: assert(!"Unsupported compression type!"); result = false; break;
         }
@@ -541,14 +560,14 @@ HError SpriteFile::LoadSprite(sprkey_t index, PixelBuffer &sprite)
         assert((im_data.Size % im_data.BPP) == 0);
         switch (im_data.BPP)
         {
-        case 1: _stream->Read(im_data.Buf, im_data.Size);
+        case 1: in->Read(im_data.Buf, im_data.Size);
             break;
-        case 2: _stream->ReadArrayOfInt16(
+        case 2: in->ReadArrayOfInt16(
                 reinterpret_cast<int16_t*>(im_data.Buf), im_data.Size / sizeof(int16_t));
             break;
-        case 3: _stream->ReadArrayOfUInt24(im_data.Buf, im_data.Size / 3);
+        case 3: in->ReadArrayOfUInt24(im_data.Buf, im_data.Size / 3);
             break;
-        case 4: _stream->ReadArrayOfInt32(
+        case 4: in->ReadArrayOfInt32(
                 reinterpret_cast<int32_t*>(im_data.Buf), im_data.Size / sizeof(int32_t));
             break;
         default: assert(0); break;
@@ -561,10 +580,138 @@ HError SpriteFile::LoadSprite(sprkey_t index, PixelBuffer &sprite)
     }
 
     sprite = std::move(image);
-    _curPos = index + 1; // mark correct pos
     return HError::None();
 }
 
+HError SpriteFile::DecodeRawData(sprkey_t index, const SpriteDatHeader &hdr,
+    const std::vector<uint8_t> &data, PixelBuffer &sprite) const
+{
+    sprite = {};
+    if (hdr.BPP == 0) return HError::None(); // empty slot, this is normal
+    Stream in(std::make_unique<MemoryStream>(data.data(), data.size()));
+    return DecodeSprite(index, hdr, &in, sprite);
+}
+
+void SpriteFile::SetDecodeThreadCount(size_t count)
+{
+#if !defined(AGS_DISABLE_THREADS)
+    if (count == 0)
+        count = std::max(1u, std::thread::hardware_concurrency());
+    if (count == _threadCount)
+        return;
+    StopWorkers();
+    _threadCount = count;
+    for (size_t i = 1; i < count; ++i)
+        _workers.emplace_back(&SpriteFile::WorkerProc, this);
+#else
+    (void)count;
+#endif
+}
+
+void SpriteFile::LoadSprites(const std::vector<sprkey_t> &indexes, std::vector<PixelBuffer> &sprites,
+    std::vector<HError> &errors)
+{
+    const size_t count = indexes.size();
+    sprites.clear();
+    sprites.resize(count);
+    errors.assign(count, HError::None());
+    if (count == 0)
+        return;
+
+    // Read the sprites in the order of their location in file, to reduce seeking
+    std::vector<size_t> order(count);
+    for (size_t i = 0; i < count; ++i)
+        order[i] = i;
+    std::sort(order.begin(), order.end(), [this, &indexes](size_t a, size_t b)
+        {
+            const sprkey_t ia = indexes[a], ib = indexes[b];
+            const soff_t off_a = (ia >= 0 && (size_t)ia < _spriteData.size()) ? _spriteData[ia].Offset : 0;
+            const soff_t off_b = (ib >= 0 && (size_t)ib < _spriteData.size()) ? _spriteData[ib].Offset : 0;
+            return off_a < off_b;
+        });
+
+#if !defined(AGS_DISABLE_THREADS)
+    if (_threadCount > 1 && count > 1)
+    {
+        // The file is read sequentially on this thread, while the worker
+        // threads decode the sprites as soon as their raw data is ready;
+        // when everything is read, this thread helps to decode the rest
+        DecodeBatch batch(indexes, order, sprites, errors);
+        {
+            std::lock_guard<std::mutex> lk(_mutex);
+            _batch = &batch;
+        }
+        for (size_t n = 0; n < count; ++n)
+        {
+            const size_t i = order[n];
+            errors[i] = LoadRawData(indexes[i], batch.Raw[i].Hdr, batch.Raw[i].Data);
+            std::lock_guard<std::mutex> lk(_mutex);
+            batch.ReadCount = n + 1;
+            _workCV.notify_one();
+        }
+        std::unique_lock<std::mutex> lk(_mutex);
+        while (DecodeNextSprite(lk));
+        _doneCV.wait(lk, [&batch]() { return batch.DoneCount == batch.Order.size(); });
+        _batch = nullptr;
+        return;
+    }
+#endif
+
+    // Without the worker threads decode the sprites right from the stream
+    for (size_t n = 0; n < count; ++n)
+    {
+        const size_t i = order[n];
+        errors[i] = LoadSprite(indexes[i], sprites[i]);
+    }
+}
+
+#if !defined(AGS_DISABLE_THREADS)
+
+bool SpriteFile::DecodeNextSprite(std::unique_lock<std::mutex> &lk)
+{
+    DecodeBatch *batch = _batch;
+    if (!batch || batch->NextDecode >= batch->ReadCount)
+        return false;
+    const size_t i = batch->Order[batch->NextDecode++];
+    lk.unlock();
+    RawSprite &raw = batch->Raw[i];
+    if (batch->Errors[i])
+        batch->Errors[i] = DecodeRawData(batch->Indexes[i], raw.Hdr, raw.Data, batch->Sprites[i]);
+    raw.Data = std::vector<uint8_t>(); // release the memory early
+    lk.lock();
+    if (++batch->DoneCount == batch->Order.size())
+        _doneCV.notify_all();
+    return true;
+}
+
+void SpriteFile::WorkerProc()
+{
+    std::unique_lock<std::mutex> lk(_mutex);
+    for (;;)
+    {
+        _workCV.wait(lk, [this]() { return _quit || (_batch && _batch->NextDecode < _batch->ReadCount); });
+        if (_quit)
+            break;
+        DecodeNextSprite(lk);
+    }
+}
+
+void SpriteFile::StopWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lk(_mutex);
+        _quit = true;
+    }
+    _workCV.notify_all();
+    for (auto &w : _workers)
+        w.join();
+    _workers.clear();
+    _quit = false;
+    _threadCount = 1u;
+}
+
+#endif // !AGS_DISABLE_THREADS
+
 HError SpriteFile::LoadRawData(sprkey_t index, SpriteDatHeader &hdr, std::vector<uint8_t> &data)
 {
     hdr = SpriteDatHeader();
@@ -807,6 +954,8 @@ void SpriteFileWriter::WriteBitmap(const BitmapData &image)
             break;
         case kSprCompress_Deflate: result = deflate_compress(im_data.Buf, im_data.Size, im_data.BPP, &mems);
             break;
+        case kSprCompress_LZ4: result = lz4_compress(im_data.Buf, im_data.Size, im_data.BPP, &mems);
+            break;
         default: assert(!"Unsupported compression type!"); result = false; break;
         }
         // mark to write as a plain byte array
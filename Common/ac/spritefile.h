@@ -23,6 +23,11 @@
 
 #include <memory>
 #include <vector>
+#if !defined(AGS_DISABLE_THREADS)
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
 #include "gfx/bitmapdata.h"
 #include "util/error.h"
 #include "util/geometry.h"
@@ -84,6 +89,7 @@ enum SpriteCompression
     kSprCompress_RLE,
     kSprCompress_LZW,
     kSprCompress_Deflate,
+    kSprCompress_LZ4,
     kNumSprCompressTypes
 };
 
@@ -132,6 +138,7 @@ public:
     static const String DefaultSpriteIndexName;
 
     SpriteFile();
+    ~SpriteFile();
     // Loads sprite reference information and inits sprite stream
     HError      OpenFile(std::unique_ptr<Stream> &&sprite_file,
                          std::unique_ptr<Stream> &&index_file);
@@ -163,6 +170,20 @@ public:
     HError      LoadSprite(sprkey_t index, PixelBuffer &sprite);
     // Loads a raw sprite element data into the buffer, stores header info separately
     HError      LoadRawData(sprkey_t index, SpriteDatHeader &hdr, std::vector<uint8_t> &data);
+    // Decodes a raw sprite element data, as returned by LoadRawData, into the pixel buffer;
+    // this does not use the file stream, and may be called from any thread.
+    HError      DecodeRawData(sprkey_t index, const SpriteDatHeader &hdr,
+                              const std::vector<uint8_t> &data, PixelBuffer &sprite) const;
+    // Sets the number of threads to decode the sprite batches with, including
+    // the calling one; 0 means to use as many as there are CPU cores.
+    // The worker threads are kept until the thread count is changed again.
+    void        SetDecodeThreadCount(size_t count);
+    size_t      GetDecodeThreadCount() const { return _threadCount; }
+    // Loads a batch of sprites: the raw data is read sequentially by the calling thread,
+    // and decoded by the worker threads, see SetDecodeThreadCount. The results are
+    // stored in the same order as the requested indexes.
+    void        LoadSprites(const std::vector<sprkey_t> &indexes, std::vector<PixelBuffer> &sprites,
+                            std::vector<HError> &errors);
     // Loads all sprites's available metrics
     HError      LoadSpriteMetrics(std::vector<SpriteDatHeader> &metrics);
 
@@ -178,6 +199,14 @@ private:
                         std::vector<Size> *metrics, std::vector<SpriteDatHeader> *metrics2);
     // Seek stream to sprite
     void        SeekToSprite(sprkey_t index);
+    // Reads the sprite's data following its header, and decodes it into the pixel buffer
+    HError      DecodeSprite(sprkey_t index, const SpriteDatHeader &hdr, Stream *in, PixelBuffer &sprite) const;
+#if !defined(AGS_DISABLE_THREADS)
+    // Decodes the next read sprite of the batch, if there is one; expects the mutex locked
+    bool        DecodeNextSprite(std::unique_lock<std::mutex> &lk);
+    void        WorkerProc();
+    void        StopWorkers();
+#endif
 
     // Internal sprite reference
     struct SpriteRef
@@ -196,6 +225,39 @@ private:
     int _storeFlags = 0; // storage flags, specify how sprites may be stored
     SpriteCompression _compress = kSprCompress_None; // sprite compression type
     sprkey_t _curPos; // current stream position (sprite slot)
+
+    size_t _threadCount = 1u; // number of threads to decode the batches with
+#if !defined(AGS_DISABLE_THREADS)
+    // Raw sprite data, read from the file and waiting to be decoded
+    struct RawSprite
+    {
+        SpriteDatHeader Hdr;
+        std::vector<uint8_t> Data;
+    };
+    // A batch of sprites being loaded by LoadSprites
+    struct DecodeBatch
+    {
+        const std::vector<sprkey_t> &Indexes;
+        const std::vector<size_t> &Order; // order of reading and decoding
+        std::vector<PixelBuffer> &Sprites;
+        std::vector<HError> &Errors;
+        std::vector<RawSprite> Raw;
+        size_t ReadCount = 0u; // sprites read from the file
+        size_t NextDecode = 0u; // next sprite to decode, in the reading order
+        size_t DoneCount = 0u; // sprites decoded
+
+        DecodeBatch(const std::vector<sprkey_t> &indexes, const std::vector<size_t> &order,
+            std::vector<PixelBuffer> &sprites, std::vector<HError> &errors)
+            : Indexes(indexes), Order(order), Sprites(sprites), Errors(errors), Raw(indexes.size()) {}
+    };
+
+    std::vector<std::thread> _workers;
+    std::mutex _mutex;
+    std::condition_variable _workCV;
+    std::condition_variable _doneCV;
+    DecodeBatch *_batch = nullptr; // the batch being decoded
+    bool _quit = false;
+#endif
 };
 
 
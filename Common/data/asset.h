@@ -49,6 +49,20 @@ struct AssetLibInfo
     std::vector<AssetInfo> AssetInfos; // information on contained assets
 };
 
+// AssetDirIndexMode tells how the assets are looked up in the directories
+enum AssetDirIndexMode
+{
+    // Search the directory for the file on each request
+    kAssetDirIndexNone,
+    // Index the directory's contents once when it's registered;
+    // the changes made to the directory after that are not noticed
+    kAssetDirIndexStatic,
+    // Index the directory, and rebuild the index whenever the list of files
+    // in it changes; falls back to kAssetDirIndexNone where unsupported
+    kAssetDirIndexWatch,
+    kNumAssetDirIndexModes
+};
+
 } // namespace Common
 } // namespace AGS
 
@@ -14,8 +14,11 @@
 #include "data/assetmanager.h"
 #include <algorithm>
 #include <regex>
+#include <stdexcept>
 #include "data/multifilelib.h"
+#include "util/directorywatcher.h"
 #include "util/file.h"
+#include "util/memory_compat.h"
 #include "util/path.h"
 
 
@@ -27,6 +30,47 @@ namespace Common
 inline static bool IsAssetLibDir(const AssetLibInfo *lib) { return lib->BaseFileName.IsEmpty(); }
 inline static bool IsAssetLibFile(const AssetLibInfo *lib) { return !lib->BaseFileName.IsEmpty(); }
 
+// Max number of files in the indexed asset directory; larger directories are
+// searched on each request instead, as indexing them may take too long,
+// and most likely such directory was registered by a mistake.
+static const size_t MaxAssetDirIndexSize = 100000;
+
+// Converts the asset name into the directory index key;
+// returns false if such name should not be looked up in the index
+static bool MakeDirIndexKey(const String &asset_name, String &key)
+{
+    key = asset_name;
+    Path::FixupPath(key);
+    while (key.StartsWith("./"))
+        key.ClipLeft(2);
+    // Absolute paths, and paths that may lead outside of the directory, are not indexed
+    return !key.IsEmpty() && Path::IsRelativePath(key) && key.FindString("..") == String::NoIndex;
+}
+
+
+AssetManager::AssetDirIndex::~AssetDirIndex() = default;
+
+bool AssetManager::AssetDirIndex::Build(const String &dir)
+{
+    Files.clear();
+    IsValid = false;
+    for (FindFile ff = FindFile::OpenFilesRecursive(dir); !ff.AtEnd(); ff.Next())
+    {
+        if (Files.size() >= MaxAssetDirIndexSize)
+        {
+            Files.clear();
+            return false;
+        }
+        auto it = Files.find(ff.Current());
+        if (it == Files.end())
+            Files.insert(std::make_pair(ff.Current(), ff.Current()));
+        else
+            it->second = ""; // several files differ only by case
+    }
+    IsValid = true;
+    return true;
+}
+
 
 bool AssetManager::AssetLibEx::TestFilter(const String &filter) const
 {
@@ -80,6 +124,13 @@ void AssetManager::SetSearchPriority(AssetSearchPriority priority)
     _libsPriority = priority;
     _libsSorter = _libsPriority == kAssetPriorityDir ? SortLibsPriorityDir : SortLibsPriorityLib;
     std::sort(_activeLibs.begin(), _activeLibs.end(), _libsSorter);
+    UpdateLibPriorities();
+    // Reorder the assets lookup according to the new priorities
+    for (auto &entry : _assetLookup)
+    {
+        std::sort(entry.second.begin(), entry.second.end(),
+            [](const AssetRef &r1, const AssetRef &r2) { return r1.Lib->Priority < r2.Lib->Priority; });
+    }
 }
 
 AssetSearchPriority AssetManager::GetSearchPriority() const
@@ -87,6 +138,23 @@ AssetSearchPriority AssetManager::GetSearchPriority() const
     return _libsPriority;
 }
 
+void AssetManager::SetDirIndexMode(AssetDirIndexMode mode)
+{
+    if (_dirIndexMode == mode)
+        return;
+    _dirIndexMode = mode;
+    for (auto &lib : _libs)
+    {
+        if (IsAssetLibDir(lib.get()))
+            IndexAssetDir(lib.get());
+    }
+}
+
+AssetDirIndexMode AssetManager::GetDirIndexMode() const
+{
+    return _dirIndexMode;
+}
+
 AssetError AssetManager::AddLibrary(const String &path, const AssetLibInfo **out_lib)
 {
     return AddLibrary(path, "", out_lib);
@@ -118,6 +186,9 @@ AssetError AssetManager::AddLibrary(const String &path, const String &filters, c
     lib->Filters = filters.Split(',');
     auto place = std::upper_bound(_activeLibs.begin(), _activeLibs.end(), lib, _libsSorter);
     _activeLibs.insert(place, lib);
+    UpdateLibPriorities();
+    if (IsAssetLibFile(lib))
+        AddToLookup(lib);
     if (out_lib)
         *out_lib = lib;
     return kAssetNoError;
@@ -129,9 +200,12 @@ void AssetManager::RemoveLibrary(const String &path)
     {
         if (Path::ComparePaths((*it)->BasePath, path) == 0)
         {
+            if (IsAssetLibFile(it->get()))
+                RemoveFromLookup(it->get());
             auto it_end = std::remove(_activeLibs.begin(), _activeLibs.end(), (*it).get());
             _activeLibs.erase(it_end, _activeLibs.end());
             _libs.erase(it);
+            UpdateLibPriorities();
             return;
         }
     }
@@ -139,6 +213,9 @@ void AssetManager::RemoveLibrary(const String &path)
 
 void AssetManager::RemoveAllLibraries()
 {
+    _assetLookup.clear();
+    _sortedAssets.clear();
+    _activeDirs.clear();
     _libs.clear();
     _activeLibs.clear();
 }
@@ -162,81 +239,41 @@ const AssetLibInfo *AssetManager::GetLibraryInfo(size_t index) const
 
 bool AssetManager::DoesAssetExist(const String &asset_name, const String &filter) const
 {
-    for (const auto &lib : _activeLibs)
-    {
-        if (!lib->TestFilter(filter))
-            continue; // filter does not match
-
-        if (IsAssetLibDir(lib))
-        {
-            String filename = File::FindFileCI(lib->BaseDir, asset_name);
-            if (!filename.IsEmpty())
-                return true;
-        }
-        else
-        {
-            if (lib->Lookup.count(asset_name) > 0)
-                return true;
-        }
-    }
-    return false;
+    return FindAssetLocations(asset_name, filter,
+        [](const AssetLibEx*, size_t, const String&) { return true; });
 }
 
 bool AssetManager::GetAssetTime(const String &asset_name, time_t &ft, const String &filter) const
 {
-    for (const auto *lib : _activeLibs)
-    {
-        if (!lib->TestFilter(filter)) continue; // filter does not match
-
-        if (IsAssetLibDir(lib))
+    return FindAssetLocations(asset_name, filter,
+        [&ft](const AssetLibEx *lib, size_t, const String &dir_file)
         {
-            String filename = File::FindFileCI(lib->BaseDir, asset_name);
-            if (!filename.IsEmpty())
-            {
-                ft = File::GetFileTime(filename);
-                return true;
-            }
-        }
-        else
-        {
-            ft = File::GetFileTime(lib->RealLibFiles[0]);
+            ft = File::GetFileTime(IsAssetLibDir(lib) ? dir_file : lib->RealLibFiles[0]);
             return true;
-        }
-    }
-    return false;
+        });
 }
 
 void AssetManager::FindAssets(std::vector<String> &assets, const String &wildcard,
     const String &filter) const
 {
-    String pattern = StrUtil::WildcardToRegex(wildcard);
-    const std::regex regex(pattern.GetCStr(), std::regex_constants::icase);
-    std::cmatch mr;
-
-    for (const auto *lib : _activeLibs)
+    for (const auto *lib : _activeDirs)
     {
         if (!lib->TestFilter(filter)) continue; // filter does not match
 
-        if (IsAssetLibDir(lib))
+        // TODO: support multipart wildcards (wildcards in each path section)
+        const String pattern_parent = Path::IsOnlyFilename(wildcard) ? String() : Path::GetParent(wildcard);
+        for (FindFile ff = FindFile::OpenFiles(Path::ConcatPaths(lib->BaseDir, pattern_parent), Path::GetFilename(wildcard));
+             !ff.AtEnd(); ff.Next())
         {
-            // TODO: support multipart wildcards (wildcards in each path section)
-            const String pattern_parent = Path::GetParent(wildcard);
-            for (FindFile ff = FindFile::OpenFiles(Path::ConcatPaths(lib->BaseDir, pattern_parent), Path::GetFilename(wildcard));
-                 !ff.AtEnd(); ff.Next())
-            {
-                assets.push_back(Path::ConcatPaths(pattern_parent, ff.Current()));
-            }
-        }
-        else
-        {
-            for (const auto &a : lib->AssetInfos)
-            {
-                if (std::regex_match(a.FileName.GetCStr(), mr, regex))
-                    assets.push_back(a.FileName);
-            }
+            assets.push_back(Path::ConcatPaths(pattern_parent, ff.Current()));
         }
     }
 
+    std::vector<const AssetRef*> refs;
+    FindLibAssets(wildcard, filter, refs);
+    for (const auto *ref : refs)
+        assets.push_back(ref->Lib->AssetInfos[ref->Index].FileName);
+
     // Sort and remove duplicates
     std::sort(assets.begin(), assets.end(), StrLessUtf8NoCase());
     assets.erase(std::unique(assets.begin(), assets.end(), StrEqUtf8NoCase()), assets.end());
@@ -249,53 +286,52 @@ void AssetManager::FindAssets(std::vector<FileEntry> &assets, const String &wild
     // there are two separate methods now, because retrieving filename only is faster than
     // full FileEntry (may require extra system calls on certain platforms).
 
-    String pattern = StrUtil::WildcardToRegex(wildcard);
-    const std::regex regex(pattern.GetCStr(), std::regex_constants::icase);
-    std::cmatch mr;
+    // Collect entries paired with their location's priority, in order to keep only
+    // the ones that were found first by lib priority; entries that were already
+    // present in the list are considered to have the top priority.
+    std::vector<std::pair<FileEntry, size_t>> found_ents;
+    for (auto &fe : assets)
+        found_ents.push_back(std::make_pair(std::move(fe), 0u));
+    assets.clear();
 
-    std::vector<FileEntry> lib_fileents;
-    for (const auto *lib : _activeLibs)
+    for (const auto *lib : _activeDirs)
     {
         if (!lib->TestFilter(filter)) continue; // filter does not match
 
-        lib_fileents.clear();
-        if (IsAssetLibDir(lib))
+        // TODO: support multipart wildcards (wildcards in each path section)
+        const String pattern_parent = Path::IsOnlyFilename(wildcard) ? String() : Path::GetParent(wildcard);
+        for (FindFile ff = FindFile::OpenFiles(Path::ConcatPaths(lib->BaseDir, pattern_parent), Path::GetFilename(wildcard));
+             !ff.AtEnd(); ff.Next())
         {
-            // TODO: support multipart wildcards (wildcards in each path section)
-            const String pattern_parent = Path::GetParent(wildcard);
-            for (FindFile ff = FindFile::OpenFiles(Path::ConcatPaths(lib->BaseDir, pattern_parent), Path::GetFilename(wildcard));
-                 !ff.AtEnd(); ff.Next())
-            {
-                FileEntry fe = ff.GetEntry();
-                fe.Name = Path::ConcatPaths(pattern_parent, fe.Name);
-                lib_fileents.push_back(fe);
-            }
-        }
-        else
-        {
-            time_t lib_time = File::GetFileTime(lib->RealLibFiles[0]);
-            for (const auto &a : lib->AssetInfos)
-            {
-                if (std::regex_match(a.FileName.GetCStr(), mr, regex))
-                    lib_fileents.push_back(FileEntry(a.FileName, true, false, lib_time));
-            }
+            FileEntry fe = ff.GetEntry();
+            fe.Name = Path::ConcatPaths(pattern_parent, fe.Name);
+            found_ents.push_back(std::make_pair(fe, lib->Priority + 1));
         }
+    }
 
-        // We have to filter out matching entries and keep only ones that were found first by lib priority
-        if (assets.empty())
-        {
-            assets = std::move(lib_fileents);
-            std::sort(assets.begin(), assets.end(), FileEntryCmpByNameCI());
-        }
-        else
+    std::vector<const AssetRef*> refs;
+    FindLibAssets(wildcard, filter, refs);
+    std::vector<std::pair<const AssetLibEx*, time_t>> lib_times; // cache lib file times
+    for (const auto *ref : refs)
+    {
+        auto it_time = std::find_if(lib_times.begin(), lib_times.end(),
+            [ref](const std::pair<const AssetLibEx*, time_t> &lt) { return lt.first == ref->Lib; });
+        if (it_time == lib_times.end())
+            it_time = lib_times.insert(lib_times.end(), std::make_pair(ref->Lib, File::GetFileTime(ref->Lib->RealLibFiles[0])));
+        found_ents.push_back(std::make_pair(
+            FileEntry(ref->Lib->AssetInfos[ref->Index].FileName, true, false, it_time->second), ref->Lib->Priority + 1));
+    }
+
+    std::stable_sort(found_ents.begin(), found_ents.end(),
+        [](const std::pair<FileEntry, size_t> &e1, const std::pair<FileEntry, size_t> &e2)
         {
-            for (const auto &fe : lib_fileents)
-            {
-                auto it_place = std::upper_bound(assets.begin(), assets.end(), fe, FileEntryCmpByNameCI());
-                if (it_place == assets.begin() || (it_place - 1)->Name.CompareUtf8NoCase(fe.Name) != 0)
-                    assets.insert(it_place, fe);
-            }
-        }
+            const int cmp = e1.first.Name.CompareUtf8NoCase(e2.first.Name);
+            return cmp < 0 || (cmp == 0 && e1.second < e2.second);
+        });
+    for (auto &e : found_ents)
+    {
+        if (assets.empty() || assets.back().Name.CompareUtf8NoCase(e.first.Name) != 0)
+            assets.push_back(std::move(e.first));
     }
 }
 
@@ -308,9 +344,7 @@ AssetError AssetManager::RegisterAssetLib(const String &path, AssetLibEx *&out_l
         lib.reset(new AssetLibEx());
         lib->BasePath = Path::MakeAbsolutePath(path);
         lib->BaseDir = Path::GetDirectoryPath(lib->BasePath);
-
-        // TODO: maybe parse directory for the faster file reference?
-        //       but if we do, then we likely would require a file watcher?
+        IndexAssetDir(lib.get());
     }
     // ...else try open a data library
     else
@@ -335,12 +369,6 @@ AssetError AssetManager::RegisterAssetLib(const String &path, AssetLibEx *&out_l
         {
             lib->RealLibFiles.push_back(File::FindFileCI(lib->BaseDir, lib->LibFileNames[i]));
         }
-
-        // Create lookup table
-        for (size_t i = 0; i < lib->AssetInfos.size(); ++i)
-        {
-            lib->Lookup[lib->AssetInfos[i].FileName] = i;
-        }
     }
 
     out_lib = lib.get();
@@ -348,42 +376,209 @@ AssetError AssetManager::RegisterAssetLib(const String &path, AssetLibEx *&out_l
     return kAssetNoError;
 }
 
-std::unique_ptr<Stream> AssetManager::OpenAsset(const String &asset_name, const String &filter) const
+void AssetManager::UpdateLibPriorities()
 {
-    for (const auto *lib : _activeLibs)
+    _activeDirs.clear();
+    for (size_t i = 0; i < _activeLibs.size(); ++i)
     {
-        if (!lib->TestFilter(filter)) continue; // filter does not match
+        _activeLibs[i]->Priority = i;
+        if (IsAssetLibDir(_activeLibs[i]))
+            _activeDirs.push_back(_activeLibs[i]);
+    }
+}
+
+void AssetManager::AddToLookup(const AssetLibEx *lib)
+{
+    const auto ref_less = [](const AssetRef &r1, const AssetRef &r2) { return r1.Lib->Priority < r2.Lib->Priority; };
+    const size_t old_count = _sortedAssets.size();
+    for (size_t i = 0; i < lib->AssetInfos.size(); ++i)
+    {
+        auto it_entry = _assetLookup.find(lib->AssetInfos[i].FileName);
+        if (it_entry == _assetLookup.end())
+        {
+            it_entry = _assetLookup.insert(
+                std::make_pair(lib->AssetInfos[i].FileName, std::vector<AssetRef>())).first;
+            _sortedAssets.push_back(&*it_entry);
+        }
+        auto &refs = it_entry->second;
+        auto it_same = std::find_if(refs.begin(), refs.end(), [lib](const AssetRef &r) { return r.Lib == lib; });
+        if (it_same != refs.end())
+        {
+            it_same->Index = i; // same name repeats in this library, the last one is used
+            continue;
+        }
+        const AssetRef ref(lib, i);
+        refs.insert(std::upper_bound(refs.begin(), refs.end(), ref, ref_less), ref);
+    }
+
+    // Sort the new names, and merge them with the previously sorted ones
+    const auto name_less = [](const AssetLookup::value_type *e1, const AssetLookup::value_type *e2)
+        { return e1->first.CompareUtf8NoCase(e2->first) < 0; };
+    std::sort(_sortedAssets.begin() + old_count, _sortedAssets.end(), name_less);
+    std::inplace_merge(_sortedAssets.begin(), _sortedAssets.begin() + old_count, _sortedAssets.end(), name_less);
+}
+
+void AssetManager::RemoveFromLookup(const AssetLibEx *lib)
+{
+    for (const auto &asset : lib->AssetInfos)
+    {
+        auto it_entry = _assetLookup.find(asset.FileName);
+        if (it_entry == _assetLookup.end())
+            continue;
+        auto &refs = it_entry->second;
+        refs.erase(std::remove_if(refs.begin(), refs.end(), [lib](const AssetRef &r) { return r.Lib == lib; }),
+            refs.end());
+    }
 
-        std::unique_ptr<Stream> s;
-        if (IsAssetLibDir(lib))
-            s = OpenAssetFromDir(lib, asset_name);
+    // Remove the entries which no longer refer to any library
+    _sortedAssets.erase(std::remove_if(_sortedAssets.begin(), _sortedAssets.end(),
+        [](const AssetLookup::value_type *e) { return e->second.empty(); }), _sortedAssets.end());
+    for (const auto &asset : lib->AssetInfos)
+    {
+        auto it_entry = _assetLookup.find(asset.FileName);
+        if (it_entry != _assetLookup.end() && it_entry->second.empty())
+            _assetLookup.erase(it_entry);
+    }
+}
+
+bool AssetManager::FindAssetLocations(const String &asset_name, const String &filter,
+    const AssetFoundCallback &callback) const
+{
+    // The library files are looked up in the merged index, but directories
+    // are searched separately; both are tested in the order of priority
+    static const std::vector<AssetRef> no_refs;
+    auto it_entry = _assetLookup.find(asset_name);
+    const auto &refs = (it_entry != _assetLookup.end()) ? it_entry->second : no_refs;
+    auto it_ref = refs.cbegin();
+    auto it_dir = _activeDirs.cbegin();
+    while (it_ref != refs.cend() || it_dir != _activeDirs.cend())
+    {
+        if (it_dir != _activeDirs.cend() &&
+            (it_ref == refs.cend() || (*it_dir)->Priority < it_ref->Lib->Priority))
+        {
+            const AssetLibEx *lib = *(it_dir++);
+            if (!lib->TestFilter(filter))
+                continue; // filter does not match
+            const String filename = FindAssetInDir(lib, asset_name);
+            if (!filename.IsEmpty() && callback(lib, 0u, filename))
+                return true;
+        }
         else
-            s = OpenAssetFromLib(lib, asset_name);
-        if (s)
-            return s;
+        {
+            const AssetRef &ref = *(it_ref++);
+            if (ref.Lib->TestFilter(filter) && callback(ref.Lib, ref.Index, String()))
+                return true;
+        }
     }
-    return nullptr;
+    return false;
 }
 
-std::unique_ptr<Stream> AssetManager::OpenAssetFromLib(const AssetLibEx *lib, const String &asset_name) const
+void AssetManager::FindLibAssets(const String &wildcard, const String &filter,
+    std::vector<const AssetRef*> &refs) const
 {
-    auto it_found = lib->Lookup.find(asset_name);
-    if (it_found == lib->Lookup.end())
-        return nullptr;
+    // Only the names starting with the wildcard's fixed part have to be tested,
+    // so find their range in the sorted list; the prefix is limited to ASCII
+    // characters, for simplicity of the case-insensitive comparison
+    size_t prefix_len = 0;
+    for (; prefix_len < wildcard.GetLength(); ++prefix_len)
+    {
+        const char c = wildcard[prefix_len];
+        if (c == '*' || c == '?' || (c & 0x80) != 0)
+            break;
+    }
+    const String prefix = wildcard.Left(prefix_len);
+    auto it_begin = std::lower_bound(_sortedAssets.begin(), _sortedAssets.end(), prefix,
+        [](const AssetLookup::value_type *e, const String &key) { return e->first.CompareUtf8NoCase(key) < 0; });
+    auto it_end = it_begin;
+    for (; it_end != _sortedAssets.end() && (*it_end)->first.CompareLeftNoCase(prefix) == 0; ++it_end);
+    if (it_begin == it_end)
+        return;
+
+    // Test the remaining part of the name, unless the wildcard is a plain prefix
+    const bool match_all = (prefix_len + 1 == wildcard.GetLength()) && wildcard[prefix_len] == '*';
+    const bool match_exact = (prefix_len == wildcard.GetLength());
+    std::regex regex;
+    std::cmatch mr;
+    if (!match_all && !match_exact)
+        regex = std::regex(StrUtil::WildcardToRegex(wildcard).GetCStr(), std::regex_constants::icase);
+
+    for (auto it = it_begin; it != it_end; ++it)
+    {
+        const auto *entry = *it;
+        if (match_exact && entry->first.GetLength() != prefix_len)
+            continue;
+        if (!match_all && !match_exact && !std::regex_match(entry->first.GetCStr(), mr, regex))
+            continue;
+        for (const auto &ref : entry->second)
+        {
+            if (ref.Lib->TestFilter(filter))
+            {
+                refs.push_back(&ref);
+                break;
+            }
+        }
+    }
+}
+
+void AssetManager::IndexAssetDir(AssetLibEx *lib)
+{
+    lib->DirIndex.reset();
+    if ((_dirIndexMode == kAssetDirIndexNone) ||
+        (_dirIndexMode == kAssetDirIndexWatch && !DirectoryWatcher::IsSupported()))
+        return;
 
-    const AssetInfo &a = lib->AssetInfos[it_found->second];
+    std::unique_ptr<AssetDirIndex> index(new AssetDirIndex());
+    if (_dirIndexMode == kAssetDirIndexWatch)
+    {
+        // Start watching before scanning the directory, so that no change is missed
+        index->Watcher.reset(new DirectoryWatcher());
+        if (!index->Watcher->Open(lib->BaseDir))
+            return; // cannot track changes, so search on each request
+    }
+    if (!index->Build(lib->BaseDir))
+        return;
+    lib->DirIndex = std::move(index);
+}
+
+String AssetManager::FindAssetInDir(const AssetLibEx *lib, const String &asset_name) const
+{
+    AssetDirIndex *index = lib->DirIndex.get();
+    String key;
+    if (!index || !MakeDirIndexKey(asset_name, key))
+        return File::FindFileCI(lib->BaseDir, asset_name);
+
+    // Static index is never modified after being built, and is safe to read
+    // concurrently; the watched index may be rebuilt by any lookup
+    std::unique_lock<std::mutex> lock;
+    if (index->Watcher)
+    {
+        lock = std::unique_lock<std::mutex>(index->Mutex);
+        if (index->IsValid && index->Watcher->HasChanges())
+            index->IsValid = index->Watcher->Open(lib->BaseDir) && index->Build(lib->BaseDir);
+    }
+    if (!index->IsValid)
+        return File::FindFileCI(lib->BaseDir, asset_name);
+
+    auto it_found = index->Files.find(key);
+    if (it_found == index->Files.end())
+        return {};
+    if (it_found->second.IsEmpty())
+        return File::FindFileCI(lib->BaseDir, asset_name); // ambiguous, let the filesystem decide
+    return Path::ConcatPaths(lib->BaseDir, it_found->second);
+}
+
+std::unique_ptr<Stream> AssetManager::OpenAssetFromLib(const AssetLibEx *lib, size_t asset_index) const
+{
+    const AssetInfo &a = lib->AssetInfos[asset_index];
     String libfile = lib->RealLibFiles[a.LibUid];
     if (libfile.IsEmpty())
         return nullptr;
     return File::OpenFile(libfile, a.Offset, a.Offset + a.Size);
 }
 
-std::unique_ptr<Stream> AssetManager::OpenAssetFromDir(const AssetLibEx *lib, const String &file_name) const
+std::unique_ptr<Stream> AssetManager::OpenAssetFromDir(const String &filename) const
 {
-    String found_file = File::FindFileCI(lib->BaseDir, file_name);
-    if (found_file.IsEmpty())
-        return nullptr;
-    return File::OpenFileRead(found_file);
+    return File::OpenFileRead(filename);
 }
 
 std::unique_ptr<Stream> AssetManager::OpenAsset(const String &asset_name) const
@@ -391,6 +586,20 @@ std::unique_ptr<Stream> AssetManager::OpenAsset(const String &asset_name) const
     return OpenAsset(asset_name, "");
 }
 
+std::unique_ptr<Stream> AssetManager::OpenAsset(const String &asset_name, const String &filter) const
+{
+    std::unique_ptr<Stream> s;
+    FindAssetLocations(asset_name, filter,
+        [this, &s](const AssetLibEx *lib, size_t index, const String &dir_file)
+        {
+            if (IsAssetLibDir(lib))
+                s = OpenAssetFromDir(dir_file);
+            else
+                s = OpenAssetFromLib(lib, index);
+            return s != nullptr;
+        });
+    return s;
+}
 
 String GetAssetErrorText(AssetError err)
 {
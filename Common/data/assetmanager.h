@@ -38,6 +38,7 @@
 
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 #include "data/asset.h"
 #include "util/directory.h"
@@ -50,6 +51,7 @@ namespace Common
 {
 
 struct MultiFileLib;
+class DirectoryWatcher;
 
 enum AssetSearchPriority
 {
@@ -106,6 +108,11 @@ public:
     void         SetSearchPriority(AssetSearchPriority priority);
     // Gets current asset search priority
     AssetSearchPriority GetSearchPriority() const;
+    // Sets the way assets are looked up in the directories (see AssetDirIndexMode);
+    // reindexes all the registered directories accordingly
+    void         SetDirIndexMode(AssetDirIndexMode mode);
+    // Gets current directory lookup mode
+    AssetDirIndexMode GetDirIndexMode() const;
 
     // Add library location to the list of asset locations
     AssetError   AddLibrary(const String &path, const AssetLibInfo **lib = nullptr);
@@ -151,27 +158,85 @@ public:
         { return OpenAsset(apath.Name, apath.Filter); }
 
 private:
+    // AssetDirIndex is a case-insensitive lookup of all the files in the asset directory
+    struct AssetDirIndex
+    {
+        // asset name to the real file path, relative to the directory;
+        // an empty path means that multiple files match the name case-insensitively
+        std::unordered_map<String, String, HashStrUtf8NoCase, StrEqUtf8NoCase> Files;
+        bool IsValid = false; // index is built and may be used
+        std::unique_ptr<DirectoryWatcher> Watcher; // optional, tracks changes to the directory
+        std::mutex Mutex; // protects index rebuilding, only used along with the Watcher
+
+        ~AssetDirIndex();
+        // Scans the directory and all subdirectories, and fills the lookup
+        bool Build(const String &dir);
+    };
+
     // AssetLibEx combines library info with extended internal data required for the manager
     struct AssetLibEx : AssetLibInfo
     {
         String FilterString; // filter string, as received on input (for diagnostic purposes)
         std::vector<String> Filters; // asset filters this library is matching to
         std::vector<String> RealLibFiles; // fixed up library filenames
-        std::unordered_map<String, size_t, HashStrUtf8NoCase, StrEqUtf8NoCase> Lookup; // name to index asset lookup
+        std::unique_ptr<AssetDirIndex> DirIndex; // directory contents, for directory libraries
+        size_t Priority = 0u; // position in the list of active libraries, lower is searched first
 
         bool TestFilter(const String &filter) const;
     };
 
+    // AssetRef refers to the asset in the particular library
+    struct AssetRef
+    {
+        const AssetLibEx *Lib = nullptr;
+        size_t Index = 0u; // index of the asset in the library
+
+        AssetRef() = default;
+        AssetRef(const AssetLibEx *lib, size_t index) : Lib(lib), Index(index) {}
+    };
+    // Asset name to the list of libraries containing it, ordered by the library priority
+    typedef std::unordered_map<String, std::vector<AssetRef>, HashStrUtf8NoCase, StrEqUtf8NoCase> AssetLookup;
+    // Callback for the asset search; receives either a library and asset index,
+    // or a directory and the found file path. Returns true to stop the search.
+    typedef std::function<bool(const AssetLibEx *lib, size_t index, const String &dir_file)> AssetFoundCallback;
+
     // Loads library and registers its contents into the cache
     AssetError  RegisterAssetLib(const String &path, AssetLibEx *&lib);
+    // Updates the libraries priorities after the list of active libraries has changed
+    void        UpdateLibPriorities();
+    // Adds the library's assets to the merged asset lookup; library's priority must be up to date
+    void        AddToLookup(const AssetLibEx *lib);
+    // Removes the library's assets from the merged asset lookup
+    void        RemoveFromLookup(const AssetLibEx *lib);
+    // Searches for the asset in all active locations matching the filter, in the priority order,
+    // and passes each found instance into the callback until it tells to stop.
+    // Returns true if the callback requested to stop, false otherwise.
+    bool        FindAssetLocations(const String &asset_name, const String &filter,
+                                   const AssetFoundCallback &callback) const;
+    // Collects assets in the libraries which match the wildcard and the filter;
+    // for each asset name returns its reference in the library of highest priority
+    void        FindLibAssets(const String &wildcard, const String &filter,
+                              std::vector<const AssetRef*> &refs) const;
+
+    // Indexes the directory library according to the current index mode
+    void        IndexAssetDir(AssetLibEx *lib);
+    // Searches for the asset file in the directory library, returns its full path, or empty string
+    String      FindAssetInDir(const AssetLibEx *lib, const String &asset_name) const;
 
     // Tries to find asset in the given location, and then opens a stream for reading
-    std::unique_ptr<Stream> OpenAssetFromLib(const AssetLibEx *lib, const String &asset_name) const;
-    std::unique_ptr<Stream> OpenAssetFromDir(const AssetLibEx *lib, const String &asset_name) const;
+    std::unique_ptr<Stream> OpenAssetFromLib(const AssetLibEx *lib, size_t asset_index) const;
+    std::unique_ptr<Stream> OpenAssetFromDir(const String &filename) const;
 
     std::vector<std::unique_ptr<AssetLibEx>> _libs;
     std::vector<AssetLibEx*> _activeLibs;
+    std::vector<const AssetLibEx*> _activeDirs; // active directories, in priority order
+    // Merged lookup of the assets in all the active library files (not directories)
+    AssetLookup _assetLookup;
+    // Pointers to the _assetLookup entries, sorted by the name case-insensitively;
+    // used for searching by a pattern
+    std::vector<const AssetLookup::value_type*> _sortedAssets;
     AssetSearchPriority _libsPriority = kAssetPriorityDir;
+    AssetDirIndexMode _dirIndexMode = kAssetDirIndexNone;
     // Sorting function, depends on priority setting
     std::function<bool(const AssetLibInfo*, const AssetLibInfo*)> _libsSorter;
 };
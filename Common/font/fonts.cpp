@@ -74,6 +74,8 @@ struct Font
 static std::vector<Font> fonts;
 static std::unique_ptr<TTFFontRenderer> ttfRenderer;
 static std::unique_ptr<WFNFontRenderer> wfnRenderer;
+// Fonts state revision, increased whenever any font is changed
+static uint32_t fonts_revision = 0u;
 
 
 void init_font_renderer(AssetManager *amgr)
@@ -125,6 +127,11 @@ bool font_first_renderer_loaded()
     return fonts.size() > 0 && fonts[0].Renderer != nullptr;
 }
 
+uint32_t get_fonts_revision()
+{
+    return fonts_revision;
+}
+
 bool is_font_loaded(int font_number)
 {
     return assert_font_renderer(font_number);
@@ -133,6 +140,7 @@ bool is_font_loaded(int font_number)
 // Finish font's initialization
 static void font_post_init(int font_number)
 {
+    fonts_revision++;
     Font &font = fonts[font_number];
     // If no font height property was provided, then try several methods,
     // depending on which interface is available
@@ -363,6 +371,7 @@ void set_font_outline(int font_number, int outline_type,
     fonts[font_number].Info.Outline = outline_type;
     fonts[font_number].Info.AutoOutlineStyle = style;
     fonts[font_number].Info.AutoOutlineThickness = thickness;
+    fonts_revision++;
 }
 
 bool is_font_antialiased(int font_number)
@@ -461,6 +470,7 @@ void set_font_linespacing(int font_number, int spacing)
     fonts[font_number].Info.Flags &= ~FFLG_DEFLINESPACING;
     fonts[font_number].Info.LineSpacing = spacing;
     fonts[font_number].LineSpacingCalc = spacing;
+    fonts_revision++;
 }
 
 int get_text_lines_height(int font_number, size_t numlines)
@@ -724,6 +734,7 @@ void adjust_fonts_for_render_mode(bool aa_mode)
         if (fonts[i].RendererInt)
             fonts[i].RendererInt->AdjustFontForAntiAlias(static_cast<int>(i), aa_mode);
     }
+    fonts_revision++;
 }
 
 void freefont(int font_number)
@@ -734,6 +745,7 @@ void freefont(int font_number)
     if (fonts[font_number].Renderer)
         fonts[font_number].Renderer->FreeMemory(font_number);
     fonts[font_number] = Font();
+    fonts_revision++;
 }
 
 void movefont(int old_number, int new_number)
@@ -746,6 +758,7 @@ void movefont(int old_number, int new_number)
 
     fonts[new_number] = std::move(fonts[old_number]);
     fonts[old_number] = Font();
+    fonts_revision++;
 }
 
 void free_all_fonts()
@@ -756,6 +769,7 @@ void free_all_fonts()
             fonts[i].Renderer->FreeMemory(static_cast<int>(i));
     }
     fonts.clear();
+    fonts_revision++;
 }
 
 void wouttextxy(Bitmap *ds, int x, int y, int font_number, color_t text_color, const char *texx)
@@ -41,6 +41,9 @@ IAGSFontRenderer* font_replace_renderer(int font_number, IAGSFontRenderer2* rend
 void font_recalc_metrics(int font_number);
 bool font_first_renderer_loaded();
 bool is_font_loaded(int font_number);
+// Returns the fonts state revision, which changes whenever any font is loaded,
+// freed, or has its settings changed; lets the text measurements be cached
+uint32_t get_fonts_revision();
 bool is_bitmap_font(int font_number);
 bool font_supports_extended_characters(int font_number);
 // Gets font's topmost available char code;
@@ -17,10 +17,45 @@
 #include "platform/platform.h"
 #include "data/assetmanager.h"
 #include "font/fonts.h"
+#include "util/resourcecache.h"
 #include "util/stream.h"
 
 using namespace AGS::Common;
 
+// Max size of the glyph bitmaps cached by a font, in bytes
+static const int MaxGlyphCacheSize = 4 * 1024 * 1024;
+// Max size of the text widths cached for a font, in bytes
+static const size_t MaxTextWidthCacheSize = 128 * 1024;
+
+// Measured text width, and the approximate memory taken by its cache entry
+struct TextWidth
+{
+    int    Width = 0;
+    size_t Size = 0u;
+
+    TextWidth() = default;
+    TextWidth(int width, size_t text_len)
+        : Width(width)
+        // the text itself, the key references in the map and MRU list, and their nodes
+        , Size(text_len + 1 + sizeof(TextWidth) + 2 * sizeof(String) + 6 * sizeof(void*)) {}
+};
+
+// Text width cache, stores widths of the most recently measured strings;
+// lines are measured over and over while the text is split and aligned,
+// and while the same labels and overlays are redrawn.
+class TTFFontRenderer::TextWidthCache final :
+    public ResourceCache<String, TextWidth>
+{
+public:
+    TextWidthCache() : ResourceCache(MaxTextWidthCacheSize) {}
+
+private:
+    size_t CalcSize(const TextWidth &item) override
+    {
+        return item.Size;
+    }
+};
+
 TTFFontRenderer::TTFFontRenderer(AssetManager *amgr)
     : _amgr(amgr)
 {
@@ -55,7 +90,25 @@ void TTFFontRenderer::EnsureTextValidForFont(char * /*text*/, int /*fontNumber*/
 
 int TTFFontRenderer::GetTextWidth(const char *text, int fontNumber)
 {
-  return alfont_text_length(_fontData[fontNumber].AlFont, text);
+  FontData &font = _fontData[fontNumber];
+  if (!font.TextWidths)
+    return alfont_text_length(font.AlFont, text);
+
+  // Text is decoded according to the current text format, which may be
+  // changed, e.g. by a translation; the widths have to be measured again then
+  if (_textWidthsUFormat != get_uformat())
+  {
+    ClearTextWidthCache();
+    _textWidthsUFormat = get_uformat();
+  }
+
+  const TextWidth &cached = font.TextWidths->Get(String::Wrapper(text));
+  if (cached.Size > 0u)
+    return cached.Width;
+  const int width = alfont_text_length(font.AlFont, text);
+  font.TextWidths->Put(String(text), TextWidth(width, strlen(text)));
+  TrimGlyphCache(font.AlFont);
+  return width;
 }
 
 int TTFFontRenderer::GetTextHeight(const char * /*text*/, int fontNumber)
@@ -78,6 +131,24 @@ void TTFFontRenderer::RenderText(const char *text, int fontNumber, BITMAP *desti
     alfont_textout_aa(destination, _fontData[fontNumber].AlFont, text, x, y - 1, colour);
   else
     alfont_textout(destination, _fontData[fontNumber].AlFont, text, x, y - 1, colour);
+  TrimGlyphCache(_fontData[fontNumber].AlFont);
+}
+
+void TTFFontRenderer::TrimGlyphCache(ALFONT_FONT *alfptr)
+{
+  // Glyphs are cached by alfont on first use; fonts with large character sets
+  // might accumulate a lot of them, so start anew when the limit is reached
+  if (alfont_get_glyph_cache_size(alfptr) > MaxGlyphCacheSize)
+    alfont_clear_glyph_cache(alfptr);
+}
+
+void TTFFontRenderer::ClearTextWidthCache()
+{
+  for (auto &font : _fontData)
+  {
+    if (font.second.TextWidths)
+      font.second.TextWidths->Clear();
+  }
 }
 
 bool TTFFontRenderer::LoadFromDisk(int fontNumber, int fontSize)
@@ -173,6 +244,7 @@ bool TTFFontRenderer::LoadFromDiskEx(int fontNumber, int fontSize, const String
 
     _fontData[fontNumber].AlFont = alfptr;
     _fontData[fontNumber].Params = f_params;
+    _fontData[fontNumber].TextWidths.reset(new TextWidthCache());
     if (src_filename)
         *src_filename = use_filename;
     if (metrics)
@@ -203,6 +275,8 @@ void TTFFontRenderer::AdjustFontForAntiAlias(int fontNumber, bool /*aa_mode*/)
         const FontRenderParams &params = _fontData[fontNumber].Params;
         int old_height = alfont_get_font_height(alfptr);
         alfont_set_font_size_ex(alfptr, old_height, GetAlfontFlags(params.LoadMode, _legacyAAHeightFixup));
+        if (_fontData[fontNumber].TextWidths)
+            _fontData[fontNumber].TextWidths->Clear();
     }
 }
 
@@ -233,6 +307,8 @@ void TTFFontRenderer::SetCharacterSpacing(int fontNumber, int spacing)
     if (_fontData.find(fontNumber) != _fontData.end())
     {
         alfont_set_char_extra_spacing(_fontData[fontNumber].AlFont, spacing);
+        if (_fontData[fontNumber].TextWidths)
+            _fontData[fontNumber].TextWidths->Clear();
     }
 }
 
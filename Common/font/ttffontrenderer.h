@@ -15,6 +15,7 @@
 #define __AC_TTFFONTRENDERER_H
 
 #include <map>
+#include <memory>
 #include "data/assetmanager.h"
 #include "font/agsfontrenderer.h"
 #include "util/string.h"
@@ -65,16 +66,26 @@ public:
   bool MeasureFontOfPixelHeight(const AGS::Common::String &filename, int pixel_height, FontMetrics *metrics);
 
 private:
+    class TextWidthCache;
+
     ALFONT_FONT *LoadTTF(const AGS::Common::String &filename, int font_size, int alfont_flags);
+    // Disposes the font's cached glyph bitmaps if these exceed the memory limit
+    void TrimGlyphCache(ALFONT_FONT *alfptr);
+    // Disposes all the cached text widths, e.g. when the text encoding changes
+    void ClearTextWidthCache();
 
     struct FontData
     {
-        ALFONT_FONT     *AlFont;
+        ALFONT_FONT     *AlFont = nullptr;
         FontRenderParams Params;
+        // Widths of the recently measured strings
+        std::unique_ptr<TextWidthCache> TextWidths;
     };
     std::map<int, FontData> _fontData;
     AGS::Common::AssetManager *_amgr = nullptr;
     bool _legacyAAHeightFixup = false;
+    // Text encoding format which the cached text widths were measured with
+    int _textWidthsUFormat = 0;
 };
 
 #endif // __AC_TTFFONTRENDERER_H
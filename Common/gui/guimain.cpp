@@ -303,6 +303,7 @@ void GUIMain::RemoveAllControls()
 {
     _ctrlRefs.clear();
     _controls.clear();
+    _ctrlDrawStates.clear();
 }
 
 bool GUIMain::BringControlToFront(int index)
@@ -352,6 +353,11 @@ void GUIMain::DrawWithControls(Bitmap *ds)
     ds->ResetClip();
     DrawSelf(ds);
     DrawControls(ds);
+
+    std::vector<ControlDrawState> states(_controls.size());
+    for (size_t i = 0; i < _controls.size(); ++i)
+        UpdateControlDrawState(i, states[i]);
+    SaveControlDrawStates(std::move(states));
 }
 
 void GUIMain::DrawControls(Bitmap *ds)
@@ -361,76 +367,206 @@ void GUIMain::DrawControls(Bitmap *ds)
 
     Bitmap tempbmp; // in case we need transforms
     for (size_t ctrl_index = 0; ctrl_index < _controls.size(); ++ctrl_index)
-    {
-        set_eip_guiobj(_ctrlDrawOrder[ctrl_index]);
+        DrawControl(ds, _ctrlDrawOrder[ctrl_index], tempbmp);
 
-        GUIObject *objToDraw = _controls[_ctrlDrawOrder[ctrl_index]];
-        Size obj_size = objToDraw->GetSize();
-
-        // Note that the control is invisible not only when Visible property is false,
-        // but also according to a combination of being disabled and some disabled gui modes
-        if (!GUI::IsGUIVisible(objToDraw))
-            continue;
-        // Control's size is empty, no sense in drawing it
-        if (obj_size.IsNull())
-            continue;
+    set_our_eip(380);
+}
 
-        if (GUI::Options.ClipControls && objToDraw->IsContentClipped())
-            ds->SetClip(objToDraw->GetRect());
-        else
-            ds->ResetClip();
+Rect GUIMain::DrawChangedControls(Bitmap *ds)
+{
+    const Rect surf_rect = RectWH(0, 0, ds->GetWidth(), ds->GetHeight());
+    // Changes to the drawing settings that affect all controls require a full redraw
+    if ((_ctrlDrawStates.size() != _controls.size()) ||
+        (_drawnCtrlsSkipped != GUI::ShouldSkipControls(this)) ||
+        (_drawnHighlightCtrl != _highlightCtrl) ||
+        (_drawnDisabledState != GUI::Context.DisabledState))
+    {
+        ds->ResetClip();
+        ds->ClearTransparent();
+        DrawWithControls(ds);
+        return surf_rect;
+    }
+    if (_drawnCtrlsSkipped)
+        return Rect(); // controls are not drawn, nothing to update
 
-        const int objx = objToDraw->GetX();
-        const int objy = objToDraw->GetY();
+    // Damaged areas are where the changed controls are now, and where they were before
+    std::vector<ControlDrawState> states(_ctrlDrawStates);
+    std::vector<Rect> damage;
+    for (size_t i = 0; i < _controls.size(); ++i)
+    {
+        if (!UpdateControlDrawState(i, states[i]))
+            continue;
+        if (_ctrlDrawStates[i].Visible)
+            damage.push_back(_ctrlDrawStates[i].Area);
+        if (states[i].Visible)
+            damage.push_back(states[i].Area);
+    }
+    if (damage.empty())
+    {
+        SaveControlDrawStates(std::move(states));
+        return Rect();
+    }
 
-        // Depending on draw properties - draw directly on the gui surface, or use a buffer
-        if (objToDraw->GetTransparency() == 0)
+    // Controls cannot be partially redrawn, so extend the damaged areas over
+    // any control that overlaps them, and merge the areas which overlap each other;
+    // repeat until every control is either entirely inside or outside of the areas.
+    for (bool extended = true; extended;)
+    {
+        extended = false;
+        for (const auto &state : states)
         {
-            objToDraw->Draw(ds, objx, objy);
-            // Reset clip, in case control does temporary surface clipping
-            ds->ResetClip();
+            if (!state.Visible)
+                continue;
+            for (auto &area : damage)
+            {
+                if (AreRectsIntersecting(area, state.Area) && !IsRectInsideRect(area, state.Area))
+                {
+                    area = SumRects(area, state.Area);
+                    extended = true;
+                }
+            }
         }
-        else
+        for (size_t i = 0; i < damage.size(); ++i)
         {
-            const Rect rc = objToDraw->CalcGraphicRect(GUI::Options.ClipControls && objToDraw->IsContentClipped());
-            tempbmp.CreateTransparent(rc.GetWidth(), rc.GetHeight());
-            objToDraw->Draw(&tempbmp, -rc.Left, -rc.Top);
-            draw_gui_sprite(ds, true, objx + rc.Left, objy + rc.Top,
-                &tempbmp, objToDraw->HasAlphaChannel(), kBlendMode_Alpha,
-                GfxDef::LegacyTrans255ToAlpha255(objToDraw->GetTransparency()));
+            for (size_t j = i + 1; j < damage.size();)
+            {
+                if (AreRectsIntersecting(damage[i], damage[j]))
+                {
+                    damage[i] = SumRects(damage[i], damage[j]);
+                    damage.erase(damage.begin() + j);
+                    extended = true;
+                }
+                else
+                {
+                    ++j;
+                }
+            }
         }
+    }
 
-        int selectedColour = 14;
-
-        if (_highlightCtrl == _ctrlDrawOrder[ctrl_index])
+    // Redraw GUI background and the controls inside each damaged area
+    Rect redrawn;
+    Bitmap tempbmp; // in case we need transforms
+    for (const auto &area : damage)
+    {
+        const Rect draw_area = IntersectRects(area, surf_rect);
+        if (draw_area.IsEmpty())
+            continue;
+        ds->SetClip(draw_area);
+        ds->ClearTransparent();
+        DrawSelf(ds);
+        for (int index : _ctrlDrawOrder)
         {
-            if (GUI::Options.OutlineControls)
-                selectedColour = 13;
-            color_t draw_color = ds->GetCompatibleColor(selectedColour);
-            DrawBlob(ds, objx + obj_size.Width - get_fixed_pixel_size(1) - 1, objy, draw_color);
-            DrawBlob(ds, objx, objy + obj_size.Height - get_fixed_pixel_size(1) - 1, draw_color);
-            DrawBlob(ds, objx, objy, draw_color);
-            DrawBlob(ds, objx + obj_size.Width - get_fixed_pixel_size(1) - 1,
-                    objy + obj_size.Height - get_fixed_pixel_size(1) - 1, draw_color);
+            if (states[index].Visible && AreRectsIntersecting(area, states[index].Area))
+                DrawControl(ds, index, tempbmp);
         }
+        redrawn = redrawn.IsEmpty() ? draw_area : SumRects(redrawn, draw_area);
+    }
+    ds->ResetClip();
+    SaveControlDrawStates(std::move(states));
+    set_our_eip(380);
+    return redrawn;
+}
+
+void GUIMain::DrawControl(Bitmap *ds, int index, Bitmap &tempbmp)
+{
+    set_eip_guiobj(index);
+
+    GUIObject *objToDraw = _controls[index];
+    Size obj_size = objToDraw->GetSize();
+
+    // Note that the control is invisible not only when Visible property is false,
+    // but also according to a combination of being disabled and some disabled gui modes
+    if (!GUI::IsGUIVisible(objToDraw))
+        return;
+    // Control's size is empty, no sense in drawing it
+    if (obj_size.IsNull())
+        return;
+
+    if (GUI::Options.ClipControls && objToDraw->IsContentClipped())
+        ds->SetClip(objToDraw->GetRect());
+    else
+        ds->ResetClip();
+
+    const int objx = objToDraw->GetX();
+    const int objy = objToDraw->GetY();
+
+    // Depending on draw properties - draw directly on the gui surface, or use a buffer
+    if (objToDraw->GetTransparency() == 0)
+    {
+        objToDraw->Draw(ds, objx, objy);
+        // Reset clip, in case control does temporary surface clipping
+        ds->ResetClip();
+    }
+    else
+    {
+        const Rect rc = objToDraw->CalcGraphicRect(GUI::Options.ClipControls && objToDraw->IsContentClipped());
+        tempbmp.CreateTransparent(rc.GetWidth(), rc.GetHeight());
+        objToDraw->Draw(&tempbmp, -rc.Left, -rc.Top);
+        draw_gui_sprite(ds, true, objx + rc.Left, objy + rc.Top,
+            &tempbmp, objToDraw->HasAlphaChannel(), kBlendMode_Alpha,
+            GfxDef::LegacyTrans255ToAlpha255(objToDraw->GetTransparency()));
+    }
+
+    int selectedColour = 14;
+
+    if (_highlightCtrl == index)
+    {
         if (GUI::Options.OutlineControls)
+            selectedColour = 13;
+        color_t draw_color = ds->GetCompatibleColor(selectedColour);
+        DrawBlob(ds, objx + obj_size.Width - get_fixed_pixel_size(1) - 1, objy, draw_color);
+        DrawBlob(ds, objx, objy + obj_size.Height - get_fixed_pixel_size(1) - 1, draw_color);
+        DrawBlob(ds, objx, objy, draw_color);
+        DrawBlob(ds, objx + obj_size.Width - get_fixed_pixel_size(1) - 1,
+                objy + obj_size.Height - get_fixed_pixel_size(1) - 1, draw_color);
+    }
+    if (GUI::Options.OutlineControls)
+    {
+        // draw a dotted outline round all objects
+        color_t draw_color = ds->GetCompatibleColor(selectedColour);
+        for (int i = 0; i < obj_size.Width; i += 2)
         {
-            // draw a dotted outline round all objects
-            color_t draw_color = ds->GetCompatibleColor(selectedColour);
-            for (int i = 0; i < obj_size.Width; i += 2)
-            {
-                ds->PutPixel(i + objx, objy, draw_color);
-                ds->PutPixel(i + objx, objy + obj_size.Height - 1, draw_color);
-            }
-            for (int i = 0; i < obj_size.Height; i += 2)
-            {
-                ds->PutPixel(objx, i + objy, draw_color);
-                ds->PutPixel(objx + obj_size.Width - 1, i + objy, draw_color);
-            }
+            ds->PutPixel(i + objx, objy, draw_color);
+            ds->PutPixel(i + objx, objy + obj_size.Height - 1, draw_color);
+        }
+        for (int i = 0; i < obj_size.Height; i += 2)
+        {
+            ds->PutPixel(objx, i + objy, draw_color);
+            ds->PutPixel(objx + obj_size.Width - 1, i + objy, draw_color);
         }
     }
+}
 
-    set_our_eip(380);
+bool GUIMain::UpdateControlDrawState(int index, ControlDrawState &state)
+{
+    GUIObject *ctrl = _controls[index];
+    const ControlDrawState was = state;
+    // Note that the control is invisible not only when Visible property is false,
+    // but also according to a combination of being disabled and some disabled gui modes
+    state.Visible = GUI::IsGUIVisible(ctrl) && !ctrl->GetSize().IsNull();
+    state.Frame = ctrl->GetRect();
+    state.ZOrder = ctrl->GetZOrder();
+    state.Transparency = ctrl->GetTransparency();
+    // Control's graphic may only change its extent if it had changed itself, or was resized
+    if (state.Visible && (ctrl->HasChanged() || !was.Visible || !(state.Frame == was.Frame)))
+    {
+        const Rect rc = ctrl->CalcGraphicRect(GUI::Options.ClipControls && ctrl->IsContentClipped());
+        // include the control's frame, for the highlight and outline
+        state.Area = SumRects(state.Frame, OffsetRect(rc, state.Frame.GetLT()));
+    }
+    return ctrl->HasChanged() || (state.Visible != was.Visible) || !(state.Area == was.Area) ||
+        (state.ZOrder != was.ZOrder) || (state.Transparency != was.Transparency);
+}
+
+void GUIMain::SaveControlDrawStates(std::vector<ControlDrawState> &&states)
+{
+    _ctrlDrawStates = std::move(states);
+    for (auto *ctrl : _controls)
+        ctrl->ClearChanged();
+    _drawnCtrlsSkipped = GUI::ShouldSkipControls(this);
+    _drawnHighlightCtrl = _highlightCtrl;
+    _drawnDisabledState = GUI::Context.DisabledState;
 }
 
 void GUIMain::DrawBlob(Bitmap *ds, int x, int y, color_t draw_color)
@@ -485,6 +621,7 @@ HError GUIMain::RebuildArray(GUIRefCollection &guiobjs)
     int thisnum;
 
     _controls.resize(_ctrlRefs.size());
+    _ctrlDrawStates.clear();
     for (size_t i = 0; i < _controls.size(); ++i)
     {
         thistype = _ctrlRefs[i].first;
@@ -210,6 +210,12 @@ public:
     void    DrawSelf(Bitmap *ds);
     void    DrawWithControls(Bitmap *ds);
     void    DrawControls(Bitmap *ds);
+    // Redraws only the parts of the GUI surface affected by the controls that
+    // have changed since the last DrawWithControls or DrawChangedControls call;
+    // expects the surface to still contain the result of that previous draw.
+    // Returns the bounding rectangle of the redrawn area, empty if nothing
+    // had to be redrawn.
+    Rect    DrawChangedControls(Bitmap *ds);
     // Polls GUI state, providing current cursor (mouse) coordinates
     void    Poll(int mx, int my);
     // Reconnects this GUIMain with the child controls from the global guiobject collection
@@ -251,7 +257,23 @@ public:
     static void SkipSavestate(Stream *in, GuiSvgVersion svg_version, std::vector<ControlRef> *ctrl_refs);
 
 private:
+    // Control's looks at the time when it was last drawn on the GUI surface
+    struct ControlDrawState
+    {
+        bool Visible = false;
+        Rect Frame;     // control's rectangle
+        Rect Area;      // area covered by the control's graphic, in GUI coordinates
+        int  ZOrder = 0;
+        int  Transparency = 0;
+    };
+
     void    DrawBlob(Bitmap *ds, int x, int y, color_t draw_color);
+    // Draws a single control, using a temporary bitmap in case it needs transforms
+    void    DrawControl(Bitmap *ds, int index, Bitmap &tempbmp);
+    // Updates the control's draw state, returns whether it has to be redrawn
+    bool    UpdateControlDrawState(int index, ControlDrawState &state);
+    // Remembers the draw states of all controls and clears their changed flags
+    void    SaveControlDrawStates(std::vector<ControlDrawState> &&states);
     // Same as FindControlAt but expects local space coordinates
     int     FindControlAtLocal(int atx, int aty, int leeway, bool must_be_clickable) const;
 
@@ -297,6 +319,13 @@ private:
     std::vector<GUIObject*> _controls;
     // Sorted array of controls in z-order.
     std::vector<int>        _ctrlDrawOrder;
+    // Draw states of the controls, as of the last draw with controls;
+    // used to find which parts of the GUI surface have to be redrawn
+    std::vector<ControlDrawState> _ctrlDrawStates;
+    // Drawing settings which affect every control, as of the last draw
+    bool    _drawnCtrlsSkipped = false;
+    int     _drawnHighlightCtrl = -1;
+    GuiDisableStyle _drawnDisabledState = kGuiDis_Undefined;
 };
 
 
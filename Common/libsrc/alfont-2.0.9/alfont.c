@@ -55,6 +55,7 @@ struct ALFONT_FONT {
     unsigned char *bmp;
     unsigned char *aabmp;
   } *cached_glyphs;       /* array to know which glyphs have been cached */
+  int cached_glyphs_size; /* total size of the cached glyph bitmaps, in bytes */
   int *fixed_sizes;       /* array with the fixed sizes */
   char *language;		  /* language */
   int type;				  /* Code Convert(Please Use TYPE_WIDECHAR for ASCII to UNICODE) */
@@ -199,10 +200,12 @@ static void _alfont_uncache_glyphs(ALFONT_FONT *f) {
       if (f->cached_glyphs[i].is_cached) {
         f->cached_glyphs[i].is_cached = 0;
         if (f->cached_glyphs[i].bmp) {
+          f->cached_glyphs_size -= f->cached_glyphs[i].width * f->cached_glyphs[i].height;
           free(f->cached_glyphs[i].bmp);
           f->cached_glyphs[i].bmp = NULL;
         }
         if (f->cached_glyphs[i].aabmp) {
+          f->cached_glyphs_size -= f->cached_glyphs[i].aawidth * f->cached_glyphs[i].aaheight;
           free(f->cached_glyphs[i].aabmp);
           f->cached_glyphs[i].aabmp = NULL;
         }
@@ -220,10 +223,12 @@ static void _alfont_uncache_glyph_number(ALFONT_FONT *f, int glyph_number) {
     if (f->cached_glyphs[glyph_number].is_cached) {
       f->cached_glyphs[glyph_number].is_cached = 0;
       if (f->cached_glyphs[glyph_number].bmp) {
+        f->cached_glyphs_size -= f->cached_glyphs[glyph_number].width * f->cached_glyphs[glyph_number].height;
         free(f->cached_glyphs[glyph_number].bmp);
         f->cached_glyphs[glyph_number].bmp = NULL;
       }
       if (f->cached_glyphs[glyph_number].aabmp) {
+        f->cached_glyphs_size -= f->cached_glyphs[glyph_number].aawidth * f->cached_glyphs[glyph_number].aaheight;
         free(f->cached_glyphs[glyph_number].aabmp);
         f->cached_glyphs[glyph_number].aabmp = NULL;
       }
@@ -241,6 +246,16 @@ static void _alfont_delete_glyphs(ALFONT_FONT *f) {
 }
 
 
+int alfont_get_glyph_cache_size(ALFONT_FONT *f) {
+  return f->cached_glyphs_size;
+}
+
+
+void alfont_clear_glyph_cache(ALFONT_FONT *f) {
+  _alfont_uncache_glyphs(f);
+}
+
+
 static void _alfont_cache_glyph(ALFONT_FONT *f, int glyph_number) {
   if ((glyph_number < 0) || (glyph_number >= f->face->num_glyphs))
     return;
@@ -287,8 +302,10 @@ static void _alfont_cache_glyph(ALFONT_FONT *f, int glyph_number) {
 
         /* allocate bitmap */
         memsize = ft_bmp->width * ft_bmp->rows * sizeof(unsigned char);
-        if (memsize > 0)
+        if (memsize > 0) {
           f->cached_glyphs[glyph_number].bmp = malloc(memsize);
+          f->cached_glyphs_size += memsize;
+        }
         else
           f->cached_glyphs[glyph_number].bmp = NULL;
 
@@ -354,8 +371,10 @@ static void _alfont_cache_glyph(ALFONT_FONT *f, int glyph_number) {
 
         /* allocate bitmap */
         memsize = ft_bmp->width * ft_bmp->rows * sizeof(unsigned char);
-        if (memsize > 0)
+        if (memsize > 0) {
           f->cached_glyphs[glyph_number].aabmp = malloc(memsize);
+          f->cached_glyphs_size += memsize;
+        }
         else
           f->cached_glyphs[glyph_number].aabmp = NULL;
 
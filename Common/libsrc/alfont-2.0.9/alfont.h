@@ -84,6 +84,10 @@ ALFONT_DLL_DECLSPEC void alfont_get_charcode_range(ALFONT_FONT *f, int *first_ch
 *  returns the length of array.
    The array is created with malloc() and must be disposed using free(). */
 ALFONT_DLL_DECLSPEC int alfont_get_valid_charcodes(ALFONT_FONT *f, int **charcodes);
+/* Returns the total size of the glyph bitmaps currently cached by the font, in bytes */
+ALFONT_DLL_DECLSPEC int alfont_get_glyph_cache_size(ALFONT_FONT *f);
+/* Disposes all the glyph bitmaps cached by the font; they will be rendered again on demand */
+ALFONT_DLL_DECLSPEC void alfont_clear_glyph_cache(ALFONT_FONT *f);
 
 ALFONT_DLL_DECLSPEC int alfont_text_mode(int mode);
 
@@ -0,0 +1,231 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2026 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include <string.h>
+#include "gtest/gtest.h"
+#include "data/assetmanager.h"
+#include "data/multifilelib.h"
+#include "util/directory.h"
+#include "util/directorywatcher.h"
+#include "util/file.h"
+#include "util/path.h"
+#include "platform/platform.h"
+#if AGS_PLATFORM_OS_WINDOWS
+#include <direct.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace AGS::Common;
+
+#if (AGS_PLATFORM_TEST_FILE_IO)
+
+static void CreateTestFile(const String &filename, const char *text)
+{
+    auto out = File::CreateFile(filename);
+    ASSERT_TRUE(out);
+    out->Write(text, strlen(text));
+}
+
+static void RemoveTestDir(const String &dir)
+{
+#if AGS_PLATFORM_OS_WINDOWS
+    _rmdir(dir.GetCStr());
+#else
+    rmdir(dir.GetCStr());
+#endif
+}
+
+// Writes an asset library file, where each asset contains a tag and its own name
+static void CreateTestLib(const String &filename, const char *tag, const std::vector<String> &assets)
+{
+    AssetLibInfo lib;
+    lib.LibFileNames.push_back(Path::GetFilename(filename));
+    for (const auto &name : assets)
+    {
+        AssetInfo a;
+        a.FileName = name;
+        a.Size = strlen(tag) + name.GetLength();
+        lib.AssetInfos.push_back(a);
+    }
+    auto out = File::CreateFile(filename);
+    ASSERT_TRUE(out);
+    MFLUtil::WriteHeader(lib, MFLUtil::kMFLVersion_MultiV30, 0, out.get());
+    for (auto &a : lib.AssetInfos)
+    {
+        a.Offset = out->GetPosition();
+        out->Write(tag, strlen(tag));
+        out->Write(a.FileName.GetCStr(), a.FileName.GetLength());
+    }
+    out->Seek(0, kSeekBegin);
+    MFLUtil::WriteHeader(lib, MFLUtil::kMFLVersion_MultiV30, 0, out.get());
+    out->Seek(0, kSeekEnd);
+    MFLUtil::WriteEnder(0, MFLUtil::kMFLVersion_MultiV30, out.get());
+}
+
+static String ReadAsset(const AssetManager &mgr, const String &name, const String &filter = "")
+{
+    auto in = mgr.OpenAsset(name, filter);
+    if (!in)
+        return "";
+    return String::FromStreamCount(in.get(), static_cast<size_t>(in->GetLength()));
+}
+
+static void TestDirLookup(AssetManager &mgr)
+{
+    ASSERT_TRUE(mgr.DoesAssetExist("Data.txt"));
+    ASSERT_TRUE(mgr.DoesAssetExist("data.TXT"));
+    ASSERT_TRUE(mgr.DoesAssetExist("./data.txt"));
+    ASSERT_TRUE(mgr.DoesAssetExist("sub/music.ogg"));
+    ASSERT_TRUE(mgr.DoesAssetExist("SUB/Music.OGG"));
+    ASSERT_FALSE(mgr.DoesAssetExist("missing.txt"));
+    ASSERT_FALSE(mgr.DoesAssetExist("sub"));
+    ASSERT_FALSE(mgr.DoesAssetExist(""));
+
+    auto in = mgr.OpenAsset("DATA.txt");
+    ASSERT_TRUE(in);
+    char buf[16]{};
+    in->Read(buf, sizeof(buf) - 1);
+    ASSERT_STREQ(buf, "data");
+    in = mgr.OpenAsset("sub/MUSIC.ogg");
+    ASSERT_TRUE(in);
+    ASSERT_EQ(in->GetLength(), 5);
+}
+
+TEST(AssetManager, DirIndex) {
+    const String dir = Path::MakeAbsolutePath("AssetDirTest");
+    const String subdir = Path::ConcatPaths(dir, "Sub");
+    ASSERT_TRUE(Directory::CreateDirectory(dir));
+    ASSERT_TRUE(Directory::CreateDirectory(subdir));
+    CreateTestFile(Path::ConcatPaths(dir, "Data.txt"), "data");
+    CreateTestFile(Path::ConcatPaths(subdir, "Music.ogg"), "music");
+    const String new_file = Path::ConcatPaths(dir, "New.txt");
+
+    AssetManager mgr;
+    // Directories are not indexed unless requested
+    ASSERT_EQ(mgr.GetDirIndexMode(), kAssetDirIndexNone);
+    ASSERT_EQ(mgr.AddLibrary(dir), kAssetNoError);
+    TestDirLookup(mgr);
+    CreateTestFile(new_file, "new");
+    ASSERT_TRUE(mgr.DoesAssetExist("new.txt"));
+    File::DeleteFile(new_file);
+    ASSERT_FALSE(mgr.DoesAssetExist("new.txt"));
+
+    // Static index does not see the files added after it was built
+    mgr.SetDirIndexMode(kAssetDirIndexStatic);
+    TestDirLookup(mgr);
+    CreateTestFile(new_file, "new");
+    ASSERT_FALSE(mgr.DoesAssetExist("new.txt"));
+    // ...but reindexing does
+    mgr.SetDirIndexMode(kAssetDirIndexNone);
+    TestDirLookup(mgr);
+    ASSERT_TRUE(mgr.DoesAssetExist("new.txt"));
+    mgr.SetDirIndexMode(kAssetDirIndexStatic);
+    ASSERT_TRUE(mgr.DoesAssetExist("new.txt"));
+    File::DeleteFile(new_file);
+
+    // Watched index is rebuilt when files are added or removed
+    if (DirectoryWatcher::IsSupported())
+    {
+        mgr.SetDirIndexMode(kAssetDirIndexWatch);
+        TestDirLookup(mgr);
+        ASSERT_FALSE(mgr.DoesAssetExist("new.txt"));
+        CreateTestFile(new_file, "new");
+        ASSERT_TRUE(mgr.DoesAssetExist("new.txt"));
+        File::DeleteFile(new_file);
+        ASSERT_FALSE(mgr.DoesAssetExist("new.txt"));
+        TestDirLookup(mgr);
+    }
+
+    mgr.RemoveAllLibraries();
+    File::DeleteFile(Path::ConcatPaths(subdir, "Music.ogg"));
+    File::DeleteFile(Path::ConcatPaths(dir, "Data.txt"));
+    RemoveTestDir(subdir);
+    RemoveTestDir(dir);
+}
+
+TEST(AssetManager, LibLookup) {
+    const String lib1 = Path::MakeAbsolutePath("AssetLibTest1.dat");
+    const String lib2 = Path::MakeAbsolutePath("AssetLibTest2.dat");
+    const String dir = Path::MakeAbsolutePath("AssetLibTestDir");
+    CreateTestLib(lib1, "A:", { "Room1.crm", "music.ogg", "Common.txt" });
+    CreateTestLib(lib2, "B:", { "common.TXT", "speech.ogg", "room2.crm" });
+    ASSERT_TRUE(Directory::CreateDirectory(dir));
+    CreateTestFile(Path::ConcatPaths(dir, "COMMON.txt"), "D:COMMON.txt");
+
+    AssetManager mgr;
+    ASSERT_EQ(mgr.AddLibrary(lib1), kAssetNoError);
+    ASSERT_EQ(mgr.AddLibrary(lib2, ",voice"), kAssetNoError);
+    // The library added first has priority
+    ASSERT_STREQ(ReadAsset(mgr, "common.txt").GetCStr(), "A:Common.txt");
+    ASSERT_STREQ(ReadAsset(mgr, "ROOM2.CRM").GetCStr(), "B:room2.crm");
+    ASSERT_STREQ(ReadAsset(mgr, "speech.ogg", "voice").GetCStr(), "B:speech.ogg");
+    ASSERT_FALSE(mgr.DoesAssetExist("room1.crm", "voice"));
+    ASSERT_TRUE(mgr.DoesAssetExist("room1.crm"));
+    ASSERT_FALSE(mgr.DoesAssetExist("missing.txt"));
+    time_t ft;
+    ASSERT_TRUE(mgr.GetAssetTime("music.ogg", ft));
+    ASSERT_FALSE(mgr.GetAssetTime("missing.txt", ft));
+
+    std::vector<String> assets;
+    mgr.FindAssets(assets, "room*");
+    ASSERT_EQ(assets, (std::vector<String>{ "Room1.crm", "room2.crm" }));
+    assets.clear();
+    mgr.FindAssets(assets, "*.OGG", "voice");
+    ASSERT_EQ(assets, (std::vector<String>{ "speech.ogg" }));
+    assets.clear();
+    mgr.FindAssets(assets, "common.txt");
+    ASSERT_EQ(assets.size(), 1u);
+    assets.clear();
+    mgr.FindAssets(assets, "*");
+    ASSERT_EQ(assets.size(), 5u);
+    std::vector<FileEntry> entries;
+    mgr.FindAssets(entries, "*o*.*");
+    ASSERT_EQ(entries.size(), 3u);
+    ASSERT_STREQ(entries[0].Name.GetCStr(), "Common.txt");
+
+    // Removing library exposes the assets of the next one
+    mgr.RemoveLibrary(lib1);
+    ASSERT_STREQ(ReadAsset(mgr, "common.txt").GetCStr(), "B:common.TXT");
+    ASSERT_FALSE(mgr.DoesAssetExist("room1.crm"));
+    assets.clear();
+    mgr.FindAssets(assets, "*");
+    ASSERT_EQ(assets.size(), 3u);
+    // Re-added library goes after the existing ones
+    ASSERT_EQ(mgr.AddLibrary(lib1), kAssetNoError);
+    ASSERT_STREQ(ReadAsset(mgr, "common.txt").GetCStr(), "B:common.TXT");
+    ASSERT_STREQ(ReadAsset(mgr, "room1.crm").GetCStr(), "A:Room1.crm");
+
+    // Directories and libraries are ordered by search priority
+    ASSERT_EQ(mgr.AddLibrary(dir), kAssetNoError);
+    ASSERT_STREQ(ReadAsset(mgr, "common.txt").GetCStr(), "D:COMMON.txt");
+    entries.clear();
+    mgr.FindAssets(entries, "common.*");
+    ASSERT_EQ(entries.size(), 1u);
+    ASSERT_STREQ(entries[0].Name.GetCStr(), "COMMON.txt");
+    mgr.SetSearchPriority(kAssetPriorityLib);
+    ASSERT_STREQ(ReadAsset(mgr, "common.txt").GetCStr(), "B:common.TXT");
+    entries.clear();
+    mgr.FindAssets(entries, "common.*");
+    ASSERT_EQ(entries.size(), 1u);
+    ASSERT_STREQ(entries[0].Name.GetCStr(), "common.TXT");
+
+    mgr.RemoveAllLibraries();
+    ASSERT_FALSE(mgr.DoesAssetExist("common.txt"));
+    File::DeleteFile(lib1);
+    File::DeleteFile(lib2);
+    File::DeleteFile(Path::ConcatPaths(dir, "COMMON.txt"));
+    RemoveTestDir(dir);
+}
+
+#endif // AGS_PLATFORM_TEST_FILE_IO
@@ -50,6 +50,11 @@ void GUIObject::MarkStateChanged(bool, bool)
 {
 }
 
+void GUIObject::ClearChanged()
+{
+    _hasChanged = false;
+}
+
 void GUIButton::PrepareTextToDraw()
 {
 }
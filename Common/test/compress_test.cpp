@@ -0,0 +1,103 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2026 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include <vector>
+#include "gtest/gtest.h"
+#include "util/compress.h"
+#include "util/lz4.h"
+#include "util/memory_compat.h"
+#include "util/memorystream.h"
+
+using namespace AGS::Common;
+
+static void TestLz4Roundtrip(const std::vector<uint8_t> &data)
+{
+    std::vector<uint8_t> comp(lz4_compress_bound(data.size()));
+    const size_t comp_sz = lz4_compress_block(data.data(), data.size(), comp.data(), comp.size());
+    ASSERT_GT(comp_sz, 0u);
+    std::vector<uint8_t> out(data.size());
+    ASSERT_TRUE(lz4_decompress_block(comp.data(), comp_sz, out.data(), out.size()));
+    ASSERT_EQ(out, data);
+    // Wrong output size is reported as a failure
+    if (!data.empty())
+    {
+        std::vector<uint8_t> out_short(data.size() - 1);
+        ASSERT_FALSE(lz4_decompress_block(comp.data(), comp_sz, out_short.data(), out_short.size()));
+    }
+    std::vector<uint8_t> out_long(data.size() + 1);
+    ASSERT_FALSE(lz4_decompress_block(comp.data(), comp_sz, out_long.data(), out_long.size()));
+}
+
+TEST(Compress, LZ4Block) {
+    // Short inputs, which are stored as literals
+    for (size_t len = 0; len <= 16; ++len)
+        TestLz4Roundtrip(std::vector<uint8_t>(len, 'a'));
+
+    // Long runs, and long literal sequences
+    TestLz4Roundtrip(std::vector<uint8_t>(100000, 0));
+    std::vector<uint8_t> noise(70000);
+    uint32_t seed = 12345;
+    for (auto &b : noise)
+    {
+        seed = seed * 1103515245u + 12345u;
+        b = static_cast<uint8_t>(seed >> 16);
+    }
+    TestLz4Roundtrip(noise);
+
+    // Repeating patterns with various distances, including those beyond the 64 KB window
+    std::vector<uint8_t> pattern;
+    for (int i = 0; i < 3; ++i)
+        pattern.insert(pattern.end(), noise.begin(), noise.end());
+    for (int i = 0; i < 1000; ++i)
+        pattern.push_back(static_cast<uint8_t>(i % 3));
+    TestLz4Roundtrip(pattern);
+
+    // Too small output buffer for compression
+    std::vector<uint8_t> comp(10);
+    ASSERT_EQ(lz4_compress_block(noise.data(), noise.size(), comp.data(), comp.size()), 0u);
+
+    // Malformed data is rejected
+    const uint8_t bad_offset[] = { 0x10, 'a', 0x05, 0x00 }; // offset beyond the output start
+    uint8_t out[32];
+    ASSERT_FALSE(lz4_decompress_block(bad_offset, sizeof(bad_offset), out, 5));
+    const uint8_t bad_length[] = { 0xF0, 0xFF }; // truncated length
+    ASSERT_FALSE(lz4_decompress_block(bad_length, sizeof(bad_length), out, sizeof(out)));
+}
+
+TEST(Compress, LZ4Pixels) {
+    // A gradient, which is better compressed with the delta filter
+    const int w = 64, h = 64, bpp = 4;
+    std::vector<uint8_t> pixels(w * h * bpp);
+    for (int y = 0; y < h; ++y)
+        for (int x = 0; x < w; ++x)
+        {
+            uint8_t *px = &pixels[(y * w + x) * bpp];
+            px[0] = static_cast<uint8_t>(x * 3);
+            px[1] = static_cast<uint8_t>(y * 2);
+            px[2] = static_cast<uint8_t>(x + y);
+            px[3] = 0xFF;
+        }
+
+    std::vector<uint8_t> membuf;
+    {
+        Stream out(std::make_unique<VectorStream>(membuf, kStream_Write));
+        ASSERT_TRUE(lz4_compress(pixels.data(), pixels.size(), bpp, &out));
+    }
+    ASSERT_LT(membuf.size(), pixels.size() / 4);
+    ASSERT_EQ(membuf[0], 1); // delta filter
+
+    std::vector<uint8_t> result(pixels.size());
+    Stream in(std::make_unique<VectorStream>(membuf));
+    ASSERT_TRUE(lz4_decompress(result.data(), result.size(), bpp, &in, membuf.size()));
+    ASSERT_EQ(result, pixels);
+}
@@ -12,7 +12,12 @@
 //
 //=============================================================================
 #include <array>
+#include <memory>
+#include <vector>
 #include "gtest/gtest.h"
+#include "ac/gamestructdefines.h"
+#include "ac/spritecache.h"
+#include "gfx/bitmap.h"
 #include "gui/guimain.h"
 
 using namespace AGS::Common;
@@ -73,3 +78,135 @@ TEST(GUI, LabelMacros) {
         ASSERT_TRUE(res2 == test.Output) << "input text: " << test.Input.GetCStr();
     }
 }
+
+namespace
+{
+
+// A control which fills its rectangle with a color, and counts its draws
+class TestControl : public GUIObject
+{
+public:
+    void Draw(Bitmap *ds, int x, int y) override
+    {
+        ds->FillRect(RectWH(x, y, _width, _height), _color);
+        _drawCount++;
+    }
+
+    void SetColor(int color)
+    {
+        _color = color;
+        _hasChanged = true;
+    }
+
+    int GetDrawCount() const { return _drawCount; }
+
+private:
+    int _color = 0;
+    int _drawCount = 0;
+};
+
+uint32_t NextRandom(uint32_t &seed)
+{
+    seed = seed * 1103515245u + 12345u;
+    return (seed >> 16) | (seed << 16);
+}
+
+bool AreBitmapsEqual(Bitmap *bmp1, Bitmap *bmp2)
+{
+    for (int y = 0; y < bmp1->GetHeight(); ++y)
+    {
+        if (memcmp(bmp1->GetScanLine(y), bmp2->GetScanLine(y), bmp1->GetWidth() * bmp1->GetBPP()) != 0)
+            return false;
+    }
+    return true;
+}
+
+// Sets up a GUI with the controls, redraws it fully into its own bitmap
+struct TestGUI
+{
+    std::vector<SpriteInfo> SprInfos;
+    SpriteCache Spriteset;
+    GUIMain Gui;
+    std::vector<TestControl> Controls;
+    std::unique_ptr<Bitmap> Surface;
+    std::unique_ptr<Bitmap> RefSurface;
+
+    TestGUI(int width, int height, size_t num_controls)
+        : Spriteset(SprInfos, SpriteCache::Callbacks())
+        , Controls(num_controls)
+    {
+        GUI::Context.Spriteset = &Spriteset;
+        GUI::Context.DisabledState = kGuiDis_Undefined;
+        Gui.SetSize(width, height);
+        Gui.SetBgColor(0x203040);
+        for (size_t i = 0; i < Controls.size(); ++i)
+        {
+            Controls[i].SetID(i);
+            Controls[i].SetZOrder(i);
+            Gui.AddControl(kGUILabel, i, &Controls[i]);
+        }
+        Gui.ResortZOrder();
+        Surface.reset(BitmapHelper::CreateBitmap(width, height, 32));
+        RefSurface.reset(BitmapHelper::CreateBitmap(width, height, 32));
+    }
+
+    ~TestGUI()
+    {
+        GUI::Context.Spriteset = nullptr;
+    }
+
+    // Tells if the incrementally redrawn surface is same as a full redraw
+    bool TestIncremental()
+    {
+        RefSurface->ClearTransparent();
+        Gui.DrawSelf(RefSurface.get());
+        Gui.DrawControls(RefSurface.get());
+        return AreBitmapsEqual(Surface.get(), RefSurface.get());
+    }
+};
+
+} // namespace
+
+TEST(GUI, DrawChangedControls) {
+    // Randomly placed controls overlapping each other
+    TestGUI test(200, 150, 40);
+    uint32_t seed = 1;
+    for (auto &ctrl : test.Controls)
+    {
+        ctrl.SetPosition(NextRandom(seed) % 190, NextRandom(seed) % 140);
+        ctrl.SetSize(4 + NextRandom(seed) % 40, 4 + NextRandom(seed) % 30);
+        ctrl.SetColor(NextRandom(seed) & 0xFFFFFF);
+    }
+    test.Gui.DrawWithControls(test.Surface.get());
+    ASSERT_TRUE(test.Gui.DrawChangedControls(test.Surface.get()).IsEmpty());
+
+    for (int frame = 0; frame < 500; ++frame)
+    {
+        TestControl &ctrl = test.Controls[NextRandom(seed) % test.Controls.size()];
+        switch (NextRandom(seed) % 4)
+        {
+        case 0:
+            ctrl.SetColor(NextRandom(seed) & 0xFFFFFF);
+            break;
+        case 1:
+            ctrl.SetPosition(NextRandom(seed) % 210 - 10, NextRandom(seed) % 160 - 10);
+            break;
+        case 2:
+            ctrl.SetVisible(!ctrl.IsVisible());
+            break;
+        case 3:
+            ctrl.SetZOrder(NextRandom(seed) % test.Controls.size());
+            test.Gui.ResortZOrder();
+            break;
+        }
+        test.Gui.MarkControlChanged();
+        const Rect area = test.Gui.DrawChangedControls(test.Surface.get());
+        ASSERT_TRUE(test.TestIncremental()) << "frame " << frame;
+        ASSERT_TRUE(IsRectInsideRect(RectWH(test.Surface->GetSize()), area));
+    }
+
+    // Changing the highlighted control redraws everything
+    test.Gui.SetHighlightControl(0);
+    ASSERT_TRUE(test.Gui.DrawChangedControls(test.Surface.get()) == RectWH(test.Surface->GetSize()));
+    ASSERT_TRUE(test.TestIncremental());
+}
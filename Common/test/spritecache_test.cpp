@@ -186,3 +186,103 @@ TEST(SpriteCache, SaveToFileUsingInputFile) {
 	ASSERT_EQ(index.Offsets[9], off); off += EMPTY_DAT_SZ;
 	ASSERT_EQ(index.Offsets[10], off); off += SPRITE_DAT_HEADER_SZ + (10 * 10 * 4);
 }
+
+TEST(SpriteCache, PrefetchSprites) {
+	std::vector<uint8_t> storage;
+
+	{
+		std::vector<SpriteInfo> spr_infos_temp;
+		auto sc_temp = std::make_unique<SpriteCache>(spr_infos_temp, SpriteCache::Callbacks());
+		FillSpriteCache(sc_temp.get());
+		SpriteFileIndex index;
+		sc_temp->SaveToFile(std::make_unique<Stream>(std::make_unique<VectorStream>(storage, kStream_Write)),
+			0, kSprCompress_None, index);
+	}
+
+	std::vector<SpriteInfo> spr_infos;
+	auto sc = std::make_unique<SpriteCache>(spr_infos, SpriteCache::Callbacks());
+	HError err = sc->InitFile(std::make_unique<Stream>(std::make_unique<VectorStream>(storage)), nullptr);
+	ASSERT_TRUE(err);
+
+	sc->PrefetchSprite(1);
+	sc->PrefetchSprite(2);
+	// Precaching is not a prefetch, the sprite is loaded right away
+	sc->PrecacheSprite(10);
+	ASSERT_TRUE(sc->IsSpriteLoaded(10));
+	// Non-asset and non-existing sprites are ignored
+	sc->PrefetchSprite(4);
+	sc->PrefetchSprite(5);
+	// Sprites are either taken from the prefetcher, or loaded on demand
+	ASSERT_EQ((*sc)[1]->GetWidth(), 1);
+	sc->UpdatePrefetched();
+	ASSERT_EQ((*sc)[2]->GetWidth(), 2);
+	ASSERT_EQ((*sc)[10]->GetWidth(), 10);
+	ASSERT_TRUE(sc->IsSpriteLoaded(1));
+	ASSERT_TRUE(sc->IsSpriteLoaded(2));
+	ASSERT_TRUE(sc->IsSpriteLoaded(10));
+	// Already loaded sprites are not prefetched again
+	sc->PrefetchSprite(1);
+
+	const auto &stats = sc->GetPrefetchStats();
+#if !defined(AGS_DISABLE_THREADS)
+	ASSERT_EQ(stats.Requested, 2u);
+	ASSERT_EQ(stats.Hits + stats.Waits + stats.Misses, 3u);
+#else
+	ASSERT_EQ(stats.Requested, 0u);
+#endif
+
+	// Prefetched sprites are loaded even if they are over the limit
+	// of the sprites waiting for the cache
+	sc->DisposeAllFreeCached();
+	sc->SetMaxCacheSize(16);
+	sc->PrefetchSprite(2);
+	sc->PrefetchSprite(10);
+	ASSERT_EQ((*sc)[10]->GetWidth(), 10);
+	ASSERT_EQ((*sc)[2]->GetWidth(), 2);
+
+	// Reset drops any pending requests
+	sc->DisposeAllFreeCached();
+	sc->PrefetchSprite(1);
+	sc->PrefetchSprite(2);
+	sc->Reset();
+	ASSERT_EQ(sc->GetSpriteSlotCount(), 0u);
+}
+
+TEST(SpriteCache, PrecacheSprites) {
+	std::vector<uint8_t> storage;
+	{
+		std::vector<SpriteInfo> spr_infos_temp;
+		auto sc_temp = std::make_unique<SpriteCache>(spr_infos_temp, SpriteCache::Callbacks());
+		for (int i = 1; i <= 10; ++i)
+		{
+			auto bmp = std::make_unique<Bitmap>(i, i, 8);
+			bmp->Clear(i);
+			sc_temp->SetSprite(i, std::move(bmp));
+		}
+		SpriteFileIndex index;
+		HError err = sc_temp->SaveToFile(std::make_unique<Stream>(std::make_unique<VectorStream>(storage, kStream_Write)),
+			0, kSprCompress_Deflate, index);
+		ASSERT_TRUE(err);
+	}
+
+	std::vector<SpriteInfo> spr_infos;
+	auto sc = std::make_unique<SpriteCache>(spr_infos, SpriteCache::Callbacks());
+	HError err = sc->InitFile(std::make_unique<Stream>(std::make_unique<VectorStream>(storage)), nullptr);
+	ASSERT_TRUE(err);
+
+	// Duplicate, already loaded, and non-existing sprites are skipped
+	ASSERT_EQ((*sc)[2]->GetPixel(0, 0), 2);
+	sc->PrefetchSprite(3);
+	sc->PrecacheSprites({ 9, 2, 3, 5, 9, 7, 100, -1 });
+	ASSERT_TRUE(sc->IsSpriteLoaded(2));
+	ASSERT_TRUE(sc->IsSpriteLoaded(3));
+	ASSERT_TRUE(sc->IsSpriteLoaded(5));
+	ASSERT_TRUE(sc->IsSpriteLoaded(7));
+	ASSERT_TRUE(sc->IsSpriteLoaded(9));
+	ASSERT_FALSE(sc->IsSpriteLoaded(4));
+	for (int i : { 3, 5, 7, 9 })
+	{
+		ASSERT_EQ(spr_infos[i].Width, i);
+		ASSERT_EQ(sc->operator[](i)->GetPixel(i - 1, i - 1), i);
+	}
+}
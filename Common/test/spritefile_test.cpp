@@ -11,6 +11,7 @@
 // https://opensource.org/license/artistic-2-0/
 //
 //=============================================================================
+#include <cstring>
 #include "gtest/gtest.h"
 #include "ac/gamestructdefines.h"
 #include "ac/spritefile.h"
@@ -108,3 +109,67 @@ TEST(SpriteFileWriter, WriteAndReadMetrics) {
 	ASSERT_EQ(metrics[4].Height, 0);
 	ASSERT_EQ(metrics[10].Height, 10);
 }
+
+// Writes a sprite file with a number of small sprites, filled with distinct patterns
+static void WritePatternSpriteFile(std::vector<uint8_t> &storage, SpriteCompression compress,
+	int sprite_count, int width, int height)
+{
+	auto sfw = std::make_unique<SpriteFileWriter>(
+		std::make_unique<Stream>(std::make_unique<VectorStream>(storage, kStream_Write)));
+	sfw->Begin(0, compress);
+	sfw->WriteEmptySlot();
+	for (int i = 1; i <= sprite_count; ++i)
+	{
+		PixelBuffer image(width, height, kPxFmt_A8R8G8B8);
+		uint32_t *px = reinterpret_cast<uint32_t*>(image.GetData());
+		for (int p = 0; p < width * height; ++p)
+			px[p] = 0xFF000000 | (i * 31 + (p / 4) % 7);
+		sfw->WriteBitmap(image);
+	}
+	sfw->Finalize();
+}
+
+TEST(SpriteFile, LoadSprites) {
+	for (int compress = kSprCompress_None; compress < kNumSprCompressTypes; ++compress)
+	{
+		std::vector<uint8_t> storage;
+		WritePatternSpriteFile(storage, static_cast<SpriteCompression>(compress), 20, 8, 8);
+
+		auto sf = std::make_unique<SpriteFile>();
+		HError err = sf->OpenFile(std::make_unique<Stream>(std::make_unique<VectorStream>(storage)), nullptr);
+		ASSERT_TRUE(err);
+
+		// Request in arbitrary order, including an empty slot and a non-existing one
+		const std::vector<sprkey_t> indexes = { 15, 3, 0, 20, 1, 7, 100, 8 };
+		std::vector<PixelBuffer> sprites;
+		std::vector<HError> errors;
+		for (size_t threads = 1; threads <= 4; ++threads)
+		{
+			sf->SetDecodeThreadCount(threads);
+			sf->LoadSprites(indexes, sprites, errors);
+			ASSERT_EQ(sprites.size(), indexes.size());
+			ASSERT_EQ(errors.size(), indexes.size());
+			for (size_t i = 0; i < indexes.size(); ++i)
+			{
+				const sprkey_t index = indexes[i];
+				if (index == 0)
+				{
+					ASSERT_TRUE(errors[i]);
+					ASSERT_EQ(sprites[i].GetData(), nullptr);
+					continue;
+				}
+				if (index == 100)
+				{
+					ASSERT_FALSE(errors[i]);
+					continue;
+				}
+				ASSERT_TRUE(errors[i]);
+				PixelBuffer single;
+				ASSERT_TRUE(sf->LoadSprite(index, single));
+				ASSERT_EQ(sprites[i].GetWidth(), 8);
+				ASSERT_EQ(sprites[i].GetHeight(), 8);
+				ASSERT_EQ(memcmp(sprites[i].GetData(), single.GetData(), single.GetDataSize()), 0);
+			}
+		}
+	}
+}
@@ -14,11 +14,14 @@
 #include "util/compress.h"
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+#include <algorithm>
 #include <vector>
 #include <miniz.h>
 #if AGS_PLATFORM_ENDIAN_BIG
 #include "util/bbop.h"
 #endif
+#include "util/lz4.h"
 #include "util/lzw.h"
 #include "util/memory_compat.h"
 #include "util/memorystream.h"
@@ -558,5 +561,92 @@ bool inflate_decompress(uint8_t* data, size_t data_sz, int /*image_bpp*/, Stream
     return z_inflate(in_buf.data(), in_sz, data, data_sz);
 }
 
+//-----------------------------------------------------------------------------
+// LZ4
+//-----------------------------------------------------------------------------
+
+// Filters applied to the pixel data before compressing with LZ4
+enum Lz4Filter
+{
+    kLz4Filter_None  = 0,
+    // Each byte is stored as a difference with the same byte of the previous pixel;
+    // this makes smooth gradients in hi-color images more compressible
+    kLz4Filter_Delta = 1
+};
+
+bool lz4_compress(const uint8_t *data, size_t data_sz, int image_bpp, Stream *out)
+{
+    std::vector<uint8_t> comp_buf(lz4_compress_bound(data_sz));
+    size_t comp_sz = lz4_compress_block(data, data_sz, comp_buf.data(), comp_buf.size());
+    if (comp_sz == 0)
+        return false;
+    uint8_t filter = kLz4Filter_None;
+
+    // Try the delta filter on multi-byte pixels, and keep it if it gives better result
+    if (image_bpp > 1 && data_sz > static_cast<size_t>(image_bpp))
+    {
+        std::vector<uint8_t> delta_buf(data_sz);
+        std::copy(data, data + image_bpp, delta_buf.data());
+        for (size_t i = image_bpp; i < data_sz; ++i)
+            delta_buf[i] = static_cast<uint8_t>(data[i] - data[i - image_bpp]);
+        std::vector<uint8_t> delta_comp(comp_buf.size());
+        const size_t delta_sz = lz4_compress_block(delta_buf.data(), data_sz, delta_comp.data(), delta_comp.size());
+        if (delta_sz > 0 && delta_sz < comp_sz)
+        {
+            comp_buf.swap(delta_comp);
+            comp_sz = delta_sz;
+            filter = kLz4Filter_Delta;
+        }
+    }
+
+    out->WriteInt8(filter);
+    out->Write(comp_buf.data(), comp_sz);
+    return true;
+}
+
+bool lz4_decompress(uint8_t *data, size_t data_sz, int image_bpp, Stream *in, size_t in_sz)
+{
+    if (in_sz < 1)
+        return false;
+    const uint8_t filter = in->ReadInt8();
+    std::vector<uint8_t> in_buf(in_sz - 1);
+    in->Read(in_buf.data(), in_buf.size());
+    if (!lz4_decompress_block(in_buf.data(), in_buf.size(), data, data_sz))
+        return false;
+
+    switch (filter)
+    {
+    case kLz4Filter_None:
+        break;
+    case kLz4Filter_Delta:
+        if (image_bpp == 4)
+        {
+            // Add the 4 bytes of a pixel at once, without carrying over between the bytes
+            size_t i = 4;
+            uint32_t prev;
+            memcpy(&prev, data, 4);
+            for (; i + 4 <= data_sz; i += 4)
+            {
+                uint32_t px;
+                memcpy(&px, data + i, 4);
+                px = ((px & 0x7F7F7F7F) + (prev & 0x7F7F7F7F)) ^ ((px ^ prev) & 0x80808080);
+                memcpy(data + i, &px, 4);
+                prev = px;
+            }
+            for (; i < data_sz; ++i)
+                data[i] = static_cast<uint8_t>(data[i] + data[i - 4]);
+        }
+        else
+        {
+            for (size_t i = image_bpp; i < data_sz; ++i)
+                data[i] = static_cast<uint8_t>(data[i] + data[i - image_bpp]);
+        }
+        break;
+    default:
+        return false;
+    }
+    return true;
+}
+
 } // namespace Common
 } // namespace AGS
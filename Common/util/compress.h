@@ -54,6 +54,11 @@ void skip_lzw(Stream *in);
 bool deflate_compress(const uint8_t* data, size_t data_sz, int image_bpp, Stream* out);
 bool inflate_decompress(uint8_t* data, size_t data_sz, int image_bpp, Stream* in, size_t in_sz);
 
+// LZ4 compression, optimized for the fast decompression;
+// multi-byte pixels may be delta-filtered, if that improves the compression.
+bool lz4_compress(const uint8_t *data, size_t data_sz, int image_bpp, Stream *out);
+bool lz4_decompress(uint8_t *data, size_t data_sz, int image_bpp, Stream *in, size_t in_sz);
+
 } // namespace Common
 } // namespace AGS
 
@@ -0,0 +1,109 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2026 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include "util/directorywatcher.h"
+#include "platform/platform.h"
+#if AGS_PLATFORM_OS_LINUX
+#define AGS_HAS_INOTIFY (1)
+#include <errno.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#include "util/directory.h"
+#include "util/path.h"
+#endif
+
+namespace AGS
+{
+namespace Common
+{
+
+#if defined(AGS_HAS_INOTIFY)
+// Events which change the list of files in the directory
+static const uint32_t WatchEventMask = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO |
+    IN_DELETE_SELF | IN_MOVE_SELF;
+#endif
+
+/* static */ bool DirectoryWatcher::IsSupported()
+{
+#if defined(AGS_HAS_INOTIFY)
+    return true;
+#else
+    return false;
+#endif
+}
+
+DirectoryWatcher::~DirectoryWatcher()
+{
+    Close();
+}
+
+bool DirectoryWatcher::Open(const String &path)
+{
+    Close();
+#if defined(AGS_HAS_INOTIFY)
+    _fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (_fd < 0)
+        return false;
+    // inotify is not recursive, so every subdirectory requires its own watch
+    if (inotify_add_watch(_fd, path.GetCStr(), WatchEventMask) < 0)
+    {
+        Close();
+        return false;
+    }
+    for (FindFile ff = FindFile::OpenDirsRecursive(path); !ff.AtEnd(); ff.Next())
+    {
+        if (inotify_add_watch(_fd, Path::ConcatPaths(path, ff.Current()).GetCStr(), WatchEventMask) < 0)
+        {
+            Close(); // most likely ran out of the user's watch limit
+            return false;
+        }
+    }
+    _changed = false;
+    return true;
+#else
+    (void)path;
+    return false;
+#endif
+}
+
+void DirectoryWatcher::Close()
+{
+#if defined(AGS_HAS_INOTIFY)
+    if (_fd >= 0)
+        close(_fd);
+#endif
+    _fd = -1;
+    _changed = false;
+}
+
+bool DirectoryWatcher::HasChanges()
+{
+    if (_fd < 0)
+        return true;
+#if defined(AGS_HAS_INOTIFY)
+    if (_changed)
+        return true;
+    // We don't need the event details, only the fact that there were any;
+    // the buffer must be large enough for at least one event with a name
+    alignas(struct inotify_event) char buf[4096];
+    ssize_t len;
+    while ((len = read(_fd, buf, sizeof(buf))) > 0)
+        _changed = true;
+    if (len < 0 && errno != EAGAIN && errno != EINTR)
+        _changed = true; // failed to poll, assume the worst
+#endif
+    return _changed;
+}
+
+} // namespace Common
+} // namespace AGS
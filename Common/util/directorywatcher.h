@@ -0,0 +1,64 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2026 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+//
+// DirectoryWatcher tracks changes to the list of files in the directory and
+// all its subdirectories: files and subdirectories being created, deleted or
+// renamed. Modifications of the file contents are not reported.
+//
+// The watcher does not run on its own, instead the user polls it for
+// the pending notifications, which is a non-blocking operation.
+// Currently only implemented with inotify on Linux.
+//
+//=============================================================================
+#ifndef __AGS_CN_UTIL__DIRECTORYWATCHER_H
+#define __AGS_CN_UTIL__DIRECTORYWATCHER_H
+
+#include "util/string.h"
+
+namespace AGS
+{
+namespace Common
+{
+
+class DirectoryWatcher
+{
+public:
+    // Tells if watching directories is supported on this platform
+    static bool IsSupported();
+
+    DirectoryWatcher() = default;
+    DirectoryWatcher(const DirectoryWatcher&) = delete;
+    ~DirectoryWatcher();
+
+    // Starts watching the directory and all of its subdirectories;
+    // returns false if the watch could not be set up
+    bool Open(const String &path);
+    void Close();
+    bool IsOpen() const { return _fd >= 0; }
+    // Tells if any files were added, removed or renamed in the watched
+    // directories since the watcher was opened; polls pending notifications.
+    // A closed watcher always reports changes, as it cannot tell otherwise.
+    bool HasChanges();
+
+    DirectoryWatcher &operator =(const DirectoryWatcher&) = delete;
+
+private:
+    int  _fd = -1; // notification handle
+    bool _changed = false; // a change was registered
+};
+
+} // namespace Common
+} // namespace AGS
+
+#endif // __AGS_CN_UTIL__DIRECTORYWATCHER_H
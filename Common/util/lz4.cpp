@@ -0,0 +1,224 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2026 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include "util/lz4.h"
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+namespace AGS
+{
+namespace Common
+{
+
+// Minimal match length
+static const size_t LZ4_MINMATCH = 4;
+// The last bytes of the block are always literals
+static const size_t LZ4_LASTLITERALS = 5;
+// The last match must start at least this far from the block's end
+static const size_t LZ4_MFLIMIT = 12;
+// Maximal back reference distance
+static const size_t LZ4_MAXDISTANCE = 65535;
+// Size of the match finder's hash table, in bits
+static const int LZ4_HASHLOG = 14;
+// Size of the fixed copy used for the short literal runs
+static const size_t LZ4_WILDCOPY = 16;
+
+static inline uint32_t lz4_read32(const uint8_t *p)
+{
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint32_t lz4_hash(uint32_t v)
+{
+    return (v * 2654435761u) >> (32 - LZ4_HASHLOG);
+}
+
+// Writes the length's remainder as a sequence of 255-valued bytes
+static inline uint8_t *lz4_write_length(uint8_t *op, size_t len)
+{
+    for (; len >= 255; len -= 255)
+        *(op++) = 255;
+    *(op++) = static_cast<uint8_t>(len);
+    return op;
+}
+
+// Writes a sequence: the literal run, optionally followed by a match
+static inline uint8_t *lz4_write_sequence(uint8_t *op, const uint8_t *op_end,
+    const uint8_t *lit, size_t lit_len, size_t offset, size_t match_len)
+{
+    // token, length bytes, literals, offset
+    const size_t max_sz = 1 + (lit_len / 255 + 1) + lit_len + 2 + (match_len / 255 + 1);
+    if (static_cast<size_t>(op_end - op) < max_sz)
+        return nullptr;
+
+    uint8_t *token = op++;
+    *token = static_cast<uint8_t>(((lit_len >= 15) ? 15 : lit_len) << 4);
+    if (lit_len >= 15)
+        op = lz4_write_length(op, lit_len - 15);
+    memcpy(op, lit, lit_len);
+    op += lit_len;
+    if (match_len == 0)
+        return op; // last literals
+
+    *(op++) = static_cast<uint8_t>(offset & 0xFF);
+    *(op++) = static_cast<uint8_t>((offset >> 8) & 0xFF);
+    const size_t ml = match_len - LZ4_MINMATCH;
+    *token |= static_cast<uint8_t>((ml >= 15) ? 15 : ml);
+    if (ml >= 15)
+        op = lz4_write_length(op, ml - 15);
+    return op;
+}
+
+size_t lz4_compress_bound(size_t src_sz)
+{
+    return src_sz + src_sz / 255 + 16;
+}
+
+size_t lz4_compress_block(const uint8_t *src, size_t src_sz, uint8_t *dst, size_t dst_sz)
+{
+    uint8_t *op = dst;
+    const uint8_t *op_end = dst + dst_sz;
+    size_t anchor = 0;
+    if (src_sz > LZ4_MFLIMIT)
+    {
+        std::vector<uint32_t> table(1 << LZ4_HASHLOG, 0u);
+        const size_t match_limit = src_sz - LZ4_MFLIMIT;
+        const size_t end_limit = src_sz - LZ4_LASTLITERALS;
+        size_t ip = 0;
+        while (ip < match_limit)
+        {
+            const uint32_t seq = lz4_read32(src + ip);
+            const uint32_t h = lz4_hash(seq);
+            size_t ref = table[h];
+            table[h] = static_cast<uint32_t>(ip);
+            if (ref >= ip || (ip - ref) > LZ4_MAXDISTANCE || lz4_read32(src + ref) != seq)
+            {
+                // Skip faster over the incompressible data
+                ip += 1 + ((ip - anchor) >> 6);
+                continue;
+            }
+
+            // Extend the match backwards, and forwards
+            while (ip > anchor && ref > 0 && src[ip - 1] == src[ref - 1])
+            {
+                ip--;
+                ref--;
+            }
+            size_t match_len = LZ4_MINMATCH;
+            while (ip + match_len < end_limit && src[ref + match_len] == src[ip + match_len])
+                match_len++;
+
+            op = lz4_write_sequence(op, op_end, src + anchor, ip - anchor, ip - ref, match_len);
+            if (!op)
+                return 0;
+            ip += match_len;
+            anchor = ip;
+            if (ip < match_limit)
+                table[lz4_hash(lz4_read32(src + ip - 2))] = static_cast<uint32_t>(ip - 2);
+        }
+    }
+
+    op = lz4_write_sequence(op, op_end, src + anchor, src_sz - anchor, 0, 0);
+    if (!op)
+        return 0;
+    return op - dst;
+}
+
+bool lz4_decompress_block(const uint8_t *src, size_t src_sz, uint8_t *dst, size_t dst_sz)
+{
+    const uint8_t *ip = src;
+    const uint8_t *ip_end = src + src_sz;
+    uint8_t *op = dst;
+    uint8_t *op_end = dst + dst_sz;
+    while (ip < ip_end)
+    {
+        const uint8_t token = *(ip++);
+        // Literal run
+        size_t len = token >> 4;
+        if (len == 15)
+        {
+            uint8_t b;
+            do
+            {
+                if (ip == ip_end)
+                    return false;
+                b = *(ip++);
+                len += b;
+            } while (b == 255);
+        }
+        if (len > static_cast<size_t>(ip_end - ip) || len > static_cast<size_t>(op_end - op))
+            return false;
+        if (len <= LZ4_WILDCOPY && static_cast<size_t>(ip_end - ip) >= LZ4_WILDCOPY &&
+            static_cast<size_t>(op_end - op) >= LZ4_WILDCOPY)
+            memcpy(op, ip, LZ4_WILDCOPY); // short runs are copied with a fixed size, which is faster
+        else
+            memcpy(op, ip, len);
+        ip += len;
+        op += len;
+        if (ip == ip_end)
+            break; // last sequence has no match
+
+        // Match
+        if (ip_end - ip < 2)
+            return false;
+        const size_t offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > static_cast<size_t>(op - dst))
+            return false;
+        len = token & 0xF;
+        if (len == 15)
+        {
+            uint8_t b;
+            do
+            {
+                if (ip == ip_end)
+                    return false;
+                b = *(ip++);
+                len += b;
+            } while (b == 255);
+        }
+        len += LZ4_MINMATCH;
+        if (len > static_cast<size_t>(op_end - op))
+            return false;
+        const uint8_t *ref = op - offset;
+        if (offset >= 8 && static_cast<size_t>(op_end - op) >= len + 8)
+        {
+            // Copy by 8 bytes, possibly past the match end, which is overwritten later
+            uint8_t *match_end = op + len;
+            do
+            {
+                memcpy(op, ref, 8);
+                op += 8;
+                ref += 8;
+            } while (op < match_end);
+            op = match_end;
+            continue;
+        }
+        // Overlapping match repeats the last offset bytes; copy the pattern
+        // in growing chunks, as each copy doubles the repeated sequence
+        while (len > 0)
+        {
+            const size_t chunk = std::min(len, static_cast<size_t>(op - ref));
+            memcpy(op, ref, chunk);
+            op += chunk;
+            len -= chunk;
+        }
+    }
+    return op == op_end;
+}
+
+} // namespace Common
+} // namespace AGS
@@ -0,0 +1,46 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2026 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+//
+// LZ4 block (un)compression functions.
+//
+// This is a compact implementation of the LZ4 block format: a sequence of
+// literal runs and back references within a 64 KB window, which may be
+// decoded with only the byte copies. The produced blocks are compatible with
+// the reference LZ4 decoder, although the compressor is a simple greedy one.
+//
+//=============================================================================
+#ifndef __AGS_CN_UTIL__LZ4_H
+#define __AGS_CN_UTIL__LZ4_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace AGS
+{
+namespace Common
+{
+
+// Returns the maximal compressed size of the given amount of data
+size_t lz4_compress_bound(size_t src_sz);
+// Compresses src into the dst buffer; returns the compressed size,
+// or 0 if the dst buffer was not large enough.
+size_t lz4_compress_block(const uint8_t *src, size_t src_sz, uint8_t *dst, size_t dst_sz);
+// Decompresses src into the dst buffer; returns true if the compressed data
+// was valid and expanded into exactly dst_sz bytes.
+bool   lz4_decompress_block(const uint8_t *src, size_t src_sz, uint8_t *dst, size_t dst_sz);
+
+} // namespace Common
+} // namespace AGS
+
+#endif // __AGS_CN_UTIL__LZ4_H
@@ -34,6 +34,7 @@
 #include "ac/speech.h"
 #include "ac/string.h"
 #include "ac/system.h"
+#include "ac/textcache.h"
 #include "debug/debug_log.h"
 #include "gfx/blender.h"
 #include "gui/guibutton.h"
@@ -187,7 +188,8 @@ std::unique_ptr<Bitmap> create_textual_image(const char *text, const DisplayText
     const bool use_font_surface_height =
         (loaded_game_file_version >= kGameVersion_360) && (loaded_game_file_version < kGameVersion_362);
 
-    break_up_text_into_lines(text, Lines, wii - 2 * padding, usingfont);
+    const int wrap_width = wii - 2 * padding;
+    break_up_text_into_lines(text, Lines, wrap_width, usingfont);
     DisplayVars disp(
         get_font_linespacing(usingfont),
         use_font_surface_height ?
@@ -290,6 +292,8 @@ std::unique_ptr<Bitmap> create_textual_image(const char *text, const DisplayText
         // Textual overlay purposed for character speech
         int ttxleft = 0, ttxtop = paddingScaled, oriwid = wii - padding * 2;
         bool draw_background = false;
+        bool cache_image = false;
+        TextImageParams image_params;
 
         DisplayTextLooks fix_look = look;
         if (use_speech_textwindow)
@@ -318,8 +322,26 @@ std::unique_ptr<Bitmap> create_textual_image(const char *text, const DisplayText
         {
             const int bmp_width = std::max(2, wii);
             const int bmp_height = std::max(2, disp.FullTextHeight + paddingDoubledScaled);
-            text_window_ds.reset(BitmapHelper::CreateTransparentBitmap(bmp_width, bmp_height, game.GetColorDepth()));
             alphaChannel = ((ShouldAntiAliasText()) && (game.GetColorDepth() >= 24));
+
+            // Plain text images do not depend on anything but the text looks,
+            // so same speech or overlay text may be taken from the cache
+            const bool in_textwindow = (fix_look.Style == kDisplayTextStyle_TextWindow);
+            image_params.Font = usingfont;
+            image_params.WrapWidth = wrap_width;
+            image_params.Width = bmp_width;
+            image_params.Height = bmp_height;
+            image_params.LineX = ttxleft;
+            image_params.LineY = ttxtop;
+            image_params.AlignWidth = in_textwindow ? oriwid : wii;
+            image_params.Align = in_textwindow ? play.text_align : play.speech_text_align;
+            image_params.TextColor = text_color;
+            image_params.OutlineColor = play.speech_text_shadow;
+            text_window_ds = textcache_get_image(text, image_params);
+            if (text_window_ds)
+                return text_window_ds;
+            text_window_ds.reset(BitmapHelper::CreateTransparentBitmap(bmp_width, bmp_height, game.GetColorDepth()));
+            cache_image = true;
         }
 
         // Assign final text color, either use passed parameter, or TextWindow property
@@ -350,6 +372,9 @@ std::unique_ptr<Bitmap> create_textual_image(const char *text, const DisplayText
                 wouttext_aligned(text_window_ds.get(), ttxleft, ttyp, wii, usingfont, text_color, Lines[i].GetCStr(), play.speech_text_align);
             }
         }
+
+        if (cache_image)
+            textcache_put_image(text, image_params, *text_window_ds);
     }
     else
     {
@@ -14,6 +14,7 @@
 #include <stdio.h>
 #include <algorithm>
 #include <cmath>
+#include <unordered_set>
 #include "aastr.h"
 #include "ac/common.h"
 #include "util/compress.h"
@@ -59,6 +60,7 @@
 #include "gfx/graphicsdriver.h"
 #include "gfx/ali3dexception.h"
 #include "gfx/blender.h"
+#include "gfx/texture_atlas.h"
 #include "main/game_run.h"
 #include "media/audio/audio_system.h"
 #include "util/delegate.h"
@@ -159,7 +161,9 @@ struct ObjTexture
     uint32_t DrawIndex = 0u;
     // Raw bitmap; used for software render mode,
     // or when particular object types require generated image.
-    std::unique_ptr<Bitmap> Bmp;
+    // May be shared with the transformed sprite cache, in which case
+    // it must be copied before modifying (see recycle_bitmap).
+    std::shared_ptr<Bitmap> Bmp;
     // Corresponding texture, created by renderer
     IDriverDependantBitmap *Ddb = nullptr;
     // Sprite notification mark: becomes invalid to notify an updated
@@ -217,7 +221,7 @@ struct ObjectCache
     String tag;
 #endif
 
-    std::unique_ptr<Bitmap> image;
+    std::shared_ptr<Bitmap> image;
     bool  in_use = false; // CHECKME: possibly may be removed
     int   sppic = 0;
     // TODO: pickout tint settings, maybe even share with Char/Obj structs,
@@ -243,6 +247,8 @@ struct ObjectCache
 // * A short-term cache of texture references, which keeps only weak refs to the textures
 //   that are currently in use. This short-term cache lets to keep reusing same texture
 //   so long as there's at least one object on screen that uses it.
+// Small sprites may be placed into the large shared textures (atlas pages)
+// instead of getting a texture of their own, if the renderer supports that.
 // NOTE: because of this two-component structure, TextureCache has to override
 // number of ResourceCache's parent methods. This design may probably be improved.
 class TextureCache :
@@ -321,18 +327,55 @@ public:
                 return nullptr;
         }
 
-        txdata.reset(gfxDriver->CreateTexture(bitmap,
-              kTxFlags_Opaque * opaque
-            | kTxFlags_HasAlpha * has_alpha));
+        uint32_t atlas_handle = UINT32_MAX;
+        if (_atlas && _atlas->Atlas.CanPlace(bitmap->GetWidth(), bitmap->GetHeight()))
+            txdata = CreateAtlasTexture(bitmap, has_alpha, opaque, atlas_handle);
+        if (!txdata)
+            txdata.reset(gfxDriver->CreateTexture(bitmap,
+                  kTxFlags_Opaque * opaque
+                | kTxFlags_HasAlpha * has_alpha));
         if (!txdata)
             return nullptr;
 
         txdata->ID = sprite_id;
+        if (atlas_handle != UINT32_MAX)
+            _atlas->RegionSprites[atlas_handle] = sprite_id;
         _txRefs[sprite_id] = txdata;
         Put(sprite_id, txdata);
         return txdata;
     }
 
+    // Sets up the atlas for the sprites not larger than max_sprite_size;
+    // page_size 0 disables the atlas
+    void ConfigureAtlas(int page_size, int max_sprite_size, size_t max_pages)
+    {
+        // The textures already made keep a reference to the old atlas state
+        _atlas.reset();
+        if (page_size <= 0 || max_sprite_size <= 0 || max_pages == 0)
+            return;
+        _atlas = std::make_shared<AtlasState>();
+        _atlas->Atlas.Configure(page_size, page_size, max_pages, max_sprite_size);
+    }
+
+    // Gets the atlas occupancy statistics
+    AtlasStats GetAtlasStats() const
+    {
+        return _atlas ? _atlas->Atlas.GetStats() : AtlasStats();
+    }
+
+    // Clears the cache, and releases the atlas pages that are no longer used
+    void Clear()
+    {
+        ResourceCache::Clear();
+        if (!_atlas)
+            return;
+        for (size_t i = 0; i < _atlas->Pages.size(); ++i)
+        {
+            if (_atlas->Atlas.GetPageStats(i).Regions == 0u)
+                _atlas->Pages[i] = nullptr;
+        }
+    }
+
     // Deletes the cached item
     void Dispose(const uint32_t &sprite_id)
     {
@@ -352,12 +395,86 @@ public:
     }
 
 private:
+    // The atlas is shared with the region textures, which
+    // free their regions when disposed
+    struct AtlasState
+    {
+        TextureAtlas Atlas;
+        // Atlas page textures
+        std::vector<std::shared_ptr<Texture>> Pages;
+        // Sprite IDs of the atlas regions, indexed by region handle
+        std::vector<uint32_t> RegionSprites;
+    };
+
+    // Below this occupancy the atlas page is considered to be mostly dead space
+    static const unsigned SparsePageOccupancy = 50;
+
     size_t CalcSize(const std::shared_ptr<Texture> &item) override
     {
         assert(item);
         return item ? item->GetMemSize() : 0u;
     }
 
+    // Creates a texture in the atlas region, and uploads the bitmap to it;
+    // returns nullptr if there's no room left
+    std::shared_ptr<Texture> CreateAtlasTexture(const Bitmap *bitmap, bool has_alpha, bool opaque,
+        uint32_t &atlas_handle)
+    {
+        AtlasRegion region;
+        const uint32_t handle = _atlas->Atlas.Allocate(bitmap->GetWidth(), bitmap->GetHeight(), region);
+        if (handle == UINT32_MAX)
+        {
+            VacateSparsestPage();
+            return nullptr;
+        }
+
+        auto &pages = _atlas->Pages;
+        if (pages.size() <= region.Page)
+            pages.resize(region.Page + 1);
+        if (!pages[region.Page])
+            pages[region.Page].reset(gfxDriver->CreateTexture(
+                _atlas->Atlas.GetPageWidth(), _atlas->Atlas.GetPageHeight(), 32));
+        std::unique_ptr<Texture> txdata;
+        if (pages[region.Page])
+            txdata.reset(gfxDriver->CreateTextureRegion(pages[region.Page], region.Area, bitmap->GetColorDepth()));
+        if (!txdata)
+        {
+            // Renderer does not support atlases, don't try again
+            Debug::Printf(kDbgMsg_Warn, "Texture atlas is not supported by the renderer, disabled");
+            _atlas->Atlas.Free(handle);
+            _atlas.reset();
+            return nullptr;
+        }
+        gfxDriver->UpdateTexture(txdata.get(), bitmap, has_alpha, opaque);
+
+        if (_atlas->RegionSprites.size() <= handle)
+            _atlas->RegionSprites.resize(handle + 1, UINT32_MAX);
+        atlas_handle = handle;
+        std::shared_ptr<AtlasState> atlas = _atlas;
+        return std::shared_ptr<Texture>(txdata.release(), [atlas, handle](Texture *tx)
+            {
+                delete tx;
+                atlas->Atlas.Free(handle);
+                atlas->RegionSprites[handle] = UINT32_MAX;
+            });
+    }
+
+    // Disposes the sprites placed on the atlas page which space is mostly dead;
+    // this makes the game objects recreate their textures on the next update,
+    // while the page gets reset and reused after all of its regions are freed
+    void VacateSparsestPage()
+    {
+        const uint32_t page = _atlas->Atlas.GetSparsestPage(SparsePageOccupancy);
+        if (page == UINT32_MAX)
+            return;
+        for (uint32_t handle : _atlas->Atlas.GetPageRegions(page))
+        {
+            const uint32_t sprite_id = _atlas->RegionSprites[handle];
+            if (sprite_id != UINT32_MAX)
+                Dispose(sprite_id);
+        }
+    }
+
     // Marks a shared texture with the invalid sprite ID,
     // this logically disconnects this texture from the cache,
     // and the game objects will be forced to recreate it on the next update
@@ -381,8 +498,123 @@ private:
     // - this lets to share same texture data among multiple sprites on screen.
     typedef std::weak_ptr<Texture> TexDataRef;
     std::unordered_map<uint32_t, TexDataRef> _txRefs;
+    // Texture atlas for small sprites
+    std::shared_ptr<AtlasState> _atlas;
 } texturecache(spriteset);
 
+// TransformedSpriteKey describes a sprite variant prepared in software mode:
+// resized, mirrored, tinted or lit. Tint and light parameters are the final
+// ones, which already include the region or ambient tint.
+struct TransformedSpriteKey
+{
+    uint32_t SpriteID = UINT32_MAX;
+    int   Width = 0, Height = 0;
+    bool  Mirrored = false;
+    bool  AntiAlias = false;
+    short TintR = 0, TintG = 0, TintB = 0, TintAmount = 0, TintLight = 0;
+    short LightLevel = 0;
+
+    bool operator ==(const TransformedSpriteKey &other) const
+    {
+        return SpriteID == other.SpriteID && Width == other.Width && Height == other.Height &&
+            Mirrored == other.Mirrored && AntiAlias == other.AntiAlias &&
+            TintR == other.TintR && TintG == other.TintG && TintB == other.TintB &&
+            TintAmount == other.TintAmount && TintLight == other.TintLight &&
+            LightLevel == other.LightLevel;
+    }
+};
+
+struct TransformedSpriteKeyHash
+{
+    size_t operator ()(const TransformedSpriteKey &key) const
+    {
+        size_t hash = key.SpriteID;
+        hash = hash * 31u + ((key.Width << 16) ^ key.Height);
+        hash = hash * 31u + ((key.Mirrored << 1) | key.AntiAlias);
+        hash = hash * 31u + ((key.TintR << 16) ^ (key.TintG << 8) ^ key.TintB);
+        hash = hash * 31u + ((key.TintAmount << 16) ^ (key.TintLight << 8) ^ key.LightLevel);
+        return hash;
+    }
+};
+
+//
+// TransformedSpriteCache keeps the sprite variants prepared for the objects
+// and characters in software mode. Unlike ObjectCache, which only remembers
+// the last image of a particular object, this is shared among all of them,
+// so that many characters using same views and scaling do not have to redo
+// same transformations over and over again.
+class TransformedSpriteCache :
+    public ResourceCache<TransformedSpriteKey, std::shared_ptr<Bitmap>, size_t, TransformedSpriteKeyHash>
+{
+public:
+    // Stores the sprite's variant, but only if the same one was put before;
+    // this way the variants used by a single object only once, such as the
+    // frames of a smooth scaling, do not push out the shared ones
+    void Put(const TransformedSpriteKey &key, const std::shared_ptr<Bitmap> &bmp)
+    {
+        if (GetMaxCacheSize() == 0u)
+            return; // cache is disabled
+        if (_requested.erase(key) == 0u)
+        {
+            if (_requested.size() >= MaxRequestedKeys)
+                _requested.clear();
+            _requested.insert(key);
+            return;
+        }
+        ResourceCache::Put(key, bmp);
+        // Remember the sprite's variants, forget the ones disposed meanwhile
+        auto &keys = _spriteKeys[key.SpriteID];
+        if (keys.size() >= MaxKeysBeforeCleanup)
+            keys.erase(std::remove_if(keys.begin(), keys.end(),
+                [this](const TransformedSpriteKey &k) { return !Exists(k); }), keys.end());
+        if (std::find(keys.begin(), keys.end(), key) == keys.end())
+            keys.push_back(key);
+    }
+
+    // Disposes all variants of the given sprite
+    void DisposeSprite(uint32_t sprite_id)
+    {
+        for (auto it = _requested.begin(); it != _requested.end();)
+        {
+            if (it->SpriteID == sprite_id)
+                it = _requested.erase(it);
+            else
+                ++it;
+        }
+        const auto found = _spriteKeys.find(sprite_id);
+        if (found == _spriteKeys.end())
+            return;
+        for (const auto &key : found->second)
+            Dispose(key);
+        _spriteKeys.erase(found);
+    }
+
+    // Clear the cache, dispose all items
+    void Clear()
+    {
+        ResourceCache::Clear();
+        _spriteKeys.clear();
+        _requested.clear();
+    }
+
+private:
+    size_t CalcSize(const std::shared_ptr<Bitmap> &item) override
+    {
+        assert(item);
+        return item ? item->GetDataSize() : 0u;
+    }
+
+    // Number of remembered sprite's keys, after which these are checked
+    // for the ones disposed by the cache
+    static const size_t MaxKeysBeforeCleanup = 16u;
+    // Max number of remembered variants which were put only once
+    static const size_t MaxRequestedKeys = 4096u;
+    // Keys of each sprite's variants, for disposing them when the sprite changes
+    std::unordered_map<uint32_t, std::vector<TransformedSpriteKey>> _spriteKeys;
+    // Variants which were put once, but not stored yet
+    std::unordered_set<TransformedSpriteKey, TransformedSpriteKeyHash> _requested;
+} transformcache;
+
 // actsps is used for temporary storage of the bitmap and texture
 // of the latest version of the sprite (room objects and characters);
 // objects sprites begin with index 0, characters are after ACTSP_OBJSOFF
@@ -731,6 +963,9 @@ void init_draw_method()
 
     // Must init this as early as possible, as this affects bitmap->texture conv
     gfxDriver->UseSmoothScaling(play.ShouldAASprites());
+    gfxDriver->SetRenderThreads(usetup.RenderThreads);
+    gfxDriver->SetSkipUnchangedFrames(usetup.SkipUnchangedFrames);
+    transformcache.SetMaxCacheSize(usetup.TransformCacheSize * 1024);
 
     if (drawstate.SoftwareRender)
     {
@@ -748,6 +983,10 @@ void init_draw_method()
             tx_cache_size = std::min<size_t>(SIZE_MAX, std::min<uint64_t>(tx_cache_size, avail_tx_mem * 0.66));
         texturecache.SetMaxCacheSize(tx_cache_size);
         Debug::Printf("Texture cache set: %zu KB", tx_cache_size / 1024);
+        // Let atlas pages take up to a half of the texture cache limit
+        const size_t page_size = static_cast<size_t>(usetup.TextureAtlasPage) * usetup.TextureAtlasPage * 4u;
+        const size_t atlas_pages = (page_size > 0u) ? std::max<size_t>(1u, tx_cache_size / 2 / page_size) : 0u;
+        texturecache.ConfigureAtlas(usetup.TextureAtlasPage, usetup.TextureAtlasMaxSprite, atlas_pages);
     }
 
     on_mainviewport_changed();
@@ -828,6 +1067,7 @@ void dispose_game_drawdata()
     walkbehindobj.clear();
 
     texturecache_clear();
+    transformcache_clear();
     guibg.clear();
     gui_render_tex.clear();
     guiobjbg.clear();
@@ -1172,14 +1412,16 @@ void replace_sprite_changed_callback(int old_sprnum, int new_sprnum, ISpriteUser
     }
 }
 
-void notify_sprite_changed(int sprnum, bool deleted)
+void notify_sprite_changed(int sprnum, bool deleted, const Rect &area)
 {
     assert(sprnum >= 0 && static_cast<uint32_t>(sprnum) < game.SpriteInfos.size());
     // Update texture cache (regen texture or clear from cache)
     if (deleted)
         clear_shared_texture(sprnum);
     else
-        update_shared_texture(sprnum);
+        update_shared_texture(sprnum, area);
+    // Any prepared variants of this sprite are no longer valid
+    transformcache.DisposeSprite(sprnum);
 
     // For texture-based renderers updating a shared texture will already
     // update all the related drawn objects on screen. But there are still
@@ -1231,12 +1473,25 @@ size_t texturecache_get_size()
     return texturecache.GetCacheSize();
 }
 
+void texturecache_get_atlas_state(size_t &pages, size_t &sprites, unsigned &occupancy)
+{
+    const AtlasStats stats = texturecache.GetAtlasStats();
+    pages = stats.Pages;
+    sprites = stats.Regions;
+    occupancy = stats.GetOccupancy();
+}
+
 void texturecache_clear()
 {
     texturecache.Clear();
 }
 
-void update_shared_texture(uint32_t sprite_id)
+void transformcache_clear()
+{
+    transformcache.Clear();
+}
+
+void update_shared_texture(uint32_t sprite_id, const Rect &area)
 {
     auto txdata = texturecache.Get(sprite_id);
     if (!txdata)
@@ -1246,8 +1501,11 @@ void update_shared_texture(uint32_t sprite_id)
     if (res.Width == game.SpriteInfos[sprite_id].Width &&
         res.Height == game.SpriteInfos[sprite_id].Height)
     {
-        gfxDriver->UpdateTexture(txdata.get(), spriteset[sprite_id],
-            (game.SpriteInfos[sprite_id].Flags & SPF_ALPHACHANNEL) != 0);
+        const bool has_alpha = (game.SpriteInfos[sprite_id].Flags & SPF_ALPHACHANNEL) != 0;
+        if (area.IsEmpty())
+            gfxDriver->UpdateTexture(txdata.get(), spriteset[sprite_id], has_alpha);
+        else
+            gfxDriver->UpdateTexture(txdata.get(), spriteset[sprite_id], area, has_alpha);
     }
     else
     {
@@ -1419,8 +1677,15 @@ void draw_sprite_support_alpha(Bitmap *ds, bool ds_has_alpha, int xpos, int ypos
     // Backwards-compatible drawing
     else if (src_has_alpha && alpha == 0xFF)
     {
-        set_alpha_blender();
-        ds->TransBlendBlt(image, xpos, ypos);
+        if (ds->GetColorDepth() == 32 && image->GetColorDepth() == 32)
+        {
+            GfxUtil::DrawSpriteRowBlend(ds, image, xpos, ypos, kRowBlend_Alpha);
+        }
+        else
+        {
+            set_alpha_blender();
+            ds->TransBlendBlt(image, xpos, ypos);
+        }
     }
     else
     {
@@ -1532,6 +1797,19 @@ static void sync_object_texture(ObjTexture &obj, bool has_alpha = false, bool op
     }
 }
 
+// Updates only the given area of the object's texture from its bitmap,
+// assuming that the rest of the bitmap has not changed since the last sync
+static void sync_object_texture_area(ObjTexture &obj, const Rect &area, bool has_alpha = false)
+{
+    std::shared_ptr<Texture> txdata;
+    if (!drawstate.SoftwareRender && (obj.Ddb->GetRefID() == UINT32_MAX))
+        txdata = gfxDriver->GetTexture(obj.Ddb);
+    if (txdata && obj.Ddb->MatchesFormat(obj.Bmp.get()))
+        gfxDriver->UpdateTexture(txdata.get(), obj.Bmp.get(), area, has_alpha);
+    else
+        sync_object_texture(obj, has_alpha);
+}
+
 //------------------------------------------------------------------------
 // Functions for filling the lists of sprites to render
 static void clear_draw_list()
@@ -1625,11 +1903,18 @@ void draw_gui_sprite(Bitmap *ds, bool use_alpha, int x, int y, Bitmap *sprite, b
     // Backwards-compatible drawing
     else if (use_alpha && ds_has_alpha && (game.options[OPT_NEWGUIALPHA] == kGuiAlphaRender_AdditiveAlpha) && (alpha == 0xFF))
     {
-        if (src_has_alpha)
-            set_additive_alpha_blender();
+        if (src_has_alpha && sprite->GetColorDepth() == 32)
+        {
+            GfxUtil::DrawSpriteRowBlend(ds, sprite, x, y, kRowBlend_AdditiveAlpha);
+        }
         else
-            set_opaque_alpha_blender();
-        ds->TransBlendBlt(sprite, x, y);
+        {
+            if (src_has_alpha)
+                set_additive_alpha_blender();
+            else
+                set_opaque_alpha_blender();
+            ds->TransBlendBlt(sprite, x, y);
+        }
     }
     else
     {
@@ -1674,6 +1959,16 @@ void recycle_bitmap(std::unique_ptr<Common::Bitmap> &bimp, int coldep, int wid,
     bimp.reset(recycle_bitmap(bimp.release(), coldep, wid, hit, make_transparent));
 }
 
+void recycle_bitmap(std::shared_ptr<Common::Bitmap> &bimp, int coldep, int wid, int hit, bool make_transparent)
+{
+    // Bitmap which is shared with anything else may not be reused
+    if (bimp && (bimp.use_count() == 1) && (bimp->GetColorDepth() == coldep) &&
+        (bimp->GetWidth() == wid) && (bimp->GetHeight() == hit))
+        recycle_bitmap(bimp.get(), coldep, wid, hit, make_transparent);
+    else
+        bimp.reset(recycle_bitmap(nullptr, coldep, wid, hit, make_transparent));
+}
+
 // Get the local tint at the specified X & Y co-ordinates, based on
 // room regions and SetAmbientTint
 // tint_amnt will be set to 0 if there is no tint enabled
@@ -1780,21 +2075,21 @@ static void apply_tint_or_light(ObjTexture &actsp, int light_level,
 
  // we can only do tint/light if the colour depths match
  if (game.GetColorDepth() == actsp.Bmp->GetColorDepth()) {
-     std::unique_ptr<Bitmap> oldwas;
+     std::shared_ptr<Bitmap> oldwas_own;
      // if the caller supplied a source bitmap, ->Blit from it
      // (used as a speed optimisation where possible)
-     if (blitFrom) 
-         oldwas.reset(blitFrom);
+     Bitmap *oldwas = blitFrom;
      // otherwise, make a new target bmp
-     else {
-         oldwas = std::move(actsp.Bmp);
+     if (!blitFrom) {
+         oldwas_own = std::move(actsp.Bmp);
+         oldwas = oldwas_own.get();
          actsp.Bmp.reset(BitmapHelper::CreateBitmap(oldwas->GetWidth(), oldwas->GetHeight(), coldept));
      }
      Bitmap *active_spr = actsp.Bmp.get();
 
      if (tint_amount) {
          // It is an RGB tint
-         tint_image(active_spr, oldwas.get(), tint_red, tint_green, tint_blue, tint_amount, tint_light);
+         tint_image(active_spr, oldwas, tint_red, tint_green, tint_blue, tint_amount, tint_light);
      }
      else {
          // the RGB values passed to set_trans_blender decide whether it will darken
@@ -1817,12 +2112,9 @@ static void apply_tint_or_light(ObjTexture &actsp, int light_level,
              lit_amnt = abs(light_level) * 2;
          }
 
-         active_spr->LitBlendBlt(oldwas.get(), 0, 0, lit_amnt);
+         active_spr->LitBlendBlt(oldwas, 0, 0, lit_amnt);
      }
 
-     if (oldwas.get() == blitFrom)
-         oldwas.release();
-
  }
  else if (blitFrom) {
      // sprite colour depth != game colour depth, so don't try and tint
@@ -1837,7 +2129,7 @@ static void apply_tint_or_light(ObjTexture &actsp, int light_level,
 // * if transformation is necessary - writes into dst and returns dst;
 // * if no transformation is necessary - simply returns src;
 // Used for software render mode only.
-static Bitmap *transform_sprite(std::unique_ptr<Bitmap> &dst, Bitmap *src, bool src_has_alpha,
+static Bitmap *transform_sprite(std::shared_ptr<Bitmap> &dst, Bitmap *src, bool src_has_alpha,
     const Size &dst_sz, GraphicFlip flip = Common::kFlip_None)
 {
     assert(!dst_sz.IsNull());
@@ -2026,37 +2318,80 @@ static bool construct_object_gfx(const ViewFrame *vf, int pic,
     const int coldept = sprite->GetColorDepth();
     const int src_sprwidth = sprite->GetWidth();
     const int src_sprheight = sprite->GetHeight();
-    bool actsps_used = false;
-    // draw the base sprite, scaled and flipped as appropriate
-    actsps_used = transform_sprite(actsp, pic, scale_size, is_mirrored ? kFlip_Horizontal : kFlip_None);
-    if (!actsps_used)
-    {
-        // ensure actsps exists // CHECKME: why do we need this in hardware accel mode too?
-        recycle_bitmap(actsp.Bmp, coldept, src_sprwidth, src_sprheight);
+    const bool has_tint_or_light = (tint_level > 0) || (light_level != 0);
+
+    // See if the same variant of this sprite was prepared for anything else;
+    // 8-bit images are not cached, because their look depends on the palette
+    const bool use_transform_cache = (coldept > 8) &&
+        ((sprite->GetSize() != scale_size) || is_mirrored || has_tint_or_light);
+    TransformedSpriteKey tf_key;
+    std::shared_ptr<Bitmap> tf_image;
+    if (use_transform_cache)
+    {
+        tf_key.SpriteID = pic;
+        tf_key.Width = scale_size.Width;
+        tf_key.Height = scale_size.Height;
+        tf_key.Mirrored = is_mirrored;
+        tf_key.AntiAlias = play.ShouldAASprites();
+        tf_key.TintR = tint_red;
+        tf_key.TintG = tint_green;
+        tf_key.TintB = tint_blue;
+        tf_key.TintAmount = tint_level;
+        tf_key.TintLight = tint_light;
+        tf_key.LightLevel = light_level;
+        tf_image = transformcache.Get(tf_key);
+    }
+
+    if (tf_image)
+    {
+        // Use the cached image as is, it's copied only if has to be modified
+        actsp.Bmp = tf_image;
     }
-
-    // apply tints or lightenings where appropriate, else just copy the source bitmap
-    if ((tint_level > 0) || (light_level != 0))
+    else
     {
-        // direct read from source bitmap, where possible
-        Bitmap *blit_from = nullptr;
+        bool actsps_used = false;
+        // draw the base sprite, scaled and flipped as appropriate
+        actsps_used = transform_sprite(actsp, pic, scale_size, is_mirrored ? kFlip_Horizontal : kFlip_None);
         if (!actsps_used)
-            blit_from = sprite;
+        {
+            // ensure actsps exists // CHECKME: why do we need this in hardware accel mode too?
+            recycle_bitmap(actsp.Bmp, coldept, src_sprwidth, src_sprheight);
+        }
 
-        apply_tint_or_light(actsp, light_level, tint_level, tint_red,
-            tint_green, tint_blue, tint_light, coldept,
-            blit_from);
-    }
-    else if (!actsps_used)
-    {
-        // no scaling, flipping or tinting was done, so just blit it normally
-        actsp.Bmp->Blit(sprite, 0, 0);
+        // apply tints or lightenings where appropriate, else just copy the source bitmap
+        if (has_tint_or_light)
+        {
+            // direct read from source bitmap, where possible
+            Bitmap *blit_from = nullptr;
+            if (!actsps_used)
+                blit_from = sprite;
+
+            apply_tint_or_light(actsp, light_level, tint_level, tint_red,
+                tint_green, tint_blue, tint_light, coldept,
+                blit_from);
+        }
+        else if (!actsps_used)
+        {
+            // no scaling, flipping or tinting was done, so just blit it normally
+            actsp.Bmp->Blit(sprite, 0, 0);
+        }
+
+        if (use_transform_cache)
+            transformcache.Put(tf_key, actsp.Bmp);
     }
 
     // Create the cached image and store it
     objsav.in_use = true;
-    recycle_bitmap(objsav.image, actsp.Bmp->GetColorDepth(), actsp.Bmp->GetWidth(), actsp.Bmp->GetHeight());
-    objsav.image->Blit(actsp.Bmp.get(), 0, 0);
+    if (actsp.Bmp.use_count() > 1)
+    {
+        // shared with the transformed sprite cache, so won't be modified
+        objsav.image = actsp.Bmp;
+    }
+    else
+    {
+        recycle_bitmap(objsav.image, actsp.Bmp->GetColorDepth(), actsp.Bmp->GetWidth(), actsp.Bmp->GetHeight());
+        objsav.image->Blit(actsp.Bmp.get(), 0, 0);
+    }
     objsav.sppic = specialpic;
     objsav.tintamnt = tint_level;
     objsav.tintr = tint_red;
@@ -2092,6 +2427,9 @@ void prepare_and_add_object_gfx(
         // Only merge sprite with the walk-behinds in software mode
         if ((drawstate.WalkBehindMethod == DrawOverCharSprite) && (actsp_modified))
         {
+            // Shared image must be copied before cutting anything out of it
+            if ((actsp.Bmp.use_count() > 1) && walkbehinds_intersect(actsp.Bmp.get(), atx, aty, usebasel))
+                actsp.Bmp.reset(BitmapHelper::CreateBitmapCopy(actsp.Bmp.get()));
             walkbehinds_cropout(actsp.Bmp.get(), atx, aty, usebasel);
         }
     }
@@ -2643,9 +2981,21 @@ void draw_gui_and_overlays()
                 eip_guinum = index;
                 set_our_eip(372);
                 const bool draw_with_controls = !draw_controls_as_textures;
-                if (gui.HasChanged() || (draw_with_controls && gui.HasControlsChanged()))
+                auto &gbg = guibg[index];
+                // If only the controls have changed, then redraw just the parts of the
+                // GUI surface which they cover; old-style GUI alpha rendering requires
+                // the alpha channel to be repaired over the whole surface though.
+                if (draw_with_controls && !gui.HasChanged() && gbg.Bmp && gbg.Ddb &&
+                    (gbg.Bmp->GetSize() == gui.GetSize()) &&
+                    (gbg.Bmp->GetColorDepth() == game.GetColorDepth()) &&
+                    !(gui.HasAlphaChannel() && (game.options[OPT_NEWGUIALPHA] == kGuiAlphaRender_Legacy)))
+                {
+                    const Rect area = gui.DrawChangedControls(gbg.Bmp.get());
+                    if (!area.IsEmpty())
+                        sync_object_texture_area(gbg, area, gui.HasAlphaChannel());
+                }
+                else if (gui.HasChanged() || (draw_with_controls && gui.HasControlsChanged()))
                 {
-                    auto &gbg = guibg[index];
                     recycle_bitmap(gbg.Bmp, game.GetColorDepth(), gui.GetWidth(), gui.GetHeight(), true);
                     // Configure GUI drawing alpha support, depending on a game version:
                     // old versions of the engine did not make opaque drawing colors, so anything
@@ -96,8 +96,9 @@ uint32_t add_sprite_changed_callback(int sprnum, AGS::Common::ISpriteUser *user)
 void remove_sprite_changed_callback(int sprnum, AGS::Common::ISpriteUser *user);
 // Replace one sprite callback with another for the given ISpriteUser object
 void replace_sprite_changed_callback(int old_sprnum, int new_sprnum, AGS::Common::ISpriteUser *user);
-// Marks all game objects which reference this sprite for redraw
-void notify_sprite_changed(int sprnum, bool deleted);
+// Marks all game objects which reference this sprite for redraw;
+// optional area tells which part of the sprite has changed, if known
+void notify_sprite_changed(int sprnum, bool deleted, const Rect &area = Rect());
 
 // Get current texture cache's stats: max size, current normal items size,
 // size of locked items (included into cur_size),
@@ -105,10 +106,16 @@ void notify_sprite_changed(int sprnum, bool deleted);
 void texturecache_get_state(size_t &max_size, size_t &cur_size, size_t &locked_size, size_t &ext_size);
 // Returns current cache size
 size_t texturecache_get_size();
+// Get texture atlas stats: number of used pages, number of sprites on them,
+// and the share of the pages' area taken by these sprites, in percents
+void texturecache_get_atlas_state(size_t &pages, size_t &sprites, unsigned &occupancy);
 // Completely resets texture cache
 void texturecache_clear();
-// Update shared and cached texture from the sprite's pixels
-void update_shared_texture(uint32_t sprite_id);
+// Clears the cache of the sprites prepared for drawing in software mode
+void transformcache_clear();
+// Update shared and cached texture from the sprite's pixels;
+// only updates the given area, unless it's empty
+void update_shared_texture(uint32_t sprite_id, const Rect &area = Rect());
 // Remove a texture from cache
 void clear_shared_texture(uint32_t sprite_id);
 // Prepares a texture for the given sprite and stores in the cache
@@ -127,6 +134,8 @@ void mark_current_background_dirty();
 // Avoid freeing and reallocating the memory if possible
 Common::Bitmap *recycle_bitmap(Common::Bitmap *bimp, int coldep, int wid, int hit, bool make_transparent = false);
 void recycle_bitmap(std::unique_ptr<Common::Bitmap> &bimp, int coldep, int wid, int hit, bool make_transparent = false);
+// Same as above, but makes a new bitmap if the old one is shared with anything else
+void recycle_bitmap(std::shared_ptr<Common::Bitmap> &bimp, int coldep, int wid, int hit, bool make_transparent = false);
 Engine::IDriverDependantBitmap* recycle_ddb_bitmap(Engine::IDriverDependantBitmap *ddb, Common::Bitmap *source, bool has_alpha = false, bool opaque = false);
 Engine::IDriverDependantBitmap* recycle_ddb_sprite(Engine::IDriverDependantBitmap *ddb, uint32_t sprite_id,
     Common::Bitmap *source, bool has_alpha = false, bool opaque = false);
@@ -59,7 +59,7 @@ void DrawingSurface_Release(ScriptDrawingSurface* sds)
     }
     else if (sds->dynamicSpriteNumber >= 0)
     {
-        on_dynsprite_surface_release(sds->dynamicSpriteNumber, sds->modified);
+        on_dynsprite_surface_release(sds->dynamicSpriteNumber, sds->modified, sds->modifiedArea);
         sds->dynamicSpriteNumber = -1;
     }
     else if (sds->dynamicSurfaceNumber >= 0)
@@ -68,6 +68,7 @@ void DrawingSurface_Release(ScriptDrawingSurface* sds)
         sds->dynamicSurfaceNumber = -1;
     }
     sds->modified = 0;
+    sds->modifiedArea = Rect();
 }
 
 void ScriptDrawingSurface::PointToGameResolution(int *xcoord, int *ycoord)
@@ -205,7 +206,7 @@ void DrawingSurface_DrawImageImpl(ScriptDrawingSurface* sds, Bitmap* src,
     draw_sprite_support_alpha(ds, sds->hasAlphaChannel != 0, dst_x, dst_y, src, src_has_alpha,
         kBlendMode_Alpha, GfxDef::Trans100ToAlpha255(trans));
 
-    sds->FinishedDrawing();
+    sds->FinishedDrawing(RectWH(dst_x, dst_y, src->GetWidth(), src->GetHeight()));
 }
 
 void DrawingSurface_DrawImage(ScriptDrawingSurface* sds,
@@ -334,7 +335,7 @@ void DrawingSurface_DrawCircle(ScriptDrawingSurface *sds, int x, int y, int radi
     if (!ds)
         return;
     ds->FillCircle(Circle(x, y, radius), sds->currentColour);
-    sds->FinishedDrawing();
+    sds->FinishedDrawing(Rect(x - radius, y - radius, x + radius, y + radius));
 }
 
 void DrawingSurface_DrawRectangle(ScriptDrawingSurface *sds, int x1, int y1, int x2, int y2)
@@ -346,7 +347,7 @@ void DrawingSurface_DrawRectangle(ScriptDrawingSurface *sds, int x1, int y1, int
     if (!ds)
         return;
     ds->FillRect(Rect(x1,y1,x2,y2), sds->currentColour);
-    sds->FinishedDrawing();
+    sds->FinishedDrawing(Rect(std::min(x1, x2), std::min(y1, y2), std::max(x1, x2), std::max(y1, y2)));
 }
 
 void DrawingSurface_DrawTriangle(ScriptDrawingSurface *sds, int x1, int y1, int x2, int y2, int x3, int y3)
@@ -359,7 +360,8 @@ void DrawingSurface_DrawTriangle(ScriptDrawingSurface *sds, int x1, int y1, int
     if (!ds)
         return;
     ds->DrawTriangle(Triangle(x1,y1,x2,y2,x3,y3), sds->currentColour);
-    sds->FinishedDrawing();
+    sds->FinishedDrawing(Rect(std::min(x1, std::min(x2, x3)), std::min(y1, std::min(y2, y3)),
+        std::max(x1, std::max(x2, x3)), std::max(y1, std::max(y2, y3))));
 }
 
 void DrawingSurface_DrawString(ScriptDrawingSurface *sds, int xx, int yy, int font, const char* text)
@@ -436,7 +438,9 @@ void DrawingSurface_DrawLine(ScriptDrawingSurface *sds, int fromx, int fromy, in
             ds->DrawLine (Line(fromx + xx, fromy + yy, tox + xx, toy + yy), draw_color);
         }
     }
-    sds->FinishedDrawing();
+    const int off1 = -(thickness / 2), off2 = thickness - 1 - (thickness / 2);
+    sds->FinishedDrawing(Rect(std::min(fromx, tox) + off1, std::min(fromy, toy) + off1,
+        std::max(fromx, tox) + off2, std::max(fromy, toy) + off2));
 }
 
 void DrawingSurface_DrawPixel(ScriptDrawingSurface *sds, int x, int y) {
@@ -456,7 +460,7 @@ void DrawingSurface_DrawPixel(ScriptDrawingSurface *sds, int x, int y) {
             ds->PutPixel(x + ii, y + jj, draw_color);
         }
     }
-    sds->FinishedDrawing();
+    sds->FinishedDrawing(RectWH(x, y, thickness, thickness));
 }
 
 int DrawingSurface_GetPixel(ScriptDrawingSurface *sds, int x, int y) {
@@ -563,7 +567,7 @@ void DrawingSurface_SetPixelsImpl(ScriptDrawingSurface *sds, void *arrobj, int x
     const int copy_height = std::min(height, std::min<int>(arr_header.TotalSize / (src_pitch), ds->GetHeight()));
     PixelOp::CopyPixelsRegion(arr_ptr, ds->GetBPP(), src_pitch, 0, 0, copy_width, copy_height,
         ds->GetDataForWriting(), dst_pitch, x, y);
-    sds->FinishedDrawing();
+    sds->FinishedDrawing(RectWH(x, y, copy_width, copy_height));
 }
 
 void DrawingSurface_SetPixels(ScriptDrawingSurface *sds, void *arrobj, int x, int y, int width, int height)
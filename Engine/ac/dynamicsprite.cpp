@@ -549,11 +549,11 @@ void detach_dynsprite_surface(int slot)
     DynamicSpriteDSRef.erase(slot);
 }
 
-void on_dynsprite_surface_release(int slot, bool modified)
+void on_dynsprite_surface_release(int slot, bool modified, const Rect &modified_area)
 {
     if (modified)
     {
-        game_sprite_updated(slot);
+        game_sprite_updated(slot, false, modified_area);
     }
 
     detach_dynsprite_surface(slot);
@@ -63,7 +63,8 @@ void    attach_dynsprite_surface(int slot, int surface_handle);
 // Detaches all drawing surfaces related to the given dynamic sprite.
 // This invalidates DrawingSurface script object(s), and erases a sprite-surface reference.
 void    detach_dynsprite_surface(int slot);
-// Notifies dynamic sprite that its drawing surface was released
-void    on_dynsprite_surface_release(int slot, bool modified);
+// Notifies dynamic sprite that its drawing surface was released;
+// modified_area is the bounds of the changes, or empty if unknown
+void    on_dynsprite_surface_release(int slot, bool modified, const Rect &modified_area);
 
 #endif // __AGS_EE_AC__DYNAMICSPRITE_H
@@ -68,6 +68,9 @@ public:
     void WriteInt16(void *address, intptr_t offset, int16_t val) override;
     void WriteInt32(void *address, intptr_t offset, int32_t val) override;
     void WriteFloat(void *address, intptr_t offset, float val) override;
+
+    // Does not keep a handle, the pool has to look the object up by address
+    int32_t *GetHandlePtr(void* /*address*/) override { return nullptr; }
 };
 
 
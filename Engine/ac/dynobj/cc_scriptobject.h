@@ -101,6 +101,11 @@ struct IScriptObject
     virtual void    WriteInt32(void *address, intptr_t offset, int32_t val)   = 0;
     virtual void    WriteFloat(void *address, intptr_t offset, float val)     = 0;
 
+    // Returns a pointer to the object's handle, if the object keeps one in its
+    // own memory header, or null otherwise. This lets the managed pool resolve
+    // the object's handle without looking up its address.
+    virtual int32_t *GetHandlePtr(void *address) = 0;
+
 protected:
     IScriptObject() = default;
     ~IScriptObject() = default;
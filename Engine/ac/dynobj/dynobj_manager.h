@@ -43,8 +43,9 @@ void  ccSerializeAllObjects(Common::Stream *out);
 int   ccUnserializeAllObjects(Common::Stream *in, ICCObjectCollectionReader *callback);
 // dispose the object if RefCount==0
 void  ccAttemptDisposeObject(int32_t handle);
-// translate between object handles and memory addresses
-int32_t ccGetObjectHandleFromAddress(void *address);
+// translate between object handles and memory addresses;
+// passing object's manager, if known, lets resolve the handle faster
+int32_t ccGetObjectHandleFromAddress(void *address, IScriptObject *manager = nullptr);
 void *ccGetObjectAddressFromHandle(int32_t handle);
 ScriptValueType ccGetObjectAddressAndManagerFromHandle(int32_t handle, void *&object, IScriptObject *&manager);
 
@@ -19,12 +19,16 @@
 #include "util/string_utils.h"               // fputstring, etc
 #include "script/cc_common.h"
 #include "util/stream.h"
+#include "util/time_util.h"
 
 using namespace AGS::Common;
+using namespace AGS::Engine;
 
 const auto OBJECT_CACHE_MAGIC_NUMBER = 0xa30b;
 const auto SERIALIZE_BUFFER_SIZE = 10240;
-const auto GARBAGE_COLLECTION_INTERVAL = 1024; // in times objects added
+const auto GARBAGE_COLLECTION_INTERVAL = 1024; // in GC candidates added
+const auto GARBAGE_COLLECTION_TIME_BUDGET = 1000; // in microseconds, per GC run
+const auto GARBAGE_COLLECTION_TIME_CHECK = 256; // in candidates checked
 const auto PRINT_STATS_INTERVAL = 1023; // bitmask!, in times ran GC
 const auto RESERVED_SIZE = 2048;
 
@@ -36,7 +40,9 @@ int ManagedObjectPool::Remove(ManagedObject &o, bool force) {
     stats.Removed++;
     handleByAddress.erase(o.addr);
     ManagedObjectLog("Line %d Disposed managed object handle=%d", currentline, o.handle);
-    objects.Free(o.handle);
+    // NOTE: pass handle by value, as Free() resets the referenced element first
+    const int32_t handle = o.handle;
+    objects.Free(handle);
     return 1;
 }
 
@@ -44,8 +50,8 @@ int32_t ManagedObjectPool::AddRef(int32_t handle) {
     if (handle < 1 || (size_t)handle >= objects.size())
         return 0;
 
+    if (!objects.IsInUse(handle)) { return 0; }
     auto &o = objects[handle];
-    if (!o.isUsed()) { return 0; }
     o.refCount++;
     ManagedObjectLog("Line %d AddRef: handle=%d new refcount=%d", currentline, o.handle, o.refCount);
     return o.refCount;
@@ -54,31 +60,43 @@ int32_t ManagedObjectPool::AddRef(int32_t handle) {
 int ManagedObjectPool::CheckDispose(int32_t handle) {
     if (handle < 1 || (size_t)handle >= objects.size())
         return 1;
-    auto & o = objects[handle];
-    if (!o.isUsed()) { return 1; }
+    if (!objects.IsInUse(handle)) { return 1; }
+    auto &o = objects[handle];
     if (o.refCount >= 1) { return 0; }
-    return Remove(o);
+    if (Remove(o))
+        return 1;
+    AddGCCandidate(handle);
+    return 0;
 }
 
 int32_t ManagedObjectPool::SubRef(int32_t handle) {
     if (handle < 1 || (size_t)handle >= objects.size()) { return 0; }
-    auto & o = objects[handle];
-    if (!o.isUsed()) { return 0; }
+    if (!objects.IsInUse(handle)) { return 0; }
+    auto &o = objects[handle];
     if (o.refCount <= 0) { assert(false); return 0; } // already disposed / disposing
 
     o.refCount--;
     const auto newRefCount = o.refCount;
     const auto canBeDisposed = (o.addr != disableDisposeForObject);
-    if (canBeDisposed && o.refCount <= 0) {
-        Remove(o);
+    if (o.refCount <= 0) {
+        if (!canBeDisposed || !Remove(o))
+            AddGCCandidate(handle);
     }
     // object could be removed at this point, don't use any values.
     ManagedObjectLog("Line %d SubRef: handle=%d new refcount=%d canBeDisposed=%d", currentline, handle, newRefCount, canBeDisposed);
     return newRefCount;
 }
 
-int32_t ManagedObjectPool::AddressToHandle(void *addr) {
+// this function is called often (whenever a pointer is assigned)
+int32_t ManagedObjectPool::AddressToHandle(void *addr, IScriptObject *manager) {
     if (addr == nullptr) { return 0; }
+    const int32_t *handle_ptr = manager ? manager->GetHandlePtr(addr) : nullptr;
+    if (handle_ptr) {
+        const int32_t handle = *handle_ptr;
+        if (handle >= 1 && (size_t)handle < objects.size() && objects.IsInUse(handle)
+            && objects[handle].addr == addr)
+            return handle;
+    }
     auto it = handleByAddress.find(addr);
     if (it == handleByAddress.end()) { return 0; }
     return it->second;
@@ -87,14 +105,14 @@ int32_t ManagedObjectPool::AddressToHandle(void *addr) {
 // this function is called often (whenever a pointer is used)
 void* ManagedObjectPool::HandleToAddress(int32_t handle) {
     if (handle < 1 || (size_t)handle >= objects.size()) { return nullptr; }
-    auto & o = objects[handle];
-    if (!o.isUsed()) { return nullptr; }
+    if (!objects.IsInUse(handle)) { return nullptr; }
+    auto &o = objects[handle];
     return o.addr;
 }
 
 // this function is called often (whenever a pointer is used)
 ScriptValueType ManagedObjectPool::HandleToAddressAndManager(int32_t handle, void *&object, IScriptObject *&manager) {
-    if ((handle < 1 || (size_t)handle >= objects.size()) || !objects[handle].isUsed())
+    if ((handle < 1 || (size_t)handle >= objects.size()) || !objects.IsInUse(handle))
     {
         object = nullptr;
         manager = nullptr;
@@ -115,34 +133,76 @@ int ManagedObjectPool::RemoveObject(void *address) {
     return Remove(o, true);
 }
 
+void ManagedObjectPool::AddGCCandidate(int32_t handle)
+{
+    gcCandidates.push_back(handle);
+    gcNewCandidates++;
+}
+
 void ManagedObjectPool::RunGarbageCollectionIfAppropriate()
 {
-    if (objectCreationCounter <= GARBAGE_COLLECTION_INTERVAL)
+    // Start a new pass after a number of GC candidates were added, either
+    // new objects or those which lost their references but were not disposed;
+    // or continue the pass which did not fit into the time budget
+    const bool pass_unfinished = gcNextCandidate > 0;
+    if (!pass_unfinished && gcNewCandidates <= GARBAGE_COLLECTION_INTERVAL)
         return;
 
-    RunGarbageCollection();
+    // Check at least as many candidates as there were added since
+    // the last run, so that the collector keeps up with the scripts
+    RunGarbageCollection(GARBAGE_COLLECTION_TIME_BUDGET, gcNewCandidates);
     if ((stats.GCTimesRun & PRINT_STATS_INTERVAL) == 0)
         PrintStats();
-    objectCreationCounter = 0;
+    gcNewCandidates = 0u;
 }
 
-void ManagedObjectPool::RunGarbageCollection()
+void ManagedObjectPool::RunGarbageCollection(uint64_t time_budget_us, size_t min_count)
 {
-    stats.GCTimesRun++;
     // NOTE: following GC implementation is not exactly a proper collector.
     // For instance, it cannot resolve circular dependencies.
     // But then, 3.* version of the engine and script compiler do not support
     // user managed structs referencing each other. This is only implemented
     // in 4.* engine and script compiler.
-    for (auto &o : objects)
+    // Since the only way for an object to become garbage is to have its
+    // reference count reach zero, the collector does not have to scan the
+    // whole pool, only the objects which had zero references at some point.
+    Stopwatch sw;
+    stats.GCTimesRun++;
+    size_t checked = 0u;
+    while (gcNextCandidate < gcCandidates.size())
     {
-        if (!o.isUsed()) { continue; }
-        assert(o.refCount >= 0); // just to make certain it's not underflow
-        if (o.refCount == 0)
+        const int32_t handle = gcCandidates[gcNextCandidate++];
+        if (objects.IsInUse(handle))
         {
-            stats.RemovedGC += Remove(o);
+            auto &o = objects[handle];
+            assert(o.refCount >= 0); // just to make certain it's not underflow
+            if (o.refCount == 0)
+            {
+                if (Remove(o))
+                    stats.RemovedGC++;
+                else
+                    gcRetryCandidates.push_back(handle);
+            }
         }
+
+        if (time_budget_us > 0u && (++checked % GARBAGE_COLLECTION_TIME_CHECK) == 0 && checked >= min_count
+            && static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(sw.Check()).count()) >= time_budget_us)
+            break;
     }
+
+    if (gcNextCandidate == gcCandidates.size())
+    {
+        // Pass complete, objects which refused to be disposed will be checked in the next one
+        gcCandidates.swap(gcRetryCandidates);
+        gcRetryCandidates.clear();
+        gcNextCandidate = 0u;
+        stats.GCPassesDone++;
+    }
+
+    const uint64_t pause = std::chrono::duration_cast<std::chrono::microseconds>(sw.Check()).count();
+    stats.GCLastPause = pause;
+    stats.GCMaxPause = std::max(stats.GCMaxPause, pause);
+    stats.GCTotalTime += pause;
     ManagedObjectLog("Ran garbage collection");
 }
 
@@ -153,7 +213,13 @@ int ManagedObjectPool::Add(int handle, void *address, IScriptObject *callback, S
 
     o = ManagedObject(obj_type, handle, address, callback);
 
+    // Objects which keep their own handle may be resolved without the map
+    int32_t *handle_ptr = callback ? callback->GetHandlePtr(address) : nullptr;
+    if (handle_ptr)
+        *handle_ptr = handle;
     handleByAddress.insert({address, handle});
+    // New object has no references yet, and becomes garbage unless it gets one
+    AddGCCandidate(handle);
     stats.Added++;
     stats.MaxObjectsPresent = std::max(stats.MaxObjectsPresent, stats.Added - stats.Removed);
     ManagedObjectLog("Allocated managed object type=%s, handle=%d, addr=%08X", callback->GetType(), handle, address);
@@ -163,7 +229,6 @@ int ManagedObjectPool::Add(int handle, void *address, IScriptObject *callback, S
 int ManagedObjectPool::AddObject(void *address, IScriptObject *callback, ScriptValueType obj_type) 
 {
     int32_t handle = objects.Add();
-    objectCreationCounter++;
     return Add(handle, address, callback, obj_type);
 }
 
@@ -293,6 +358,10 @@ void ManagedObjectPool::Reset()
         Remove(o, true);
     }
     objects.Clear();
+    gcCandidates.clear();
+    gcRetryCandidates.clear();
+    gcNextCandidate = 0u;
+    gcNewCandidates = 0u;
 
     PrintStats();
 }
@@ -306,12 +375,22 @@ void ManagedObjectPool::PrintStats()
         "\tTotal objects added:         %+10" PRIu64 "\n"
         "\tTotal objects removed:       %+10" PRIu64 "\n"
         "\tObjects removed by GC:       %+10" PRIu64 "\n"
-        "\tTimes GC ran:                %+10" PRIu64 "",
+        "\tTimes GC ran:                %+10" PRIu64 "\n"
+        "\tGC passes done:              %+10" PRIu64 "\n"
+        "\tGC candidates pending:       %+10" PRIu64 "\n"
+        "\tGC total time (us):          %+10" PRIu64 "\n"
+        "\tGC last pause (us):          %+10" PRIu64 "\n"
+        "\tGC max pause (us):           %+10" PRIu64 "",
         stats.Added - stats.Removed,
         stats.MaxObjectsPresent,
         stats.Added, stats.Removed,
         stats.RemovedGC,
-        stats.GCTimesRun
+        stats.GCTimesRun,
+        stats.GCPassesDone,
+        static_cast<uint64_t>(gcCandidates.size() - gcNextCandidate + gcRetryCandidates.size()),
+        stats.GCTotalTime,
+        stats.GCLastPause,
+        stats.GCMaxPause
     );
 }
 
@@ -327,10 +406,12 @@ void ManagedObjectPool::TraverseManagedObjects(const String &type, PfnProcessObj
 
 ManagedObjectPool::ManagedObjectPool()
     : objects(1)
-    , objectCreationCounter(0)
+    , gcNextCandidate(0u)
+    , gcNewCandidates(0u)
 {
     objects.Reserve(RESERVED_SIZE);
     handleByAddress.reserve(RESERVED_SIZE);
+    gcCandidates.reserve(RESERVED_SIZE);
 }
 
 ManagedObjectPool pool;
@@ -46,11 +46,26 @@ private:
     };
 
     IndexedObjectPool<ManagedObject, int32_t> objects;
+    // Address map has all the objects, but the objects which keep their own
+    // handle (see IScriptObject::GetHandlePtr) are resolved without it,
+    // when their manager is known; this is the case with script pointers.
     std::unordered_map<void*, int32_t> handleByAddress;
+    // Handles of the objects which got zero references but were not disposed
+    // right away (new objects, objects returned from functions, objects
+    // which refused to be disposed): only these are checked by the GC.
+    // The list may have handles of already disposed or referenced objects.
+    std::vector<int32_t> gcCandidates;
+    // Next candidate to check in the current GC pass
+    size_t gcNextCandidate;
+    // Candidates which refused disposal during the current GC pass,
+    // these will be checked again in the next pass
+    std::vector<int32_t> gcRetryCandidates;
 
     int  Add(int handle, void *address, IScriptObject *callback, ScriptValueType obj_type);
-    // Various counters, for GC trigger and stats
-    int objectCreationCounter;  // used to do garbage collection every so often
+    // Number of GC candidates added since the last GC run, used to trigger one
+    size_t gcNewCandidates;
+
+public:
     struct Stats
     {
         uint64_t Added = 0u; // total number of objects added
@@ -58,10 +73,22 @@ private:
         uint64_t RemovedGC = 0u; // number of objects removed by GC
         uint64_t MaxObjectsPresent = 0u; // max objects presets at the same time
         uint64_t GCTimesRun = 0u; // how many times GC ran
-    } stats;
+        uint64_t GCPassesDone = 0u; // how many times GC has checked all candidates
+        uint64_t GCTotalTime = 0u; // total time spent in GC, in microseconds
+        uint64_t GCLastPause = 0u; // duration of the last GC run, in microseconds
+        uint64_t GCMaxPause = 0u; // longest GC run, in microseconds
+    };
+
+private:
+    Stats stats;
 
     int  Remove(ManagedObject &o, bool force = false);
-    void RunGarbageCollection();
+    // Schedules the object for the check by GC
+    void AddGCCandidate(int32_t handle);
+    // Checks the GC candidates and removes ones without references;
+    // time_budget_us limits the run time, but at least min_count candidates
+    // are checked; 0 means to do the whole pass at once
+    void RunGarbageCollection(uint64_t time_budget_us = 0u, size_t min_count = 0u);
     void WriteImpl(Common::Stream *out) const;
 
 public:
@@ -69,7 +96,9 @@ public:
     int32_t AddRef(int32_t handle);
     int CheckDispose(int32_t handle);
     int32_t SubRef(int32_t handle);
-    int32_t AddressToHandle(void *addr);
+    // Gets the object's handle by its address; the manager is optional,
+    // but lets resolve the handle faster if the object keeps one
+    int32_t AddressToHandle(void *addr, IScriptObject *manager = nullptr);
     void* HandleToAddress(int32_t handle);
     ScriptValueType HandleToAddressAndManager(int32_t handle, void *&object, IScriptObject *&manager);
     int RemoveObject(void *address);
@@ -82,6 +111,9 @@ public:
     // De-allocate all objects
     void Reset();
     void PrintStats();
+    const Stats &GetStats() const { return stats; }
+    // Gets the number of objects present in the pool
+    size_t GetObjectCount() const { return stats.Added - stats.Removed; }
 
     typedef void (*PfnProcessObject)(int handle, IScriptObject *obj);
     void TraverseManagedObjects(const AGS::Common::String &type, PfnProcessObject proc);
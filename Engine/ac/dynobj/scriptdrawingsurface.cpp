@@ -126,6 +126,17 @@ void ScriptDrawingSurface::Invalidate()
     hasAlphaChannel = 0;
 }
 
+void ScriptDrawingSurface::FinishedDrawing(const Rect &area)
+{
+    if (area.IsEmpty())
+        modifiedArea = Rect(); // unknown, assume whole surface
+    else if (!modified)
+        modifiedArea = area;
+    else if (!modifiedArea.IsEmpty())
+        modifiedArea = SumRects(modifiedArea, area);
+    modified = true;
+}
+
 ScriptDrawingSurface::ScriptDrawingSurface() 
 {
     Invalidate();
@@ -32,6 +32,9 @@ struct ScriptDrawingSurface final : AGSCCDynamicObject {
     int currentColourScript;
     int highResCoordinates;
     int modified;
+    // Bounds of the modified area, in surface coordinates;
+    // empty if the whole surface is considered modified
+    Rect modifiedArea;
     int hasAlphaChannel;
 
     int Dispose(void *address, bool force) override;
@@ -44,7 +47,10 @@ struct ScriptDrawingSurface final : AGSCCDynamicObject {
     void SizeToGameResolution(int *width, int *height);
     void SizeToGameResolution(int *adjustValue);
     void SizeToDataResolution(int *adjustValue);
-    void FinishedDrawing() { modified = true; }
+    // Marks the whole surface as modified
+    void FinishedDrawing() { modified = true; modifiedArea = Rect(); }
+    // Marks the given area of the surface as modified
+    void FinishedDrawing(const Rect &area);
 
     void Invalidate();
 
@@ -22,6 +22,9 @@ struct ScriptString final : AGSCCDynamicObject
 public:
     struct Header
     {
+        // Handle of this string in the managed pool; placed first,
+        // so that the other fields keep their offsets from the data
+        int32_t Handle = 0;
         uint32_t Length = 0u;  // string length in bytes (not counting 0)
         uint32_t ULength = 0u; // Unicode compatible length in characters
         // Saved last requested character index and buffer offset;
@@ -79,6 +82,7 @@ public:
 
     const char *GetType() override;
     int Dispose(void *address, bool force) override;
+    int32_t *GetHandlePtr(void *address) override { return &GetHeader(address).Handle; }
     void Unserialize(int index, AGS::Common::Stream *in, size_t data_sz) override;
 
 private:
@@ -29,6 +29,9 @@ public:
 
     struct Header
     {
+        // Handle of this object in the managed pool; placed first,
+        // so that the other fields keep their offsets from the data
+        int32_t Handle = 0;
         uint32_t Size = 0u;
         // NOTE: we use signed int for Size at the moment, because the managed
         // object interface's Serialize() function requires the object to return
@@ -46,12 +49,18 @@ public:
         return reinterpret_cast<const Header&>(*(static_cast<const uint8_t*>(address) - MemHeaderSz));
     }
 
+    inline static Header &GetHeader(void *address)
+    {
+        return reinterpret_cast<Header&>(*(static_cast<uint8_t*>(address) - MemHeaderSz));
+    }
+
     // Create managed struct object and return a pointer to the beginning of a buffer
     static DynObjectRef Create(size_t size);
 
     // return the type name of the object
     const char *GetType() override;
     int Dispose(void *address, bool force) override;
+    int32_t *GetHandlePtr(void *address) override { return &GetHeader(address).Handle; }
     void Unserialize(int index, AGS::Common::Stream *in, size_t data_sz) override;
 
 private:
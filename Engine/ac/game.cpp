@@ -1261,7 +1261,7 @@ void Game_ScanSaveSlots(void *dest_arr, int min_slot, int max_slot, int save_sor
     can_run_delayed_command();
     if (inside_script)
     {
-        int handle = ccGetObjectHandleFromAddress(dest_arr);
+        int handle = ccGetObjectHandleFromAddress(dest_arr, &globalDynamicArray);
         ccAddObjectReference(handle); // add internal handle to prevent disposal
         curscript->QueueAction(PostScriptAction(ePSAScanSaves, handle, min_slot, max_slot, save_sort, sort_dir, user_param, "ScanSaveSlots"));
         return;
@@ -1883,10 +1883,10 @@ void get_message_text (int msnum, char *buffer, char giveErr) {
     replace_tokens(get_translation(thisroom.Messages[msnum].GetCStr()), buffer, maxlen);
 }
 
-void game_sprite_updated(int sprnum, bool deleted)
+void game_sprite_updated(int sprnum, bool deleted, const Rect &area)
 {
     // Notify draw system about dynamic sprite change
-    notify_sprite_changed(sprnum, deleted);
+    notify_sprite_changed(sprnum, deleted, area);
 }
 
 void precache_view(int view, int first_loop, int last_loop, bool with_sounds)
@@ -1904,7 +1904,17 @@ void precache_view(int view, int first_loop, int last_loop, bool with_sounds)
     const size_t txcache_before = texturecache_get_size();
     int total_frames = 0, total_sounds = 0;
 
-    int64_t dur_sp_load = 0, dur_tx_make = 0, dur_sound_load = 0;
+    // Load all the frames at once first, letting the sprites decode in parallel
+    std::vector<sprkey_t> frame_sprites;
+    for (int i = first_loop; i <= last_loop; ++i)
+    {
+        for (int j = 0; j < views[view].loops[i].numFrames; ++j)
+            frame_sprites.push_back(views[view].loops[i].frames[j].pic);
+    }
+    const auto tp_batch = FastClock::now();
+    spriteset.PrecacheSprites(frame_sprites);
+
+    int64_t dur_sp_load = ToMilliseconds(FastClock::now() - tp_batch), dur_tx_make = 0, dur_sound_load = 0;
     for (int i = first_loop; i <= last_loop; ++i)
     {
         for (int j = 0; j < views[view].loops[i].numFrames; ++j, ++total_frames)
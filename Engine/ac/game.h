@@ -224,7 +224,8 @@ void get_message_text (int msnum, char *buffer, char giveErr = 1);
 
 // Notifies the game objects that certain sprite was updated.
 // This make them update their render states, caches, and so on.
-void game_sprite_updated(int sprnum, bool deleted = false);
+// Optional area tells which part of the sprite has changed, if known.
+void game_sprite_updated(int sprnum, bool deleted = false, const Rect &area = Rect());
 // Precaches sprites for a view, within a selected range of loops.
 void precache_view(int view, int first_loop = 0, int last_loop = INT32_MAX, bool with_sounds = false);
 
@@ -19,6 +19,7 @@
 #include "ac/runtime_defines.h"
 #include "ac/speech.h"
 #include "ac/sys_events.h"
+#include "data/asset.h"
 #include "main/graphics_mode.h"
 #include "util/string.h"
 
@@ -89,6 +90,8 @@ struct GameConfig
     static const size_t DefSpriteCacheSize  = (128 * 1024); // 128 MB
 #endif
     static const size_t DefTexCacheSize     = (128 * 1024); // 128 MB
+    static const size_t DefTransformCacheSize = (32 * 1024); // 32 MB
+    static const int DefTextureAtlasMaxSprite = 64;
     static const size_t DefSoundLoadAtOnce  = 1024; // 1 MB
     static const size_t DefSoundCache       = 1024u * 32; // 32 MB
 
@@ -99,6 +102,8 @@ struct GameConfig
     // Graphic options (additional)
     bool    RenderAtScreenRes    = false; // render sprites at screen resolution, as opposed to native one
     bool    AntialiasSprites     = false;  // apply AA (linear) scaling to game sprites, regardless of final filter
+    int     RenderThreads        = 1; // number of threads for the software renderer, 0 = as many as CPU cores
+    bool    SkipUnchangedFrames  = false; // don't render and present frames same as the previous one
 
     // For mobile devices
     ScreenRotation Rotation      = kScreenRotation_Unlocked; // how to display the game on mobile screen
@@ -118,7 +123,11 @@ struct GameConfig
 
     // Cache options
     size_t  SpriteCacheSize      = DefSpriteCacheSize; // in KB
+    int     SpriteDecodeThreads  = 1; // number of threads for decoding precached sprites, 0 = as many as CPU cores
     size_t  TextureCacheSize     = DefTexCacheSize; // in KB
+    size_t  TransformCacheSize   = DefTransformCacheSize; // in KB
+    int     TextureAtlasPage     = 0; // size of the texture atlas pages, 0 = no atlas
+    int     TextureAtlasMaxSprite = DefTextureAtlasMaxSprite; // max size of a sprite put on atlas
     size_t  SoundCacheSize       = DefSoundCache; // sound cache limit, in KB
     size_t  SoundLoadAtOnceSize  = DefSoundLoadAtOnce; // threshold for loading sounds immediately, in KB
 
@@ -135,8 +144,10 @@ struct GameConfig
     bool    LoadLatestSave       = false; // load latest saved game on launch
     bool    CompressSaves        = true;
     bool    ClearCacheOnRoomChange = false; // for low-end devices: clear resource caches on room change
+    AGS::Common::AssetDirIndexMode AssetDirIndex = AGS::Common::kAssetDirIndexNone; // how to look up assets in the game directories
     bool    RunInBackground      = false; // whether run on background, when game is switched out
     bool    ShowFps              = false;
+    String  ScriptProfileFile; // file to write script profiler results to; empty disables profiling
 
     // Accessibility options
     AccessibilityGameConfig Access;
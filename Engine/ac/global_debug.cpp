@@ -12,6 +12,7 @@
 //
 //=============================================================================
 #include "ac/global_debug.h"
+#include <cinttypes>
 #include "ac/common.h"
 #include "ac/characterinfo.h"
 #include "ac/draw.h"
@@ -24,8 +25,10 @@
 #include "ac/global_room.h"
 #include "ac/properties.h"
 #include "ac/sys_events.h"
+#include "ac/textcache.h"
 #include "ac/translation.h"
 #include "ac/walkablearea.h"
+#include "ac/dynobj/managedobjectpool.h"
 #include "gfx/gfxfilter.h"
 #include "gui/guidialog.h"
 #include "script/cc_common.h"
@@ -80,6 +83,22 @@ String GetRuntimeInfo()
         render_frame.GetWidth(), render_frame.GetHeight(),
         total_normspr / 1024, max_normspr / 1024, norm_spr_filled, total_lockspr / 1024, total_extspr / 1024,
         total_txcached / 1024, max_txcached / 1024, tx_filled);
+    size_t atlas_pages, atlas_sprites;
+    unsigned atlas_filled;
+    texturecache_get_atlas_state(atlas_pages, atlas_sprites, atlas_filled);
+    if (atlas_pages > 0)
+        runtimeInfo.AppendFmt("\nTexture atlas: %zu pages, %zu sprites (%u%%)", atlas_pages, atlas_sprites, atlas_filled);
+    uint32_t lines_hits, lines_misses, image_hits, image_misses;
+    size_t text_images_size;
+    textcache_get_stats(lines_hits, lines_misses, image_hits, image_misses, text_images_size);
+    if (lines_hits + lines_misses > 0)
+        runtimeInfo.AppendFmt("\nText cache: lines %u%% hits, images %u%% hits (%zu KB)",
+            static_cast<unsigned>(lines_hits * 100ull / (lines_hits + lines_misses)),
+            (image_hits + image_misses > 0) ? static_cast<unsigned>(image_hits * 100ull / (image_hits + image_misses)) : 0u,
+            text_images_size / 1024);
+    const auto &gc_stats = pool.GetStats();
+    runtimeInfo.AppendFmt("\nManaged objects: %zu, GC: %" PRIu64 " freed, pause %.2f ms (max %.2f)",
+        pool.GetObjectCount(), gc_stats.RemovedGC, gc_stats.GCLastPause * 0.001f, gc_stats.GCMaxPause * 0.001f);
     if (play.separate_music_lib)
         runtimeInfo.Append("[AUDIO.VOX enabled");
     if (play.voice_avail)
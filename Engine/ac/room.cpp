@@ -65,6 +65,7 @@
 #include "script/script.h"
 #include "script/script_runtime.h"
 #include "ac/spritecache.h"
+#include "ac/view.h"
 #include "util/stream.h"
 #include "gfx/graphicsdriver.h"
 #include "data/assetmanager.h"
@@ -91,6 +92,7 @@ extern ScriptHotspot scrHotspot[MAX_ROOM_HOTSPOTS];
 extern int in_leaves_screen;
 extern CharacterInfo*playerchar;
 extern std::vector<CharacterExtras> charextra;
+extern std::vector<ViewStruct> views;
 extern IDriverDependantBitmap* roomBackgroundBmp;
 extern IGraphicsDriver *gfxDriver;
 extern RGB palette[256];
@@ -237,8 +239,8 @@ ScriptUserObject *Room_NearestWalkableArea(int x, int y)
     if (displayed_room < 0)
         quit("!Room.NearestWalkableArea: no room is currently loaded");
     Point found_pt;
-    if (Pathfinding::FindNearestWalkablePoint(thisroom.WalkAreaMask.get(),
-        Point(room_to_mask_coord(x), room_to_mask_coord(y)), found_pt))
+    if (find_nearest_walkable_point(Point(room_to_mask_coord(x), room_to_mask_coord(y)), found_pt,
+        RectWH(thisroom.WalkAreaMask->GetSize())))
     {
         return ScriptStructHelpers::CreatePoint(mask_to_room_coord(found_pt.X), mask_to_room_coord(found_pt.Y));
     }
@@ -552,6 +554,36 @@ static void init_object_states(size_t start, size_t end)
     }
 }
 
+// Queues the sprites which are likely to be drawn first in the new room
+// for the background loading: the room objects' images and the current
+// view loops of objects and characters present in this room.
+static void prefetch_room_sprites(int room_number)
+{
+    auto prefetch_loop = [](int view, int loop)
+    {
+        if (view < 0 || static_cast<size_t>(view) >= views.size() || loop >= views[view].numLoops)
+            return;
+        const auto &view_loop = views[view].loops[loop];
+        for (int i = 0; i < view_loop.numFrames; ++i)
+            spriteset.PrefetchSprite(view_loop.frames[i].pic);
+    };
+
+    for (uint32_t i = 0; i < croom->numobj; ++i)
+    {
+        const auto &obj = croom->obj[i];
+        if (obj.on != OBJ_STATE_ENABLED)
+            continue;
+        spriteset.PrefetchSprite(obj.num);
+        if (obj.view != RoomObject::NoView)
+            prefetch_loop(obj.view, obj.loop);
+    }
+    for (const auto &chi : game.chars)
+    {
+        if (chi.room == room_number && chi.on)
+            prefetch_loop(chi.view, chi.loop);
+    }
+}
+
 HError LoadRoom(const String &filename, RoomStruct *room, AssetManager *mgr, bool game_is_hires, const std::vector<SpriteInfo> &sprinfos)
 {
     auto in = mgr->OpenAsset(filename);
@@ -660,6 +692,7 @@ void load_new_room(int newnum, CharacterInfo *forchar)
     delete walkareabackup;
     // copy the walls screen
     walkareabackup=BitmapHelper::CreateBitmapCopy(thisroom.WalkAreaMask.get());
+    reset_walkable_area_search();
 
     set_our_eip(204);
     redo_walkable_areas();
@@ -769,6 +802,8 @@ void load_new_room(int newnum, CharacterInfo *forchar)
     }
 
     objs = croom->obj.size() > 0 ? &croom->obj[0] : nullptr;
+    // Begin loading sprites in background while the room is being prepared
+    prefetch_room_sprites(newnum);
 
     for (uint32_t cc = 0; cc < thisroom.Objects.size(); cc++)
     {
@@ -1051,6 +1086,7 @@ void new_room(int newnum,CharacterInfo*forchar) {
         spriteset.DisposeAllFreeCached();
         soundcache_clear();
         texturecache_clear();
+        transformcache_clear();
     }
 
     load_new_room(newnum,forchar);
@@ -1069,6 +1105,7 @@ void set_room_placeholder()
     thisroom.RegionMask = dummy_bg;
     thisroom.WalkAreaMask = dummy_bg;
     thisroom.WalkBehindMask = dummy_bg;
+    reset_walkable_area_search();
 
     reset_temp_room();
     croom = &troom;
@@ -1253,6 +1290,10 @@ void on_room_mask_surface_release(RoomAreaMask mask, bool modified)
         {
             walkbehinds_recalc();
         }
+        else if (mask == kRoomAreaWalkable)
+        {
+            invalidate_walkable_area_search(RectWH(thisroom.WalkAreaMask->GetSize()));
+        }
         if (get_room_mask_debugmode() == mask)
         {
             debug_draw_room_mask(mask);
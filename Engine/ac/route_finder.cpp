@@ -12,6 +12,8 @@
 //
 //=============================================================================
 #include "ac/route_finder.h"
+#include <string.h>
+#include <cmath>
 #include <memory>
 #include <allegro.h>
 #include "ac/movelist.h"
@@ -87,6 +89,300 @@ void MaskRouteFinder::SetWalkableArea(const Bitmap *walkablearea, int coord_scal
     OnSetWalkableArea();
 }
 
+// Integer square root, rounded down
+static int isqrt(uint64_t value)
+{
+    int root = static_cast<int>(std::sqrt(static_cast<double>(value)));
+    while (static_cast<uint64_t>(root) * root > value)
+        root--;
+    while (static_cast<uint64_t>(root + 1) * (root + 1) <= value)
+        root++;
+    return root;
+}
+
+// Integer division rounded towards negative infinity
+static int64_t floor_div(int64_t num, int64_t den)
+{
+    const int64_t q = num / den;
+    return ((num % den != 0) && ((num < 0) != (den < 0))) ? q - 1 : q;
+}
+
+void MaskDistanceField::SetMask(const Bitmap *mask)
+{
+    assert(!mask || mask->GetColorDepth() == 8);
+    _mask = mask;
+    _width = mask ? mask->GetWidth() : 0;
+    _height = mask ? mask->GetHeight() : 0;
+    _valid = false;
+    _hasDirty = false;
+    _scanCost = 0u;
+}
+
+void MaskDistanceField::Invalidate(const Rect &area)
+{
+    // Nothing to update yet
+    if (!_valid)
+        return;
+    const Rect change = IntersectRects(area, RectWH(0, 0, _width, _height));
+    if (change.IsEmpty())
+        return;
+    _dirty = _hasDirty ? SumRects(_dirty, change) : change;
+    _hasDirty = true;
+    _scanCost = 0u;
+}
+
+void MaskDistanceField::Invalidate()
+{
+    Invalidate(RectWH(0, 0, _width, _height));
+}
+
+inline uint32_t MaskDistanceField::GetSqDistanceImpl(int x, int y) const
+{
+    const int near_x = _nearCol[y * _width + x];
+    const uint32_t col_dist = _colDist[y * _width + near_x];
+    if (col_dist == static_cast<uint32_t>(_width + _height))
+        return UINT32_MAX; // no walkable pixels at all
+    return (x - near_x) * (x - near_x) + col_dist * col_dist;
+}
+
+uint32_t MaskDistanceField::GetSqDistance(int x, int y)
+{
+    assert(_mask && x >= 0 && x < _width && y >= 0 && y < _height);
+    // The column distances are stored in 16-bit values
+    assert(_width + _height < UINT16_MAX);
+    Sync();
+    return GetSqDistanceImpl(x, y);
+}
+
+bool MaskDistanceField::FindNearestWalkablePoint(const Point &from_pt, Point &dst_pt,
+    const Rect &limits, const int range, const int step)
+{
+    if (!_mask)
+        return false;
+    // Only the common 1 pixel step scan is accelerated here
+    if ((step != 1) || (_width + _height >= UINT16_MAX) || (_width * _height > MaxMaskPixels) ||
+        (from_pt.X < 0) || (from_pt.X >= _width) || (from_pt.Y < 0) || (from_pt.Y >= _height))
+        return Pathfinding::FindNearestWalkablePoint(_mask, from_pt, dst_pt, limits, range, step);
+
+    // This repeats the scan of Pathfinding::FindNearestWalkablePoint, and gives
+    // exactly same result, but skips the pixels which are known to be not walkable:
+    // - the inner rectangles, which are all closer than the nearest walkable pixel;
+    // - along the scanned lines, by the distance to the nearest walkable pixel.
+    const Rect mask_limits = IntersectRects(limits, RectWH(0, 0, _width, _height));
+    const Rect use_limits = (range <= 0) ? mask_limits :
+        IntersectRects(mask_limits, RectWH(from_pt.X - range / 2, from_pt.Y - range / 2, range * 2, range * 2));
+    if (use_limits.IsEmpty())
+        return false;
+
+    if (use_limits.IsInside(from_pt) && _mask->GetScanLine(from_pt.Y)[from_pt.X] > 0)
+    {
+        dst_pt = from_pt;
+        return true;
+    }
+
+    // Calculating the distances costs about as much as reading the whole mask,
+    // so only do that after the plain scans since the last change read as much
+    if ((!_valid || _hasDirty) && (_scanCost < static_cast<uint64_t>(_width) * _height))
+    {
+        const bool found = Pathfinding::FindNearestWalkablePoint(_mask, from_pt, dst_pt, limits, range, step);
+        // The scan reads about 8 * N pixels on each N-th rectangle
+        const int dx = dst_pt.X - from_pt.X, dy = dst_pt.Y - from_pt.Y;
+        _scanCost += found ? 1 + 4 * static_cast<uint64_t>(dx * dx + dy * dy) : _width * _height;
+        return found;
+    }
+    Sync();
+    const uint32_t from_sqdist = GetSqDistanceImpl(from_pt.X, from_pt.Y);
+    if (from_sqdist == UINT32_MAX)
+        return false; // no walkable pixels at all
+
+    uint64_t nearest_sqdist = UINT64_MAX;
+    Point nearest_pt(-1, -1);
+    int max_range = std::max(
+        std::max(from_pt.X - use_limits.Left, use_limits.Right - from_pt.X),
+        std::max(from_pt.Y - use_limits.Top, use_limits.Bottom - from_pt.Y));
+    // Tests the pixel, returns the number of pixels to advance along the line
+    const auto test_pixel = [&](int x, int y)
+    {
+        const uint32_t sqdist_to_walkable = GetSqDistanceImpl(x, y);
+        if (sqdist_to_walkable > 0)
+            return isqrt(sqdist_to_walkable - 1) + 1;
+        uint64_t sqdist = (x - from_pt.X) * (x - from_pt.X) + (y - from_pt.Y) * (y - from_pt.Y);
+        if (sqdist < nearest_sqdist)
+        {
+            max_range = std::sqrt(sqdist);
+            nearest_sqdist = sqdist;
+            nearest_pt = Point(x, y);
+        }
+        return 1;
+    };
+    const auto scan_column = [&](int x, int y0, int y1)
+    {
+        for (int y = y0; y <= y1; y += test_pixel(x, y));
+    };
+
+    // Any rectangle closer than this only has pixels closer than the nearest walkable one
+    int cur_range = isqrt(from_sqdist / 2);
+    if (2 * static_cast<uint64_t>(cur_range) * cur_range < from_sqdist)
+        cur_range++;
+    for (cur_range = std::max(1, cur_range); cur_range <= max_range; ++cur_range)
+    {
+        const int scan_fromx = std::max(use_limits.Left,   from_pt.X - cur_range);
+        const int scan_tox   = std::min(use_limits.Right,  from_pt.X + cur_range);
+        const int scan_fromy = std::max(use_limits.Top,    from_pt.Y - cur_range);
+        const int scan_toy   = std::min(use_limits.Bottom, from_pt.Y + cur_range);
+        if ((scan_fromx > scan_tox) || (scan_fromy > scan_toy))
+            continue;
+        // Same order as in the scan: left column, then top and bottom lines
+        // between, x by x, then right column.
+        scan_column(scan_fromx, scan_fromy, scan_toy);
+        const int bottom_y = scan_fromy + cur_range * 2;
+        const int inner_tox = scan_tox - 1;
+        int top_x = scan_fromx + 1;
+        int bottom_x = (bottom_y <= scan_toy) ? scan_fromx + 1 : INT32_MAX;
+        while (std::min(top_x, bottom_x) <= inner_tox)
+        {
+            const int x = std::min(top_x, bottom_x);
+            if (top_x == x)
+                top_x += test_pixel(x, scan_fromy);
+            if (bottom_x == x)
+                bottom_x += test_pixel(x, bottom_y);
+        }
+        if (scan_tox != scan_fromx)
+            scan_column(scan_tox, scan_fromy, scan_toy);
+    }
+
+    if (nearest_sqdist < UINT64_MAX)
+    {
+        dst_pt = nearest_pt;
+        return true;
+    }
+    return false;
+}
+
+void MaskDistanceField::Sync()
+{
+    if (_valid && !_hasDirty)
+        return;
+
+    _rowChanged.assign(_height, 0);
+    if (!_valid)
+    {
+        _colDist.resize(_width * _height);
+        _nearCol.resize(_width * _height);
+        _envSites.resize(_width);
+        _envStarts.resize(_width);
+        UpdateColumns(0, _width - 1);
+        std::fill(_rowChanged.begin(), _rowChanged.end(), 1);
+    }
+    else
+    {
+        UpdateColumns(_dirty.Left, _dirty.Right);
+    }
+
+    for (int y = 0; y < _height; ++y)
+    {
+        if (_rowChanged[y])
+            UpdateRow(y);
+    }
+    _valid = true;
+    _hasDirty = false;
+}
+
+void MaskDistanceField::UpdateColumns(int x0, int x1)
+{
+    // Distance which means "no walkable pixels in this column"
+    const uint16_t no_dist = static_cast<uint16_t>(_width + _height);
+    const int cols = x1 - x0 + 1;
+    // The first calculation writes the distances in place, the later
+    // ones compare them with the old distances to find the changed rows
+    const bool in_place = !_valid;
+    const int pitch = in_place ? _width : cols;
+    if (!in_place)
+        _colTemp.resize(cols * _height);
+    uint16_t *dist_buf = in_place ? &_colDist[x0] : _colTemp.data();
+    // Distances to the nearest walkable pixel above
+    for (int y = 0; y < _height; ++y)
+    {
+        const uint8_t *mask_line = _mask->GetScanLine(y) + x0;
+        uint16_t *dist = &dist_buf[y * pitch];
+        const uint16_t *prev_dist = dist - pitch;
+        for (int i = 0; i < cols; ++i)
+        {
+            if (mask_line[i] > 0)
+                dist[i] = 0;
+            else
+                dist[i] = (y > 0) ? std::min<uint16_t>(no_dist, prev_dist[i] + 1) : no_dist;
+        }
+    }
+    // Distances to the nearest walkable pixel below, and pick the least
+    for (int y = _height - 1; y >= 0; --y)
+    {
+        uint16_t *dist = &dist_buf[y * pitch];
+        if (y < _height - 1)
+        {
+            const uint16_t *next_dist = dist + pitch;
+            for (int i = 0; i < cols; ++i)
+                dist[i] = std::min<uint16_t>(dist[i], next_dist[i] + 1);
+        }
+        if (in_place)
+            continue;
+        uint16_t *old_dist = &_colDist[y * _width + x0];
+        if (memcmp(old_dist, dist, cols * sizeof(uint16_t)) != 0)
+        {
+            memcpy(old_dist, dist, cols * sizeof(uint16_t));
+            _rowChanged[y] = 1;
+        }
+    }
+}
+
+void MaskDistanceField::UpdateRow(int y)
+{
+    // This is a second phase of the exact euclidean distance transform
+    // by Meijster et al.: for each pixel find the column, whose nearest
+    // walkable pixel gives the least distance; these columns are gathered
+    // as a lower envelope of the column distance functions.
+    const uint16_t *g = &_colDist[y * _width];
+    uint16_t *near_col = &_nearCol[y * _width];
+    int *sites = _envSites.data();
+    int *starts = _envStarts.data();
+    const auto f = [g](int x, int i)
+        { return static_cast<int64_t>(x - i) * (x - i) + static_cast<int64_t>(g[i]) * g[i]; };
+    const auto sep = [g](int i, int u)
+        { return floor_div(static_cast<int64_t>(u) * u - static_cast<int64_t>(i) * i
+            + static_cast<int64_t>(g[u]) * g[u] - static_cast<int64_t>(g[i]) * g[i], 2 * (u - i)); };
+
+    int q = 0;
+    sites[0] = 0;
+    starts[0] = 0;
+    for (int u = 1; u < _width; ++u)
+    {
+        while ((q >= 0) && (f(starts[q], sites[q]) > f(starts[q], u)))
+            q--;
+        if (q < 0)
+        {
+            q = 0;
+            sites[0] = u;
+        }
+        else
+        {
+            const int64_t w = 1 + sep(sites[q], u);
+            if (w < _width)
+            {
+                q++;
+                sites[q] = u;
+                starts[q] = static_cast<int>(w);
+            }
+        }
+    }
+
+    for (int u = _width - 1; u >= 0; --u)
+    {
+        near_col[u] = static_cast<uint16_t>(sites[q]);
+        if (u == starts[q])
+            q--;
+    }
+}
+
 
 namespace Pathfinding
 {
@@ -307,13 +603,13 @@ void RecalculateMoveSpeeds(MoveList &mls, int old_speed_x, int old_speed_y, int
     }
 }
 
-bool FindNearestWalkablePoint(Bitmap *mask, const Point &from_pt, Point &dst_pt,
+bool FindNearestWalkablePoint(const Bitmap *mask, const Point &from_pt, Point &dst_pt,
     const int range, const int step)
 {
     return FindNearestWalkablePoint(mask, from_pt, dst_pt, RectWH(mask->GetSize()), range, step);
 }
 
-bool FindNearestWalkablePoint(Bitmap *mask, const Point &from_pt, Point &dst_pt,
+bool FindNearestWalkablePoint(const Bitmap *mask, const Point &from_pt, Point &dst_pt,
     const Rect &limits, const int range, const int step)
 {
     assert(mask->GetColorDepth() == 8);
@@ -87,6 +87,66 @@ protected:
     int _coordScale = 1;
 };
 
+// MaskDistanceField: keeps the distances from each pixel of a 8-bit mask
+// to the nearest walkable (non-zero) pixel, which lets find the nearest walkable
+// point without scanning the mask around. The distances are calculated when
+// requested, and after that only recalculated for the reported mask changes.
+// NOTE: the distances take 4 bytes per mask pixel (about 33 MB for a 4K mask),
+// so the masks larger than MaxMaskPixels are not accelerated, and
+// FindNearestWalkablePoint does the plain scan on them.
+class MaskDistanceField
+{
+public:
+    // Largest mask for which the distances are calculated, about 35 MB
+    static const int MaxMaskPixels = 4096 * 2160;
+
+    // Assigns the mask; the distances will be calculated anew
+    void SetMask(const Common::Bitmap *mask);
+    // Notifies that the mask pixels were changed within the given rectangle
+    void Invalidate(const Rect &area);
+    // Notifies that the whole mask was changed
+    void Invalidate();
+    // Gets the squared distance from the given mask pixel to the nearest
+    // walkable pixel; returns UINT32_MAX if there are no walkable pixels at all
+    uint32_t GetSqDistance(int x, int y);
+    // Searchs for the nearest walkable point on the mask, same as
+    // Pathfinding::FindNearestWalkablePoint, and gives exactly same result,
+    // but skips the parts of the mask which have no walkable pixels.
+    bool FindNearestWalkablePoint(const Point &from_pt, Point &dst_pt,
+        const Rect &limits, const int range = 0, const int step = 1);
+
+private:
+    // Recalculates the distances in the changed parts of the mask
+    void Sync();
+    // Recalculates the vertical distances in the given columns,
+    // and marks the rows which got any changes
+    void UpdateColumns(int x0, int x1);
+    // Recalculates the nearest columns in the given row
+    void UpdateRow(int y);
+    // Gets the squared distance from the mask pixel, must be in sync
+    inline uint32_t GetSqDistanceImpl(int x, int y) const;
+
+    const Common::Bitmap *_mask = nullptr;
+    int _width = 0;
+    int _height = 0;
+    // Vertical distance to the nearest walkable pixel in the same column
+    std::vector<uint16_t> _colDist;
+    // Column of the nearest walkable pixel, which is then found by _colDist
+    std::vector<uint16_t> _nearCol;
+    // Helper buffers for the calculation
+    std::vector<uint16_t> _colTemp;
+    std::vector<uint8_t> _rowChanged;
+    std::vector<int> _envSites;
+    std::vector<int> _envStarts;
+    // Whether the distances were calculated at all
+    bool _valid = false;
+    // Changed part of the mask, which is not recalculated yet
+    Rect _dirty;
+    bool _hasDirty = false;
+    // Approximate number of pixels read by the plain scans since the last change
+    uint64_t _scanCost = 0u;
+};
+
 //
 // Various additional pathfinding functions and helpers.
 // Manages converting navigation paths into MoveLists.
@@ -106,9 +166,9 @@ namespace Pathfinding
     void RecalculateMoveSpeeds(MoveList &mls, int old_speed_x, int old_speed_y, int new_speed_x, int new_speed_y);
     // Searchs for the nearest walkable point on a mask, starting from the given location,
     // and scanning around in the given square range. Optionally limit the scan to the certain rectangle.
-    bool FindNearestWalkablePoint(AGS::Common::Bitmap *mask, const Point &from_pt, Point &dst_pt,
+    bool FindNearestWalkablePoint(const AGS::Common::Bitmap *mask, const Point &from_pt, Point &dst_pt,
         const int range = 0, const int step = 1);
-    bool FindNearestWalkablePoint(AGS::Common::Bitmap *mask, const Point &from_pt, Point &dst_pt,
+    bool FindNearestWalkablePoint(const AGS::Common::Bitmap *mask, const Point &from_pt, Point &dst_pt,
         const Rect &limits, const int range = 0, const int step = 0);
 }
 
@@ -32,6 +32,7 @@ namespace Engine
 JPSRouteFinder::JPSRouteFinder()
     : nav(*new Navigation())
 {
+    EnableNavigationCache(true);
 }
 
 JPSRouteFinder::~JPSRouteFinder()
@@ -43,6 +44,13 @@ void JPSRouteFinder::Configure(GameDataVersion /*game_ver*/)
 {
 }
 
+void JPSRouteFinder::EnableNavigationCache(bool enable)
+{
+    _navCacheEnabled = enable;
+    nav.EnableJumpTables(enable);
+    _routeCache.clear();
+}
+
 void JPSRouteFinder::OnSetWalkableArea()
 {
 }
@@ -79,22 +87,57 @@ bool JPSRouteFinder::FindRouteJPS(std::vector<Point> &nav_path, int fromx, int f
 
     SyncNavWalkablearea();
 
+    if (_navCacheEnabled)
+    {
+        // The mask is regenerated before each search, but is often the same;
+        // the routes found on it remain valid until it changes
+        if (nav.SyncJumpTables())
+            _routeCache.clear();
+
+        for (auto it = _routeCache.begin(); it != _routeCache.end(); ++it)
+        {
+            if ((it->FromX != fromx) || (it->FromY != fromy) || (it->DestX != destx) || (it->DestY != desty))
+                continue;
+            std::rotate(_routeCache.begin(), it, it + 1); // move to front
+            if (!_routeCache.front().Found)
+                return false;
+            nav_path = _routeCache.front().Path;
+            return true;
+        }
+    }
+
     path.clear();
     cpath.clear();
 
-    if (nav.NavigateRefined(fromx, fromy, destx, desty, path, cpath) == Navigation::NAV_UNREACHABLE)
-        return false;
-
-    nav_path.clear();
+    const bool found = nav.NavigateRefined(fromx, fromy, destx, desty, path, cpath) != Navigation::NAV_UNREACHABLE;
+    if (found)
+    {
+        nav_path.clear();
+
+        for (size_t i = 0; i < cpath.size(); i++)
+        {
+            int x, y;
+            nav.UnpackSquare(cpath[i], x, y);
+            nav_path.emplace_back( x, y );
+        }
+    }
 
-    for (size_t i = 0; i < cpath.size(); i++)
+    if (_navCacheEnabled)
     {
-        int x, y;
-        nav.UnpackSquare(cpath[i], x, y);
-        nav_path.emplace_back( x, y );
+        if (_routeCache.size() >= MaxCachedRoutes)
+            _routeCache.pop_back();
+        CachedRoute route;
+        route.FromX = fromx;
+        route.FromY = fromy;
+        route.DestX = destx;
+        route.DestY = desty;
+        route.Found = found;
+        if (found)
+            route.Path = nav_path;
+        _routeCache.insert(_routeCache.begin(), std::move(route));
     }
 
-    return true;
+    return found;
 }
 
 bool JPSRouteFinder::FindRouteImpl(std::vector<Point> &nav_path, int srcx, int srcy, int dstx, int dsty,
@@ -33,6 +33,11 @@ public:
     ~JPSRouteFinder();
 
     void Configure(GameDataVersion game_ver) override;
+    // Enables the navigation cache: the precomputed jump distances for the
+    // walkable mask, and the recently found routes (enabled by default).
+    // NOTE: jump distances take 9 bytes per mask pixel, so these are not
+    // precomputed for the masks larger than Full HD (1920x1080)
+    void EnableNavigationCache(bool enable);
 
 private:
     // Update the implementation after a new walkable area is set
@@ -48,6 +53,20 @@ private:
 
     Navigation &nav; // declare as reference, because we must hide real Navigation decl here
     std::vector<int> path, cpath;
+
+    // Route found between the two points on the current walkable mask
+    struct CachedRoute
+    {
+        int FromX = 0, FromY = 0, DestX = 0, DestY = 0;
+        bool Found = false;
+        std::vector<Point> Path;
+    };
+    // Max number of the recent routes to keep
+    static const size_t MaxCachedRoutes = 16u;
+
+    bool _navCacheEnabled = false;
+    // Recently found routes, most recent first
+    std::vector<CachedRoute> _routeCache;
 };
 
 } // namespace Engine
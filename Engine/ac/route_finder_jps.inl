@@ -24,6 +24,7 @@
 #include <functional>
 #include <assert.h>
 #include <stddef.h>
+#include <string.h>
 #include <math.h>
 
 namespace AGS
@@ -65,6 +66,14 @@ public:
 
 	inline void SetMapRow(int y, const unsigned char *row) {map[y] = row;}
 
+	// enables precomputed jump distances (JPS+), which let the search
+	// skip straight runs of cells without testing each of them
+	void EnableJumpTables(bool enable);
+	// brings the jump tables up to date with the map contents; must be called
+	// before navigating whenever the map rows were changed;
+	// returns whether the map differs from the one last synced
+	bool SyncJumpTables();
+
 	inline static int PackSquare(int x, int y);
 	inline static void UnpackSquare(int sq, int &x, int &y);
 
@@ -140,6 +149,33 @@ private:
 
 	bool navLock;
 
+	// jump tables: for each cell and orthogonal direction, the number of steps
+	// to the next jump point, or to the first impassable cell (marked with JUMP_WALL)
+	enum JumpDir
+	{
+		JUMP_EAST,
+		JUMP_WEST,
+		JUMP_SOUTH,
+		JUMP_NORTH,
+		JUMP_DIRS
+	};
+	static const unsigned short JUMP_WALL = 0x8000;
+	// largest map which the jump tables are built for: these take 9 bytes
+	// per cell (jumps and a copy of the map), about 18 MB at this size
+	static const int JUMP_MAX_CELLS = 1920*1080;
+
+	std::vector<unsigned short> jumps[JUMP_DIRS];
+	// copy of the map which the jump tables were built for
+	std::vector<unsigned char> jumpsMap;
+	bool useJumps;
+	bool jumpsValid;
+
+	inline unsigned short NextJump(unsigned short next, int nx, int ny, int dx, int dy) const;
+	void FreeJumpTables();
+	void BuildRowJumps(int y);
+	void BuildColumnJumps(int x0, int x1);
+	int FindOrthoJumpPrecomputed(int x, int y, int dx, int dy, int ex, int ey);
+
 	void IncFrameId();
 
 	// outside map test
@@ -196,11 +232,16 @@ Navigation::Navigation()
 	// no diagonal route - this should correspond to what AGS does
 	, nodiag(true)
 	, navLock(false)
+	, useJumps(false)
+	, jumpsValid(false)
 {
 }
 
 void Navigation::Resize(int width, int height)
 {
+	if (width != mapWidth || height != mapHeight)
+		jumpsValid = false;
+
 	mapWidth = width;
 	mapHeight = height;
 
@@ -287,10 +328,210 @@ bool Navigation::HasForcedNeighbor(int x, int y, int dx, int dy) const
 		(!Passable(x, y - dy) && Passable(x + dx, y - dy));
 }
 
+void Navigation::EnableJumpTables(bool enable)
+{
+	useJumps = enable;
+	jumpsValid = false;
+
+	if (!enable)
+		FreeJumpTables();
+}
+
+void Navigation::FreeJumpTables()
+{
+	for (int i=0; i<JUMP_DIRS; i++)
+		std::vector<unsigned short>().swap(jumps[i]);
+
+	std::vector<unsigned char>().swap(jumpsMap);
+}
+
+inline unsigned short Navigation::NextJump(unsigned short next, int nx, int ny, int dx, int dy) const
+{
+	if (!Walkable(nx, ny))
+		return 1 | JUMP_WALL;
+
+	if (HasForcedNeighbor(nx, ny, dx, dy))
+		return 1;
+
+	// keeps the wall flag, the step count never overflows into it
+	return next + 1;
+}
+
+void Navigation::BuildRowJumps(int y)
+{
+	unsigned short *east = &jumps[JUMP_EAST][y*mapWidth];
+	unsigned short *west = &jumps[JUMP_WEST][y*mapWidth];
+
+	east[mapWidth-1] = 1 | JUMP_WALL;
+
+	for (int x = mapWidth-2; x >= 0; x--)
+		east[x] = NextJump(east[x+1], x+1, y, 1, 0);
+
+	west[0] = 1 | JUMP_WALL;
+
+	for (int x = 1; x < mapWidth; x++)
+		west[x] = NextJump(west[x-1], x-1, y, -1, 0);
+}
+
+void Navigation::BuildColumnJumps(int x0, int x1)
+{
+	unsigned short *south = &jumps[JUMP_SOUTH][0];
+	unsigned short *north = &jumps[JUMP_NORTH][0];
+
+	// rows are processed in order, which is friendlier to the cache
+	for (int x = x0; x <= x1; x++)
+		south[(mapHeight-1)*mapWidth + x] = 1 | JUMP_WALL;
+
+	for (int y = mapHeight-2; y >= 0; y--)
+	{
+		for (int x = x0; x <= x1; x++)
+			south[y*mapWidth + x] = NextJump(south[(y+1)*mapWidth + x], x, y+1, 0, 1);
+	}
+
+	for (int x = x0; x <= x1; x++)
+		north[x] = 1 | JUMP_WALL;
+
+	for (int y = 1; y < mapHeight; y++)
+	{
+		for (int x = x0; x <= x1; x++)
+			north[y*mapWidth + x] = NextJump(north[(y-1)*mapWidth + x], x, y-1, 0, -1);
+	}
+}
+
+bool Navigation::SyncJumpTables()
+{
+	// step counts must fit below the wall flag
+	if (!useJumps || mapWidth <= 0 || mapHeight <= 0 ||
+		mapWidth >= JUMP_WALL || mapHeight >= JUMP_WALL)
+	{
+		jumpsValid = false;
+		return true;
+	}
+
+	// the maps over the memory budget are searched without the tables
+	if ((size_t)mapWidth*mapHeight > (size_t)JUMP_MAX_CELLS)
+	{
+		if (!jumpsMap.empty())
+			FreeJumpTables();
+		jumpsValid = false;
+		return true;
+	}
+
+	if (!jumpsValid)
+	{
+		const size_t size = (size_t)mapWidth*mapHeight;
+
+		for (int i=0; i<JUMP_DIRS; i++)
+			jumps[i].resize(size);
+
+		jumpsMap.resize(size);
+
+		for (int y=0; y<mapHeight; y++)
+		{
+			memcpy(&jumpsMap[y*mapWidth], map[y], mapWidth);
+			BuildRowJumps(y);
+		}
+
+		BuildColumnJumps(0, mapWidth-1);
+		jumpsValid = true;
+		return true;
+	}
+
+	// the map is usually regenerated for each search, but only the small parts
+	// of it change (e.g. blocking areas of the characters); find the changed
+	// rectangle and only rebuild the jumps that could be affected by it
+	int x0 = mapWidth, y0 = mapHeight, x1 = -1, y1 = -1;
+
+	for (int y=0; y<mapHeight; y++)
+	{
+		const unsigned char *row = map[y];
+		unsigned char *saved = &jumpsMap[y*mapWidth];
+
+		if (memcmp(row, saved, mapWidth) == 0)
+			continue;
+
+		int first = 0, last = mapWidth-1;
+
+		while (row[first] == saved[first])
+			first++;
+
+		while (row[last] == saved[last])
+			last--;
+
+		x0 = std::min(x0, first);
+		x1 = std::max(x1, last);
+		y0 = std::min(y0, y);
+		y1 = y;
+		memcpy(saved, row, mapWidth);
+	}
+
+	if (y1 < 0)
+		return false;
+
+	// forced neighbors are tested on the adjacent rows and columns
+	for (int y = std::max(0, y0-1); y <= std::min(mapHeight-1, y1+1); y++)
+		BuildRowJumps(y);
+
+	BuildColumnJumps(std::max(0, x0-1), std::min(mapWidth-1, x1+1));
+	return true;
+}
+
+// same as FindOrthoJump, but takes the jump point from the tables,
+// and finds the cell closest to the target analytically
+int Navigation::FindOrthoJumpPrecomputed(int x, int y, int dx, int dy, int ex, int ey)
+{
+	const JumpDir dir = dx > 0 ? JUMP_EAST : (dx < 0 ? JUMP_WEST : (dy > 0 ? JUMP_SOUTH : JUMP_NORTH));
+	const unsigned short jump = jumps[dir][y*mapWidth + x];
+	const bool wall = (jump & JUMP_WALL) != 0;
+	const int steps = jump & ~JUMP_WALL;
+
+	// number of passable cells that the scan goes over
+	int last = wall ? steps-1 : steps;
+
+	// the scan stops early if it meets the target
+	int tsteps = -1;
+
+	if (!dy && ey == y)
+		tsteps = (ex - x) * dx;
+	else if (!dx && ex == x)
+		tsteps = (ey - y) * dy;
+
+	const bool target = tsteps >= 1 && tsteps <= last;
+
+	if (target)
+		last = tsteps;
+
+	if (last >= 1)
+	{
+		// distance to the target along the line is minimal at a single cell
+		const int s = iclamp(dx ? (ex - x) * dx : (ey - y) * dy, 1, last);
+		const int cx = x + dx*s;
+		const int cy = y + dy*s;
+		const int edist = ClosestDist(cx - ex, cy - ey);
+
+		if (edist < closest)
+		{
+			closest = edist;
+			cnode = PackSquare(cx, cy);
+		}
+	}
+
+	if (target)
+		return PackSquare(ex, ey);
+
+	if (wall)
+		return -1;
+
+	return PackSquare(x + dx*steps, y + dy*steps);
+}
+
 int Navigation::FindOrthoJump(int x, int y, int dx, int dy, int ex, int ey)
 {
 	assert((!dx || !dy) && (dx || dy));
 
+	if (jumpsValid)
+		return FindOrthoJumpPrecomputed(x, y, dx, dy, ex, ey);
+
 	for (;;)
 	{
 		x += dx;
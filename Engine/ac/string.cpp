@@ -21,6 +21,7 @@
 #include "ac/gamestate.h"
 #include "ac/global_translation.h"
 #include "ac/runtime_defines.h"
+#include "ac/textcache.h"
 #include "ac/dynobj/scriptstring.h"
 #include "ac/dynobj/dynobj_manager.h"
 #include "font/fonts.h"
@@ -324,6 +325,10 @@ size_t break_up_text_into_lines(const char *todis, bool apply_direction, SplitLi
     if (wii < 3)
         return 0;
 
+    // Same texts are often split again, e.g. when the labels or overlays are redrawn
+    if (textcache_get_lines(todis, apply_direction, wii, fonnt, max_lines, lines, longestline))
+        return lines.Count();
+
     bool compat_mode = loaded_game_file_version < kGameVersion_360;
     split_lines(todis, lines, wii, fonnt, compat_mode, max_lines);
 
@@ -348,6 +353,7 @@ size_t break_up_text_into_lines(const char *todis, bool apply_direction, SplitLi
         int line_length = get_text_width_outlined(lines[rr].GetCStr(), fonnt);
         longestline = std::max(longestline, line_length);
     }
+    textcache_put_lines(todis, apply_direction, wii, fonnt, max_lines, lines, longestline);
     return lines.Count();
 }
 
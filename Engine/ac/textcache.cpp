@@ -0,0 +1,250 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2026 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include "ac/textcache.h"
+#include <string.h>
+#include <vector>
+#include <allegro.h> // get_uformat
+#include "ac/gamesetupstruct.h"
+#include "font/fonts.h"
+#include "util/resourcecache.h"
+
+using namespace AGS::Common;
+
+extern GameSetupStruct game;
+
+namespace
+{
+
+inline size_t hash_combine(size_t seed, size_t value)
+{
+    return seed ^ (value + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+}
+
+struct TextLinesKey
+{
+    String Text;
+    int Width = 0;
+    int Font = 0;
+    bool ApplyDirection = false;
+    size_t MaxLines = 0u;
+
+    TextLinesKey() = default;
+    TextLinesKey(const String &text, int width, int font, bool apply_direction, size_t max_lines)
+        : Text(text), Width(width), Font(font), ApplyDirection(apply_direction), MaxLines(max_lines) {}
+
+    bool operator ==(const TextLinesKey &other) const
+    {
+        return Width == other.Width && Font == other.Font && ApplyDirection == other.ApplyDirection
+            && MaxLines == other.MaxLines && Text == other.Text;
+    }
+};
+
+struct TextLinesKeyHash
+{
+    size_t operator ()(const TextLinesKey &key) const
+    {
+        size_t hash = std::hash<String>()(key.Text);
+        hash = hash_combine(hash, key.Width);
+        hash = hash_combine(hash, key.Font);
+        hash = hash_combine(hash, key.ApplyDirection);
+        return hash_combine(hash, key.MaxLines);
+    }
+};
+
+struct TextLinesEntry
+{
+    std::vector<String> Lines;
+    int LongestLine = 0;
+    // Approximate memory taken by the entry, including its key;
+    // 0 means an invalid entry
+    size_t DataSize = 0u;
+};
+
+class TextLinesCache final :
+    public ResourceCache<TextLinesKey, TextLinesEntry, size_t, TextLinesKeyHash>
+{
+public:
+    TextLinesCache() : ResourceCache(DEFAULT_TEXTLINESCACHESIZE) {}
+
+private:
+    size_t CalcSize(const TextLinesEntry &item) override
+    {
+        return item.DataSize;
+    }
+};
+
+struct TextImageKey
+{
+    String Text;
+    TextImageParams Params;
+
+    TextImageKey() = default;
+    TextImageKey(const String &text, const TextImageParams &params)
+        : Text(text), Params(params) {}
+
+    bool operator ==(const TextImageKey &other) const
+    {
+        const TextImageParams &a = Params, &b = other.Params;
+        return a.Font == b.Font && a.WrapWidth == b.WrapWidth && a.Width == b.Width && a.Height == b.Height
+            && a.LineX == b.LineX && a.LineY == b.LineY && a.AlignWidth == b.AlignWidth && a.Align == b.Align
+            && a.TextColor == b.TextColor && a.OutlineColor == b.OutlineColor && Text == other.Text;
+    }
+};
+
+struct TextImageKeyHash
+{
+    size_t operator ()(const TextImageKey &key) const
+    {
+        const TextImageParams &p = key.Params;
+        size_t hash = std::hash<String>()(key.Text);
+        hash = hash_combine(hash, p.Font);
+        hash = hash_combine(hash, p.WrapWidth);
+        hash = hash_combine(hash, (p.Width << 16) ^ p.Height);
+        hash = hash_combine(hash, (p.LineX << 16) ^ p.LineY);
+        hash = hash_combine(hash, (p.AlignWidth << 4) ^ p.Align);
+        hash = hash_combine(hash, static_cast<uint32_t>(p.TextColor));
+        return hash_combine(hash, static_cast<uint32_t>(p.OutlineColor));
+    }
+};
+
+class TextImageCache final :
+    public ResourceCache<TextImageKey, std::shared_ptr<Bitmap>, size_t, TextImageKeyHash>
+{
+public:
+    TextImageCache() : ResourceCache(DEFAULT_TEXTIMAGECACHESIZE) {}
+
+private:
+    size_t CalcSize(const std::shared_ptr<Bitmap> &item) override
+    {
+        return item ? static_cast<size_t>(item->GetDataSize()) : 0u;
+    }
+};
+
+// The global state which the text layout and rendering depend on
+struct TextCacheContext
+{
+    uint32_t FontsRevision = 0u;
+    int UFormat = 0;
+    int RightToLeft = 0;
+    int AntiAliasFonts = 0;
+    int ColorDepth = 0;
+
+    bool operator !=(const TextCacheContext &other) const
+    {
+        return FontsRevision != other.FontsRevision || UFormat != other.UFormat
+            || RightToLeft != other.RightToLeft || AntiAliasFonts != other.AntiAliasFonts
+            || ColorDepth != other.ColorDepth;
+    }
+};
+
+TextLinesCache LinesCache;
+TextImageCache ImageCache;
+TextCacheContext CacheContext;
+uint32_t LinesHits = 0u, LinesMisses = 0u;
+uint32_t ImageHits = 0u, ImageMisses = 0u;
+
+// Clears the caches if anything that the cached results depend on was changed
+void validate_context()
+{
+    TextCacheContext context;
+    context.FontsRevision = get_fonts_revision();
+    context.UFormat = get_uformat();
+    context.RightToLeft = game.options[OPT_RIGHTLEFTWRITE];
+    context.AntiAliasFonts = game.options[OPT_ANTIALIASFONTS];
+    context.ColorDepth = game.GetColorDepth();
+    if (context != CacheContext)
+    {
+        LinesCache.Clear();
+        ImageCache.Clear();
+        CacheContext = context;
+    }
+}
+
+} // namespace
+
+bool textcache_get_lines(const char *text, bool apply_direction, int width, int font, size_t max_lines,
+    SplitLines &lines, int &longest_line)
+{
+    validate_context();
+    const TextLinesEntry &entry = LinesCache.Get(
+        TextLinesKey(String::Wrapper(text), width, font, apply_direction, max_lines));
+    if (entry.DataSize == 0u)
+    {
+        LinesMisses++;
+        return false;
+    }
+
+    LinesHits++;
+    lines.Reset();
+    for (const auto &line : entry.Lines)
+        lines.Add(line.GetCStr());
+    longest_line = entry.LongestLine;
+    return true;
+}
+
+void textcache_put_lines(const char *text, bool apply_direction, int width, int font, size_t max_lines,
+    const SplitLines &lines, int longest_line)
+{
+    validate_context();
+    TextLinesEntry entry;
+    entry.DataSize = sizeof(TextLinesKey) + sizeof(TextLinesEntry) + strlen(text);
+    entry.Lines.reserve(lines.Count());
+    for (size_t i = 0; i < lines.Count(); ++i)
+    {
+        entry.Lines.push_back(lines[i]);
+        entry.DataSize += sizeof(String) + lines[i].GetLength();
+    }
+    entry.LongestLine = longest_line;
+    // The key must own a copy of the text
+    LinesCache.Put(TextLinesKey(String(text), width, font, apply_direction, max_lines), std::move(entry));
+}
+
+std::unique_ptr<Bitmap> textcache_get_image(const char *text, const TextImageParams &params)
+{
+    validate_context();
+    const auto &image = ImageCache.Get(TextImageKey(String::Wrapper(text), params));
+    if (!image)
+    {
+        ImageMisses++;
+        return nullptr;
+    }
+
+    ImageHits++;
+    return std::unique_ptr<Bitmap>(BitmapHelper::CreateBitmapCopy(image.get()));
+}
+
+void textcache_put_image(const char *text, const TextImageParams &params, const Bitmap &image)
+{
+    validate_context();
+    std::shared_ptr<Bitmap> copy(BitmapHelper::CreateBitmapCopy(&image));
+    if (!copy)
+        return;
+    ImageCache.Put(TextImageKey(String(text), params), std::move(copy));
+}
+
+void textcache_clear()
+{
+    LinesCache.Clear();
+    ImageCache.Clear();
+}
+
+void textcache_get_stats(uint32_t &lines_hits, uint32_t &lines_misses,
+    uint32_t &image_hits, uint32_t &image_misses, size_t &image_cache_size)
+{
+    lines_hits = LinesHits;
+    lines_misses = LinesMisses;
+    image_hits = ImageHits;
+    image_misses = ImageMisses;
+    image_cache_size = ImageCache.GetCacheSize();
+}
@@ -0,0 +1,75 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2026 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+//
+// Text layout cache: remembers the lines which the texts were split into,
+// and the images of the plain text overlays (speech, textual overlays),
+// so that the same text displayed again does not have to be measured and
+// rendered anew.
+//
+// Cached results depend on the fonts, the text format and the game's
+// rendering settings; the cache clears itself whenever any of these change.
+//
+//=============================================================================
+#ifndef __AGS_EE_AC__TEXTCACHE_H
+#define __AGS_EE_AC__TEXTCACHE_H
+
+#include <memory>
+#include "gfx/bitmap.h"
+#include "platform/types.h"
+#include "util/geometry.h"
+
+class SplitLines;
+
+// Lines cache limit, in bytes
+const size_t DEFAULT_TEXTLINESCACHESIZE = 256u * 1024;
+// Text images cache limit, in bytes
+const size_t DEFAULT_TEXTIMAGECACHESIZE = 4u * 1024 * 1024;
+
+// Parameters of the plain text image
+struct TextImageParams
+{
+    int Font = 0;
+    // Width by which the text was split into lines
+    int WrapWidth = 0;
+    // Image size
+    int Width = 0;
+    int Height = 0;
+    // Position of the first line
+    int LineX = 0;
+    int LineY = 0;
+    // Width within which the lines are aligned
+    int AlignWidth = 0;
+    HorAlignment Align = kHAlignNone;
+    color_t TextColor = 0;
+    color_t OutlineColor = 0;
+};
+
+// Looks up the lines which the text was split into with these parameters;
+// on success fills the lines and the width of the longest one
+bool textcache_get_lines(const char *text, bool apply_direction, int width, int font, size_t max_lines,
+    SplitLines &lines, int &longest_line);
+// Remembers the lines which the text was split into
+void textcache_put_lines(const char *text, bool apply_direction, int width, int font, size_t max_lines,
+    const SplitLines &lines, int longest_line);
+// Returns a copy of the cached text image, or null if there's none
+std::unique_ptr<AGS::Common::Bitmap> textcache_get_image(const char *text, const TextImageParams &params);
+// Remembers a copy of the text image
+void textcache_put_image(const char *text, const TextImageParams &params, const AGS::Common::Bitmap &image);
+// Disposes all the cached lines and images
+void textcache_clear();
+// Gets the cache usage statistics
+void textcache_get_stats(uint32_t &lines_hits, uint32_t &lines_misses,
+    uint32_t &image_hits, uint32_t &image_misses, size_t &image_cache_size);
+
+#endif // __AGS_EE_AC__TEXTCACHE_H
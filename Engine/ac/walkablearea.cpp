@@ -21,11 +21,13 @@
 #include "ac/room.h"
 #include "ac/roomobject.h"
 #include "ac/roomstatus.h"
+#include "ac/route_finder.h"
 #include "ac/walkablearea.h"
 #include "game/roomstruct.h"
 #include "gfx/bitmap.h"
 
 using namespace AGS::Common;
+using namespace AGS::Engine;
 
 extern RoomStruct thisroom;
 extern GameSetupStruct game;
@@ -34,20 +36,37 @@ extern RoomStatus*croom;
 extern RoomObject*objs;
 
 Bitmap *walkareabackup=nullptr, *walkable_areas_temp = nullptr;
+// Distances to the nearest walkable pixels of the room mask
+MaskDistanceField walkable_distance;
+// Whether the room mask may be changed without the engine knowing
+bool walkable_mask_untracked = false;
 
 void redo_walkable_areas()
 {
-    thisroom.WalkAreaMask->Blit(walkareabackup, 0, 0);
+    // Track which part of the mask changes its walkability
+    int changed_x0 = INT32_MAX, changed_y0 = INT32_MAX, changed_x1 = -1, changed_y1 = -1;
     for (int h = 0; h < walkareabackup->GetHeight(); ++h)
     {
+        const uint8_t *backup_scanline = walkareabackup->GetScanLine(h);
         uint8_t *walls_scanline = thisroom.WalkAreaMask->GetScanLineForWriting(h);
         for (int w = 0; w < walkareabackup->GetWidth(); ++w)
         {
-            if ((walls_scanline[w] >= sizeof(play.walkable_areas_on)) ||
-                    (play.walkable_areas_on[walls_scanline[w]] == 0))
-                walls_scanline[w] = 0;
+            uint8_t area = backup_scanline[w];
+            if ((area >= sizeof(play.walkable_areas_on)) ||
+                    (play.walkable_areas_on[area] == 0))
+                area = 0;
+            if ((area > 0) != (walls_scanline[w] > 0))
+            {
+                changed_x0 = std::min(changed_x0, w);
+                changed_x1 = std::max(changed_x1, w);
+                changed_y0 = std::min(changed_y0, h);
+                changed_y1 = h;
+            }
+            walls_scanline[w] = area;
         }
     }
+    if (changed_x1 >= 0)
+        invalidate_walkable_area_search(Rect(changed_x0, changed_y0, changed_x1, changed_y1));
 }
 
 int get_walkable_area_pixel(int x, int y)
@@ -208,3 +227,27 @@ int get_walkable_area_at_character (int charnum) {
     CharacterInfo *chin = &game.chars[charnum];
     return get_walkable_area_at_location(chin->x, chin->y);
 }
+
+void reset_walkable_area_search()
+{
+    walkable_distance.SetMask(thisroom.WalkAreaMask.get());
+    walkable_mask_untracked = false;
+}
+
+void invalidate_walkable_area_search(const Rect &mask_area)
+{
+    walkable_distance.Invalidate(mask_area);
+}
+
+void untrack_walkable_area_search()
+{
+    walkable_mask_untracked = true;
+}
+
+bool find_nearest_walkable_point(const Point &from_pt, Point &dst_pt, const Rect &limits, int range, int step)
+{
+    // While the mask is open for drawing, it may change anytime
+    if (walkable_mask_untracked || get_room_mask_surface(kRoomAreaWalkable))
+        return Pathfinding::FindNearestWalkablePoint(thisroom.WalkAreaMask.get(), from_pt, dst_pt, limits, range, step);
+    return walkable_distance.FindNearestWalkablePoint(from_pt, dst_pt, limits, range, step);
+}
@@ -27,5 +27,16 @@ void  remove_walkable_areas_from_temp(const Rect &area);
 Common::Bitmap *prepare_walkable_areas (int sourceChar);
 int   get_walkable_area_at_location(int xx, int yy);
 int   get_walkable_area_at_character (int charnum);
+// Resets the nearest walkable point search for the newly loaded room mask
+void  reset_walkable_area_search();
+// Notifies that the walkable mask was changed within the given area (in mask coordinates)
+void  invalidate_walkable_area_search(const Rect &mask_area);
+// Notifies that the walkable mask was given out for direct modification,
+// which cannot be tracked; the search will always scan the mask until the room changes
+void  untrack_walkable_area_search();
+// Searchs for the nearest walkable point on the room's walkable mask, in mask coordinates;
+// see Pathfinding::FindNearestWalkablePoint
+bool  find_nearest_walkable_point(const Point &from_pt, Point &dst_pt,
+                                  const Rect &limits, int range = 0, int step = 1);
 
 #endif // __AGS_EE_AC__WALKABLEAREA_H
@@ -27,14 +27,23 @@ extern RoomStruct thisroom;
 extern IGraphicsDriver *gfxDriver;
 extern RoomStatus *croom;
 
+// A vertical run of the same WB area in the mask column
+struct WalkBehindSpan
+{
+    int Y1 = 0, Y2 = 0; // run's top and bottom (exclusive) Y coords
+    int WB = 0; // WB area index
+};
+
 // An info on vertical column of walk-behind mask, which may contain WB area
 struct WalkBehindColumn
 {
     bool Exists = false; // whether any WB area is in this column
     int Y1 = 0, Y2 = 0; // WB top and bottom Y coords
+    uint32_t FirstSpan = 0u, SpanCount = 0u; // column's runs in walkBehindSpans
 };
 
 std::vector<WalkBehindColumn> walkBehindCols; // precalculated WB positions
+std::vector<WalkBehindSpan> walkBehindSpans; // WB runs of all the columns, top to bottom
 Rect walkBehindAABB[MAX_WALK_BEHINDS]; // WB bounding box
 int walkBehindsCachedForBgNum = -1; // WB textures are for this background
 bool noWalkBehindsAtAll = false; // quick report that no WBs in this room
@@ -91,18 +100,16 @@ void walkbehinds_generate_sprites()
     walkBehindsCachedForBgNum = play.bg_frame;
 }
 
-// Edits the given game object's sprite, cutting out pixels covered by walk-behinds;
-// returns whether any pixels were updated;
-bool walkbehinds_cropout(Bitmap *sprit, int sprx, int spry, int basel)
+// Cuts out sprite pixels covered by walk-behinds, filling whole vertical
+// runs of the WB areas with the mask color
+template <typename TPx>
+static bool walkbehinds_cropout_spans(Bitmap *sprit, int sprx, int spry, int basel)
 {
-    if (noWalkBehindsAtAll)
-        return false;
-
-    const int maskcol = sprit->GetMaskColor();
-    const int spcoldep = sprit->GetColorDepth();
+    const TPx maskcol = static_cast<TPx>(sprit->GetMaskColor());
+    const int spr_height = sprit->GetHeight();
 
     bool pixels_changed = false;
-    // pass along the sprite's pixels, but skip those that lie outside the mask
+    // pass along the sprite's columns, but skip those that lie outside the mask
     for (int x = std::max(0, 0 - sprx);
         (x < sprit->GetWidth()) && (x + sprx < thisroom.WalkBehindMask->GetWidth()); ++x)
     {
@@ -111,44 +118,77 @@ bool walkbehinds_cropout(Bitmap *sprit, int sprx, int spry, int basel)
         // skip if no area, or sprite lies outside of all areas in this column
         if ((!wbcol.Exists) ||
             (wbcol.Y2 <= spry) ||
-            (wbcol.Y1 > spry + sprit->GetHeight()))
+            (wbcol.Y1 >= spry + spr_height))
             continue;
 
-        // ensure we only check within the valid areas (between Y1 and Y2)
-        // we assume that Y1 and Y2 are always within the mask
-        for (int y = std::max(0, wbcol.Y1 - spry);
-            (y < sprit->GetHeight()) && (y + spry < wbcol.Y2); ++y)
+        const WalkBehindSpan *span = &walkBehindSpans[wbcol.FirstSpan];
+        const WalkBehindSpan *span_end = span + wbcol.SpanCount;
+        for (; (span != span_end) && (span->Y1 < spry + spr_height); ++span)
         {
-            const int wb = thisroom.WalkBehindMask->GetScanLine(y + spry)[x + sprx];
-            if (wb < 1) continue; // "no area"
-            if (croom->walkbehind_base[wb] <= basel) continue;
+            if ((span->Y2 <= spry) || (croom->walkbehind_base[span->WB] <= basel))
+                continue;
 
             pixels_changed = true;
-            uint8_t *dst_line = sprit->GetScanLineForWriting(y);
-            switch (spcoldep)
-            {
-            case 8:
-                dst_line[x] = maskcol;
-                break;
-            case 16:
-                reinterpret_cast<uint16_t*>(dst_line)[x] = maskcol;
-                break;
-            case 32:
-                reinterpret_cast<uint32_t*>(dst_line)[x] = maskcol;
-                break;
-            default:
-                assert(0);
-                break;
-            }
+            const int y2 = std::min(span->Y2 - spry, spr_height);
+            for (int y = std::max(0, span->Y1 - spry); y < y2; ++y)
+                reinterpret_cast<TPx*>(sprit->GetScanLineForWriting(y))[x] = maskcol;
         }
     }
     return pixels_changed;
 }
 
+// Edits the given game object's sprite, cutting out pixels covered by walk-behinds;
+// returns whether any pixels were updated;
+bool walkbehinds_cropout(Bitmap *sprit, int sprx, int spry, int basel)
+{
+    if (noWalkBehindsAtAll)
+        return false;
+
+    switch (sprit->GetColorDepth())
+    {
+    case 8:
+        return walkbehinds_cropout_spans<uint8_t>(sprit, sprx, spry, basel);
+    case 16:
+        return walkbehinds_cropout_spans<uint16_t>(sprit, sprx, spry, basel);
+    case 32:
+        return walkbehinds_cropout_spans<uint32_t>(sprit, sprx, spry, basel);
+    default:
+        assert(0);
+        return false;
+    }
+}
+
+bool walkbehinds_intersect(const Bitmap *sprit, int sprx, int spry, int basel)
+{
+    if (noWalkBehindsAtAll)
+        return false;
+
+    const int spr_height = sprit->GetHeight();
+    for (int x = std::max(0, 0 - sprx);
+        (x < sprit->GetWidth()) && (x + sprx < thisroom.WalkBehindMask->GetWidth()); ++x)
+    {
+        const auto &wbcol = walkBehindCols[x + sprx];
+        if ((!wbcol.Exists) ||
+            (wbcol.Y2 <= spry) ||
+            (wbcol.Y1 >= spry + spr_height))
+            continue;
+
+        const WalkBehindSpan *span = &walkBehindSpans[wbcol.FirstSpan];
+        const WalkBehindSpan *span_end = span + wbcol.SpanCount;
+        for (; (span != span_end) && (span->Y1 < spry + spr_height); ++span)
+        {
+            if ((span->Y2 > spry) && (croom->walkbehind_base[span->WB] > basel))
+                return true;
+        }
+    }
+    return false;
+}
+
 void walkbehinds_recalc()
 {
     // Reset all data
     walkBehindCols.clear();
+    walkBehindSpans.clear();
     for (int wb = 0; wb < MAX_WALK_BEHINDS; ++wb)
     {
         walkBehindAABB[wb] = Rect(INT32_MAX, INT32_MAX, INT32_MIN, INT32_MIN);
@@ -161,6 +201,7 @@ void walkbehinds_recalc()
     for (int col = 0; col < mask->GetWidth(); ++col)
     {
         auto &wbcol = walkBehindCols[col];
+        wbcol.FirstSpan = static_cast<uint32_t>(walkBehindSpans.size());
         for (int y = 0; y < mask->GetHeight(); ++y)
         {
             int wb = mask->GetScanLine(y)[col];
@@ -173,6 +214,21 @@ void walkbehinds_recalc()
                     wbcol.Exists = true;
                     noWalkBehindsAtAll = false;
                 }
+                // continue the current run, or begin a new one
+                if ((wbcol.SpanCount > 0) && (walkBehindSpans.back().WB == wb) &&
+                    (walkBehindSpans.back().Y2 == y))
+                {
+                    walkBehindSpans.back().Y2 = y + 1;
+                }
+                else
+                {
+                    WalkBehindSpan span;
+                    span.Y1 = y;
+                    span.Y2 = y + 1;
+                    span.WB = wb;
+                    walkBehindSpans.push_back(span);
+                    wbcol.SpanCount++;
+                }
                 wbcol.Y2 = y + 1; // +1 to allow bottom line of screen to work (CHECKME??)
                 // resize the bounding rect
                 walkBehindAABB[wb].Left = std::min(col, walkBehindAABB[wb].Left);
@@ -43,6 +43,8 @@ void walkbehinds_generate_sprites();
 // Edits the given game object's sprite, cutting out pixels covered by walk-behinds;
 // returns whether any pixels were updated
 bool walkbehinds_cropout(Common::Bitmap *sprit, int sprx, int spry, int basel);
+// Tests whether any pixels of the given game object's sprite are covered by walk-behinds
+bool walkbehinds_intersect(const Common::Bitmap *sprit, int sprx, int spry, int basel);
 
 extern bool noWalkBehindsAtAll;
 extern int walkBehindsCachedForBgNum;
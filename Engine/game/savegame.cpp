@@ -34,6 +34,7 @@
 #include "ac/string.h"
 #include "ac/system.h"
 #include "ac/timer.h"
+#include "ac/walkablearea.h"
 #include "ac/dynobj/dynobj_manager.h"
 #include "ac/dynobj/cc_dynamicarray.h"
 #include "ac/dynobj/scriptuserobject.h"
@@ -879,6 +880,8 @@ HSaveError DoAfterRestore(const PreservedParams &pp, RestoredData &r_data, SaveC
                 thisroom.CopyMask(static_cast<RoomAreaMask>(i), r_data.RoomMask[i].get());
             }
         }
+        if (r_data.RoomMask[kRoomAreaWalkable])
+            invalidate_walkable_area_search(RectWH(thisroom.WalkAreaMask->GetSize()));
 
         in_new_room = kEnterRoom_RestoredSave;  // don't run "enters screen" events
         // now that room has loaded, copy saved light levels in
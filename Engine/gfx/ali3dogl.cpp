@@ -75,8 +75,12 @@ OGLTexture::~OGLTexture()
 {
     if (_tiles)
     {
-        for (size_t i = 0; i < _numTiles; ++i)
-            glDeleteTextures(1, &(_tiles[i].texture));
+        // Atlas regions share the GL textures of their page
+        if (!_page)
+        {
+            for (size_t i = 0; i < _numTiles; ++i)
+                glDeleteTextures(1, &(_tiles[i].texture));
+        }
         delete[] _tiles;
     }
     if (_vertex)
@@ -88,6 +92,8 @@ OGLTexture::~OGLTexture()
 size_t OGLTexture::GetMemSize() const
 {
     // FIXME: a proper size in video memory, check OpenGL docs
+    if (_page)
+        return Res.Width * Res.Height * 4; // only a part of the page
     size_t sz = 0u;
     for (size_t i = 0; i < _numTiles; ++i)
         sz += _tiles[i].allocWidth * _tiles[i].allocHeight * 4;
@@ -890,6 +896,7 @@ void OGLGraphicsDriver::GetCopyOfScreenIntoDDB(IDriverDependantBitmap *target, u
             PlaneScaling(), GL_NEAREST, GL_CLAMP);
         SetBackbufferState(&backbuffer, true);
         RenderTexture(_nativeSurface, 0, 0, backbuffer.Projection, glmex::identity(), SpriteColorTransform(), surf_sz);
+        bitmap->GetTexture()->MarkModified();
     }
 }
 
@@ -964,6 +971,15 @@ void OGLGraphicsDriver::Render()
 
 void OGLGraphicsDriver::Render(int /*xoff*/, int /*yoff*/, GraphicFlip /*flip*/)
 {
+    _lastFrameSkipped = !ShouldRenderFrame(_spriteList);
+    if (_lastFrameSkipped)
+    {
+        // Keep the previous frame on screen, and only reset the lists
+        BackupDrawLists();
+        ClearDrawLists();
+        ResetFxPool();
+        return;
+    }
     RenderAndPresent(true);
 }
 
@@ -981,6 +997,7 @@ void OGLGraphicsDriver::Render(IDriverDependantBitmap *target)
         glm::ortho(0.0f, (float)surf_sz.Width, 0.0f, (float)surf_sz.Height, 0.0f, 1.0f),
         PlaneScaling(), GL_NEAREST, GL_CLAMP);
     RenderToSurface(&backbuffer, true);
+    bitmap->GetTexture()->MarkModified();
 }
 
 void OGLGraphicsDriver::RenderSprite(const OGLDrawListEntry *drawListEntry,
@@ -1661,7 +1678,7 @@ void OGLGraphicsDriver::UpdateTextureRegion(OGLTextureTile *tile, const Bitmap *
   }
 
   glBindTexture(GL_TEXTURE_2D, tile->texture);
-  glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, tileWidth, tileHeight, GL_RGBA, GL_UNSIGNED_BYTE, origPtr);
+  glTexSubImage2D(GL_TEXTURE_2D, 0, tile->texx, tile->texy, tileWidth, tileHeight, GL_RGBA, GL_UNSIGNED_BYTE, origPtr);
 
   delete []origPtr;
 }
@@ -1693,6 +1710,79 @@ void OGLGraphicsDriver::UpdateTexture(Texture *txdata, const Bitmap *bitmap, boo
 
   if (color_depth == 8)
       unselect_palette();
+
+  txdata->MarkModified();
+}
+
+void OGLGraphicsDriver::UpdateTextureSubRegion(OGLTextureTile *tile, const Bitmap *bitmap, const Rect &area, bool has_alpha, bool opaque)
+{
+  // Tile's image is offset by the edge pixels, see UpdateTextureRegion
+  const int texxoff = (tile->allocWidth > tile->width) ? std::min(tile->allocWidth - tile->width - 1, 1) : 0;
+  const int texyoff = (tile->allocHeight > tile->height) ? std::min(tile->allocHeight - tile->height - 1, 1) : 0;
+
+  TextureTile subTile;
+  subTile.x = area.Left;
+  subTile.y = area.Top;
+  subTile.width = area.GetWidth();
+  subTile.height = area.GetHeight();
+  std::vector<uint32_t> buf(subTile.width * subTile.height);
+  uint8_t *memPtr = reinterpret_cast<uint8_t*>(buf.data());
+  const int pitch = subTile.width * sizeof(uint32_t);
+
+  assert(!opaque || !has_alpha); // has_alpha is meaningless with opaque
+  if (opaque)
+    BitmapToVideoMemOpaque(bitmap, &subTile, memPtr, pitch);
+  else
+    BitmapToVideoMem(bitmap, &subTile, memPtr, pitch, has_alpha, false);
+
+  glBindTexture(GL_TEXTURE_2D, tile->texture);
+  glTexSubImage2D(GL_TEXTURE_2D, 0,
+    tile->texx + texxoff + (area.Left - tile->x), tile->texy + texyoff + (area.Top - tile->y),
+    subTile.width, subTile.height, GL_RGBA, GL_UNSIGNED_BYTE, memPtr);
+}
+
+void OGLGraphicsDriver::UpdateTexture(Texture *txdata, const Bitmap *bitmap, const Rect &area, bool has_alpha, bool opaque)
+{
+  const int color_depth = bitmap->GetColorDepth();
+  if (bitmap->GetColorDepth() != txdata->Res.ColorDepth)
+    throw Ali3DException("UpdateDDBFromBitmap: mismatched colour depths");
+  if (txdata->Res.Width != bitmap->GetWidth() || txdata->Res.Height != bitmap->GetHeight())
+    throw Ali3DException("UpdateDDBFromBitmap: mismatched bitmap size");
+
+  const Rect dirty = IntersectRects(area, RectWH(0, 0, bitmap->GetWidth(), bitmap->GetHeight()));
+  if (dirty.IsEmpty())
+    return;
+  // Linear filtering fix makes each pixel depend on its neighbours, update everything
+  const bool usingLinearFiltering = _filter->UseLinearFiltering() || (_smoothScaling && has_alpha);
+  if (usingLinearFiltering)
+  {
+    UpdateTexture(txdata, bitmap, has_alpha, opaque);
+    return;
+  }
+
+  if (color_depth == 8)
+      select_palette(palette);
+
+  auto *ogldata = reinterpret_cast<OGLTexture*>(txdata);
+  for (size_t i = 0; i < ogldata->_numTiles; ++i)
+  {
+    auto &tile = ogldata->_tiles[i];
+    const Rect tile_rc = RectWH(tile.x, tile.y, tile.width, tile.height);
+    const Rect sub = IntersectRects(dirty, tile_rc);
+    if (sub.IsEmpty())
+      continue;
+    // Tile edges are copied to the surrounding pixels, update whole tile if they change
+    if (sub.Left == tile_rc.Left || sub.Top == tile_rc.Top ||
+        sub.Right == tile_rc.Right || sub.Bottom == tile_rc.Bottom)
+      UpdateTextureRegion(&tile, bitmap, has_alpha, opaque);
+    else
+      UpdateTextureSubRegion(&tile, bitmap, sub, has_alpha, opaque);
+  }
+
+  if (color_depth == 8)
+      unselect_palette();
+
+  txdata->MarkModified();
 }
 
 int OGLGraphicsDriver::GetCompatibleBitmapFormat(int color_depth)
@@ -1804,6 +1894,41 @@ std::shared_ptr<Texture> OGLGraphicsDriver::GetTexture(IDriverDependantBitmap *d
     return std::static_pointer_cast<Texture>((reinterpret_cast<OGLBitmap*>(ddb))->GetSharedTexture());
 }
 
+Texture *OGLGraphicsDriver::CreateTextureRegion(std::shared_ptr<Texture> page, const Rect &region, int color_depth)
+{
+  // Only the regular single-tile textures may serve as atlas pages
+  auto ogl_page = std::static_pointer_cast<OGLTexture>(page);
+  if (!ogl_page || ogl_page->RenderTarget || ogl_page->_page || ogl_page->_numTiles != 1)
+    return nullptr;
+  const OGLTextureTile &page_tile = ogl_page->_tiles[0];
+  // Need a pixel around the region for the clamped edges, see UpdateTextureRegion
+  if (region.IsEmpty() || region.Left < 1 || region.Top < 1 ||
+      region.Right + 1 >= page_tile.width || region.Bottom + 1 >= page_tile.height)
+    return nullptr;
+
+  auto *txdata = new OGLTexture(GraphicResolution(region.GetWidth(), region.GetHeight(), color_depth), false);
+  txdata->_page = ogl_page;
+  txdata->_numTiles = 1;
+  txdata->_tiles = new OGLTextureTile[1];
+  OGLTextureTile &tile = txdata->_tiles[0];
+  tile.width = region.GetWidth();
+  tile.height = region.GetHeight();
+  tile.allocWidth = page_tile.allocWidth;
+  tile.allocHeight = page_tile.allocHeight;
+  tile.texture = page_tile.texture;
+  tile.texx = region.Left - 1;
+  tile.texy = region.Top - 1;
+
+  txdata->_vertex = new OGLCUSTOMVERTEX[4];
+  for (int i = 0; i < 4; ++i)
+  {
+    txdata->_vertex[i] = defaultVertices[i];
+    txdata->_vertex[i].tu = (float)((defaultVertices[i].tu > 0.0) ? region.Right + 1 : region.Left) / (float)tile.allocWidth;
+    txdata->_vertex[i].tv = (float)((defaultVertices[i].tv > 0.0) ? region.Bottom + 1 : region.Top) / (float)tile.allocHeight;
+  }
+  return txdata;
+}
+
 Texture *OGLGraphicsDriver::CreateTexture(int width, int height, int color_depth, int txflags)
 {
   assert(width > 0);
@@ -60,6 +60,9 @@ struct OGLCUSTOMVERTEX
 struct OGLTextureTile : public TextureTile
 {
     unsigned int texture = 0;
+    // Position of the tile's pixels inside the GL texture, including the
+    // clamped edges; non-zero only when the texture is an atlas page
+    int texx = 0, texy = 0;
 };
 
 // Full OpenGL texture data
@@ -68,6 +71,8 @@ struct OGLTexture : Texture
     OGLCUSTOMVERTEX *_vertex = nullptr;
     OGLTextureTile *_tiles = nullptr;
     size_t _numTiles = 0;
+    // The atlas page, if this texture is its region; the page owns GL textures
+    std::shared_ptr<OGLTexture> _page;
 
     OGLTexture(const GraphicResolution &res, bool rt)
         : Texture(res, rt) {}
@@ -241,6 +246,7 @@ public:
     bool DoesSupportVsyncToggle() override { return _capsVsync; }
     void RenderSpritesAtScreenResolution(bool enabled) override;
     void UseSmoothScaling(bool enabled) override { _smoothScaling = enabled; }
+    void SetRenderThreads(int /*count*/) override { }
     bool SupportsGammaControl() override;
     void SetGamma(int newGamma) override;
 
@@ -264,8 +270,11 @@ public:
 
     // Create texture data with the given parameters
     Texture *CreateTexture(int width, int height, int color_depth, int txflags) override;
+    // Create texture data which refers to a region of another texture
+    Texture *CreateTextureRegion(std::shared_ptr<Texture> page, const Rect &region, int color_depth) override;
     // Update texture data from the given bitmap
     void UpdateTexture(Texture *txdata, const Bitmap *bitmap, bool has_alpha, bool opaque) override;
+    void UpdateTexture(Texture *txdata, const Bitmap *bitmap, const Rect &area, bool has_alpha, bool opaque) override;
     // Retrieve shared texture data object from the given DDB
     std::shared_ptr<Texture> GetTexture(IDriverDependantBitmap *ddb) override;
 
@@ -343,6 +352,8 @@ private:
     //
     void AdjustSizeToNearestSupportedByCard(int *width, int *height);
     void UpdateTextureRegion(OGLTextureTile *tile, const Bitmap *bitmap, bool has_alpha, bool opaque);
+    // Updates only the given area of the tile, which must not touch the tile's edges
+    void UpdateTextureSubRegion(OGLTextureTile *tile, const Bitmap *bitmap, const Rect &area, bool has_alpha, bool opaque);
 
     ///////////////////////////////////////////////////////
     // Shader management: implementation
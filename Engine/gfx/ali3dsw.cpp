@@ -17,6 +17,7 @@
 #include <stack>
 #include "ac/sys_events.h"
 #include "gfx/ali3dexception.h"
+#include "gfx/blender.h"
 #include "gfx/gfxfilter_sdl_renderer.h"
 #include "gfx/gfxfilter_aa_sdl_renderer.h"
 #include "gfx/gfx_util.h"
@@ -34,9 +35,6 @@ namespace ALSW
 
 using namespace Common;
 
-static uint32_t _trans_alpha_blender32(uint32_t x, uint32_t y, uint32_t n);
-
-
 // ----------------------------------------------------------------------------
 // SDLRendererGraphicsDriver
 // ----------------------------------------------------------------------------
@@ -578,7 +576,7 @@ void SDLRendererGraphicsDriver::RenderToBackBuffer()
 
 size_t SDLRendererGraphicsDriver::RenderSpriteBatch(const ALSpriteBatch &batch, size_t from, Bitmap *surface, int surf_offx, int surf_offy)
 {
-  for (; (from < _spriteList.size()) && (_spriteList[from].node == batch.ID); ++from)
+  while ((from < _spriteList.size()) && (_spriteList[from].node == batch.ID))
   {
     const auto &sprite = _spriteList[from];
     if (sprite.ddb == nullptr)
@@ -589,6 +587,7 @@ size_t SDLRendererGraphicsDriver::RenderSpriteBatch(const ALSpriteBatch &batch,
         throw Ali3DException("Unhandled attempt to draw null sprite");
       // Stage surface could have been replaced by plugin
       surface = _stageVirtualScreen;
+      ++from;
       continue;
     }
     else if (sprite.ddb == reinterpret_cast<ALSoftwareBitmap*>(DRAWENTRY_TINT))
@@ -596,9 +595,41 @@ size_t SDLRendererGraphicsDriver::RenderSpriteBatch(const ALSpriteBatch &batch,
       // draw screen tint fx
       set_trans_blender(_tint_red, _tint_green, _tint_blue, 0);
       surface->LitBlendBlt(surface, 0, 0, 128);
+      ++from;
       continue;
     }
 
+    // Find the run of sprites which may be drawn concurrently; it is ended by
+    // the tint and plugin events, which work with the whole surface, and
+    // by the sprites which have to be drawn using Allegro's blender modes.
+    size_t run_end = from;
+    if (_bandRender.GetBandCount(surface) > 1)
+    {
+      for (; (run_end < _spriteList.size()) && (_spriteList[run_end].node == batch.ID) &&
+             CanRenderInBands(_spriteList[run_end], surface); ++run_end);
+    }
+
+    if (run_end - from > 1)
+    {
+      // Each band draws the whole run in order, clipped by its own borders
+      _bandRender.Draw(surface, [this, from, run_end, surf_offx, surf_offy](Bitmap *band, int band_y)
+      {
+        for (size_t i = from; i < run_end; ++i)
+          RenderSprite(_spriteList[i], band, surf_offx, surf_offy - band_y);
+      });
+      from = run_end;
+    }
+    else
+    {
+      RenderSprite(sprite, surface, surf_offx, surf_offy);
+      ++from;
+    }
+  }
+  return from;
+}
+
+void SDLRendererGraphicsDriver::RenderSprite(const ALDrawListEntry &sprite, Bitmap *surface, int surf_offx, int surf_offy)
+{
     ALSoftwareBitmap* bitmap = sprite.ddb;
     int drawAtX = sprite.x + surf_offx;
     int drawAtY = sprite.y + surf_offy;
@@ -616,6 +647,11 @@ size_t SDLRendererGraphicsDriver::RenderSpriteBatch(const ALSpriteBatch &batch,
         // Allegro 4 **does not have such function ready** :( (only masked blends, where it skips magenta pixels);
         // I am leaving this problem for the future, as coincidentally software mode does not need this atm.
     }
+    else if (has_alpha && (surface->GetColorDepth() == 32) && (native_bmp->GetColorDepth() == 32))
+    {
+      GfxUtil::DrawSpriteRowBlend(surface, native_bmp, drawAtX, drawAtY,
+          (alpha == 255) ? kRowBlend_Alpha : kRowBlend_TransAlpha, alpha);
+    }
     else if (has_alpha)
     {
       if (alpha == 255) // no global transparency, simple alpha blend
@@ -631,8 +667,17 @@ size_t SDLRendererGraphicsDriver::RenderSpriteBatch(const ALSpriteBatch &batch,
       GfxUtil::DrawSpriteWithTransparency(surface, native_bmp, drawAtX, drawAtY,
           alpha);
     }
-  }
-  return from;
+}
+
+bool SDLRendererGraphicsDriver::CanRenderInBands(const ALDrawListEntry &sprite, const Bitmap *surface)
+{
+    if ((sprite.ddb == nullptr) || (sprite.ddb == reinterpret_cast<ALSoftwareBitmap*>(DRAWENTRY_TINT)))
+        return false;
+    // 32-bit sprites over 32-bit surface are drawn either with a plain or
+    // masked blit, or with the row blenders, none of which use global state
+    const Bitmap *native_bmp = sprite.ddb->GetBitmap();
+    return (surface->GetColorDepth() == 32) && (native_bmp->GetColorDepth() == 32) &&
+        (native_bmp != surface);
 }
 
 void SDLRendererGraphicsDriver::BlitToTexture()
@@ -786,28 +831,6 @@ bool SDLRendererGraphicsDriver::GetCopyOfScreenIntoBitmap(Bitmap *destination, c
   return true;
 }
 
-// add the alpha values together, used for compositing alpha images
-// TODO: why is this here, move to gfx/blender? check if there's already similar function there
-static uint32_t _trans_alpha_blender32(uint32_t x, uint32_t y, uint32_t n)
-{
-   uint32_t res, g;
-
-   n = (n * geta32(x)) / 256;
-
-   if (n)
-      n++;
-
-   res = ((x & 0xFF00FF) - (y & 0xFF00FF)) * n / 256 + y;
-   y &= 0xFF00;
-   x &= 0xFF00;
-   g = (x - y) * n / 256 + y;
-
-   res &= 0xFF00FF;
-   g &= 0xFF00;
-
-   return res | g;
-}
-
 bool SDLRendererGraphicsDriver::SetVsyncImpl(bool enabled, bool &vsync_res)
 {
 #if SDL_VERSION_ATLEAST(2, 0, 18)
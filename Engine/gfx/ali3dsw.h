@@ -26,6 +26,7 @@
 #include <memory>
 #include <SDL.h>
 #include "platform/platform.h"
+#include "gfx/banded_render.h"
 #include "gfx/bitmap.h"
 #include "gfx/ddb.h"
 #include "gfx/gfxdriverfactorybase.h"
@@ -207,6 +208,10 @@ public:
     void RenderSpritesAtScreenResolution(bool /*enabled*/) override { }
     // Enables or disables a smooth sprite scaling mode
     void UseSmoothScaling(bool /*enabled*/) override { }
+    // Sets the number of threads to draw the sprites with
+    void SetRenderThreads(int count) override { _bandRender.SetThreadCount(count > 0 ? static_cast<size_t>(count) : 0u); }
+    // Skipping unchanged frames is not supported by the software renderer
+    void SetSkipUnchangedFrames(bool /*enabled*/) override { }
     // Tells if driver supports gamma control
     bool SupportsGammaControl() override;
     // Sets gamma level
@@ -239,8 +244,11 @@ public:
     Texture *CreateTexture(int, int, int, int) override { return nullptr; /* not supported */}
     // Create texture and initialize its pixels from the given bitmap; optionally assigns a ID
     Texture *CreateTexture(const Bitmap*, int) override { return nullptr; /* not supported */ }
+    // Create texture data which refers to a region of another texture
+    Texture *CreateTextureRegion(std::shared_ptr<Texture>, const Rect&, int) override { return nullptr; /* not supported */ }
     // Update texture data from the given bitmap
     void UpdateTexture(Texture *txdata, const Bitmap*, bool, bool) override { /* not supported */}
+    void UpdateTexture(Texture *txdata, const Bitmap*, const Rect&, bool, bool) override { /* not supported */}
     // Retrieve shared texture object from the given DDB
     std::shared_ptr<Texture> GetTexture(IDriverDependantBitmap *ddb) override { return nullptr; /* not supported */ }
 
@@ -273,6 +281,8 @@ public:
     void Render() override;
     // Renders and presents with additional final offset and flip.
     void Render(int xoff, int yoff, Common::GraphicFlip flip) override;
+    // Software renderer never skips frames
+    bool WasLastFrameSkipped() const override { return false; }
     // Renders draw lists onto the provided texture.
     void Render(IDriverDependantBitmap *target) override;
     // Renders draw lists to backbuffer, but does not call present.
@@ -322,6 +332,11 @@ private:
     //
     // Renders single sprite batch on the precreated surface
     size_t RenderSpriteBatch(const ALSpriteBatch &batch, size_t from, Common::Bitmap *surface, int surf_offx, int surf_offy);
+    // Renders single sprite on the surface
+    void RenderSprite(const ALDrawListEntry &sprite, Common::Bitmap *surface, int surf_offx, int surf_offy);
+    // Tells if the sprite may be rendered concurrently with the others,
+    // on the separate bands of the surface
+    static bool CanRenderInBands(const ALDrawListEntry &sprite, const Common::Bitmap *surface);
     // Copy raw screen bitmap pixels to the SDL texture
     void BlitToTexture();
     // Render SDL texture on screen
@@ -361,6 +376,8 @@ private:
     ALSpriteBatches _spriteBatches;
     // List of sprites to render
     std::vector<ALDrawListEntry> _spriteList;
+    // Draws sprites on the surface bands in multiple threads
+    BandedRenderer _bandRender;
 };
 
 
@@ -0,0 +1,146 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2026 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include "gfx/banded_render.h"
+#include <algorithm>
+
+namespace AGS
+{
+namespace Engine
+{
+
+BandedRenderer::~BandedRenderer()
+{
+#if !defined(AGS_DISABLE_THREADS)
+    StopWorkers();
+#endif
+}
+
+void BandedRenderer::SetThreadCount(size_t count)
+{
+#if !defined(AGS_DISABLE_THREADS)
+    if (count == 0)
+        count = std::max(1u, std::thread::hardware_concurrency());
+    if (count == _threadCount)
+        return;
+    StopWorkers();
+    _threadCount = count;
+    for (size_t i = 1; i < count; ++i)
+        _workers.emplace_back(&BandedRenderer::WorkerProc, this);
+#else
+    (void)count;
+#endif
+}
+
+size_t BandedRenderer::GetBandCount(const Bitmap *surface) const
+{
+    return std::max<size_t>(1u,
+        std::min<size_t>(_threadCount, surface->GetHeight() / MinBandHeight));
+}
+
+void BandedRenderer::Draw(Bitmap *surface, const DrawFunc &draw)
+{
+    const size_t band_count = GetBandCount(surface);
+    const Rect clip = surface->GetClip();
+    if (band_count <= 1 || clip.Left > clip.Right)
+    {
+        draw(surface, 0);
+        return;
+    }
+
+#if !defined(AGS_DISABLE_THREADS)
+    // Make sub-bitmaps for the bands, clipped by the surface's clipping rect;
+    // skip the bands which are clipped out completely
+    const int width = surface->GetWidth();
+    const int height = surface->GetHeight();
+    if (_bands.size() < band_count)
+    {
+        _bands.resize(band_count);
+        _bandY.resize(band_count);
+    }
+    size_t use_bands = 0u;
+    for (size_t i = 0; i < band_count; ++i)
+    {
+        const int top = static_cast<int>(height * i / band_count);
+        const int bottom = static_cast<int>(height * (i + 1) / band_count) - 1;
+        const int clip_top = std::max(clip.Top, top);
+        const int clip_bottom = std::min(clip.Bottom, bottom);
+        if (clip_top > clip_bottom)
+            continue;
+        if (!_bands[use_bands])
+            _bands[use_bands].reset(new Bitmap());
+        Bitmap *band = _bands[use_bands].get();
+        band->CreateSubBitmap(surface, RectWH(0, top, width, bottom - top + 1));
+        band->SetClip(Rect(clip.Left, clip_top - top, clip.Right, clip_bottom - top));
+        _bandY[use_bands++] = top;
+    }
+
+    std::unique_lock<std::mutex> lk(_mutex);
+    _draw = &draw;
+    _bandCount = use_bands;
+    _bandsLeft = use_bands;
+    _nextBand = 0u;
+    _workCV.notify_all();
+    while (DrawNextBand(lk));
+    _doneCV.wait(lk, [this]() { return _bandsLeft == 0u; });
+    _draw = nullptr;
+    _bandCount = 0u;
+    _nextBand = 0u;
+#endif
+}
+
+#if !defined(AGS_DISABLE_THREADS)
+
+bool BandedRenderer::DrawNextBand(std::unique_lock<std::mutex> &lk)
+{
+    if (_nextBand >= _bandCount)
+        return false;
+    const size_t i = _nextBand++;
+    lk.unlock();
+    (*_draw)(_bands[i].get(), _bandY[i]);
+    lk.lock();
+    if (--_bandsLeft == 0u)
+        _doneCV.notify_all();
+    return true;
+}
+
+void BandedRenderer::WorkerProc()
+{
+    std::unique_lock<std::mutex> lk(_mutex);
+    for (;;)
+    {
+        _workCV.wait(lk, [this]() { return _quit || _nextBand < _bandCount; });
+        if (_quit)
+            break;
+        DrawNextBand(lk);
+    }
+}
+
+void BandedRenderer::StopWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lk(_mutex);
+        _quit = true;
+    }
+    _workCV.notify_all();
+    for (auto &w : _workers)
+        w.join();
+    _workers.clear();
+    _quit = false;
+    _threadCount = 1u;
+}
+
+#endif // !AGS_DISABLE_THREADS
+
+} // namespace Engine
+} // namespace AGS
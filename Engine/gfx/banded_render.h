@@ -0,0 +1,96 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2026 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+//
+// BandedRenderer splits the drawing surface into horizontal bands, and
+// lets a number of threads draw same things on their own bands at once.
+// Each band is a sub-bitmap with its own clipping rectangle, so the drawing
+// functions clip the sprites by the band's borders, and never touch the
+// pixels of other bands. This way the final result is exactly same as if
+// everything was drawn over the whole surface in order.
+//
+// The draw function is called concurrently, so it must only use the drawing
+// operations that do not depend on the global state: e.g. row blenders,
+// plain and masked blits, but not the Allegro's blender modes.
+//
+//=============================================================================
+#ifndef __AGS_EE_GFX__BANDEDRENDER_H
+#define __AGS_EE_GFX__BANDEDRENDER_H
+
+#include <functional>
+#include <memory>
+#include <vector>
+#if !defined(AGS_DISABLE_THREADS)
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+#include "gfx/bitmap.h"
+
+namespace AGS
+{
+namespace Engine
+{
+
+using Common::Bitmap;
+
+class BandedRenderer
+{
+public:
+    // Draws onto the band, whose top is at band_y of the full surface
+    typedef std::function<void(Bitmap *band, int band_y)> DrawFunc;
+
+    BandedRenderer() = default;
+    ~BandedRenderer();
+
+    // Sets the number of threads to draw with, including the calling one;
+    // 0 means to use as many as there are CPU cores
+    void SetThreadCount(size_t count);
+    size_t GetThreadCount() const { return _threadCount; }
+    // Returns the number of bands the given surface would be split into
+    size_t GetBandCount(const Bitmap *surface) const;
+    // Calls the draw function for each band of the surface, and returns
+    // when all of them are done; the calling thread draws too
+    void Draw(Bitmap *surface, const DrawFunc &draw);
+
+private:
+#if !defined(AGS_DISABLE_THREADS)
+    // Draws the next band, if there are any left; expects the mutex locked
+    bool DrawNextBand(std::unique_lock<std::mutex> &lk);
+    void WorkerProc();
+    void StopWorkers();
+#endif
+
+    // Bands narrower than this are not worth a separate thread
+    static const int MinBandHeight = 16;
+
+    size_t _threadCount = 1u;
+    std::vector<std::unique_ptr<Bitmap>> _bands;
+    size_t _bandCount = 0u;
+    const DrawFunc *_draw = nullptr;
+    std::vector<int> _bandY;
+#if !defined(AGS_DISABLE_THREADS)
+    std::vector<std::thread> _workers;
+    std::mutex _mutex;
+    std::condition_variable _workCV;
+    std::condition_variable _doneCV;
+    size_t _nextBand = 0u;
+    size_t _bandsLeft = 0u;
+    bool _quit = false;
+#endif
+};
+
+} // namespace Engine
+} // namespace AGS
+
+#endif // __AGS_EE_GFX__BANDEDRENDER_H
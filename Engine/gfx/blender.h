@@ -54,6 +54,11 @@ uint32_t _argb2rgb_blender(uint32_t src_col, uint32_t dst_col, uint32_t src_alph
 uint32_t _rgb2argb_blender(uint32_t src_col, uint32_t dst_col, uint32_t src_alpha);
 // Sets the alpha channel to opaque. Used when drawing a non-alpha sprite onto an alpha-sprite.
 uint32_t _opaque_alpha_blender(uint32_t src_col, uint32_t dst_col, uint32_t src_alpha);
+// Trans alpha blender combines RGBs proportionally to src alpha multiplied by
+// the overall alpha, and discards alpha in the end. Used for compositing alpha images.
+uint32_t _trans_alpha_blender32(uint32_t src_col, uint32_t dst_col, uint32_t src_alpha);
+// Additive alpha blender copies src RGB, and sums src and dst alpha values.
+uint32_t _additive_alpha_copysrc_blender(uint32_t src_col, uint32_t dst_col, uint32_t src_alpha);
 
 // Additive alpha blender plain copies src over, applying a summ of src and
 // dst alpha values.
@@ -0,0 +1,294 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2026 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include "gfx/blender_rows.h"
+#include "gfx/blender.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define AGS_ROWBLEND_SSE2 (1)
+#include <emmintrin.h>
+#endif
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define AGS_ROWBLEND_AVX2 (1)
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#define AGS_ROWBLEND_NEON (1)
+#include <arm_neon.h>
+#endif
+
+#include "gfx/blender_rows_impl.h"
+
+extern "C" {
+    // Standard Allegro 4 blenders for 32-bit color mode
+    uint32_t _blender_trans24(uint32_t x, uint32_t y, uint32_t n);
+    uint32_t _blender_alpha32(uint32_t x, uint32_t y, uint32_t n);
+}
+
+namespace AGS
+{
+namespace Engine
+{
+
+#if defined(AGS_ROWBLEND_AVX2)
+// Implemented in blender_rows_avx2.cpp, which is compiled for AVX2
+void GetRowBlendersAVX2(PfnRowBlend *blenders);
+#endif
+
+namespace
+{
+
+//-----------------------------------------------------------------------------
+// Scalar implementation: calls per-pixel blenders directly
+//-----------------------------------------------------------------------------
+template <uint32_t (*blender)(uint32_t, uint32_t, uint32_t)>
+void ScalarBlendRow(uint32_t *dst, const uint32_t *src, size_t count, uint32_t alpha)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (src[i] != RowBlendMaskColor)
+            dst[i] = blender(src[i], dst[i], alpha);
+    }
+}
+
+void GetRowBlendersScalar(PfnRowBlend *blenders)
+{
+    blenders[kRowBlend_Alpha] = ScalarBlendRow<_blender_alpha32>;
+    blenders[kRowBlend_TransAlpha] = ScalarBlendRow<_trans_alpha_blender32>;
+    blenders[kRowBlend_Argb2Rgb] = ScalarBlendRow<_argb2rgb_blender>;
+    blenders[kRowBlend_Argb2Argb] = ScalarBlendRow<_argb2argb_blender>;
+    blenders[kRowBlend_Trans] = ScalarBlendRow<_blender_trans24>;
+    blenders[kRowBlend_AdditiveAlpha] = ScalarBlendRow<_additive_alpha_copysrc_blender>;
+}
+
+#if defined(AGS_ROWBLEND_SSE2)
+//-----------------------------------------------------------------------------
+// SSE2 implementation: 4 pixels at a time
+//-----------------------------------------------------------------------------
+struct SSE2Traits
+{
+    typedef __m128i P;
+    typedef __m128i V;
+    static const size_t Pixels = 4;
+
+    static FORCEINLINE P Load(const uint32_t *p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+    static FORCEINLINE void Store(uint32_t *p, P v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+    static FORCEINLINE V Lo(P p) { return _mm_unpacklo_epi8(p, _mm_setzero_si128()); }
+    static FORCEINLINE V Hi(P p) { return _mm_unpackhi_epi8(p, _mm_setzero_si128()); }
+    static FORCEINLINE P Pack(V lo, V hi) { return _mm_packus_epi16(lo, hi); }
+    static FORCEINLINE P Set32(uint32_t v) { return _mm_set1_epi32(static_cast<int>(v)); }
+    static FORCEINLINE V Set16(uint16_t v) { return _mm_set1_epi16(static_cast<short>(v)); }
+    // Sets the same 4 components to each pixel: b, g, r, a
+    static FORCEINLINE V Set4x16(uint16_t b, uint16_t g, uint16_t r, uint16_t a)
+    {
+        return _mm_set_epi16(static_cast<short>(a), static_cast<short>(r), static_cast<short>(g), static_cast<short>(b),
+                             static_cast<short>(a), static_cast<short>(r), static_cast<short>(g), static_cast<short>(b));
+    }
+    static FORCEINLINE V Add(V a, V b) { return _mm_add_epi16(a, b); }
+    static FORCEINLINE V Sub(V a, V b) { return _mm_sub_epi16(a, b); }
+    static FORCEINLINE V Mul(V a, V b) { return _mm_mullo_epi16(a, b); }
+    static FORCEINLINE V MulHi(V a, V b) { return _mm_mulhi_epu16(a, b); }
+    static FORCEINLINE V Srl8(V a) { return _mm_srli_epi16(a, 8); }
+    static FORCEINLINE V Min(V a, V b) { return _mm_min_epi16(a, b); }
+    static FORCEINLINE V And(V a, V b) { return _mm_and_si128(a, b); }
+    static FORCEINLINE V Or(V a, V b) { return _mm_or_si128(a, b); }
+    static FORCEINLINE V CmpEq16(V a, V b) { return _mm_cmpeq_epi16(a, b); }
+    static FORCEINLINE V Select16(V m, V a, V b) { return _mm_or_si128(_mm_and_si128(m, a), _mm_andnot_si128(m, b)); }
+    static FORCEINLINE P CmpEq32(P a, P b) { return _mm_cmpeq_epi32(a, b); }
+    static FORCEINLINE P Select32(P m, P a, P b) { return _mm_or_si128(_mm_and_si128(m, a), _mm_andnot_si128(m, b)); }
+    static FORCEINLINE P AddsU8(P a, P b) { return _mm_adds_epu8(a, b); }
+    // Copies alpha component to all the components of the same pixel
+    static FORCEINLINE V BcastAlpha(V v) { return _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, 0xFF), 0xFF); }
+    // Calculates (65536 / v), for v in [1; 256] range
+    static FORCEINLINE V Recip(V v)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128 num = _mm_set1_ps(65536.f);
+        const __m128i lo = _mm_cvttps_epi32(_mm_div_ps(num, _mm_cvtepi32_ps(_mm_unpacklo_epi16(v, zero))));
+        const __m128i hi = _mm_cvttps_epi32(_mm_div_ps(num, _mm_cvtepi32_ps(_mm_unpackhi_epi16(v, zero))));
+        // there's no unsigned 32->16 pack in SSE2, so pack with the signed bias
+        const __m128i bias = _mm_set1_epi32(0x8000);
+        return _mm_xor_si128(_mm_packs_epi32(_mm_sub_epi32(lo, bias), _mm_sub_epi32(hi, bias)), _mm_set1_epi16(-0x8000));
+    }
+    // Moves G component to R position (and others up accordingly)
+    static FORCEINLINE V MoveGToR(V v) { return _mm_slli_epi64(v, 16); }
+    // Moves B component to R position, and G to A
+    static FORCEINLINE V MoveBToR(V v) { return _mm_slli_epi64(v, 32); }
+};
+#endif // AGS_ROWBLEND_SSE2
+
+#if defined(AGS_ROWBLEND_NEON)
+//-----------------------------------------------------------------------------
+// NEON implementation: 4 pixels at a time
+//-----------------------------------------------------------------------------
+struct NEONTraits
+{
+    typedef uint32x4_t P;
+    typedef uint16x8_t V;
+    static const size_t Pixels = 4;
+    static const size_t Lanes = 8;
+
+    static FORCEINLINE P Load(const uint32_t *p) { return vld1q_u32(p); }
+    static FORCEINLINE void Store(uint32_t *p, P v) { vst1q_u32(p, v); }
+    static FORCEINLINE V Lo(P p) { return vmovl_u8(vget_low_u8(vreinterpretq_u8_u32(p))); }
+    static FORCEINLINE V Hi(P p) { return vmovl_u8(vget_high_u8(vreinterpretq_u8_u32(p))); }
+    static FORCEINLINE P Pack(V lo, V hi) { return vreinterpretq_u32_u8(vcombine_u8(vqmovn_u16(lo), vqmovn_u16(hi))); }
+    static FORCEINLINE P Set32(uint32_t v) { return vdupq_n_u32(v); }
+    static FORCEINLINE V Set16(uint16_t v) { return vdupq_n_u16(v); }
+    // Sets the same 4 components to each pixel: b, g, r, a
+    static FORCEINLINE V Set4x16(uint16_t b, uint16_t g, uint16_t r, uint16_t a)
+    {
+        const uint16_t v[8] = { b, g, r, a, b, g, r, a };
+        return vld1q_u16(v);
+    }
+    static FORCEINLINE V Add(V a, V b) { return vaddq_u16(a, b); }
+    static FORCEINLINE V Sub(V a, V b) { return vsubq_u16(a, b); }
+    static FORCEINLINE V Mul(V a, V b) { return vmulq_u16(a, b); }
+    static FORCEINLINE V MulHi(V a, V b)
+    {
+        return vcombine_u16(vshrn_n_u32(vmull_u16(vget_low_u16(a), vget_low_u16(b)), 16),
+                            vshrn_n_u32(vmull_u16(vget_high_u16(a), vget_high_u16(b)), 16));
+    }
+    static FORCEINLINE V Srl8(V a) { return vshrq_n_u16(a, 8); }
+    static FORCEINLINE V Min(V a, V b) { return vminq_u16(a, b); }
+    static FORCEINLINE V And(V a, V b) { return vandq_u16(a, b); }
+    static FORCEINLINE V Or(V a, V b) { return vorrq_u16(a, b); }
+    static FORCEINLINE V CmpEq16(V a, V b) { return vceqq_u16(a, b); }
+    static FORCEINLINE V Select16(V m, V a, V b) { return vbslq_u16(m, a, b); }
+    static FORCEINLINE P CmpEq32(P a, P b) { return vceqq_u32(a, b); }
+    static FORCEINLINE P Select32(P m, P a, P b) { return vbslq_u32(m, a, b); }
+    static FORCEINLINE P AddsU8(P a, P b) { return vreinterpretq_u32_u8(vqaddq_u8(vreinterpretq_u8_u32(a), vreinterpretq_u8_u32(b))); }
+    // Copies alpha component to all the components of the same pixel
+    static FORCEINLINE V BcastAlpha(V v) { return vcombine_u16(vdup_lane_u16(vget_low_u16(v), 3), vdup_lane_u16(vget_high_u16(v), 3)); }
+    // Calculates (65536 / v), for v in [1; 256] range
+    static FORCEINLINE V Recip(V v)
+    {
+#if defined(__aarch64__) || defined(_M_ARM64)
+        const float32x4_t num = vdupq_n_f32(65536.f);
+        const uint32x4_t lo = vcvtq_u32_f32(vdivq_f32(num, vcvtq_f32_u32(vmovl_u16(vget_low_u16(v)))));
+        const uint32x4_t hi = vcvtq_u32_f32(vdivq_f32(num, vcvtq_f32_u32(vmovl_u16(vget_high_u16(v)))));
+        return vcombine_u16(vqmovn_u32(lo), vqmovn_u32(hi));
+#else
+        // 32-bit ARM has no vector division
+        uint16_t buf[Lanes];
+        vst1q_u16(buf, v);
+        for (size_t i = 0; i < Lanes; ++i)
+        {
+            const uint32_t k = 0x10000u / buf[i];
+            buf[i] = static_cast<uint16_t>(k > 0xFFFF ? 0xFFFF : k);
+        }
+        return vld1q_u16(buf);
+#endif
+    }
+    // Moves G component to R position (and others up accordingly)
+    static FORCEINLINE V MoveGToR(V v) { return vreinterpretq_u16_u64(vshlq_n_u64(vreinterpretq_u64_u16(v), 16)); }
+    // Moves B component to R position, and G to A
+    static FORCEINLINE V MoveBToR(V v) { return vreinterpretq_u16_u64(vshlq_n_u64(vreinterpretq_u64_u16(v), 32)); }
+};
+#endif // AGS_ROWBLEND_NEON
+
+//-----------------------------------------------------------------------------
+// CPU features detection
+//-----------------------------------------------------------------------------
+#if defined(AGS_ROWBLEND_AVX2)
+bool HasAVX2()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return false;
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx)
+        return false;
+    // the OS must save the AVX registers on context switch
+    if ((_xgetbv(0) & 0x6) != 0x6)
+        return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+#endif // AGS_ROWBLEND_AVX2
+
+// Blenders table for every implementation; null if not supported
+struct RowBlendersTable
+{
+    PfnRowBlend Blenders[kNumRowBlendImpls][kNumRowBlendOps] = {};
+    RowBlendImpl Best = kRowBlendImpl_Scalar;
+
+    RowBlendersTable()
+    {
+        GetRowBlendersScalar(Blenders[kRowBlendImpl_Scalar]);
+#if defined(AGS_ROWBLEND_SSE2)
+        RowKernels<SSE2Traits>::GetBlenders(Blenders[kRowBlendImpl_SSE2]);
+        Best = kRowBlendImpl_SSE2;
+#endif
+#if defined(AGS_ROWBLEND_AVX2)
+        if (HasAVX2())
+        {
+            GetRowBlendersAVX2(Blenders[kRowBlendImpl_AVX2]);
+            Best = kRowBlendImpl_AVX2;
+        }
+#endif
+#if defined(AGS_ROWBLEND_NEON)
+        RowKernels<NEONTraits>::GetBlenders(Blenders[kRowBlendImpl_NEON]);
+        Best = kRowBlendImpl_NEON;
+#endif
+    }
+};
+
+const RowBlendersTable &GetBlendersTable()
+{
+    static const RowBlendersTable table;
+    return table;
+}
+
+} // namespace
+
+RowBlendImpl GetRowBlendImpl()
+{
+    return GetBlendersTable().Best;
+}
+
+const char *GetRowBlendImplName(RowBlendImpl impl)
+{
+    switch (impl)
+    {
+    case kRowBlendImpl_Scalar: return "Scalar";
+    case kRowBlendImpl_SSE2: return "SSE2";
+    case kRowBlendImpl_AVX2: return "AVX2";
+    case kRowBlendImpl_NEON: return "NEON";
+    default: return "Unknown";
+    }
+}
+
+PfnRowBlend GetRowBlender(RowBlendOp op, RowBlendImpl impl)
+{
+    if (op < 0 || op >= kNumRowBlendOps || impl < 0 || impl >= kNumRowBlendImpls)
+        return nullptr;
+    return GetBlendersTable().Blenders[impl][op];
+}
+
+PfnRowBlend GetRowBlender(RowBlendOp op)
+{
+    return GetRowBlender(op, GetRowBlendImpl());
+}
+
+} // namespace Engine
+} // namespace AGS
@@ -0,0 +1,81 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2026 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+//
+// Row blenders: functions that blend whole rows of 32-bit pixels at once.
+// Each blend operation produces exactly the same results as one of the
+// per-pixel blenders used with Allegro's draw_trans_sprite, but avoids
+// calling the blender for every pixel, and processes several pixels at a
+// time using the SIMD instructions, where these are available.
+//
+// The implementation is chosen at runtime, depending on the CPU features:
+// SSE2 and AVX2 on x86, NEON on ARM, with the plain C++ fallback.
+//
+//=============================================================================
+#ifndef __AGS_EE_GFX__BLENDERROWS_H
+#define __AGS_EE_GFX__BLENDERROWS_H
+
+#include "platform/types.h"
+
+namespace AGS
+{
+namespace Engine
+{
+
+// Blend operations, each one matching a 32-bit per-pixel blender
+enum RowBlendOp
+{
+    // ARGB over RGB, Allegro's _blender_alpha32 (set_alpha_blender)
+    kRowBlend_Alpha,
+    // ARGB over RGB with global alpha, _trans_alpha_blender32
+    kRowBlend_TransAlpha,
+    // ARGB over RGB with optional global alpha, _argb2rgb_blender
+    kRowBlend_Argb2Rgb,
+    // ARGB over ARGB with optional global alpha, _argb2argb_blender
+    kRowBlend_Argb2Argb,
+    // RGB over RGB with constant alpha, Allegro's _blender_trans24 (set_trans_blender)
+    kRowBlend_Trans,
+    // Copies src RGB, sums src and dst alpha, _additive_alpha_copysrc_blender
+    kRowBlend_AdditiveAlpha,
+    kNumRowBlendOps
+};
+
+// Row blenders implementations
+enum RowBlendImpl
+{
+    kRowBlendImpl_Scalar,
+    kRowBlendImpl_SSE2,
+    kRowBlendImpl_AVX2,
+    kRowBlendImpl_NEON,
+    kNumRowBlendImpls
+};
+
+// Blends a row of src pixels over the row of dst pixels; the alpha parameter
+// has the same meaning as the one passed into the matching per-pixel blender.
+// Src pixels of the mask color are skipped, same as draw_trans_sprite does.
+typedef void (*PfnRowBlend)(uint32_t *dst, const uint32_t *src, size_t count, uint32_t alpha);
+
+// Returns the best row blenders implementation supported by this system
+RowBlendImpl GetRowBlendImpl();
+// Returns the implementation's name, for logging purposes
+const char *GetRowBlendImplName(RowBlendImpl impl);
+// Returns the row blender of the given implementation,
+// or null if such implementation is not supported by this system
+PfnRowBlend GetRowBlender(RowBlendOp op, RowBlendImpl impl);
+// Returns the row blender of the best supported implementation
+PfnRowBlend GetRowBlender(RowBlendOp op);
+
+} // namespace Engine
+} // namespace AGS
+
+#endif // __AGS_EE_GFX__BLENDERROWS_H
@@ -0,0 +1,112 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2026 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+//
+// AVX2 implementation of the row blenders, 8 pixels at a time.
+// The whole file is compiled for AVX2, and must only be called after
+// checking that the CPU supports it.
+//
+//=============================================================================
+#include "gfx/blender_rows.h"
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+
+// Enable AVX2 code generation for this file only, without the build flags
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("avx2"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+#include <immintrin.h>
+#include "gfx/blender_rows_impl.h"
+
+namespace AGS
+{
+namespace Engine
+{
+
+namespace
+{
+
+struct AVX2Traits
+{
+    typedef __m256i P;
+    typedef __m256i V;
+    static const size_t Pixels = 8;
+
+    // NOTE: unpack and pack instructions work within the 128-bit halves,
+    // so the pixels order is shuffled by Lo/Hi, and restored by Pack
+    static FORCEINLINE P Load(const uint32_t *p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    static FORCEINLINE void Store(uint32_t *p, P v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+    static FORCEINLINE V Lo(P p) { return _mm256_unpacklo_epi8(p, _mm256_setzero_si256()); }
+    static FORCEINLINE V Hi(P p) { return _mm256_unpackhi_epi8(p, _mm256_setzero_si256()); }
+    static FORCEINLINE P Pack(V lo, V hi) { return _mm256_packus_epi16(lo, hi); }
+    static FORCEINLINE P Set32(uint32_t v) { return _mm256_set1_epi32(static_cast<int>(v)); }
+    static FORCEINLINE V Set16(uint16_t v) { return _mm256_set1_epi16(static_cast<short>(v)); }
+    // Sets the same 4 components to each pixel: b, g, r, a
+    static FORCEINLINE V Set4x16(uint16_t b, uint16_t g, uint16_t r, uint16_t a)
+    {
+        return _mm256_set1_epi64x(static_cast<long long>(
+            (static_cast<uint64_t>(a) << 48) | (static_cast<uint64_t>(r) << 32) |
+            (static_cast<uint64_t>(g) << 16) | static_cast<uint64_t>(b)));
+    }
+    static FORCEINLINE V Add(V a, V b) { return _mm256_add_epi16(a, b); }
+    static FORCEINLINE V Sub(V a, V b) { return _mm256_sub_epi16(a, b); }
+    static FORCEINLINE V Mul(V a, V b) { return _mm256_mullo_epi16(a, b); }
+    static FORCEINLINE V MulHi(V a, V b) { return _mm256_mulhi_epu16(a, b); }
+    static FORCEINLINE V Srl8(V a) { return _mm256_srli_epi16(a, 8); }
+    static FORCEINLINE V Min(V a, V b) { return _mm256_min_epi16(a, b); }
+    static FORCEINLINE V And(V a, V b) { return _mm256_and_si256(a, b); }
+    static FORCEINLINE V Or(V a, V b) { return _mm256_or_si256(a, b); }
+    static FORCEINLINE V CmpEq16(V a, V b) { return _mm256_cmpeq_epi16(a, b); }
+    static FORCEINLINE V Select16(V m, V a, V b) { return _mm256_blendv_epi8(b, a, m); }
+    static FORCEINLINE P CmpEq32(P a, P b) { return _mm256_cmpeq_epi32(a, b); }
+    static FORCEINLINE P Select32(P m, P a, P b) { return _mm256_blendv_epi8(b, a, m); }
+    static FORCEINLINE P AddsU8(P a, P b) { return _mm256_adds_epu8(a, b); }
+    // Copies alpha component to all the components of the same pixel
+    static FORCEINLINE V BcastAlpha(V v) { return _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(v, 0xFF), 0xFF); }
+    // Calculates (65536 / v), for v in [1; 256] range
+    static FORCEINLINE V Recip(V v)
+    {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256 num = _mm256_set1_ps(65536.f);
+        const __m256i lo = _mm256_cvttps_epi32(_mm256_div_ps(num, _mm256_cvtepi32_ps(_mm256_unpacklo_epi16(v, zero))));
+        const __m256i hi = _mm256_cvttps_epi32(_mm256_div_ps(num, _mm256_cvtepi32_ps(_mm256_unpackhi_epi16(v, zero))));
+        return _mm256_packus_epi32(lo, hi);
+    }
+    // Moves G component to R position (and others up accordingly)
+    static FORCEINLINE V MoveGToR(V v) { return _mm256_slli_epi64(v, 16); }
+    // Moves B component to R position, and G to A
+    static FORCEINLINE V MoveBToR(V v) { return _mm256_slli_epi64(v, 32); }
+};
+
+} // namespace
+
+void GetRowBlendersAVX2(PfnRowBlend *blenders)
+{
+    RowKernels<AVX2Traits>::GetBlenders(blenders);
+}
+
+} // namespace Engine
+} // namespace AGS
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // x86
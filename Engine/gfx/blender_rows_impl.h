@@ -0,0 +1,230 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2026 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+//
+// SIMD row blenders, written once over the "traits" class which wraps
+// the vector instructions of a particular instruction set:
+//   P  - vector of 32-bit pixels, T::Pixels of them;
+//   V  - vector of 16-bit color components, of the half of P pixels.
+//
+// All the blenders use only 16-bit multiplications. The per-pixel blenders
+// process R and B components together in a 32-bit integer, but this may be
+// reduced to the per-component formulas which give exactly same results:
+//   ((x - y) * n / 256 + y) & mask   ==   (x * n + y * (256 - n)) >> 8
+// as long as n is in [0; 256] range. The exception is that the per-pixel
+// blenders add up the full dst value, so its G component is also added
+// to the lower part of R product, and occasionally rounds it up:
+//   R = (xR * n + yR * (256 - n) + yG) >> 8
+//
+// The reciprocal of the final alpha in argb2argb blender, (65536 / n),
+// is calculated with the floating point division. For n in [1; 256] range
+// the float error is smaller than the distance to the nearest integer,
+// so the truncated result is always exact.
+//
+// NOTE: this header must be included only by the row blenders implementation
+// files. Everything here is defined with the internal linkage, because each
+// file compiles these functions for a different instruction set, and they
+// must not be merged together by the linker.
+//
+//=============================================================================
+#ifndef __AGS_EE_GFX__BLENDERROWSIMPL_H
+#define __AGS_EE_GFX__BLENDERROWSIMPL_H
+
+#include <string.h>
+#include "gfx/blender_rows.h"
+
+namespace AGS
+{
+namespace Engine
+{
+namespace
+{
+
+// Allegro's MASK_COLOR_32
+const uint32_t RowBlendMaskColor = 0x00FF00FF;
+
+template <class T>
+struct RowKernels
+{
+    typedef typename T::P P;
+    typedef typename T::V V;
+
+    // Blends two components proportionally: (x * n + y * (256 - n) + carry) >> 8
+    static FORCEINLINE V Lerp(V x, V y, V n, V carry, V c256)
+    {
+        return T::Srl8(T::Add(T::Add(T::Mul(x, n), T::Mul(y, T::Sub(c256, n))), carry));
+    }
+
+    // Increments n if it's not zero
+    static FORCEINLINE V IncNonZero(V n, V c1)
+    {
+        return T::Add(n, T::Min(n, c1));
+    }
+
+    // ARGB over RGB, where the alpha factor is (src_alpha * k / 256);
+    // covers _blender_alpha32, _trans_alpha_blender32 and _argb2rgb_blender
+    struct OpAlpha
+    {
+        V K, C1, C256, RGBMask, RMask;
+
+        OpAlpha(uint32_t k)
+            : K(T::Set16(static_cast<uint16_t>(k))), C1(T::Set16(1)), C256(T::Set16(256))
+            , RGBMask(T::Set4x16(0xFFFF, 0xFFFF, 0xFFFF, 0)), RMask(T::Set4x16(0, 0, 0xFFFF, 0)) {}
+
+        FORCEINLINE V operator()(V x, V y) const
+        {
+            const V n = IncNonZero(T::Srl8(T::Mul(T::BcastAlpha(x), K)), C1);
+            return T::And(Lerp(x, y, n, T::And(T::MoveGToR(y), RMask), C256), RGBMask);
+        }
+    };
+
+    // RGB over RGB with the constant alpha; _blender_trans24
+    struct OpTrans
+    {
+        V N, C256, RGBMask, RMask;
+
+        OpTrans(uint32_t alpha)
+            : N(T::Set16(static_cast<uint16_t>(alpha ? alpha + 1 : 0))), C256(T::Set16(256))
+            , RGBMask(T::Set4x16(0xFFFF, 0xFFFF, 0xFFFF, 0)), RMask(T::Set4x16(0, 0, 0xFFFF, 0)) {}
+
+        FORCEINLINE V operator()(V x, V y) const
+        {
+            return T::And(Lerp(x, y, N, T::And(T::MoveGToR(y), RMask), C256), RGBMask);
+        }
+    };
+
+    // ARGB over ARGB; _argb2argb_blender, see argb2argb_blend_core for
+    // the reference; the final color is divided by the resulting alpha,
+    // which is done by multiplying on its reciprocal
+    struct OpArgb2Argb
+    {
+        V K, Zero, C1, C256, RGBMask, AlphaMask, RMask, GRLowMask;
+
+        OpArgb2Argb(uint32_t k)
+            : K(T::Set16(static_cast<uint16_t>(k))), Zero(T::Set16(0)), C1(T::Set16(1)), C256(T::Set16(256))
+            , RGBMask(T::Set4x16(0xFFFF, 0xFFFF, 0xFFFF, 0)), AlphaMask(T::Set4x16(0, 0, 0, 0xFFFF))
+            , RMask(T::Set4x16(0, 0, 0xFFFF, 0)), GRLowMask(T::Set4x16(0, 0xFF, 0xFF, 0)) {}
+
+        FORCEINLINE V operator()(V x, V y) const
+        {
+            const V sa = T::Srl8(T::Mul(T::BcastAlpha(x), K));
+            const V skip = T::CmpEq16(sa, Zero); // zero src alpha keeps dst
+            const V sa1 = T::Add(sa, C1);
+            const V da = IncNonZero(T::BcastAlpha(y), C1);
+            // dst color multiplied by its alpha, and blended with src;
+            // reference keeps the lower bits of G and R products, which
+            // add up to the blending result
+            const V dc_full = T::Mul(y, da);
+            const V dc = T::Srl8(dc_full);
+            const V c = Lerp(x, dc, sa1, T::And(dc_full, GRLowMask), C256);
+            // final alpha, and its reciprocal
+            const V fa = T::Sub(C256, T::Srl8(T::Mul(T::Sub(C256, sa1), T::Sub(C256, da))));
+            const V k = T::Recip(fa);
+            // Reference multiplies R and B together in one 32-bit integer,
+            // where the upper half of B's product is carried into R
+            const V carry = T::And(T::MoveBToR(T::MulHi(c, k)), RMask);
+            const V res = T::Srl8(T::Add(T::Mul(c, k), carry));
+            const V out = T::Or(T::And(res, RGBMask), T::And(T::Sub(fa, C1), AlphaMask));
+            return T::Select16(skip, y, out);
+        }
+    };
+
+    // Blends the row using the per-component operation
+    template <class TOp>
+    static void BlendRow(uint32_t *dst, const uint32_t *src, size_t count, const TOp &op)
+    {
+        const P mask_col = T::Set32(RowBlendMaskColor);
+        size_t i = 0;
+        for (; i + T::Pixels <= count; i += T::Pixels)
+        {
+            const P s = T::Load(src + i);
+            const P d = T::Load(dst + i);
+            const P r = T::Pack(op(T::Lo(s), T::Lo(d)), op(T::Hi(s), T::Hi(d)));
+            T::Store(dst + i, T::Select32(T::CmpEq32(s, mask_col), d, r));
+        }
+        if (i == count)
+            return;
+        // The remaining pixels are padded with the mask color, and blended as a whole
+        uint32_t sbuf[T::Pixels], dbuf[T::Pixels] = {};
+        const size_t rest = count - i;
+        for (size_t j = 0; j < T::Pixels; ++j)
+            sbuf[j] = (j < rest) ? src[i + j] : RowBlendMaskColor;
+        memcpy(dbuf, dst + i, rest * sizeof(uint32_t));
+        BlendRow(dbuf, sbuf, T::Pixels, op);
+        memcpy(dst + i, dbuf, rest * sizeof(uint32_t));
+    }
+
+    static void Alpha(uint32_t *dst, const uint32_t *src, size_t count, uint32_t /*alpha*/)
+    {
+        BlendRow(dst, src, count, OpAlpha(256));
+    }
+
+    static void TransAlpha(uint32_t *dst, const uint32_t *src, size_t count, uint32_t alpha)
+    {
+        BlendRow(dst, src, count, OpAlpha(alpha));
+    }
+
+    static void Argb2Rgb(uint32_t *dst, const uint32_t *src, size_t count, uint32_t alpha)
+    {
+        BlendRow(dst, src, count, OpAlpha(alpha > 0 ? (alpha & 0xFF) + 1 : 256));
+    }
+
+    static void Argb2Argb(uint32_t *dst, const uint32_t *src, size_t count, uint32_t alpha)
+    {
+        BlendRow(dst, src, count, OpArgb2Argb(alpha > 0 ? (alpha & 0xFF) + 1 : 256));
+    }
+
+    static void Trans(uint32_t *dst, const uint32_t *src, size_t count, uint32_t alpha)
+    {
+        BlendRow(dst, src, count, OpTrans(alpha));
+    }
+
+    // Copies src RGB, and sums src and dst alpha with saturation
+    static void AdditiveAlpha(uint32_t *dst, const uint32_t *src, size_t count, uint32_t /*alpha*/)
+    {
+        const P mask_col = T::Set32(RowBlendMaskColor);
+        const P alpha_mask = T::Set32(0xFF000000);
+        size_t i = 0;
+        for (; i + T::Pixels <= count; i += T::Pixels)
+        {
+            const P s = T::Load(src + i);
+            const P d = T::Load(dst + i);
+            const P r = T::Select32(alpha_mask, T::AddsU8(s, d), s);
+            T::Store(dst + i, T::Select32(T::CmpEq32(s, mask_col), d, r));
+        }
+        for (; i < count; ++i)
+        {
+            const uint32_t s = src[i];
+            if (s == RowBlendMaskColor)
+                continue;
+            const uint32_t a = (s >> 24) + (dst[i] >> 24);
+            dst[i] = ((a > 0xFF ? 0xFF : a) << 24) | (s & 0x00FFFFFF);
+        }
+    }
+
+    static void GetBlenders(PfnRowBlend *blenders)
+    {
+        blenders[kRowBlend_Alpha] = Alpha;
+        blenders[kRowBlend_TransAlpha] = TransAlpha;
+        blenders[kRowBlend_Argb2Rgb] = Argb2Rgb;
+        blenders[kRowBlend_Argb2Argb] = Argb2Argb;
+        blenders[kRowBlend_Trans] = Trans;
+        blenders[kRowBlend_AdditiveAlpha] = AdditiveAlpha;
+    }
+};
+
+} // namespace
+} // namespace Engine
+} // namespace AGS
+
+#endif // __AGS_EE_GFX__BLENDERROWSIMPL_H
@@ -43,15 +43,28 @@ struct Texture
     uint32_t ID = UINT32_MAX; // optional ID, may refer to sprite ID
     const GraphicResolution Res;
     const bool RenderTarget = false; // TODO: replace with flags later
+    // Modification stamp, changed whenever the pixels are updated by the driver;
+    // stamps are unique among all textures, so that the new texture
+    // never matches the one which existed before at the same address
+    uint64_t Stamp = 0u;
 
     virtual ~Texture() = default;
     virtual size_t GetMemSize() const = 0;
 
+    void MarkModified() { Stamp = NextStamp(); }
+
 protected:
     Texture(const GraphicResolution &res, bool rt)
-        : Res(res), RenderTarget(rt) {}
+        : Res(res), RenderTarget(rt), Stamp(NextStamp()) {}
     Texture(uint32_t id, const GraphicResolution &res, bool rt)
-        : ID(id), Res(res), RenderTarget(rt) {}
+        : ID(id), Res(res), RenderTarget(rt), Stamp(NextStamp()) {}
+
+private:
+    static uint64_t NextStamp()
+    {
+        static uint64_t last_stamp = 0u;
+        return ++last_stamp;
+    }
 };
 
 
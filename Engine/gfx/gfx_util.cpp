@@ -14,6 +14,7 @@
 
 #include "platform/platform.h"
 #include "gfx/gfx_util.h"
+#include <algorithm>
 #include "gfx/blender.h"
 
 namespace AGS
@@ -64,18 +65,33 @@ static const BlendModeSetter BlendModeSets[kNumBlendModes] =
     // NOTE: add new modes here
 };
 
-bool SetBlender(BlendMode blend_mode, bool dst_has_alpha, bool src_has_alpha, int blend_alpha)
+static PfnBlenderCb GetBlender(BlendMode blend_mode, bool dst_has_alpha, bool src_has_alpha, int blend_alpha)
 {
     if (blend_mode < 0 || blend_mode >= kNumBlendModes)
-        return false;
+        return nullptr;
     const BlendModeSetter &set = BlendModeSets[blend_mode];
-    PfnBlenderCb blender;
     if (dst_has_alpha)
-        blender = src_has_alpha ? set.AllAlpha :
+        return src_has_alpha ? set.AllAlpha :
             (blend_alpha == 0xFF ? set.OpaqueToAlphaNoTrans : set.OpaqueToAlpha);
     else
-        blender = src_has_alpha ? set.AlphaToOpaque : set.AllOpaque;
+        return src_has_alpha ? set.AlphaToOpaque : set.AllOpaque;
+}
+
+// Finds the row blending operation matching the per-pixel blender
+static bool GetRowBlendOp(PfnBlenderCb blender, RowBlendOp &op)
+{
+    if (blender == _argb2argb_blender)
+        op = kRowBlend_Argb2Argb;
+    else if (blender == _argb2rgb_blender)
+        op = kRowBlend_Argb2Rgb;
+    else
+        return false;
+    return true;
+}
 
+bool SetBlender(BlendMode blend_mode, bool dst_has_alpha, bool src_has_alpha, int blend_alpha)
+{
+    PfnBlenderCb blender = GetBlender(blend_mode, dst_has_alpha, src_has_alpha, blend_alpha);
     if (blender)
     {
         set_blender_mode(nullptr, nullptr, blender, 0, 0, 0, blend_alpha);
@@ -90,11 +106,17 @@ void DrawSpriteBlend(Bitmap *ds, const Point &ds_at, const Bitmap *sprite,
     if (blend_alpha <= 0)
         return; // do not draw 100% transparent image
 
-    if (// support only 32-bit blending at the moment
-        ds->GetColorDepth() == 32 && sprite->GetColorDepth() == 32 &&
-        // set blenders if applicable and tell if succeeded
-        SetBlender(blend_mode, dst_has_alpha, src_has_alpha, blend_alpha))
+    // support only 32-bit blending at the moment
+    PfnBlenderCb blender = (ds->GetColorDepth() == 32 && sprite->GetColorDepth() == 32) ?
+        GetBlender(blend_mode, dst_has_alpha, src_has_alpha, blend_alpha) : nullptr;
+    RowBlendOp row_op;
+    if (blender && GetRowBlendOp(blender, row_op))
+    {
+        DrawSpriteRowBlend(ds, sprite, ds_at.X, ds_at.Y, row_op, blend_alpha);
+    }
+    else if (blender)
     {
+        set_blender_mode(nullptr, nullptr, blender, 0, 0, 0, blend_alpha);
         ds->TransBlendBlt(sprite, ds_at.X, ds_at.Y);
     }
     else
@@ -124,7 +146,11 @@ void DrawSpriteWithTransparency(Bitmap *ds, const Bitmap *sprite, int x, int y,
         sprite = conv_bm.get();
     }
 
-    if ((alpha < 0xFF) && (surface_depth > 8) && (sprite_depth > 8))
+    if ((alpha < 0xFF) && (surface_depth == 32) && (sprite_depth > 8))
+    {
+        DrawSpriteRowBlend(ds, sprite, x, y, kRowBlend_Trans, alpha);
+    }
+    else if ((alpha < 0xFF) && (surface_depth > 8) && (sprite_depth > 8))
     {
         set_trans_blender(0, 0, 0, alpha);
         ds->TransBlendBlt(sprite, x, y);
@@ -135,6 +161,30 @@ void DrawSpriteWithTransparency(Bitmap *ds, const Bitmap *sprite, int x, int y,
     }
 }
 
+void DrawSpriteRowBlend(Bitmap *ds, const Bitmap *sprite, int x, int y, RowBlendOp op, int alpha)
+{
+    assert(ds->GetColorDepth() == 32 && sprite->GetColorDepth() == 32);
+    PfnRowBlend row_blend = GetRowBlender(op);
+    if (!row_blend)
+        return;
+
+    // Clip same way as Allegro's draw_trans_sprite does
+    const Rect clip = ds->GetClip();
+    const int src_x = std::max(0, clip.Left - x);
+    const int src_y = std::max(0, clip.Top - y);
+    const int w = std::min(sprite->GetWidth(), clip.Right + 1 - x) - src_x;
+    const int h = std::min(sprite->GetHeight(), clip.Bottom + 1 - y) - src_y;
+    if (w <= 0 || h <= 0)
+        return;
+
+    for (int row = 0; row < h; ++row)
+    {
+        const uint32_t *src = reinterpret_cast<const uint32_t*>(sprite->GetScanLine(src_y + row)) + src_x;
+        uint32_t *dst = reinterpret_cast<uint32_t*>(ds->GetScanLineForWriting(y + src_y + row)) + x + src_x;
+        row_blend(dst, src, w, static_cast<uint32_t>(alpha));
+    }
+}
+
 } // namespace GfxUtil
 
 } // namespace Engine
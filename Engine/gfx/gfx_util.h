@@ -25,6 +25,7 @@
 #define __AGS_EE_GFX__GFXUTIL_H
 
 #include "gfx/bitmap.h"
+#include "gfx/blender_rows.h"
 #include "gfx/gfx_def.h"
 
 namespace AGS
@@ -54,6 +55,11 @@ namespace GfxUtil
     // ignores image's alpha channel, even if there's one;
     // does a conversion if sprite and destination color depths do not match.
     void DrawSpriteWithTransparency(Bitmap *ds, const Bitmap *sprite, int x, int y, int alpha = 0xFF);
+
+    // Draws a 32-bit bitmap over another 32-bit bitmap using the row blender,
+    // clipped by the destination's clipping rectangle; gives same result as
+    // TransBlendBlt with the matching per-pixel blender set.
+    void DrawSpriteRowBlend(Bitmap *ds, const Bitmap *sprite, int x, int y, RowBlendOp op, int alpha = 0xFF);
 } // namespace GfxUtil
 
 } // namespace Engine
@@ -198,6 +198,37 @@ GPUGraphicsDriver::~GPUGraphicsDriver()
     DestroyAllStageScreens();
 }
 
+void GPUGraphicsDriver::SetSkipUnchangedFrames(bool enabled)
+{
+    _skipUnchangedFrames = enabled;
+    _lastFrameSkipped = false;
+    _sceneTracker.Invalidate();
+}
+
+void GPUGraphicsDriver::OnModeSet(const DisplayMode &mode)
+{
+    GraphicsDriverBase::OnModeSet(mode);
+    _sceneTracker.Invalidate();
+}
+
+void GPUGraphicsDriver::OnSetNativeRes(const GraphicResolution &native_res)
+{
+    GraphicsDriverBase::OnSetNativeRes(native_res);
+    _sceneTracker.Invalidate();
+}
+
+void GPUGraphicsDriver::OnSetRenderFrame(const Rect &dst_rect)
+{
+    GraphicsDriverBase::OnSetRenderFrame(dst_rect);
+    _sceneTracker.Invalidate();
+}
+
+void GPUGraphicsDriver::OnSetFilter()
+{
+    GraphicsDriverBase::OnSetFilter();
+    _sceneTracker.Invalidate();
+}
+
 Bitmap *GPUGraphicsDriver::GetMemoryBackBuffer()
 {
     return nullptr;
@@ -397,74 +428,54 @@ template <typename T> void get_pixel_if_not_transparent(const T *pixel, T *red,
     ( (((a) & 0xFF) << _vmem_a_shift_32) | (((r) & 0xFF) << _vmem_r_shift_32) | (((g) & 0xFF) << _vmem_g_shift_32) | (((b) & 0xFF) << _vmem_b_shift_32) )
 
 
-// Template helper function which converts bitmap to a video memory buffer,
-// applies transparency and optionally copyies the source alpha channel (if available).
-template <typename T, bool HasAlpha> void
-GPUGraphicsDriver::BitmapToVideoMemImpl(
+// Converts bitmap to a video memory buffer, one row at a time,
+// using the row converters for the bitmap's color depth
+void GPUGraphicsDriver::BitmapToVideoMemConvert(
         const Bitmap *bitmap, const TextureTile *tile,
-        uint8_t *dst_ptr, const int dst_pitch)
+        uint8_t *dst_ptr, const int dst_pitch, PixelConvertMode mode)
 {
-    // tell the compiler these won't change mid loop execution
-    const int t_width = tile->width;
-    const int t_height = tile->height;
-    const int t_x = tile->x;
-    const int t_y = tile->y;
-
-    const int idst_pitch = dst_pitch * sizeof(uint8_t) / sizeof(uint32_t); // destination is always 32-bit
-    auto idst = reinterpret_cast<uint32_t*>(dst_ptr);
+    const int color_depth = bitmap->GetColorDepth();
+    PfnConvertRow convert_row = GetRowConverter(color_depth);
+    if (!convert_row)
+        return;
 
-    for (int y = 0; y < t_height; y++)
+    PixelConvertParams params;
+    params.Dst = PixelFormat(_vmem_r_shift_32, _vmem_g_shift_32, _vmem_b_shift_32, _vmem_a_shift_32);
+    params.Mode = mode;
+    uint32_t palette[256];
+    switch (color_depth)
     {
-        const uint8_t *scanline_at = bitmap->GetScanLine(y + t_y);
-        for (int x = 0; x < t_width; x++)
+    case 8:
+        // 8-bit pixels are converted using the current palette, prepare the final colors
+        for (int i = 0; i < 256; ++i)
         {
-            auto srcData = (const T *) &scanline_at[(x + t_x) * sizeof(T)];
-            const T src_color = srcData[0];
-            if (HasAlpha)
-            {
-                idst[x] = VMEMCOLOR_RGBA(algetr<T>(src_color), algetg<T>(src_color), algetb<T>(src_color),
-                    algeta<T>(src_color));
-            }
-            else if (is_color_mask<T>(src_color))
-            {
-                idst[x] = 0;
-            }
+            const uint8_t c = static_cast<uint8_t>(i);
+            if ((mode == kPxConvert_MaskToAlpha) && is_color_mask<uint8_t>(c))
+                palette[i] = 0;
             else
-            {
-                idst[x] = VMEMCOLOR_RGBA(algetr<T>(src_color), algetg<T>(src_color), algetb<T>(src_color),
-                    0xFF);
-            }
+                palette[i] = VMEMCOLOR_RGBA(algetr<uint8_t>(c), algetg<uint8_t>(c), algetb<uint8_t>(c), 0xFF);
         }
-        idst += idst_pitch;
+        params.Palette = palette;
+        break;
+    case 16:
+        params.Src = PixelFormat(_rgb_r_shift_16, _rgb_g_shift_16, _rgb_b_shift_16);
+        params.GreenBits = 6;
+        params.MaskColor = MASK_COLOR_16;
+        break;
+    case 32:
+        params.Src = PixelFormat(_rgb_r_shift_32, _rgb_g_shift_32, _rgb_b_shift_32, _rgb_a_shift_32);
+        params.MaskColor = MASK_COLOR_32;
+        break;
+    default:
+        return;
     }
-}
 
-// Template helper function which converts bitmap to a video memory buffer,
-// assuming that the destination is always opaque (alpha channel is filled with 0xFF)
-template <typename T> void
-GPUGraphicsDriver::BitmapToVideoMemOpaqueImpl(
-        const Bitmap *bitmap, const TextureTile *tile,
-        uint8_t *dst_ptr, const int dst_pitch)
-{
-    // tell the compiler these won't change mid loop execution
-    const int t_width = tile->width;
-    const int t_height = tile->height;
-    const int t_x = tile->x;
-    const int t_y = tile->y;
-
-    const int idst_pitch = dst_pitch * sizeof(uint8_t) / sizeof(uint32_t); // destination is always 32-bit
-    auto idst = reinterpret_cast<uint32_t*>(dst_ptr);
-
-    for (int y = 0; y < t_height; y++)
+    const int bpp = bitmap->GetBPP();
+    for (int y = 0; y < tile->height; ++y)
     {
-        const uint8_t* scanline_at = bitmap->GetScanLine(y + t_y);
-        for (int x = 0; x < t_width; x++)
-        {
-            auto srcData = (const T *)&scanline_at[(x + t_x) * sizeof(T)];
-            const T src_color = srcData[0];
-            idst[x] = VMEMCOLOR_RGBA(algetr<T>(src_color), algetg<T>(src_color), algetb<T>(src_color), 0xFF);
-        }
-        idst += idst_pitch;
+        convert_row(reinterpret_cast<uint32_t*>(dst_ptr),
+            bitmap->GetScanLine(y + tile->y) + tile->x * bpp, tile->width, params);
+        dst_ptr += dst_pitch;
     }
 }
 
@@ -544,36 +555,28 @@ GPUGraphicsDriver::BitmapToVideoMemLinearImpl(
 void GPUGraphicsDriver::BitmapToVideoMem(const Bitmap *bitmap, const TextureTile *tile,
     uint8_t *dst_ptr, const int dst_pitch, const bool has_alpha, const bool linear_filter)
 {
+    if (!linear_filter)
+    {
+        // Only 32-bit bitmaps may have alpha channel
+        const bool copy_alpha = has_alpha && (bitmap->GetColorDepth() == 32);
+        BitmapToVideoMemConvert(bitmap, tile, dst_ptr, dst_pitch,
+            copy_alpha ? kPxConvert_CopyAlpha : kPxConvert_MaskToAlpha);
+        return;
+    }
+
     switch (bitmap->GetColorDepth())
     {
         case 8:
-            if (linear_filter) {
-                BitmapToVideoMemLinearImpl<uint8_t, false>(bitmap, tile, dst_ptr, dst_pitch);
-            } else {
-                BitmapToVideoMemImpl<uint8_t, false>(bitmap, tile, dst_ptr, dst_pitch);
-            }
-
+            BitmapToVideoMemLinearImpl<uint8_t, false>(bitmap, tile, dst_ptr, dst_pitch);
             break;
         case 16:
-            if (linear_filter) {
-                BitmapToVideoMemLinearImpl<uint16_t, false>(bitmap, tile, dst_ptr, dst_pitch);
-            } else {
-                BitmapToVideoMemImpl<uint16_t, false>(bitmap, tile, dst_ptr, dst_pitch);
-            }
+            BitmapToVideoMemLinearImpl<uint16_t, false>(bitmap, tile, dst_ptr, dst_pitch);
             break;
         case 32:
-            if (linear_filter) {
-                if (has_alpha) {
-                    BitmapToVideoMemLinearImpl<uint32_t, true>(bitmap, tile, dst_ptr, dst_pitch);
-                } else {
-                    BitmapToVideoMemLinearImpl<uint32_t, false>(bitmap, tile, dst_ptr, dst_pitch);
-                }
+            if (has_alpha) {
+                BitmapToVideoMemLinearImpl<uint32_t, true>(bitmap, tile, dst_ptr, dst_pitch);
             } else {
-                if (has_alpha) {
-                    BitmapToVideoMemImpl<uint32_t, true>(bitmap, tile, dst_ptr, dst_pitch);
-                } else {
-                    BitmapToVideoMemImpl<uint32_t, false>(bitmap, tile, dst_ptr, dst_pitch);
-                }
+                BitmapToVideoMemLinearImpl<uint32_t, false>(bitmap, tile, dst_ptr, dst_pitch);
             }
             break;
         default:
@@ -584,20 +587,7 @@ void GPUGraphicsDriver::BitmapToVideoMem(const Bitmap *bitmap, const TextureTile
 void GPUGraphicsDriver::BitmapToVideoMemOpaque(const Bitmap *bitmap, const TextureTile *tile,
     uint8_t *dst_ptr, const int dst_pitch)
 {
-    switch (bitmap->GetColorDepth())
-    {
-        case 8:
-            BitmapToVideoMemOpaqueImpl<uint8_t>(bitmap, tile, dst_ptr, dst_pitch);
-            break;
-        case 16:
-            BitmapToVideoMemOpaqueImpl<uint16_t>(bitmap, tile, dst_ptr, dst_pitch);
-            break;
-        case 32:
-            BitmapToVideoMemOpaqueImpl<uint32_t>(bitmap, tile, dst_ptr, dst_pitch);
-            break;
-        default:
-            break;
-    }
+    BitmapToVideoMemConvert(bitmap, tile, dst_ptr, dst_pitch, kPxConvert_Opaque);
 }
 
 
@@ -24,6 +24,8 @@
 #include "gfx/ddb.h"
 #include "gfx/gfx_def.h"
 #include "gfx/graphicsdriver.h"
+#include "gfx/pixel_convert.h"
+#include "gfx/scene_tracker.h"
 #include "util/scaling.h"
 #include "util/resourcecache.h"
 
@@ -367,6 +369,18 @@ public:
     // for compatibility reasons.
     bool UsesMemoryBackBuffer() override { return false; }
 
+    ///////////////////////////////////////////////////////
+    // Miscelaneous setup
+    //
+    // Enables or disables skipping the frames which scene is same as the previous one
+    void SetSkipUnchangedFrames(bool enabled) override;
+
+    ///////////////////////////////////////////////////////
+    // Rendering and presenting
+    //
+    // Tells if the last call to Render() has skipped the frame
+    bool WasLastFrameSkipped() const override { return _lastFrameSkipped; }
+
     ///////////////////////////////////////////////////////
     // Texture management
     // 
@@ -394,6 +408,35 @@ public:
     bool    GetStageMatrixes(RenderMatrixes &rm) override;
 
 protected:
+    // Any change to the display mode or scaling requires to redraw the frame
+    void OnModeSet(const DisplayMode &mode) override;
+    void OnSetNativeRes(const GraphicResolution &native_res) override;
+    void OnSetRenderFrame(const Rect &dst_rect) override;
+    void OnSetFilter() override;
+
+    // Tells if the current draw lists have to be rendered and presented;
+    // returns false if skipping unchanged frames is enabled, and the scene
+    // is same as in the previously rendered frame.
+    template <class T_DDB>
+    bool ShouldRenderFrame(const std::vector<SpriteDrawListEntry<T_DDB>> &sprites)
+    {
+        if (!_skipUnchangedFrames)
+            return true;
+        _sceneTracker.BeginFrame();
+        for (const auto &desc : _spriteBatchDesc)
+            _sceneTracker.AddBatch(SceneBatchRecord(desc));
+        for (const auto &e : sprites)
+        {
+            if (e.skip)
+                continue;
+            if (e.ddb)
+                _sceneTracker.AddSprite(SceneSpriteRecord(e.node, e.x, e.y, e.ddb, e.ddb->GetTexture()));
+            else
+                _sceneTracker.AddEvent(); // render callback
+        }
+        return _sceneTracker.EndFrame();
+    }
+
     // Prepares bitmap to be applied to the texture, copies pixels to the provided buffer
     void BitmapToVideoMem(const Bitmap *bitmap, const TextureTile *tile,
                         uint8_t *dst_ptr, const int dst_pitch, const bool has_alpha, const bool linear_filter);
@@ -436,6 +479,11 @@ protected:
     int _vmem_g_shift_32;
     int _vmem_b_shift_32;
 
+    // Compares the draw lists of the consecutive frames
+    SceneChangeTracker _sceneTracker;
+    bool _skipUnchangedFrames = false;
+    bool _lastFrameSkipped = false;
+
 private:
     // Stage virtual screens are used to let plugins draw custom graphics
     // in between render stages (between room and GUI, after GUI, and so on).
@@ -464,17 +512,10 @@ private:
     std::vector<ScreenFx> _fxPool;
     size_t _fxIndex; // next free pool item
 
-    // specialized method to convert bitmap to video memory depending on bit depth
-    template <typename T, bool HasAlpha> void
-    BitmapToVideoMemImpl(
-            const Bitmap *bitmap, const TextureTile *tile,
-            uint8_t *dst_ptr, const int dst_pitch
-    );
-
-    template <typename T> void
-    BitmapToVideoMemOpaqueImpl(
+    // converts bitmap to video memory using the row converters
+    void BitmapToVideoMemConvert(
             const Bitmap *bitmap, const TextureTile *tile,
-            uint8_t *dst_ptr, const int dst_pitch
+            uint8_t *dst_ptr, const int dst_pitch, PixelConvertMode mode
     );
 
     template <typename T, bool HasAlpha> void
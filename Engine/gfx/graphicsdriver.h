@@ -165,6 +165,12 @@ public:
     virtual void RenderSpritesAtScreenResolution(bool enabled) = 0;
     // Enables or disables a smooth sprite scaling mode
     virtual void UseSmoothScaling(bool enabled) = 0;
+    // Sets the number of threads the renderer may draw the scene with;
+    // 0 means to choose automatically. Only used by the software renderer.
+    virtual void SetRenderThreads(int count) = 0;
+    // Enables or disables skipping the render and present of the frames
+    // which scene is same as the previous one. Only used by the hardware-accelerated renderers.
+    virtual void SetSkipUnchangedFrames(bool enabled) = 0;
     // Tells if driver supports gamma control
     virtual bool SupportsGammaControl() = 0;
     // Sets gamma level
@@ -198,8 +204,15 @@ public:
     virtual Texture *CreateTexture(int width, int height, int color_depth, int txflags = kTxFlags_None) = 0;
     // Create texture and initialize its pixels from the given bitmap
     virtual Texture *CreateTexture(const Bitmap *bmp, int txflags = kTxFlags_None) = 0;
+    // Create texture data which refers to a region of another texture (an atlas page);
+    // the region must have at least 1 pixel of unused space around it, as the renderer
+    // may write clamped edges there. Returns nullptr if not supported by the renderer.
+    virtual Texture *CreateTextureRegion(std::shared_ptr<Texture> page, const Rect &region, int color_depth) = 0;
     // Update texture data from the given bitmap
     virtual void UpdateTexture(Texture *txdata, const Bitmap *bmp, bool has_alpha, bool opaque = false) = 0;
+    // Update only the given area of the texture data from the same area of the bitmap;
+    // the texture must be the same size as the bitmap
+    virtual void UpdateTexture(Texture *txdata, const Bitmap *bmp, const Rect &area, bool has_alpha, bool opaque = false) = 0;
     // Retrieve shared texture object from the given DDB
     virtual std::shared_ptr<Texture> GetTexture(IDriverDependantBitmap *ddb) = 0;
 
@@ -259,6 +272,9 @@ public:
     // TODO: leftover from old code, solely for software renderer; remove when
     // software mode either discarded or scene node graph properly implemented.
     virtual void Render(int xoff, int yoff, Common::GraphicFlip flip) = 0;
+    // Tells if the last call to Render() has skipped the frame, because
+    // its draw lists were same as the previous one's.
+    virtual bool WasLastFrameSkipped() const = 0;
     // Renders draw lists onto the provided texture;
     // target DDB must be created using CreateRenderTargetDDB!
     virtual void Render(IDriverDependantBitmap *target) = 0;
@@ -0,0 +1,313 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2026 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include "gfx/pixel_convert.h"
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define AGS_PXCONVERT_SSE2 (1)
+#include <emmintrin.h>
+#endif
+
+namespace AGS
+{
+namespace Engine
+{
+
+namespace
+{
+
+inline bool IsSameFormat(const PixelFormat &f1, const PixelFormat &f2)
+{
+    return f1.RShift == f2.RShift && f1.GShift == f2.GShift &&
+        f1.BShift == f2.BShift && f1.AShift == f2.AShift;
+}
+
+//-----------------------------------------------------------------------------
+// Scalar implementation, also used for the remainders of the SIMD rows
+//-----------------------------------------------------------------------------
+void ConvertRow8Scalar(uint32_t *dst, const void *src, size_t count, const PixelConvertParams &params)
+{
+    const uint8_t *src8 = static_cast<const uint8_t*>(src);
+    const uint32_t *palette = params.Palette;
+    for (size_t i = 0; i < count; ++i)
+        dst[i] = palette[src8[i]];
+}
+
+// Expands the 5 or 6-bit component to 8 bits, same as Allegro's _rgb_scale_5/6 tables
+inline uint32_t ExpandComponent(uint32_t c, int bits)
+{
+    return (c << (8 - bits)) | (c >> (2 * bits - 8));
+}
+
+template <PixelConvertMode Mode>
+void ConvertPixels16Scalar(uint32_t *dst, const uint16_t *src, size_t count, const PixelConvertParams &params)
+{
+    const PixelFormat &sf = params.Src;
+    const PixelFormat &df = params.Dst;
+    const int g_bits = params.GreenBits;
+    const uint32_t g_mask = (1u << g_bits) - 1;
+    const uint32_t alpha = 0xFFu << df.AShift;
+    for (size_t i = 0; i < count; ++i)
+    {
+        const uint32_t c = src[i];
+        if ((Mode == kPxConvert_MaskToAlpha) && (c == params.MaskColor))
+        {
+            dst[i] = 0;
+            continue;
+        }
+        const uint32_t r = ExpandComponent((c >> sf.RShift) & 0x1F, 5);
+        const uint32_t g = ExpandComponent((c >> sf.GShift) & g_mask, g_bits);
+        const uint32_t b = ExpandComponent((c >> sf.BShift) & 0x1F, 5);
+        dst[i] = (r << df.RShift) | (g << df.GShift) | (b << df.BShift) | alpha;
+    }
+}
+
+template <PixelConvertMode Mode>
+void ConvertPixels32Scalar(uint32_t *dst, const uint32_t *src, size_t count, const PixelConvertParams &params)
+{
+    const PixelFormat &sf = params.Src;
+    const PixelFormat &df = params.Dst;
+    const uint32_t alpha = 0xFFu << df.AShift;
+    for (size_t i = 0; i < count; ++i)
+    {
+        const uint32_t c = src[i];
+        if ((Mode == kPxConvert_MaskToAlpha) && (c == params.MaskColor))
+        {
+            dst[i] = 0;
+            continue;
+        }
+        const uint32_t rgb = (((c >> sf.RShift) & 0xFF) << df.RShift) |
+            (((c >> sf.GShift) & 0xFF) << df.GShift) |
+            (((c >> sf.BShift) & 0xFF) << df.BShift);
+        if (Mode == kPxConvert_CopyAlpha)
+            dst[i] = rgb | (((c >> sf.AShift) & 0xFF) << df.AShift);
+        else
+            dst[i] = rgb | alpha;
+    }
+}
+
+void ConvertRow16Scalar(uint32_t *dst, const void *src, size_t count, const PixelConvertParams &params)
+{
+    const uint16_t *src16 = static_cast<const uint16_t*>(src);
+    if (params.Mode == kPxConvert_MaskToAlpha)
+        ConvertPixels16Scalar<kPxConvert_MaskToAlpha>(dst, src16, count, params);
+    else
+        ConvertPixels16Scalar<kPxConvert_Opaque>(dst, src16, count, params);
+}
+
+void ConvertRow32Scalar(uint32_t *dst, const void *src, size_t count, const PixelConvertParams &params)
+{
+    const uint32_t *src32 = static_cast<const uint32_t*>(src);
+    switch (params.Mode)
+    {
+    case kPxConvert_MaskToAlpha:
+        ConvertPixels32Scalar<kPxConvert_MaskToAlpha>(dst, src32, count, params);
+        break;
+    case kPxConvert_CopyAlpha:
+        if (IsSameFormat(params.Src, params.Dst))
+            memcpy(dst, src32, count * sizeof(uint32_t));
+        else
+            ConvertPixels32Scalar<kPxConvert_CopyAlpha>(dst, src32, count, params);
+        break;
+    default:
+        ConvertPixels32Scalar<kPxConvert_Opaque>(dst, src32, count, params);
+        break;
+    }
+}
+
+#if defined(AGS_PXCONVERT_SSE2)
+//-----------------------------------------------------------------------------
+// SSE2 implementation: 8 pixels at a time for 16-bit, and 4 for 32-bit
+//-----------------------------------------------------------------------------
+// Component shifts prepared for the SSE2 shift instructions
+struct SSE2Format
+{
+    __m128i SrcR, SrcG, SrcB, SrcA;
+    __m128i DstR, DstG, DstB, DstA;
+
+    SSE2Format(const PixelConvertParams &params)
+        : SrcR(_mm_cvtsi32_si128(params.Src.RShift))
+        , SrcG(_mm_cvtsi32_si128(params.Src.GShift))
+        , SrcB(_mm_cvtsi32_si128(params.Src.BShift))
+        , SrcA(_mm_cvtsi32_si128(params.Src.AShift))
+        , DstR(_mm_cvtsi32_si128(params.Dst.RShift))
+        , DstG(_mm_cvtsi32_si128(params.Dst.GShift))
+        , DstB(_mm_cvtsi32_si128(params.Dst.BShift))
+        , DstA(_mm_cvtsi32_si128(params.Dst.AShift))
+    {}
+};
+
+template <PixelConvertMode Mode>
+void ConvertPixels16SSE2(uint32_t *dst, const uint16_t *src, size_t count, const PixelConvertParams &params)
+{
+    const SSE2Format fmt(params);
+    const int g_bits = params.GreenBits;
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i mask5 = _mm_set1_epi32(0x1F);
+    const __m128i g_mask = _mm_set1_epi32((1 << g_bits) - 1);
+    const __m128i g_up = _mm_cvtsi32_si128(8 - g_bits);
+    const __m128i g_down = _mm_cvtsi32_si128(2 * g_bits - 8);
+    const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFFu << params.Dst.AShift));
+    const __m128i mask_color = _mm_set1_epi32(static_cast<int>(params.MaskColor));
+
+    // Converts 4 pixels, zero-extended to 32 bits
+    auto convert4 = [&](__m128i c)
+    {
+        __m128i r = _mm_and_si128(_mm_srl_epi32(c, fmt.SrcR), mask5);
+        __m128i g = _mm_and_si128(_mm_srl_epi32(c, fmt.SrcG), g_mask);
+        __m128i b = _mm_and_si128(_mm_srl_epi32(c, fmt.SrcB), mask5);
+        r = _mm_or_si128(_mm_slli_epi32(r, 3), _mm_srli_epi32(r, 2));
+        g = _mm_or_si128(_mm_sll_epi32(g, g_up), _mm_srl_epi32(g, g_down));
+        b = _mm_or_si128(_mm_slli_epi32(b, 3), _mm_srli_epi32(b, 2));
+        __m128i res = _mm_or_si128(
+            _mm_or_si128(_mm_sll_epi32(r, fmt.DstR), _mm_sll_epi32(g, fmt.DstG)),
+            _mm_or_si128(_mm_sll_epi32(b, fmt.DstB), alpha));
+        if (Mode == kPxConvert_MaskToAlpha)
+            res = _mm_andnot_si128(_mm_cmpeq_epi32(c, mask_color), res);
+        return res;
+    };
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), convert4(_mm_unpacklo_epi16(px, zero)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 4), convert4(_mm_unpackhi_epi16(px, zero)));
+    }
+    ConvertPixels16Scalar<Mode>(dst + i, src + i, count - i, params);
+}
+
+template <PixelConvertMode Mode>
+void ConvertPixels32SSE2(uint32_t *dst, const uint32_t *src, size_t count, const PixelConvertParams &params)
+{
+    const SSE2Format fmt(params);
+    const __m128i mask8 = _mm_set1_epi32(0xFF);
+    const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFFu << params.Dst.AShift));
+    const __m128i mask_color = _mm_set1_epi32(static_cast<int>(params.MaskColor));
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        const __m128i r = _mm_and_si128(_mm_srl_epi32(c, fmt.SrcR), mask8);
+        const __m128i g = _mm_and_si128(_mm_srl_epi32(c, fmt.SrcG), mask8);
+        const __m128i b = _mm_and_si128(_mm_srl_epi32(c, fmt.SrcB), mask8);
+        const __m128i a = (Mode == kPxConvert_CopyAlpha) ?
+            _mm_sll_epi32(_mm_and_si128(_mm_srl_epi32(c, fmt.SrcA), mask8), fmt.DstA) : alpha;
+        __m128i res = _mm_or_si128(
+            _mm_or_si128(_mm_sll_epi32(r, fmt.DstR), _mm_sll_epi32(g, fmt.DstG)),
+            _mm_or_si128(_mm_sll_epi32(b, fmt.DstB), a));
+        if (Mode == kPxConvert_MaskToAlpha)
+            res = _mm_andnot_si128(_mm_cmpeq_epi32(c, mask_color), res);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), res);
+    }
+    ConvertPixels32Scalar<Mode>(dst + i, src + i, count - i, params);
+}
+
+void ConvertRow16SSE2(uint32_t *dst, const void *src, size_t count, const PixelConvertParams &params)
+{
+    const uint16_t *src16 = static_cast<const uint16_t*>(src);
+    if (params.Mode == kPxConvert_MaskToAlpha)
+        ConvertPixels16SSE2<kPxConvert_MaskToAlpha>(dst, src16, count, params);
+    else
+        ConvertPixels16SSE2<kPxConvert_Opaque>(dst, src16, count, params);
+}
+
+void ConvertRow32SSE2(uint32_t *dst, const void *src, size_t count, const PixelConvertParams &params)
+{
+    const uint32_t *src32 = static_cast<const uint32_t*>(src);
+    switch (params.Mode)
+    {
+    case kPxConvert_MaskToAlpha:
+        ConvertPixels32SSE2<kPxConvert_MaskToAlpha>(dst, src32, count, params);
+        break;
+    case kPxConvert_CopyAlpha:
+        if (IsSameFormat(params.Src, params.Dst))
+            memcpy(dst, src32, count * sizeof(uint32_t));
+        else
+            ConvertPixels32SSE2<kPxConvert_CopyAlpha>(dst, src32, count, params);
+        break;
+    default:
+        ConvertPixels32SSE2<kPxConvert_Opaque>(dst, src32, count, params);
+        break;
+    }
+}
+#endif // AGS_PXCONVERT_SSE2
+
+// Converters table for every implementation; null if not supported
+struct RowConvertersTable
+{
+    // Converters for 8, 16 and 32-bit sources
+    PfnConvertRow Converters[kNumPxConvertImpls][3] = {};
+    PixelConvertImpl Best = kPxConvertImpl_Scalar;
+
+    RowConvertersTable()
+    {
+        Converters[kPxConvertImpl_Scalar][0] = ConvertRow8Scalar;
+        Converters[kPxConvertImpl_Scalar][1] = ConvertRow16Scalar;
+        Converters[kPxConvertImpl_Scalar][2] = ConvertRow32Scalar;
+#if defined(AGS_PXCONVERT_SSE2)
+        // Palette lookups cannot be vectorized with SSE2
+        Converters[kPxConvertImpl_SSE2][0] = ConvertRow8Scalar;
+        Converters[kPxConvertImpl_SSE2][1] = ConvertRow16SSE2;
+        Converters[kPxConvertImpl_SSE2][2] = ConvertRow32SSE2;
+        Best = kPxConvertImpl_SSE2;
+#endif
+    }
+};
+
+const RowConvertersTable &GetConvertersTable()
+{
+    static const RowConvertersTable table;
+    return table;
+}
+
+} // namespace
+
+PixelConvertImpl GetPixelConvertImpl()
+{
+    return GetConvertersTable().Best;
+}
+
+const char *GetPixelConvertImplName(PixelConvertImpl impl)
+{
+    switch (impl)
+    {
+    case kPxConvertImpl_Scalar: return "Scalar";
+    case kPxConvertImpl_SSE2: return "SSE2";
+    default: return "Unknown";
+    }
+}
+
+PfnConvertRow GetRowConverter(int src_depth, PixelConvertImpl impl)
+{
+    if (impl < 0 || impl >= kNumPxConvertImpls)
+        return nullptr;
+    switch (src_depth)
+    {
+    case 8: return GetConvertersTable().Converters[impl][0];
+    case 15:
+    case 16: return GetConvertersTable().Converters[impl][1];
+    case 32: return GetConvertersTable().Converters[impl][2];
+    default: return nullptr;
+    }
+}
+
+PfnConvertRow GetRowConverter(int src_depth)
+{
+    return GetRowConverter(src_depth, GetPixelConvertImpl());
+}
+
+} // namespace Engine
+} // namespace AGS
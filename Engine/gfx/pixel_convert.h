@@ -0,0 +1,98 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2026 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+//
+// Row converters: functions that convert whole rows of 8, 16 and 32-bit
+// bitmap pixels into the 32-bit video memory format, for uploading to
+// textures. The results are exactly the same as when converting each pixel
+// using Allegro's getr/getg/getb functions, but several pixels are processed
+// at a time using the SIMD instructions, where these are available.
+//
+// 8-bit pixels are converted using a lookup table, which has to be prepared
+// from the current palette by the caller. 16-bit pixels have their 5 and 6-bit
+// components expanded to 8 bits. 32-bit pixels are rearranged, and either
+// have their alpha copied, or the mask color pixels made transparent.
+//
+//=============================================================================
+#ifndef __AGS_EE_GFX__PIXELCONVERT_H
+#define __AGS_EE_GFX__PIXELCONVERT_H
+
+#include "platform/types.h"
+
+namespace AGS
+{
+namespace Engine
+{
+
+// Layout of the 16 or 32-bit pixel: bit shifts of each color component
+struct PixelFormat
+{
+    int RShift = 0, GShift = 0, BShift = 0, AShift = 0;
+
+    PixelFormat() = default;
+    PixelFormat(int r_shift, int g_shift, int b_shift, int a_shift = 0)
+        : RShift(r_shift), GShift(g_shift), BShift(b_shift), AShift(a_shift) {}
+};
+
+// Defines how the alpha of the converted pixels is filled
+enum PixelConvertMode
+{
+    // Mask color pixels become fully transparent black, others are opaque
+    kPxConvert_MaskToAlpha,
+    // Alpha is copied from the source pixels (32-bit only)
+    kPxConvert_CopyAlpha,
+    // All pixels are opaque
+    kPxConvert_Opaque
+};
+
+// Row converters implementations
+enum PixelConvertImpl
+{
+    kPxConvertImpl_Scalar,
+    kPxConvertImpl_SSE2,
+    kNumPxConvertImpls
+};
+
+struct PixelConvertParams
+{
+    // Source pixel layout (16 and 32-bit)
+    PixelFormat Src;
+    // Number of bits in the green component of a 16-bit pixel: 6 for 565, 5 for 555
+    int GreenBits = 6;
+    // Destination pixel layout
+    PixelFormat Dst;
+    PixelConvertMode Mode = kPxConvert_MaskToAlpha;
+    // Source mask color (16 and 32-bit)
+    uint32_t MaskColor = 0u;
+    // Lookup table of 256 final destination colors (8-bit);
+    // the mask color and the mode must already be applied to it
+    const uint32_t *Palette = nullptr;
+};
+
+// Converts a row of src pixels into dst pixels
+typedef void (*PfnConvertRow)(uint32_t *dst, const void *src, size_t count, const PixelConvertParams &params);
+
+// Returns the best row converters implementation supported by this system
+PixelConvertImpl GetPixelConvertImpl();
+// Returns the implementation's name, for logging purposes
+const char *GetPixelConvertImplName(PixelConvertImpl impl);
+// Returns the row converter for the given source color depth (8, 15, 16 or 32)
+// of the given implementation, or null if it's not supported by this system
+PfnConvertRow GetRowConverter(int src_depth, PixelConvertImpl impl);
+// Returns the row converter of the best supported implementation
+PfnConvertRow GetRowConverter(int src_depth);
+
+} // namespace Engine
+} // namespace AGS
+
+#endif // __AGS_EE_GFX__PIXELCONVERT_H
@@ -0,0 +1,142 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2026 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include "gfx/scene_tracker.h"
+#include <cstring>
+#include <utility>
+#include "gfx/gfxdriverbase.h"
+
+namespace AGS
+{
+namespace Engine
+{
+
+SceneBatchRecord::SceneBatchRecord(const SpriteBatchDesc &desc)
+    : Parent(desc.Parent)
+    , Viewport(desc.Viewport)
+    , X(desc.Transform.X)
+    , Y(desc.Transform.Y)
+    , ScaleX(desc.Transform.ScaleX)
+    , ScaleY(desc.Transform.ScaleY)
+    , Rotate(desc.Transform.Rotate)
+    , Alpha(desc.Transform.Color.Alpha)
+    , Flip(desc.Flip)
+    , Surface(desc.Surface.get())
+    , RenderTarget(desc.RenderTarget)
+    , FilterFlags(desc.FilterFlags)
+{
+}
+
+// Compares float values bitwise: the record only has to tell if the same
+// value was assigned again, and there's no arithmetic involved
+static inline bool IsSameFloat(float a, float b)
+{
+    uint32_t bits_a, bits_b;
+    static_assert(sizeof(bits_a) == sizeof(a), "float is expected to be 32-bit");
+    std::memcpy(&bits_a, &a, sizeof(bits_a));
+    std::memcpy(&bits_b, &b, sizeof(bits_b));
+    return bits_a == bits_b;
+}
+
+bool SceneBatchRecord::operator ==(const SceneBatchRecord &other) const
+{
+    return Parent == other.Parent && Viewport == other.Viewport &&
+        X == other.X && Y == other.Y &&
+        IsSameFloat(ScaleX, other.ScaleX) && IsSameFloat(ScaleY, other.ScaleY) &&
+        IsSameFloat(Rotate, other.Rotate) &&
+        Alpha == other.Alpha && Flip == other.Flip &&
+        Surface == other.Surface && RenderTarget == other.RenderTarget &&
+        FilterFlags == other.FilterFlags;
+}
+
+SceneSpriteRecord::SceneSpriteRecord(uint32_t node, int x, int y, const BaseDDB *ddb, const Texture *tx)
+    : Node(node)
+    , X(x)
+    , Y(y)
+    , DDB(ddb)
+    , Tx(tx)
+    , TxStamp(tx ? tx->Stamp : 0u)
+    , Stretch(ddb->GetSizeToRender())
+    , Flip(ddb->GetFlip())
+    , Alpha(ddb->GetAlpha())
+    , LightLevel(ddb->GetLightLevel())
+    , TxFlags(ddb->GetTextureFlags())
+{
+    ddb->GetTint(TintR, TintG, TintB, TintSat);
+}
+
+bool SceneSpriteRecord::operator ==(const SceneSpriteRecord &other) const
+{
+    return Node == other.Node && X == other.X && Y == other.Y &&
+        DDB == other.DDB && Tx == other.Tx && TxStamp == other.TxStamp &&
+        Stretch == other.Stretch && Flip == other.Flip &&
+        Alpha == other.Alpha && LightLevel == other.LightLevel &&
+        TintR == other.TintR && TintG == other.TintG && TintB == other.TintB &&
+        TintSat == other.TintSat && TxFlags == other.TxFlags;
+}
+
+void SceneChangeTracker::BeginFrame()
+{
+    _batches.clear();
+    _sprites.clear();
+    _hasEvents = false;
+    _changed = !_hasPrevFrame;
+}
+
+template <typename TRecord>
+void SceneChangeTracker::Add(std::vector<TRecord> &cur, const std::vector<TRecord> &prev, const TRecord &rec)
+{
+    const size_t index = cur.size();
+    cur.push_back(rec);
+    if (!_changed)
+        _changed = (index >= prev.size()) || (prev[index] != rec);
+}
+
+void SceneChangeTracker::AddBatch(const SceneBatchRecord &batch)
+{
+    Add(_batches, _prevBatches, batch);
+}
+
+void SceneChangeTracker::AddSprite(const SceneSpriteRecord &sprite)
+{
+    Add(_sprites, _prevSprites, sprite);
+}
+
+void SceneChangeTracker::AddEvent()
+{
+    _hasEvents = true;
+    _changed = true;
+}
+
+bool SceneChangeTracker::EndFrame()
+{
+    // Less entries than in the previous frame also means a change
+    if (_batches.size() != _prevBatches.size() || _sprites.size() != _prevSprites.size())
+        _changed = true;
+    std::swap(_batches, _prevBatches);
+    std::swap(_sprites, _prevSprites);
+    // A frame with render events may not be compared with, as we do not
+    // know what the callbacks have drawn in it
+    _hasPrevFrame = !_hasEvents;
+    return _changed;
+}
+
+void SceneChangeTracker::Invalidate()
+{
+    _hasPrevFrame = false;
+    _prevBatches.clear();
+    _prevSprites.clear();
+}
+
+} // namespace Engine
+} // namespace AGS
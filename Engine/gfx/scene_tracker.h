@@ -0,0 +1,122 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2026 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+//
+// SceneChangeTracker compares the draw lists of two consecutive frames,
+// and tells whether the new frame would look any different on screen.
+// Each sprite batch and sprite entry is stored as a compact record of
+// everything that affects the rendered image: batch viewports, transforms
+// and targets, sprite positions and draw parameters, and the modification
+// stamps of the textures. Render events (plugin callbacks) may draw
+// anything, so a frame which has them is always considered changed.
+//
+//=============================================================================
+#ifndef __AGS_EE_GFX__SCENETRACKER_H
+#define __AGS_EE_GFX__SCENETRACKER_H
+
+#include <vector>
+#include "gfx/gfx_def.h"
+#include "platform/types.h"
+#include "util/geometry.h"
+
+namespace AGS
+{
+namespace Engine
+{
+
+class BaseDDB;
+struct SpriteBatchDesc;
+struct Texture;
+
+// A record of the sprite batch's parameters
+struct SceneBatchRecord
+{
+    uint32_t Parent = UINT32_MAX;
+    Rect Viewport;
+    int X = 0, Y = 0;
+    float ScaleX = 1.f, ScaleY = 1.f;
+    float Rotate = 0.f;
+    int Alpha = 255;
+    Common::GraphicFlip Flip = Common::kFlip_None;
+    const void *Surface = nullptr;
+    const void *RenderTarget = nullptr;
+    uint32_t FilterFlags = 0u;
+
+    SceneBatchRecord() = default;
+    SceneBatchRecord(const SpriteBatchDesc &desc);
+
+    bool operator ==(const SceneBatchRecord &other) const;
+    bool operator !=(const SceneBatchRecord &other) const { return !(*this == other); }
+};
+
+// A record of the sprite entry's parameters
+struct SceneSpriteRecord
+{
+    uint32_t Node = 0u;
+    int X = 0, Y = 0;
+    const void *DDB = nullptr;
+    const void *Tx = nullptr;
+    uint64_t TxStamp = 0u;
+    Size Stretch;
+    Common::GraphicFlip Flip = Common::kFlip_None;
+    int Alpha = 255;
+    int LightLevel = 0;
+    int TintR = 0, TintG = 0, TintB = 0, TintSat = 0;
+    int TxFlags = 0;
+
+    SceneSpriteRecord() = default;
+    SceneSpriteRecord(uint32_t node, int x, int y, const BaseDDB *ddb, const Texture *tx);
+
+    bool operator ==(const SceneSpriteRecord &other) const;
+    bool operator !=(const SceneSpriteRecord &other) const { return !(*this == other); }
+};
+
+class SceneChangeTracker
+{
+public:
+    // Starts recording a new frame
+    void BeginFrame();
+    // Records a sprite batch, in the order of their indexes
+    void AddBatch(const SceneBatchRecord &batch);
+    // Records a sprite entry, in the draw order
+    void AddSprite(const SceneSpriteRecord &sprite);
+    // Records a render event; this marks the frame as changed
+    void AddEvent();
+    // Ends recording a frame; compares it with the previous one, and
+    // keeps it for the next comparison. Returns whether the frame has changed.
+    bool EndFrame();
+    // Forgets the previous frame, making the next one count as changed
+    void Invalidate();
+
+    // Tells if this frame is changed so far; valid during recording
+    bool IsChanged() const { return _changed; }
+
+private:
+    // Notes the difference if a new record does not match the previous frame
+    template <typename TRecord>
+    void Add(std::vector<TRecord> &cur, const std::vector<TRecord> &prev, const TRecord &rec);
+
+    std::vector<SceneBatchRecord> _batches, _prevBatches;
+    std::vector<SceneSpriteRecord> _sprites, _prevSprites;
+    // Whether there's any previous frame to compare with
+    bool _hasPrevFrame = false;
+    // Whether the frame recorded so far has any render events
+    bool _hasEvents = false;
+    // Whether the frame recorded so far is different from the previous one
+    bool _changed = true;
+};
+
+} // namespace Engine
+} // namespace AGS
+
+#endif // __AGS_EE_GFX__SCENETRACKER_H
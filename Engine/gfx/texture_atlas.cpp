@@ -0,0 +1,271 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2026 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include "gfx/texture_atlas.h"
+#include <algorithm>
+#include <limits>
+
+namespace AGS
+{
+namespace Engine
+{
+
+SkylinePacker::SkylinePacker(int width, int height)
+{
+    Reset(width, height);
+}
+
+void SkylinePacker::Reset()
+{
+    _skyline.clear();
+    _skyline.push_back(Segment(0, 0, _width));
+    _usedArea = 0u;
+}
+
+void SkylinePacker::Reset(int width, int height)
+{
+    _width = std::max(0, width);
+    _height = std::max(0, height);
+    Reset();
+}
+
+int SkylinePacker::Fit(size_t index, int width, int height) const
+{
+    const int x = _skyline[index].X;
+    if (x + width > _width)
+        return -1;
+    int y = _skyline[index].Y;
+    int width_left = width;
+    for (size_t i = index; width_left > 0; ++i)
+    {
+        y = std::max(y, _skyline[i].Y);
+        if (y + height > _height)
+            return -1;
+        width_left -= _skyline[i].Width;
+    }
+    return y;
+}
+
+bool SkylinePacker::Insert(int width, int height, Point &pos)
+{
+    if (width <= 0 || height <= 0)
+        return false;
+
+    // Find the position where the rectangle's bottom is the lowest,
+    // prefer narrower segments on a tie
+    size_t best_index = SIZE_MAX;
+    int best_bottom = std::numeric_limits<int>::max();
+    int best_width = std::numeric_limits<int>::max();
+    int best_y = 0;
+    for (size_t i = 0; i < _skyline.size(); ++i)
+    {
+        const int y = Fit(i, width, height);
+        if (y < 0)
+            continue;
+        if ((y + height < best_bottom) ||
+            ((y + height == best_bottom) && (_skyline[i].Width < best_width)))
+        {
+            best_index = i;
+            best_bottom = y + height;
+            best_width = _skyline[i].Width;
+            best_y = y;
+        }
+    }
+    if (best_index == SIZE_MAX)
+        return false;
+
+    // Raise the skyline over the new rectangle
+    const Segment seg(_skyline[best_index].X, best_y + height, width);
+    _skyline.insert(_skyline.begin() + best_index, seg);
+    for (size_t i = best_index + 1; i < _skyline.size();)
+    {
+        const int shrink = seg.X + seg.Width - _skyline[i].X;
+        if (shrink <= 0)
+            break;
+        _skyline[i].X += shrink;
+        _skyline[i].Width -= shrink;
+        if (_skyline[i].Width > 0)
+            break;
+        _skyline.erase(_skyline.begin() + i);
+    }
+    // Merge the neighbour segments of equal height
+    for (size_t i = 0; i + 1 < _skyline.size();)
+    {
+        if (_skyline[i].Y == _skyline[i + 1].Y)
+        {
+            _skyline[i].Width += _skyline[i + 1].Width;
+            _skyline.erase(_skyline.begin() + i + 1);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+
+    _usedArea += static_cast<uint64_t>(width) * height;
+    pos = Point(seg.X, best_y);
+    return true;
+}
+
+
+TextureAtlas::TextureAtlas(int page_width, int page_height, size_t max_pages, int max_region_size, int padding)
+{
+    Configure(page_width, page_height, max_pages, max_region_size, padding);
+}
+
+void TextureAtlas::Configure(int page_width, int page_height, size_t max_pages, int max_region_size, int padding)
+{
+    Clear();
+    _pageWidth = std::max(0, page_width);
+    _pageHeight = std::max(0, page_height);
+    _maxPages = max_pages;
+    _padding = std::max(0, padding);
+    // A region must fit into the page with its padding
+    _maxRegionSize = std::max(0,
+        std::min(max_region_size, std::min(_pageWidth, _pageHeight) - 2 * _padding));
+}
+
+bool TextureAtlas::CanPlace(int width, int height) const
+{
+    return IsEnabled() && width > 0 && height > 0 &&
+        width <= _maxRegionSize && height <= _maxRegionSize;
+}
+
+uint32_t TextureAtlas::Allocate(int width, int height, AtlasRegion &region)
+{
+    if (!CanPlace(width, height))
+        return UINT32_MAX;
+
+    const int cell_w = width + 2 * _padding;
+    const int cell_h = height + 2 * _padding;
+    Point pos;
+    size_t page = 0u;
+    for (; page < _pages.size(); ++page)
+    {
+        if (_pages[page].Packer.Insert(cell_w, cell_h, pos))
+            break;
+    }
+    if (page == _pages.size())
+    {
+        if (_pages.size() >= _maxPages)
+            return UINT32_MAX;
+        _pages.emplace_back();
+        _pages.back().Packer.Reset(_pageWidth, _pageHeight);
+        if (!_pages.back().Packer.Insert(cell_w, cell_h, pos))
+            return UINT32_MAX; // should not happen, as CanPlace tested the size
+    }
+
+    uint32_t handle;
+    if (!_freeHandles.empty())
+    {
+        handle = _freeHandles.back();
+        _freeHandles.pop_back();
+    }
+    else
+    {
+        handle = static_cast<uint32_t>(_regions.size());
+        _regions.emplace_back();
+    }
+
+    const uint64_t area = static_cast<uint64_t>(cell_w) * cell_h;
+    _regions[handle].Page = static_cast<uint32_t>(page);
+    _regions[handle].Area = area;
+    _pages[page].Regions++;
+    _pages[page].LiveArea += area;
+    region.Page = static_cast<uint32_t>(page);
+    region.Area = RectWH(pos.X + _padding, pos.Y + _padding, width, height);
+    return handle;
+}
+
+void TextureAtlas::Free(uint32_t handle)
+{
+    if (handle >= _regions.size() || _regions[handle].Page == UINT32_MAX)
+        return;
+
+    Page &page = _pages[_regions[handle].Page];
+    page.Regions--;
+    page.LiveArea -= _regions[handle].Area;
+    // When the last region is gone, all the dead space may be used again
+    if (page.Regions == 0u)
+        page.Packer.Reset();
+    _regions[handle] = RegionEntry();
+    _freeHandles.push_back(handle);
+}
+
+void TextureAtlas::Clear()
+{
+    _pages.clear();
+    _regions.clear();
+    _freeHandles.clear();
+}
+
+AtlasPageStats TextureAtlas::GetPageStats(size_t page) const
+{
+    AtlasPageStats stats;
+    if (page >= _pages.size())
+        return stats;
+    stats.Regions = _pages[page].Regions;
+    stats.LiveArea = _pages[page].LiveArea;
+    stats.UsedArea = _pages[page].Packer.GetUsedArea();
+    stats.PageArea = static_cast<uint64_t>(_pageWidth) * _pageHeight;
+    return stats;
+}
+
+AtlasStats TextureAtlas::GetStats() const
+{
+    AtlasStats stats;
+    for (size_t i = 0; i < _pages.size(); ++i)
+    {
+        const AtlasPageStats page = GetPageStats(i);
+        if (page.Regions == 0u)
+            continue;
+        stats.Pages++;
+        stats.Regions += page.Regions;
+        stats.LiveArea += page.LiveArea;
+        stats.UsedArea += page.UsedArea;
+        stats.PageArea += page.PageArea;
+    }
+    return stats;
+}
+
+uint32_t TextureAtlas::GetSparsestPage(unsigned max_occupancy) const
+{
+    uint32_t sparsest = UINT32_MAX;
+    uint64_t min_area = std::numeric_limits<uint64_t>::max();
+    for (size_t i = 0; i < _pages.size(); ++i)
+    {
+        const AtlasPageStats page = GetPageStats(i);
+        if ((page.Regions == 0u) || (page.GetOccupancy() >= max_occupancy))
+            continue;
+        if (page.LiveArea < min_area)
+        {
+            sparsest = static_cast<uint32_t>(i);
+            min_area = page.LiveArea;
+        }
+    }
+    return sparsest;
+}
+
+std::vector<uint32_t> TextureAtlas::GetPageRegions(uint32_t page) const
+{
+    std::vector<uint32_t> handles;
+    for (size_t i = 0; i < _regions.size(); ++i)
+    {
+        if (_regions[i].Page == page)
+            handles.push_back(static_cast<uint32_t>(i));
+    }
+    return handles;
+}
+
+} // namespace Engine
+} // namespace AGS
@@ -0,0 +1,172 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2026 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+//
+// TextureAtlas allocates regions for the small sprites on the large texture
+// pages, so that many sprites may share a single texture object.
+//
+// Each page is packed using the "skyline" method: the page keeps the
+// silhouette of the placed rectangles, and each new one is put at the lowest
+// position where it fits. Skyline cannot reuse the space of an individual
+// freed region, so the freed area stays "dead" until all regions of the page
+// are freed, and the page is reset. The owner may defragment the atlas by
+// moving the remaining regions out of the sparse pages, see GetSparsestPage().
+//
+// The atlas only does the bookkeeping, and does not deal with the textures.
+//
+//=============================================================================
+#ifndef __AGS_EE_GFX__TEXTUREATLAS_H
+#define __AGS_EE_GFX__TEXTUREATLAS_H
+
+#include <vector>
+#include "platform/types.h"
+#include "util/geometry.h"
+
+namespace AGS
+{
+namespace Engine
+{
+
+// Packs rectangles into a single page, using skyline bottom-left method
+class SkylinePacker
+{
+public:
+    SkylinePacker() = default;
+    SkylinePacker(int width, int height);
+
+    int GetWidth() const { return _width; }
+    int GetHeight() const { return _height; }
+    // Gets the total area of the rectangles placed since the last reset
+    uint64_t GetUsedArea() const { return _usedArea; }
+
+    // Clears the page, and optionally changes its size
+    void Reset();
+    void Reset(int width, int height);
+    // Finds a place for the rectangle of the given size and marks it used;
+    // returns false if there's no room left for it
+    bool Insert(int width, int height, Point &pos);
+
+private:
+    // A horizontal segment of the skyline
+    struct Segment
+    {
+        int X = 0, Y = 0, Width = 0;
+        Segment() = default;
+        Segment(int x, int y, int width) : X(x), Y(y), Width(width) {}
+    };
+
+    // Tests placing a rectangle starting at the given segment;
+    // returns the lowest y it may be placed at, or -1 if it does not fit
+    int Fit(size_t index, int width, int height) const;
+
+    int _width = 0;
+    int _height = 0;
+    uint64_t _usedArea = 0u;
+    std::vector<Segment> _skyline;
+};
+
+// A region allocated in the atlas
+struct AtlasRegion
+{
+    uint32_t Page = UINT32_MAX;
+    Rect Area; // the region itself, without the padding
+
+    bool IsValid() const { return Page != UINT32_MAX; }
+};
+
+// Occupancy of a single atlas page
+struct AtlasPageStats
+{
+    size_t   Regions = 0u;  // number of live regions
+    uint64_t LiveArea = 0u; // area of the live regions, including padding
+    uint64_t UsedArea = 0u; // area taken since the last page reset, live or dead
+    uint64_t PageArea = 0u; // full page area
+
+    // The share of the page taken by the live regions, in percents
+    unsigned GetOccupancy() const { return PageArea > 0u ? static_cast<unsigned>(LiveArea * 100 / PageArea) : 0u; }
+};
+
+// Occupancy of the whole atlas
+struct AtlasStats
+{
+    size_t   Pages = 0u;    // number of non-empty pages
+    size_t   Regions = 0u;
+    uint64_t LiveArea = 0u;
+    uint64_t UsedArea = 0u;
+    uint64_t PageArea = 0u; // total area of the non-empty pages
+
+    unsigned GetOccupancy() const { return PageArea > 0u ? static_cast<unsigned>(LiveArea * 100 / PageArea) : 0u; }
+};
+
+class TextureAtlas
+{
+public:
+    TextureAtlas() = default;
+    TextureAtlas(int page_width, int page_height, size_t max_pages, int max_region_size, int padding = 1);
+
+    // Resets the atlas, and sets new parameters
+    void Configure(int page_width, int page_height, size_t max_pages, int max_region_size, int padding = 1);
+    bool IsEnabled() const { return _maxPages > 0 && _maxRegionSize > 0; }
+    int GetPageWidth() const { return _pageWidth; }
+    int GetPageHeight() const { return _pageHeight; }
+
+    // Tells if the region of the given size may be placed in the atlas
+    bool CanPlace(int width, int height) const;
+    // Allocates a region of the given size, with the free padding around it;
+    // returns a region handle, or UINT32_MAX if there's no room left
+    uint32_t Allocate(int width, int height, AtlasRegion &region);
+    // Frees the region; resets the page when it has no more live regions
+    void Free(uint32_t handle);
+    // Forgets all the regions and pages
+    void Clear();
+
+    // Gets the number of pages, including empty ones
+    size_t GetPageCount() const { return _pages.size(); }
+    AtlasPageStats GetPageStats(size_t page) const;
+    AtlasStats GetStats() const;
+    // Finds the non-empty page with the least live area, which space is mostly
+    // dead; returns UINT32_MAX if there's no page which live occupancy is
+    // below the given percentage. Relocating regions out of such page lets to
+    // reset it and use the dead space again.
+    uint32_t GetSparsestPage(unsigned max_occupancy) const;
+    // Gets the handles of all live regions on the page
+    std::vector<uint32_t> GetPageRegions(uint32_t page) const;
+
+private:
+    struct Page
+    {
+        SkylinePacker Packer;
+        size_t Regions = 0u;
+        uint64_t LiveArea = 0u;
+    };
+
+    struct RegionEntry
+    {
+        uint32_t Page = UINT32_MAX; // UINT32_MAX if the handle is free
+        uint64_t Area = 0u;
+    };
+
+    int _pageWidth = 0;
+    int _pageHeight = 0;
+    size_t _maxPages = 0u;
+    int _maxRegionSize = 0;
+    int _padding = 1;
+    std::vector<Page> _pages;
+    std::vector<RegionEntry> _regions;
+    std::vector<uint32_t> _freeHandles;
+};
+
+} // namespace Engine
+} // namespace AGS
+
+#endif // __AGS_EE_GFX__TEXTUREATLAS_H
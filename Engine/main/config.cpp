@@ -406,6 +406,8 @@ void load_common_config(const ConfigTree &cfg, GameConfig &setup)
     setup.RenderAtScreenRes = CfgReadBoolInt(cfg, "graphics", "render_at_screenres");
     setup.AntialiasSprites = CfgReadBoolInt(cfg, "graphics", "antialias", setup.AntialiasSprites);
     setup.SoftwareRenderDriver = CfgReadString(cfg, "graphics", "software_driver");
+    setup.RenderThreads = std::max(0, CfgReadInt(cfg, "graphics", "render_threads", setup.RenderThreads));
+    setup.SkipUnchangedFrames = CfgReadBoolInt(cfg, "graphics", "skip_unchanged_frames", setup.SkipUnchangedFrames);
 
     String rotation_str = CfgReadString(cfg, "graphics", "rotation", "unlocked");
     setup.Rotation = StrUtil::ParseEnum<ScreenRotation>(
@@ -442,9 +444,17 @@ void load_common_config(const ConfigTree &cfg, GameConfig &setup)
     setup.SpriteCacheSize = std::min<uint64_t>(
         CfgReadUInt64(cfg, "graphics", "sprite_cache_size", setup.SpriteCacheSize),
         SIZE_MAX / 1024);
+    setup.SpriteDecodeThreads = std::max(0, CfgReadInt(cfg, "graphics", "sprite_decode_threads", setup.SpriteDecodeThreads));
     setup.TextureCacheSize = std::min<uint64_t>(
         CfgReadUInt64(cfg, "graphics", "texture_cache_size", setup.TextureCacheSize),
         SIZE_MAX / 1024);
+    setup.TransformCacheSize = std::min<uint64_t>(
+        CfgReadUInt64(cfg, "graphics", "transform_cache_size", setup.TransformCacheSize),
+        SIZE_MAX / 1024);
+    setup.TextureAtlasPage = Math::Clamp(
+        CfgReadInt(cfg, "graphics", "texture_atlas_page", setup.TextureAtlasPage), 0, 8192);
+    setup.TextureAtlasMaxSprite = std::max(0,
+        CfgReadInt(cfg, "graphics", "texture_atlas_max_sprite", setup.TextureAtlasMaxSprite));
     setup.SoundCacheSize = std::min<uint64_t>(
         CfgReadUInt64(cfg, "sound", "cache_size", setup.SoundCacheSize),
         SIZE_MAX / 1024);
@@ -457,7 +467,11 @@ void load_common_config(const ConfigTree &cfg, GameConfig &setup)
     setup.CompressSaves = CfgReadBoolInt(cfg, "misc", "compress_saves", setup.CompressSaves);
     setup.RunInBackground = CfgReadInt(cfg, "misc", "background", 0) != 0;
     setup.ShowFps = CfgReadBoolInt(cfg, "misc", "show_fps");
+    setup.ScriptProfileFile = CfgReadString(cfg, "misc", "script_profile");
     setup.ClearCacheOnRoomChange = CfgReadBoolInt(cfg, "misc", "clear_cache_on_room_change", setup.ClearCacheOnRoomChange);
+    setup.AssetDirIndex = StrUtil::ParseEnum<AssetDirIndexMode>(
+        CfgReadString(cfg, "misc", "asset_dir_index", "none"),
+        CstrArr<kNumAssetDirIndexModes>{ "none", "static", "watch" }, setup.AssetDirIndex);
 
     // Accessibility settings
     setup.Access.SpeechSkipStyle = parse_speechskip_style(CfgReadString(cfg, "access", "speechskip"));
@@ -350,6 +350,7 @@ void engine_locate_audio_pak()
 // Assign asset locations to the AssetManager
 void engine_assign_assetpaths()
 {
+    AssetMgr->SetDirIndexMode(usetup.AssetDirIndex);
     AssetMgr->AddLibrary(ResPaths.GamePak.Path, ",audio"); // main pack may have audio bundled too
     // The asset filters are currently a workaround for limiting search to certain locations;
     // this is both an optimization and to prevent unexpected behavior.
@@ -610,13 +611,14 @@ HError engine_init_sprites()
     }
 
     const char *compress_desc = StrUtil::SelectCStr<kNumSprCompressTypes>(
-        CstrArr<kNumSprCompressTypes>{"none", "rle", "lzw", "deflate"},
+        CstrArr<kNumSprCompressTypes>{"none", "rle", "lzw", "deflate", "lz4"},
         spriteset.GetSpriteCompression(), "unknown");
     Debug::Printf("Sprite file info: compression: %s, storage flags: 0x%08x, total sprites: %zu",
         compress_desc, spriteset.GetStoreFlags(), spriteset.GetSpriteSlotCount());
     if (usetup.SpriteCacheSize > 0)
         spriteset.SetMaxCacheSize(usetup.SpriteCacheSize * 1024);
     Debug::Printf("Sprite cache set: %zu KB", spriteset.GetMaxCacheSize() / 1024);
+    spriteset.SetDecodeThreadCount(usetup.SpriteDecodeThreads);
     return HError::None();
 }
 
@@ -658,13 +660,18 @@ void engine_init_game_settings()
             palette[ee]=game.defpal[ee];
     }
 
-    for (ee = 0; ee < game.numcursors; ee++) 
+    // The cursor graphics are assigned to mousecurs[] and so cannot
+    // be removed from memory; load them all at once
+    std::vector<sprkey_t> cursor_sprites;
+    for (ee = 0; ee < game.numcursors; ee++)
     {
-        // The cursor graphics are assigned to mousecurs[] and so cannot
-        // be removed from memory
         if (game.mcurs[ee].pic >= 0)
-            spriteset.PrecacheSprite(game.mcurs[ee].pic);
+            cursor_sprites.push_back(game.mcurs[ee].pic);
+    }
+    spriteset.PrecacheSprites(cursor_sprites);
 
+    for (ee = 0; ee < game.numcursors; ee++) 
+    {
         // just in case they typed an invalid view number in the editor
         if (game.mcurs[ee].view >= game.numviews)
             game.mcurs[ee].view = -1;
@@ -1357,6 +1364,8 @@ int initialize_engine(const ConfigTree &startup_opts)
 
     if ((debug_flags & DBG_DBGSCRIPT) != 0)
         ccSetDebugLogging(true);
+    if (!usetup.ScriptProfileFile.IsEmpty())
+        ccStartScriptProfiler();
 
     // TODO: move *init_game_settings to game init code unit
     engine_init_game_settings();
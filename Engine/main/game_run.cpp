@@ -1309,6 +1309,7 @@ void UpdateGameOnce(bool do_controls, IDriverDependantBitmap *extra_ddb, int ext
     set_our_eip(1012);
 
     update_polled_stuff();
+    spriteset.UpdatePrefetched();
     game_loop_update_background_animation();
     game_loop_update_loop_counter();
     game_loop_update_fps();
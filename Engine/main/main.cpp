@@ -185,6 +185,8 @@ void main_print_help() {
            "                                 error (5), critical (6)\n"
            "  --script-log                 Log executed script instructions in 'script.log'\n"
            "                                 WARNING: extremely verbose, may slow app down\n"
+           "  --script-profile <FILE>      Profile script function calls and write results\n"
+           "                                 to FILE as collapsed stacks, on exit\n"
 #if AGS_PLATFORM_OS_WINDOWS
            "  --setup                      Run setup application\n"
 #endif
@@ -372,6 +374,8 @@ static int main_process_cmdline(ConfigTree &cfg, int argc, char *argv[])
             cfg["log"]["sdl"] = arg + 10;
         }
         else if (ags_stricmp(arg, "--script-log") == 0) debug_flags |= DBG_DBGSCRIPT;
+        else if (ags_stricmp(arg, "--script-profile") == 0 && (argc > ee + 1))
+            cfg["misc"]["script_profile"] = argv[++ee];
         else if (ags_stricmp(arg, "--console-attach") == 0) attachToParentConsole = true;
         else if (ags_stricmp(arg, "--no-message-box") == 0) hideMessageBoxes = true;
         //
@@ -45,6 +45,7 @@
 #include "platform/base/sys_main.h"
 #include "plugin/plugin_engine.h"
 #include "script/cc_common.h"
+#include "script/script_runtime.h"
 #include "media/audio/audio_system.h"
 #include "media/video/video.h"
 
@@ -100,6 +101,17 @@ void quit_check_dynamic_sprites(QuitReason qreason)
     }
 }
 
+void quit_print_sprite_stats()
+{
+    const auto &stats = spriteset.GetPrefetchStats();
+    if (stats.Requested == 0u)
+        return;
+    Debug::Printf(kDbgGroup_SprCache, kDbgMsg_Info,
+        "Sprite prefetch: requested %u, hits %u, waits %u, misses %u, game thread stall time %lld ms",
+        stats.Requested, stats.Hits, stats.Waits, stats.Misses,
+        static_cast<long long>(stats.StallTime.count() / 1000));
+}
+
 void quit_shutdown_audio()
 {
     set_our_eip(9917);
@@ -205,8 +217,11 @@ void quit(const char *quitmsg)
 
     set_our_eip(9908);
 
+    ccStopScriptProfiler(usetup.ScriptProfileFile);
+
     // Release game data and unregister assets
     quit_check_dynamic_sprites(qreason);
+    quit_print_sprite_stats();
     shutdown_game_state();
     unload_game();
     AssetMgr.reset();
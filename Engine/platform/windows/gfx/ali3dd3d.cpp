@@ -191,7 +191,7 @@ void D3DGraphicsDriver::SetupDefaultVertices()
 
 void D3DGraphicsDriver::OnModeSet(const DisplayMode &mode)
 {
-  GraphicsDriverBase::OnModeSet(mode);
+  GPUGraphicsDriver::OnModeSet(mode);
 
   // The display mode has been set up successfully, save the
   // final refresh rate that we are using
@@ -462,6 +462,8 @@ HRESULT D3DGraphicsDriver::ResetDeviceAndRestore()
     // Reinitialize D3D settings, backbuffer surface, etc
     InitializeD3DState();
     CreateVirtualScreen();
+    // The backbuffer contents are lost, so the next frame must be rendered
+    _sceneTracker.Invalidate();
     return D3D_OK;
 }
 
@@ -940,6 +942,7 @@ void D3DGraphicsDriver::GetCopyOfScreenIntoDDB(IDriverDependantBitmap *target, u
         }
         RenderTexture(_nativeSurface, 0, 0, glmex::identity(), SpriteColorTransform(), _srcRect.GetSize());
         direct3ddevice->EndScene();
+        bitmap->GetTexture()->MarkModified();
     }
 }
 
@@ -1026,6 +1029,15 @@ void D3DGraphicsDriver::Render()
 void D3DGraphicsDriver::Render(int /*xoff*/, int /*yoff*/, GraphicFlip /*flip*/)
 {
     ResetDeviceIfNecessary();
+    _lastFrameSkipped = !ShouldRenderFrame(_spriteList);
+    if (_lastFrameSkipped)
+    {
+        // Keep the previous frame on screen, and only reset the lists
+        BackupDrawLists();
+        ClearDrawLists();
+        ResetFxPool();
+        return;
+    }
     RenderAndPresent(true);
 }
 
@@ -1044,6 +1056,7 @@ void D3DGraphicsDriver::Render(IDriverDependantBitmap *target)
         RectWH(0, 0, surf_sz.Width, surf_sz.Height), glmex::ortho_d3d(surf_sz.Width, surf_sz.Height),
         PlaneScaling(), D3DTEXF_POINT);
     RenderToSurface(&backbuffer, true);
+    bitmap->GetTexture()->MarkModified();
 }
 
 void D3DGraphicsDriver::RenderSprite(const D3DDrawListEntry *drawListEntry, const glm::mat4 &matGlobal,
@@ -1717,6 +1730,76 @@ void D3DGraphicsDriver::UpdateTexture(Texture *txdata, const Bitmap *bitmap, boo
 
   if (color_depth == 8)
       unselect_palette();
+
+  txdata->MarkModified();
+}
+
+void D3DGraphicsDriver::UpdateTextureSubRegion(D3DTextureTile *tile, const Bitmap *bitmap, const Rect &area, bool has_alpha, bool opaque)
+{
+  auto &texture = tile->texture;
+
+  RECT lockRect;
+  lockRect.left = area.Left - tile->x;
+  lockRect.top = area.Top - tile->y;
+  lockRect.right = area.Right + 1 - tile->x;
+  lockRect.bottom = area.Bottom + 1 - tile->y;
+  D3DLOCKED_RECT lockedRegion;
+  HRESULT hr = texture->LockRect(0, &lockedRegion, &lockRect, D3DLOCK_NOSYSLOCK);
+  if (hr != D3D_OK)
+  {
+    throw Ali3DException("Unable to lock texture");
+  }
+
+  TextureTile subTile;
+  subTile.x = area.Left;
+  subTile.y = area.Top;
+  subTile.width = area.GetWidth();
+  subTile.height = area.GetHeight();
+  uint8_t *memPtr = static_cast<uint8_t*>(lockedRegion.pBits);
+
+  assert(!opaque || !has_alpha); // has_alpha is meaningless with opaque
+  if (opaque)
+    BitmapToVideoMemOpaque(bitmap, &subTile, memPtr, lockedRegion.Pitch);
+  else
+    BitmapToVideoMem(bitmap, &subTile, memPtr, lockedRegion.Pitch, has_alpha, false);
+
+  texture->UnlockRect(0);
+}
+
+void D3DGraphicsDriver::UpdateTexture(Texture *txdata, const Bitmap *bitmap, const Rect &area, bool has_alpha, bool opaque)
+{
+  const int color_depth = bitmap->GetColorDepth();
+  if (bitmap->GetColorDepth() != txdata->Res.ColorDepth)
+    throw Ali3DException("UpdateDDBFromBitmap: mismatched colour depths");
+  if (txdata->Res.Width != bitmap->GetWidth() || txdata->Res.Height != bitmap->GetHeight())
+    throw Ali3DException("UpdateDDBFromBitmap: mismatched bitmap size");
+
+  const Rect dirty = IntersectRects(area, RectWH(0, 0, bitmap->GetWidth(), bitmap->GetHeight()));
+  if (dirty.IsEmpty())
+    return;
+  // Linear filtering fix makes each pixel depend on its neighbours, update everything
+  const bool usingLinearFiltering = _filter->NeedToColourEdgeLines() || (_smoothScaling && has_alpha);
+  if (usingLinearFiltering)
+  {
+    UpdateTexture(txdata, bitmap, has_alpha, opaque);
+    return;
+  }
+
+  if (color_depth == 8)
+      select_palette(palette);
+
+  auto *d3ddata = reinterpret_cast<D3DTexture*>(txdata);
+  for (auto &tile : d3ddata->_tiles)
+  {
+    const Rect sub = IntersectRects(dirty, RectWH(tile.x, tile.y, tile.width, tile.height));
+    if (!sub.IsEmpty())
+      UpdateTextureSubRegion(&tile, bitmap, sub, has_alpha, opaque);
+  }
+
+  if (color_depth == 8)
+      unselect_palette();
+
+  txdata->MarkModified();
 }
 
 int D3DGraphicsDriver::GetCompatibleBitmapFormat(int color_depth)
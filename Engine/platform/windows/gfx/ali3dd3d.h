@@ -245,6 +245,7 @@ public:
     bool DoesSupportVsyncToggle() override { return _capsVsync; }
     void RenderSpritesAtScreenResolution(bool enabled) override { _renderAtScreenRes = enabled; };
     void UseSmoothScaling(bool enabled) override { _smoothScaling = enabled; }
+    void SetRenderThreads(int /*count*/) override { }
     bool SupportsGammaControl() override;
     void SetGamma(int newGamma) override;
 
@@ -268,8 +269,12 @@ public:
 
     // Create texture data with the given parameters
     Texture *CreateTexture(int width, int height, int color_depth, int txflags) override;
+    // Create texture data which refers to a region of another texture;
+    // TODO: not supported yet, all sprites get textures of their own
+    Texture *CreateTextureRegion(std::shared_ptr<Texture>, const Rect&, int) override { return nullptr; }
     // Update texture data from the given bitmap
     void UpdateTexture(Texture *txdata, const Bitmap *bitmap, bool has_alpha, bool opaque) override;
+    void UpdateTexture(Texture *txdata, const Bitmap *bitmap, const Rect &area, bool has_alpha, bool opaque) override;
     // Retrieve shared texture data object from the given DDB
     std::shared_ptr<Texture> GetTexture(IDriverDependantBitmap *ddb) override;
 
@@ -348,6 +353,8 @@ private:
     bool IsTextureFormatOk(D3DFORMAT TextureFormat, D3DFORMAT AdapterFormat);
     void AdjustSizeToNearestSupportedByCard(int *width, int *height);
     void UpdateTextureRegion(D3DTextureTile *tile, const Bitmap *bitmap, bool has_alpha, bool opaque);
+    // Updates only the given area of the tile
+    void UpdateTextureSubRegion(D3DTextureTile *tile, const Bitmap *bitmap, const Rect &area, bool has_alpha, bool opaque);
     // For tracked render targets, disposes only the internal texture data
     void ReleaseRenderTargetData();
     // For tracked render targets, recreates the internal texture data
@@ -12,8 +12,10 @@
 //
 //=============================================================================
 #include "script/cc_instance.h"
+#include <algorithm>
 #include <cstdio>
 #include <deque>
+#include <functional>
 #include <vector>
 #include <string.h>
 #include "ac/common.h"
@@ -24,6 +26,7 @@
 #include "ac/dynobj/scriptstring.h"
 #include "ac/dynobj/scriptuserobject.h"
 #include "script/cc_common.h"
+#include "script/script_profiler.h"
 #include "script/script_runtime.h"
 
 #if (DEBUG_CC_EXEC)
@@ -142,6 +145,54 @@ const ScriptCommandInfo sccmd_info[CC_NUM_SCCMDS] =
     ScriptCommandInfo( SCMD_NEWUSEROBJECT   , "newuserobject"     , 2, kScOpOneArgIsReg ),
 };
 
+// Internal instruction codes, used only in the pre-decoded instructions array.
+// A special code which marks invalid positions in the instructions array
+#define SCMD_INVALID            (CC_NUM_SCCMDS)
+// Fused instructions ("superinstructions"), replacing the common instruction
+// sequences, saving the dispatch between them. Sequences were picked from
+// the patterns which the script compiler emits for local variable access,
+// literal assignments and conditions; they were not measured on the real
+// game scripts. Build with PROFILE_CC_OPCODES to collect the opcode pair
+// statistics of a running game, and revise this list.
+#define SCMDX_LOADSPOFFS_MEMREAD  (CC_NUM_SCCMDS + 1)  // MAR = SP - arg1; reg2 = m[MAR]
+#define SCMDX_LOADSPOFFS_MEMWRITE (CC_NUM_SCCMDS + 2)  // MAR = SP - arg1; m[MAR] = reg2
+#define SCMDX_LITTOREG_MEMREAD  (CC_NUM_SCCMDS + 3)  // reg1 = arg2; reg3 = m[MAR]
+#define SCMDX_LITTOREG_MEMWRITE (CC_NUM_SCCMDS + 4)  // reg1 = arg2; m[MAR] = reg3
+#define SCMDX_REGTOREG_POPREG   (CC_NUM_SCCMDS + 5)  // reg2 = reg1; sp--; reg3 = m[sp]
+#define SCMDX_ISEQUAL_JZ        (CC_NUM_SCCMDS + 6)  // reg1 = reg1 == reg2; jump if ax==0 to arg3
+#define SCMDX_NOTEQUAL_JZ       (CC_NUM_SCCMDS + 7)  // reg1 = reg1 != reg2; jump if ax==0 to arg3
+#define SCMDX_GREATER_JZ        (CC_NUM_SCCMDS + 8)  // reg1 = reg1 > reg2; jump if ax==0 to arg3
+#define SCMDX_LESSTHAN_JZ       (CC_NUM_SCCMDS + 9)  // reg1 = reg1 < reg2; jump if ax==0 to arg3
+#define SCMDX_GTE_JZ            (CC_NUM_SCCMDS + 10) // reg1 = reg1 >= reg2; jump if ax==0 to arg3
+#define SCMDX_LTE_JZ            (CC_NUM_SCCMDS + 11) // reg1 = reg1 <= reg2; jump if ax==0 to arg3
+// A jump with the invalid destination, replaces JMP, JZ or JNZ (stored in arg2);
+// fails if the jump is taken, the way the jump to a non-instruction used to fail
+#define SCMDX_BADJUMP           (CC_NUM_SCCMDS + 12)
+#define CC_NUM_SCCMDS_EX        (CC_NUM_SCCMDS + 13)
+
+struct ScriptFusedInfo
+{
+    const int32_t   Code;
+    const int32_t   First;  // first instruction in sequence
+    const int32_t   Second; // second instruction in sequence
+    const char     *CmdName;
+};
+
+const ScriptFusedInfo scfused_info[] =
+{
+    { SCMDX_LOADSPOFFS_MEMREAD , SCMD_LOADSPOFFS, SCMD_MEMREAD , "load.sp.offs+memread4" },
+    { SCMDX_LOADSPOFFS_MEMWRITE, SCMD_LOADSPOFFS, SCMD_MEMWRITE, "load.sp.offs+memwrite4" },
+    { SCMDX_LITTOREG_MEMREAD   , SCMD_LITTOREG  , SCMD_MEMREAD , "movl+memread4" },
+    { SCMDX_LITTOREG_MEMWRITE  , SCMD_LITTOREG  , SCMD_MEMWRITE, "movl+memwrite4" },
+    { SCMDX_REGTOREG_POPREG    , SCMD_REGTOREG  , SCMD_POPREG  , "mov+pop" },
+    { SCMDX_ISEQUAL_JZ         , SCMD_ISEQUAL   , SCMD_JZ      , "cmpeq+jzi" },
+    { SCMDX_NOTEQUAL_JZ        , SCMD_NOTEQUAL  , SCMD_JZ      , "cmpne+jzi" },
+    { SCMDX_GREATER_JZ         , SCMD_GREATER   , SCMD_JZ      , "gt+jzi" },
+    { SCMDX_LESSTHAN_JZ        , SCMD_LESSTHAN  , SCMD_JZ      , "lt+jzi" },
+    { SCMDX_GTE_JZ             , SCMD_GTE       , SCMD_JZ      , "gte+jzi" },
+    { SCMDX_LTE_JZ             , SCMD_LTE       , SCMD_JZ      , "lte+jzi" },
+};
+
 
 extern new_line_hook_type new_line_hook;
 
@@ -212,6 +263,7 @@ private:
 unsigned ccInstance::_timeoutCheckMs = 60u;
 unsigned ccInstance::_timeoutAbortMs = 0u;
 unsigned ccInstance::_maxWhileLoops = 0u;
+ScriptProfiler *ccInstance::_profiler = nullptr;
 #if (DEBUG_CC_EXEC)
 std::weak_ptr<AGS::Common::TextStreamWriter> ccInstance::_execWriterRef;
 #endif
@@ -222,9 +274,55 @@ ccInstance *ccInstance::GetCurrentInstance()
     return InstThreads.size() > 0 ? InstThreads.back() : nullptr;
 }
 
+#if (PROFILE_CC_OPCODES)
+// Counters of executed pairs of adjacent instructions
+static uint64_t OpcodePairCounts[CC_NUM_SCCMDS][CC_NUM_SCCMDS]{};
+
+static void PrintOpcodePairStats()
+{
+    std::vector<std::pair<uint64_t, int>> pairs;
+    uint64_t total = 0u;
+    for (int first = 0; first < CC_NUM_SCCMDS; ++first)
+    {
+        for (int second = 0; second < CC_NUM_SCCMDS; ++second)
+        {
+            const uint64_t count = OpcodePairCounts[first][second];
+            if (count == 0u)
+                continue;
+            pairs.push_back(std::make_pair(count, first * CC_NUM_SCCMDS + second));
+            total += count;
+        }
+    }
+    if (pairs.empty())
+        return;
+
+    std::sort(pairs.begin(), pairs.end(), std::greater<std::pair<uint64_t, int>>());
+    const size_t max_pairs = std::min<size_t>(pairs.size(), 64u);
+    Debug::Printf(kDbgGroup_Script, kDbgMsg_Info, "Script opcode pairs executed: %llu, most frequent %zu:",
+        static_cast<unsigned long long>(total), max_pairs);
+    for (size_t i = 0; i < max_pairs; ++i)
+    {
+        const int first = pairs[i].second / CC_NUM_SCCMDS;
+        const int second = pairs[i].second % CC_NUM_SCCMDS;
+        Debug::Printf(kDbgGroup_Script, kDbgMsg_Info, "%12llu (%5.2f%%)  %s, %s",
+            static_cast<unsigned long long>(pairs[i].first), 100.0 * pairs[i].first / total,
+            sccmd_info[first].CmdName, sccmd_info[second].CmdName);
+    }
+    memset(OpcodePairCounts, 0, sizeof(OpcodePairCounts));
+}
+#endif // PROFILE_CC_OPCODES
+
+void ccInstance::SetProfiler(ScriptProfiler *profiler)
+{
+    _profiler = profiler;
+}
+
 void ccInstance::FreeInstanceStack()
 {
     InstThreads.clear();
+#if (PROFILE_CC_OPCODES)
+    PrintOpcodePairStats();
+#endif
 }
 
 std::unique_ptr<ccInstance> ccInstance::CreateFromScript(PScript scri)
@@ -445,7 +543,13 @@ ccInstError ccInstance::CallScriptFunction(const String &funcname, int32_t numar
 
     InstThreads.push_back(this); // push instance thread
     _runningInst = this;
+    const size_t profiler_depth = _profiler ? _profiler->GetDepth() : 0u;
+    if (_profiler)
+        ProfileScriptFunction(this, start_at);
     const ccInstError reterr = Run(start_at);
+    // Unwind the functions which did not return, in case of abort or error
+    if (_profiler)
+        _profiler->UnwindTo(profiler_depth);
     // Cleanup before returning, even if error
     ASSERT_STACK_SIZE(numargs);
     PopValuesFromStack(numargs);
@@ -527,32 +631,21 @@ inline RuntimeScriptValue GetStackPtrOffsetFw(RuntimeScriptValue *stack, int32_t
     return stack_ptr;
 }
 
-// Applies a runtime fixup to the given arg;
-// Fixup of type `fixup` is applied to the `code` value,
-// the result is assigned to the `arg`.
-inline bool FixupArgument(RuntimeScriptValue &arg, const int fixup, const uintptr_t code,
-    RuntimeScriptValue *stack, const char *strings)
+// Gets the literal argument of the pre-decoded instruction, applying a fixup;
+// the fixups that do not depend on the runtime state are already resolved
+// by this time, and their values are stored in the `resolved_args` array.
+inline bool FixupArgument(RuntimeScriptValue &arg, const ScriptInstruction &op, const int arg_index,
+    const RuntimeScriptValue *resolved_args, RuntimeScriptValue *stack)
 {
-    // could be relative pointer or import address
-    switch (fixup)
+    const int32_t code = op.Args[arg_index];
+    switch (op.Fixup)
     {
     case FIXUP_NOFIXUP:
+        arg.SetInt32(code);
         return true;
     case FIXUP_GLOBALDATA:
-        {
-            ScriptVariable *gl_var = (ScriptVariable*)code;
-            assert(gl_var->RValue.IsValid());
-            arg.SetGlobalVar(&gl_var->RValue);
-        }
-        return true;
-    case FIXUP_FUNCTION:
-        // originally commented -- CHECKME: could this be used in very old versions of AGS?
-        //      code[fixup] += (long)&code[0];
-        // This is a program counter value, presumably will be used as SCMD_CALL argument
-        arg.SetInt32(static_cast<int32_t>(code));
-        return true;
     case FIXUP_STRING:
-        arg.SetStringLiteral(strings + code);
+        arg = resolved_args[code];
         return true;
     case FIXUP_IMPORT:
         {
@@ -564,23 +657,54 @@ inline bool FixupArgument(RuntimeScriptValue &arg, const int fixup, const uintpt
             }
             else
             {
-                cc_error("cannot resolve import, key = %ld", code);
+                arg.SetInt32(code);
+                cc_error("cannot resolve import, key = %d", code);
                 return false;
             }
         }
         return true;
-    case FIXUP_DATADATA:
-        return false; // placeholder, fail at this as not supposed to be here
     case FIXUP_STACK:
-        arg = GetStackPtrOffsetFw(stack, static_cast<int32_t>(code));
+        arg = GetStackPtrOffsetFw(stack, code);
         return true;
     default:
-        cc_error("internal fixup type error: %d", fixup);
+        arg.SetInt32(code);
+        cc_error("internal fixup type error: %d", op.Fixup);
         return false;
     }
 }
 
 
+// Threaded code dispatch: each instruction handler jumps directly to the
+// handler of the next instruction, instead of returning to the common switch.
+// This relies on the "labels as values" extension of GCC and Clang.
+// Disabled when DEBUG_CC_EXEC or PROFILE_CC_OPCODES is on, because debug checks,
+// opcode dump and statistics are done in the beginning of the main loop.
+#ifndef CC_THREADED_DISPATCH
+#if (defined(__GNUC__) || defined(__clang__)) && !(DEBUG_CC_EXEC) && !(PROFILE_CC_OPCODES)
+#define CC_THREADED_DISPATCH 1
+#else
+#define CC_THREADED_DISPATCH 0
+#endif
+#endif
+
+// CC_OP marks an instruction handler, CC_NEXT_OP ends the handler,
+// advancing program counter and passing to the next instruction.
+#if (CC_THREADED_DISPATCH)
+#define CC_OP(OP) case OP: op_##OP
+#define CC_NEXT_OP() \
+    { \
+        _pc += codeOp->ArgCount + 1; \
+        if ((_flags & INSTF_ABORTED) != 0) \
+            return kInstErr_None; \
+        codeOp = &codeOps[_pc]; \
+        goto *dispatch_table[codeOp->Code]; \
+    }
+#else
+#define CC_OP(OP) case OP
+#define CC_NEXT_OP() break
+#endif
+
+
 #define MAXNEST 50  // number of recursive function calls allowed
 ccInstError ccInstance::Run(int32_t curpc)
 {
@@ -601,7 +725,9 @@ ccInstError ccInstance::Run(int32_t curpc)
     thisbase[0] = 0;
     funcstart[0] = _pc;
     ccInstance *codeInst = _runningInst;
-    ScriptOperation codeOp;
+    const ScriptInstruction *const codeOps = codeInst->_codeOps;
+    const ScriptInstruction *codeOp = nullptr;
+    const RuntimeScriptValue *const resolvedArgs = codeInst->_scriptData->resolved_args.data();
     FunctionCallStack func_callstack(16);
 #if DEBUG_CC_EXEC
     const bool dump_opcodes = ccGetOption(SCOPT_DEBUGRUN) != 0;
@@ -612,6 +738,104 @@ ccInstError ccInstance::Run(int32_t curpc)
 
     const auto timeout = std::chrono::milliseconds(_timeoutCheckMs);
     _lastAliveTs = FastClock::now();
+#if (PROFILE_CC_OPCODES)
+    int prevOpcode = -1; // last executed opcode
+    int32_t prevNextPc = -1; // position right after the last executed instruction
+#endif
+
+#if (CC_THREADED_DISPATCH)
+    // Instruction handlers, ordered by instruction code
+    static const void *const dispatch_table[CC_NUM_SCCMDS_EX] =
+    {
+        &&op_invalid,
+        &&op_SCMD_ADD,
+        &&op_SCMD_SUB,
+        &&op_SCMD_REGTOREG,
+        &&op_SCMD_WRITELIT,
+        &&op_SCMD_RET,
+        &&op_SCMD_LITTOREG,
+        &&op_SCMD_MEMREAD,
+        &&op_SCMD_MEMWRITE,
+        &&op_SCMD_MULREG,
+        &&op_SCMD_DIVREG,
+        &&op_SCMD_ADDREG,
+        &&op_SCMD_SUBREG,
+        &&op_SCMD_BITAND,
+        &&op_SCMD_BITOR,
+        &&op_SCMD_ISEQUAL,
+        &&op_SCMD_NOTEQUAL,
+        &&op_SCMD_GREATER,
+        &&op_SCMD_LESSTHAN,
+        &&op_SCMD_GTE,
+        &&op_SCMD_LTE,
+        &&op_SCMD_AND,
+        &&op_SCMD_OR,
+        &&op_SCMD_CALL,
+        &&op_SCMD_MEMREADB,
+        &&op_SCMD_MEMREADW,
+        &&op_SCMD_MEMWRITEB,
+        &&op_SCMD_MEMWRITEW,
+        &&op_SCMD_JZ,
+        &&op_SCMD_PUSHREG,
+        &&op_SCMD_POPREG,
+        &&op_SCMD_JMP,
+        &&op_SCMD_MUL,
+        &&op_SCMD_CALLEXT,
+        &&op_SCMD_PUSHREAL,
+        &&op_SCMD_SUBREALSTACK,
+        &&op_SCMD_LINENUM,
+        &&op_SCMD_CALLAS,
+        &&op_SCMD_THISBASE,
+        &&op_SCMD_NUMFUNCARGS,
+        &&op_SCMD_MODREG,
+        &&op_SCMD_XORREG,
+        &&op_SCMD_NOTREG,
+        &&op_SCMD_SHIFTLEFT,
+        &&op_SCMD_SHIFTRIGHT,
+        &&op_SCMD_CALLOBJ,
+        &&op_SCMD_CHECKBOUNDS,
+        &&op_SCMD_MEMWRITEPTR,
+        &&op_SCMD_MEMREADPTR,
+        &&op_SCMD_MEMZEROPTR,
+        &&op_SCMD_MEMINITPTR,
+        &&op_SCMD_LOADSPOFFS,
+        &&op_SCMD_CHECKNULL,
+        &&op_SCMD_FADD,
+        &&op_SCMD_FSUB,
+        &&op_SCMD_FMULREG,
+        &&op_SCMD_FDIVREG,
+        &&op_SCMD_FADDREG,
+        &&op_SCMD_FSUBREG,
+        &&op_SCMD_FGREATER,
+        &&op_SCMD_FLESSTHAN,
+        &&op_SCMD_FGTE,
+        &&op_SCMD_FLTE,
+        &&op_SCMD_ZEROMEMORY,
+        &&op_SCMD_CREATESTRING,
+        &&op_SCMD_STRINGSEQUAL,
+        &&op_SCMD_STRINGSNOTEQ,
+        &&op_SCMD_CHECKNULLREG,
+        &&op_SCMD_LOOPCHECKOFF,
+        &&op_SCMD_MEMZEROPTRND,
+        &&op_SCMD_JNZ,
+        &&op_SCMD_DYNAMICBOUNDS,
+        &&op_SCMD_NEWARRAY,
+        &&op_SCMD_NEWUSEROBJECT,
+        &&op_invalid, // SCMD_INVALID
+        &&op_SCMDX_LOADSPOFFS_MEMREAD,
+        &&op_SCMDX_LOADSPOFFS_MEMWRITE,
+        &&op_SCMDX_LITTOREG_MEMREAD,
+        &&op_SCMDX_LITTOREG_MEMWRITE,
+        &&op_SCMDX_REGTOREG_POPREG,
+        &&op_SCMDX_ISEQUAL_JZ,
+        &&op_SCMDX_NOTEQUAL_JZ,
+        &&op_SCMDX_GREATER_JZ,
+        &&op_SCMDX_LESSTHAN_JZ,
+        &&op_SCMDX_GTE_JZ,
+        &&op_SCMDX_LTE_JZ,
+        &&op_SCMDX_BADJUMP,
+    };
+#endif
 
     /* Main bytecode execution loop */
     //=====================================================================
@@ -624,34 +848,17 @@ ccInstError ccInstance::Run(int32_t curpc)
         //
         /* Read operation */
         //=====================================================================
-        codeOp.Instruction.Code = codeInst->_code[_pc];
-        codeOp.Instruction.InstanceId = (codeOp.Instruction.Code >> INSTANCE_ID_SHIFT) & INSTANCE_ID_MASK;
-        codeOp.Instruction.Code &= INSTANCE_ID_REMOVEMASK; // now this is pure instruction code
-
-        CC_ERROR_IF_RETCODE((codeOp.Instruction.Code < 0 || codeOp.Instruction.Code >= CC_NUM_SCCMDS),
-            "invalid instruction %d found in code stream", codeOp.Instruction.Code);
-
-        codeOp.ArgCount = sccmd_info[codeOp.Instruction.Code].ArgCount;
-
-        CC_ERROR_IF_RETCODE(static_cast<uint32_t>(_pc + codeOp.ArgCount) >= codeInst->_codesize,
-            "unexpected end of code data (%u; %u)", static_cast<uint32_t>(_pc + codeOp.ArgCount), codeInst->_codesize);
-
-
-        // Read arguments; use switch as it proved to be faster than the loop
-        switch (codeOp.ArgCount)
-        {
-        case 3:
-            codeOp.Args[2].SetInt32(static_cast<int32_t>(codeInst->_code[_pc + 3]));
-            /* fall-through */
-        case 2:
-            codeOp.Args[1].SetInt32(static_cast<int32_t>(codeInst->_code[_pc + 2]));
-            /* fall-through */
-        case 1:
-            codeOp.Args[0].SetInt32(static_cast<int32_t>(codeInst->_code[_pc + 1]));
-            break;
-        default:
-            break;
-        }
+        // NOTE: instructions are decoded and validated when the instance is
+        // created, see DecodeInstructions().
+        CC_ERROR_IF_RETCODE(static_cast<uint32_t>(_pc) >= codeInst->_codesize,
+            "unexpected end of code data (%u; %u)", static_cast<uint32_t>(_pc), codeInst->_codesize);
+        codeOp = &codeOps[_pc];
+#if (PROFILE_CC_OPCODES)
+        if ((prevOpcode >= 0) && (_pc == prevNextPc) && (codeOp->Code < CC_NUM_SCCMDS))
+            OpcodePairCounts[prevOpcode][codeOp->Code]++;
+        prevOpcode = (codeOp->Code < CC_NUM_SCCMDS) ? codeOp->Code : -1;
+        prevNextPc = _pc + codeOp->ArgCount + 1;
+#endif
         //---------------------------------------------------------------------
         /* End read operation */
         //=====================================================================
@@ -659,24 +866,28 @@ ccInstError ccInstance::Run(int32_t curpc)
 #if (DEBUG_CC_EXEC)
         if (dump_opcodes)
         {
-            DumpInstruction(codeOp);
+            DumpInstruction(*codeOp);
         }
 #endif
 
+#if (CC_THREADED_DISPATCH)
+        goto *dispatch_table[codeOp->Code];
+#endif
+
         /* Perform operation */
         //=====================================================================
-        switch (codeOp.Instruction.Code)
+        switch (codeOp->Code)
         {
-        case SCMD_LINENUM:
-            _lineNumber = codeOp.Arg1i();
+        CC_OP(SCMD_LINENUM):
+            _lineNumber = codeOp->Arg1i();
             currentline = _lineNumber;
             if (new_line_hook)
                 new_line_hook(this, currentline);
-            break;
-        case SCMD_ADD:
+            CC_NEXT_OP();
+        CC_OP(SCMD_ADD):
         {
-            const auto arg_reg = codeOp.Arg1i();
-            const auto arg_lit = codeOp.Arg2i();
+            const auto arg_reg = codeOp->Arg1i();
+            const auto arg_lit = codeOp->Arg2i();
             auto &reg1 = _registers[arg_reg];
             // If the the register is SREG_SP, we are allocating new variable on the stack
             if (arg_reg == SREG_SP)
@@ -703,12 +914,12 @@ ccInstError ccInstance::Run(int32_t curpc)
             {
                 reg1.IValue += arg_lit;
             }
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_SUB:
+        CC_OP(SCMD_SUB):
         {
-            const auto arg_reg = codeOp.Arg1i();
-            const auto arg_lit = codeOp.Arg2i();
+            const auto arg_reg = codeOp->Arg1i();
+            const auto arg_lit = codeOp->Arg2i();
             auto &reg1 = _registers[arg_reg];
             if (reg1.Type == kScValStackPtr)
             {
@@ -733,16 +944,16 @@ ccInstError ccInstance::Run(int32_t curpc)
             {
                 reg1.IValue -= arg_lit;
             }
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_REGTOREG:
+        CC_OP(SCMD_REGTOREG):
         {
-            const auto &reg1 = _registers[codeOp.Arg1i()];
-            auto       &reg2 = _registers[codeOp.Arg2i()];
+            const auto &reg1 = _registers[codeOp->Arg1i()];
+            auto       &reg2 = _registers[codeOp->Arg2i()];
             reg2 = reg1;
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_WRITELIT:
+        CC_OP(SCMD_WRITELIT):
         {
             // Take the data address from reg[MAR] and copy there arg1 bytes from arg2 address
             //
@@ -750,10 +961,10 @@ ccInstError ccInstance::Run(int32_t curpc)
             // long, or rather int32 due x32 build), written value may normally
             // be only up to 4 bytes large;
             // I guess that's an obsolete way to do WRITE, WRITEW and WRITEB
-            const auto arg_size = codeOp.Arg1i();
-            FixupArgument(codeOp.Args[1], codeInst->_code_fixups[_pc + 2], codeInst->_code[_pc + 2], _stackBegin, codeInst->_strings);
+            const auto arg_size = codeOp->Arg1i();
+            RuntimeScriptValue arg_value;
+            FixupArgument(arg_value, *codeOp, 1, resolvedArgs, _stackBegin);
             ASSERT_CC_ERROR();
-            const auto &arg_value = codeOp.Arg2();
             switch (arg_size)
             {
             case sizeof(char) :
@@ -770,9 +981,9 @@ ccInstError ccInstance::Run(int32_t curpc)
                 cc_error("unexpected data size for WRITELIT op: %d", arg_size);
                 break;
             }
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_RET:
+        CC_OP(SCMD_RET):
         {
             if (loopIterationCheckDisabled > 0)
                 loopIterationCheckDisabled--;
@@ -781,6 +992,8 @@ ccInstError ccInstance::Run(int32_t curpc)
             RuntimeScriptValue rval = PopValueFromStack();
             curnest--;
             _pc = rval.IValue;
+            if (_profiler)
+                _profiler->Leave();
             if (_pc == 0)
             {
                 _returnValue = _registers[SREG_AX].IValue;
@@ -789,167 +1002,167 @@ ccInstError ccInstance::Run(int32_t curpc)
             POP_CALL_STACK();
             continue; // continue so that the PC doesn't get overwritten
         }
-        case SCMD_LITTOREG:
+        CC_OP(SCMD_LITTOREG):
         {
-            auto &reg1 = _registers[codeOp.Arg1i()];
-            FixupArgument(codeOp.Args[1], codeInst->_code_fixups[_pc + 2], codeInst->_code[_pc + 2], _stackBegin, codeInst->_strings);
+            auto &reg1 = _registers[codeOp->Arg1i()];
+            RuntimeScriptValue arg_value;
+            FixupArgument(arg_value, *codeOp, 1, resolvedArgs, _stackBegin);
             ASSERT_CC_ERROR();
-            const auto &arg_value = codeOp.Arg2();
             reg1 = arg_value;
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_MEMREAD:
+        CC_OP(SCMD_MEMREAD):
         {
             // Take the data address from reg[MAR] and copy int32_t to reg[arg1]
-            auto &reg1 = _registers[codeOp.Arg1i()];
+            auto &reg1 = _registers[codeOp->Arg1i()];
             reg1 = _registers[SREG_MAR].ReadValue();
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_MEMWRITE:
+        CC_OP(SCMD_MEMWRITE):
         {
             // Take the data address from reg[MAR] and copy there int32_t from reg[arg1]
-            const auto &reg1 = _registers[codeOp.Arg1i()];
+            const auto &reg1 = _registers[codeOp->Arg1i()];
             _registers[SREG_MAR].WriteValue(reg1);
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_LOADSPOFFS:
+        CC_OP(SCMD_LOADSPOFFS):
         {
-            const auto arg_off = codeOp.Arg1i();
+            const auto arg_off = codeOp->Arg1i();
             _registers[SREG_MAR] = GetStackPtrOffsetRw(arg_off);
             ASSERT_CC_ERROR();
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_MULREG:
+        CC_OP(SCMD_MULREG):
         {
-            auto       &reg1 = _registers[codeOp.Arg1i()];
-            const auto &reg2 = _registers[codeOp.Arg2i()];
+            auto       &reg1 = _registers[codeOp->Arg1i()];
+            const auto &reg2 = _registers[codeOp->Arg2i()];
             reg1.SetInt32(reg1.IValue * reg2.IValue);
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_DIVREG:
+        CC_OP(SCMD_DIVREG):
         {
-            auto       &reg1 = _registers[codeOp.Arg1i()];
-            const auto &reg2 = _registers[codeOp.Arg2i()];
+            auto       &reg1 = _registers[codeOp->Arg1i()];
+            const auto &reg2 = _registers[codeOp->Arg2i()];
             if (reg2.IValue == 0)
             {
                 cc_error("!Integer divide by zero");
                 return kInstErr_Generic;
             }
             reg1.SetInt32(reg1.IValue / reg2.IValue);
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_ADDREG:
+        CC_OP(SCMD_ADDREG):
         {
-            auto       &reg1 = _registers[codeOp.Arg1i()];
-            const auto &reg2 = _registers[codeOp.Arg2i()];
+            auto       &reg1 = _registers[codeOp->Arg1i()];
+            const auto &reg2 = _registers[codeOp->Arg2i()];
             // This may be pointer arithmetics, in which case IValue stores offset from base pointer
             reg1.IValue += reg2.IValue;
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_SUBREG:
+        CC_OP(SCMD_SUBREG):
         {
-            auto       &reg1 = _registers[codeOp.Arg1i()];
-            const auto &reg2 = _registers[codeOp.Arg2i()];
+            auto       &reg1 = _registers[codeOp->Arg1i()];
+            const auto &reg2 = _registers[codeOp->Arg2i()];
             // This may be pointer arithmetics, in which case IValue stores offset from base pointer
             reg1.IValue -= reg2.IValue;
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_BITAND:
+        CC_OP(SCMD_BITAND):
         {
-            auto       &reg1 = _registers[codeOp.Arg1i()];
-            const auto &reg2 = _registers[codeOp.Arg2i()];
+            auto       &reg1 = _registers[codeOp->Arg1i()];
+            const auto &reg2 = _registers[codeOp->Arg2i()];
             reg1.SetInt32(reg1.IValue & reg2.IValue);
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_BITOR:
+        CC_OP(SCMD_BITOR):
         {
-            auto       &reg1 = _registers[codeOp.Arg1i()];
-            const auto &reg2 = _registers[codeOp.Arg2i()];
+            auto       &reg1 = _registers[codeOp->Arg1i()];
+            const auto &reg2 = _registers[codeOp->Arg2i()];
             reg1.SetInt32(reg1.IValue | reg2.IValue);
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_ISEQUAL:
+        CC_OP(SCMD_ISEQUAL):
         {
-            auto       &reg1 = _registers[codeOp.Arg1i()];
-            const auto &reg2 = _registers[codeOp.Arg2i()];
+            auto       &reg1 = _registers[codeOp->Arg1i()];
+            const auto &reg2 = _registers[codeOp->Arg2i()];
             reg1.SetInt32AsBool(reg1 == reg2);
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_NOTEQUAL:
+        CC_OP(SCMD_NOTEQUAL):
         {
-            auto       &reg1 = _registers[codeOp.Arg1i()];
-            const auto &reg2 = _registers[codeOp.Arg2i()];
+            auto       &reg1 = _registers[codeOp->Arg1i()];
+            const auto &reg2 = _registers[codeOp->Arg2i()];
             reg1.SetInt32AsBool(reg1 != reg2);
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_GREATER:
+        CC_OP(SCMD_GREATER):
         {
-            auto       &reg1 = _registers[codeOp.Arg1i()];
-            const auto &reg2 = _registers[codeOp.Arg2i()];
+            auto       &reg1 = _registers[codeOp->Arg1i()];
+            const auto &reg2 = _registers[codeOp->Arg2i()];
             reg1.SetInt32AsBool(reg1.IValue > reg2.IValue);
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_LESSTHAN:
+        CC_OP(SCMD_LESSTHAN):
         {
-            auto       &reg1 = _registers[codeOp.Arg1i()];
-            const auto &reg2 = _registers[codeOp.Arg2i()];
+            auto       &reg1 = _registers[codeOp->Arg1i()];
+            const auto &reg2 = _registers[codeOp->Arg2i()];
             reg1.SetInt32AsBool(reg1.IValue < reg2.IValue);
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_GTE:
+        CC_OP(SCMD_GTE):
         {
-            auto       &reg1 = _registers[codeOp.Arg1i()];
-            const auto &reg2 = _registers[codeOp.Arg2i()];
+            auto       &reg1 = _registers[codeOp->Arg1i()];
+            const auto &reg2 = _registers[codeOp->Arg2i()];
             reg1.SetInt32AsBool(reg1.IValue >= reg2.IValue);
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_LTE:
+        CC_OP(SCMD_LTE):
         {
-            auto       &reg1 = _registers[codeOp.Arg1i()];
-            const auto &reg2 = _registers[codeOp.Arg2i()];
+            auto       &reg1 = _registers[codeOp->Arg1i()];
+            const auto &reg2 = _registers[codeOp->Arg2i()];
             reg1.SetInt32AsBool(reg1.IValue <= reg2.IValue);
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_AND:
+        CC_OP(SCMD_AND):
         {
-            auto       &reg1 = _registers[codeOp.Arg1i()];
-            const auto &reg2 = _registers[codeOp.Arg2i()];
+            auto       &reg1 = _registers[codeOp->Arg1i()];
+            const auto &reg2 = _registers[codeOp->Arg2i()];
             reg1.SetInt32AsBool(reg1.IValue && reg2.IValue);
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_OR:
+        CC_OP(SCMD_OR):
         {
-            auto       &reg1 = _registers[codeOp.Arg1i()];
-            const auto &reg2 = _registers[codeOp.Arg2i()];
+            auto       &reg1 = _registers[codeOp->Arg1i()];
+            const auto &reg2 = _registers[codeOp->Arg2i()];
             reg1.SetInt32AsBool(reg1.IValue || reg2.IValue);
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_XORREG:
+        CC_OP(SCMD_XORREG):
         {
-            auto       &reg1 = _registers[codeOp.Arg1i()];
-            const auto &reg2 = _registers[codeOp.Arg2i()];
+            auto       &reg1 = _registers[codeOp->Arg1i()];
+            const auto &reg2 = _registers[codeOp->Arg2i()];
             reg1.SetInt32(reg1.IValue ^ reg2.IValue);
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_MODREG:
+        CC_OP(SCMD_MODREG):
         {
-            auto       &reg1 = _registers[codeOp.Arg1i()];
-            const auto &reg2 = _registers[codeOp.Arg2i()];
+            auto       &reg1 = _registers[codeOp->Arg1i()];
+            const auto &reg2 = _registers[codeOp->Arg2i()];
             if (reg2.IValue == 0)
             {
                 cc_error("!Integer divide by zero");
                 return kInstErr_Generic;
             }
             reg1.SetInt32(reg1.IValue % reg2.IValue);
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_NOTREG:
+        CC_OP(SCMD_NOTREG):
         {
-            auto       &reg1 = _registers[codeOp.Arg1i()];
+            auto       &reg1 = _registers[codeOp->Arg1i()];
             reg1 = !(reg1);
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_CALL:
+        CC_OP(SCMD_CALL):
         {
             // Call another function within same script, just save PC
             // and continue from there
@@ -962,9 +1175,9 @@ ccInstError ccInstance::Run(int32_t curpc)
             PUSH_CALL_STACK();
 
             ASSERT_STACK_SPACE_VALS(1);
-            PushValueToStack(RuntimeScriptValue().SetInt32(_pc + codeOp.ArgCount + 1));
+            PushValueToStack(RuntimeScriptValue().SetInt32(_pc + codeOp->ArgCount + 1));
 
-            const auto &reg1 = _registers[codeOp.Arg1i()];
+            const auto &reg1 = _registers[codeOp->Arg1i()];
             if (thisbase[curnest] == 0)
                 _pc = reg1.IValue;
             else {
@@ -980,68 +1193,70 @@ ccInstError ccInstance::Run(int32_t curpc)
             curnest++;
             thisbase[curnest] = 0;
             funcstart[curnest] = _pc;
+            if (_profiler)
+                ProfileScriptFunction(codeInst, _pc);
             continue; // continue so that the PC doesn't get overwritten
         }
-        case SCMD_MEMREADB:
+        CC_OP(SCMD_MEMREADB):
         {
             // Take the data address from reg[MAR] and copy byte to reg[arg1]
-            auto &reg1 = _registers[codeOp.Arg1i()];
+            auto &reg1 = _registers[codeOp->Arg1i()];
             reg1.SetUInt8(_registers[SREG_MAR].ReadByte());
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_MEMREADW:
+        CC_OP(SCMD_MEMREADW):
         {
             // Take the data address from reg[MAR] and copy int16_t to reg[arg1]
-            auto &reg1 = _registers[codeOp.Arg1i()];
+            auto &reg1 = _registers[codeOp->Arg1i()];
             reg1.SetInt16(_registers[SREG_MAR].ReadInt16());
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_MEMWRITEB:
+        CC_OP(SCMD_MEMWRITEB):
         {
             // Take the data address from reg[MAR] and copy there byte from reg[arg1]
-            const auto &reg1 = _registers[codeOp.Arg1i()];
+            const auto &reg1 = _registers[codeOp->Arg1i()];
             _registers[SREG_MAR].WriteByte(reg1.IValue);
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_MEMWRITEW:
+        CC_OP(SCMD_MEMWRITEW):
         {
             // Take the data address from reg[MAR] and copy there int16_t from reg[arg1]
-            const auto &reg1 = _registers[codeOp.Arg1i()];
+            const auto &reg1 = _registers[codeOp->Arg1i()];
             _registers[SREG_MAR].WriteInt16(reg1.IValue);
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_JZ:
+        CC_OP(SCMD_JZ):
         {
-            const auto arg_lit = codeOp.Arg1i();
+            const auto arg_lit = codeOp->Arg1i();
             if (_registers[SREG_AX].IsNull())
                 _pc += arg_lit;
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_JNZ:
+        CC_OP(SCMD_JNZ):
         {
-            const auto arg_lit = codeOp.Arg1i();
+            const auto arg_lit = codeOp->Arg1i();
             if (!_registers[SREG_AX].IsNull())
                 _pc += arg_lit;
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_PUSHREG:
+        CC_OP(SCMD_PUSHREG):
         {
             // Push reg[arg1] value to the stack
-            const auto &reg1 = _registers[codeOp.Arg1i()];
+            const auto &reg1 = _registers[codeOp->Arg1i()];
             ASSERT_STACK_SPACE_VALS(1);
             PushValueToStack(reg1);
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_POPREG:
+        CC_OP(SCMD_POPREG):
         {
-            auto &reg1 = _registers[codeOp.Arg1i()];
+            auto &reg1 = _registers[codeOp->Arg1i()];
             ASSERT_STACK_SIZE(1);
             reg1 = PopValueFromStack();
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_JMP:
+        CC_OP(SCMD_JMP):
         {
-            const auto arg_lit = codeOp.Arg1i();
+            const auto arg_lit = codeOp->Arg1i();
             _pc += arg_lit;
 
             // Make sure it's not stuck in a While loop
@@ -1070,30 +1285,30 @@ ccInstError ccInstance::Run(int32_t curpc)
                     _lastAliveTs = FastClock::now();
                 }
             }
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_MUL:
+        CC_OP(SCMD_MUL):
         {
-            auto &reg1 = _registers[codeOp.Arg1i()];
-            const auto arg_lit = codeOp.Arg2i();
+            auto &reg1 = _registers[codeOp->Arg1i()];
+            const auto arg_lit = codeOp->Arg2i();
             reg1.IValue *= arg_lit;
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_CHECKBOUNDS:
+        CC_OP(SCMD_CHECKBOUNDS):
         {
-            const auto &reg1 = _registers[codeOp.Arg1i()];
-            const auto arg_lit = codeOp.Arg2i();
+            const auto &reg1 = _registers[codeOp->Arg1i()];
+            const auto arg_lit = codeOp->Arg2i();
             if ((reg1.IValue < 0) ||
                 (reg1.IValue >= arg_lit))
             {
                 cc_error("!Array index out of bounds (index: %d, bounds: 0..%d)", reg1.IValue, arg_lit - 1);
                 return kInstErr_Generic;
             }
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_DYNAMICBOUNDS:
+        CC_OP(SCMD_DYNAMICBOUNDS):
         {
-            const auto &reg1 = _registers[codeOp.Arg1i()];
+            const auto &reg1 = _registers[codeOp->Arg1i()];
             void *arr_ptr = _registers[SREG_MAR].GetPtrWithOffset();
             const auto &hdr = CCDynamicArray::GetHeader(arr_ptr);
             if ((reg1.IValue < 0) ||
@@ -1111,11 +1326,11 @@ ccInstError ccInstance::Run(int32_t curpc)
                 }
                 return kInstErr_Generic;
             }
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_MEMREADPTR:
+        CC_OP(SCMD_MEMREADPTR):
         {
-            auto &reg1 = _registers[codeOp.Arg1i()];
+            auto &reg1 = _registers[codeOp->Arg1i()];
             int32_t handle = _registers[SREG_MAR].ReadInt32();
             // FIXME: make pool return a ready RuntimeScriptValue with these set?
             // or another struct, which may be assigned to RSV
@@ -1124,13 +1339,14 @@ ccInstError ccInstance::Run(int32_t curpc)
             ScriptValueType obj_type = ccGetObjectAddressAndManagerFromHandle(handle, object, manager);
             reg1.SetScriptObject(obj_type, object, manager);
             ASSERT_CC_ERROR();
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_MEMWRITEPTR:
+        CC_OP(SCMD_MEMWRITEPTR):
         {
-            const auto &reg1 = _registers[codeOp.Arg1i()];
+            const auto &reg1 = _registers[codeOp->Arg1i()];
             int32_t handle = _registers[SREG_MAR].ReadInt32();
             void *address;
+            IScriptObject *manager = nullptr;
 
             switch (reg1.Type)
             {
@@ -1140,6 +1356,9 @@ ccInstError ccInstance::Run(int32_t curpc)
                 address = reg1.ArrMgr->GetElementPtr(reg1.Ptr, reg1.IValue);
                 break;
             case kScValScriptObject:
+                address = reg1.Ptr;
+                manager = reg1.ObjMgr;
+                break;
             case kScValPluginObject:
             case kScValPluginArgPtr:
                 address = reg1.Ptr;
@@ -1155,7 +1374,7 @@ ccInstError ccInstance::Run(int32_t curpc)
                 break;
             }
 
-            int32_t newHandle = ccGetObjectHandleFromAddress(address);
+            int32_t newHandle = ccGetObjectHandleFromAddress(address, manager);
             if (newHandle == -1)
                 return kInstErr_Generic;
 
@@ -1166,12 +1385,13 @@ ccInstError ccInstance::Run(int32_t curpc)
             }
             // Assign always, avoid leaving undefined value
             _registers[SREG_MAR].WriteInt32(newHandle);
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_MEMINITPTR:
+        CC_OP(SCMD_MEMINITPTR):
         {
             void *address;
-            const auto &reg1 = _registers[codeOp.Arg1i()];
+            IScriptObject *manager = nullptr;
+            const auto &reg1 = _registers[codeOp->Arg1i()];
 
             switch (reg1.Type)
             {
@@ -1181,6 +1401,9 @@ ccInstError ccInstance::Run(int32_t curpc)
                 address = reg1.ArrMgr->GetElementPtr(reg1.Ptr, reg1.IValue);
                 break;
             case kScValScriptObject:
+                address = reg1.Ptr;
+                manager = reg1.ObjMgr;
+                break;
             case kScValPluginObject:
             case kScValPluginArgPtr:
                 address = reg1.Ptr;
@@ -1197,22 +1420,22 @@ ccInstError ccInstance::Run(int32_t curpc)
             }
 
             // like memwriteptr, but doesn't attempt to free the old one
-            int32_t newHandle = ccGetObjectHandleFromAddress(address);
+            int32_t newHandle = ccGetObjectHandleFromAddress(address, manager);
             if (newHandle == -1)
                 return kInstErr_Generic;
 
             ccAddObjectReference(newHandle);
             _registers[SREG_MAR].WriteInt32(newHandle);
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_MEMZEROPTR:
+        CC_OP(SCMD_MEMZEROPTR):
         {
             int32_t handle = _registers[SREG_MAR].ReadInt32();
             ccReleaseObjectReference(handle);
             _registers[SREG_MAR].WriteInt32(0);
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_MEMZEROPTRND:
+        CC_OP(SCMD_MEMZEROPTRND):
         {
             int32_t handle = _registers[SREG_MAR].ReadInt32();
 
@@ -1225,37 +1448,37 @@ ccInstError ccInstance::Run(int32_t curpc)
             ccReleaseObjectReference(handle);
             pool.disableDisposeForObject = nullptr;
             _registers[SREG_MAR].WriteInt32(0);
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_CHECKNULL:
+        CC_OP(SCMD_CHECKNULL):
             if (_registers[SREG_MAR].IsNull())
             {
                 cc_error("!Null pointer referenced");
                 return kInstErr_Generic;
             }
-            break;
-        case SCMD_CHECKNULLREG:
+            CC_NEXT_OP();
+        CC_OP(SCMD_CHECKNULLREG):
         {
-            const auto &reg1 = _registers[codeOp.Arg1i()];
+            const auto &reg1 = _registers[codeOp->Arg1i()];
             if (reg1.IsNull())
             {
                 cc_error("!Null string referenced");
                 return kInstErr_Generic;
             }
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_NUMFUNCARGS:
+        CC_OP(SCMD_NUMFUNCARGS):
         {
-            const auto arg_lit = codeOp.Arg1i();
+            const auto arg_lit = codeOp->Arg1i();
             num_args_to_func = arg_lit;
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_CALLAS:
+        CC_OP(SCMD_CALLAS):
         {
             PUSH_CALL_STACK();
 
             // Call to a function in another script
-            const auto &reg1 = _registers[codeOp.Arg1i()];
+            const auto &reg1 = _registers[codeOp->Arg1i()];
 
             // If there are nested CALLAS calls, the stack might
             // contain 2 calls worth of parameters, so only
@@ -1280,7 +1503,7 @@ ccInstError ccInstance::Run(int32_t curpc)
             ccInstance *wasRunning = _runningInst;
 
             // extract the instance ID
-            int32_t instId = codeOp.Instruction.InstanceId;
+            int32_t instId = codeOp->InstanceId;
             // determine the offset into the code of the instance we want
             _runningInst = LoadedInstances[instId];
             uintptr_t callAddr = reg1.PtrU8 - reinterpret_cast<uint8_t*>(_runningInst->_code);
@@ -1291,6 +1514,8 @@ ccInstError ccInstance::Run(int32_t curpc)
             }
             callAddr /= sizeof(uintptr_t); // size of ccScript::code elements
 
+            if (_profiler)
+                ProfileScriptFunction(_runningInst, static_cast<int32_t>(callAddr));
             if (Run(static_cast<int32_t>(callAddr)))
                 return kInstErr_Generic;
 
@@ -1305,12 +1530,12 @@ ccInstError ccInstance::Run(int32_t curpc)
             was_just_callas = func_callstack.GetSize();
             num_args_to_func = -1;
             POP_CALL_STACK();
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_CALLEXT:
+        CC_OP(SCMD_CALLEXT):
         {
             // Call to a real 'C' code function
-            const auto &reg1 = _registers[codeOp.Arg1i()];
+            const auto &reg1 = _registers[codeOp->Arg1i()];
 
             was_just_callas = -1;
             if (num_args_to_func < 0)
@@ -1326,6 +1551,8 @@ ccInstError ccInstance::Run(int32_t curpc)
             }
 
             RuntimeScriptValue return_value;
+            if (_profiler)
+                ProfileExternalFunction(reg1);
 
             if (reg1.Type == kScValPluginFunction)
             {
@@ -1367,6 +1594,9 @@ ccInstError ccInstance::Run(int32_t curpc)
                 cc_error("invalid pointer type for function call: %d", reg1.Type);
             }
 
+            if (_profiler)
+                _profiler->Leave();
+
             if (cc_has_error())
             {
                 return kInstErr_Generic;
@@ -1375,20 +1605,20 @@ ccInstError ccInstance::Run(int32_t curpc)
             _registers[SREG_AX] = return_value;
             next_call_needs_object = 0;
             num_args_to_func = -1;
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_PUSHREAL:
+        CC_OP(SCMD_PUSHREAL):
         {
-            const auto &reg1 = _registers[codeOp.Arg1i()];
+            const auto &reg1 = _registers[codeOp->Arg1i()];
             func_callstack.Push(reg1);
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_SUBREALSTACK:
+        CC_OP(SCMD_SUBREALSTACK):
         {
             // Drop arg_lit entries from the func_callstack
             // TODO: cannot we just clear the func_callstack right after using it in call op?
             // it does not seem like these values are needed for anything else.
-            const auto arg_lit = codeOp.Arg1i();
+            const auto arg_lit = codeOp->Arg1i();
             if (func_callstack.GetSize() < static_cast<uint32_t>(arg_lit))
             {
                 cc_error("function callstack underflow");
@@ -1402,12 +1632,12 @@ ccInstError ccInstance::Run(int32_t curpc)
                 PopValuesFromStack(arg_lit);
                 was_just_callas = -1;
             }
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_CALLOBJ:
+        CC_OP(SCMD_CALLOBJ):
         {
             // set the OP register
-            const auto &reg1 = _registers[codeOp.Arg1i()];
+            const auto &reg1 = _registers[codeOp->Arg1i()];
             if (reg1.IsNull())
             {
                 cc_error("!Null pointer referenced");
@@ -1439,34 +1669,34 @@ ccInstError ccInstance::Run(int32_t curpc)
                 return kInstErr_Generic;
             }
             next_call_needs_object = 1;
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_SHIFTLEFT:
+        CC_OP(SCMD_SHIFTLEFT):
         {
-            auto       &reg1 = _registers[codeOp.Arg1i()];
-            const auto &reg2 = _registers[codeOp.Arg2i()];
+            auto       &reg1 = _registers[codeOp->Arg1i()];
+            const auto &reg2 = _registers[codeOp->Arg2i()];
             reg1.SetInt32(reg1.IValue << reg2.IValue);
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_SHIFTRIGHT:
+        CC_OP(SCMD_SHIFTRIGHT):
         {
-            auto       &reg1 = _registers[codeOp.Arg1i()];
-            const auto &reg2 = _registers[codeOp.Arg2i()];
+            auto       &reg1 = _registers[codeOp->Arg1i()];
+            const auto &reg2 = _registers[codeOp->Arg2i()];
             reg1.SetInt32(reg1.IValue >> reg2.IValue);
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_THISBASE:
+        CC_OP(SCMD_THISBASE):
         {
-            const auto arg_lit = codeOp.Arg1i();
+            const auto arg_lit = codeOp->Arg1i();
             thisbase[curnest] = arg_lit;
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_NEWARRAY:
+        CC_OP(SCMD_NEWARRAY):
         {
-            auto &reg1 = _registers[codeOp.Arg1i()];
+            auto &reg1 = _registers[codeOp->Arg1i()];
             const int arg_elnum = reg1.IValue;
-            const uint32_t arg_elsize = static_cast<uint32_t>(codeOp.Arg2i());
-            const bool arg_managed = codeOp.Arg3().GetAsBool();
+            const uint32_t arg_elsize = static_cast<uint32_t>(codeOp->Arg2i());
+            const bool arg_managed = codeOp->Arg3i() != 0;
             if (arg_elnum < 0)
             {
                 cc_error("Invalid size for dynamic array; requested: %d, range: 0..%d", arg_elnum, INT32_MAX);
@@ -1474,12 +1704,12 @@ ccInstError ccInstance::Run(int32_t curpc)
             }
             DynObjectRef ref = CCDynamicArray::Create(static_cast<uint32_t>(arg_elnum), arg_elsize, arg_managed);
             reg1.SetScriptObject(ref.Obj(), &globalDynamicArray);
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_NEWUSEROBJECT:
+        CC_OP(SCMD_NEWUSEROBJECT):
         {
-            auto &reg1 = _registers[codeOp.Arg1i()];
-            const uint32_t arg_size = static_cast<uint32_t>(codeOp.Arg2i());
+            auto &reg1 = _registers[codeOp->Arg1i()];
+            const uint32_t arg_size = static_cast<uint32_t>(codeOp->Arg2i());
             if (arg_size > INT32_MAX)
             {
                 cc_error("Invalid size for user object; requested: %u, range: 0..%d", arg_size, INT32_MAX);
@@ -1487,86 +1717,86 @@ ccInstError ccInstance::Run(int32_t curpc)
             }
             DynObjectRef ref = ScriptUserObject::Create(arg_size);
             reg1.SetScriptObject(ref.Obj(), ref.Mgr());
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_FADD:
+        CC_OP(SCMD_FADD):
         {
-            auto &reg1 = _registers[codeOp.Arg1i()];
-            const auto arg_lit = codeOp.Arg2i();
+            auto &reg1 = _registers[codeOp->Arg1i()];
+            const auto arg_lit = codeOp->Arg2i();
             reg1.SetFloat(reg1.FValue + arg_lit); // arg2 was used as int here originally
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_FSUB:
+        CC_OP(SCMD_FSUB):
         {
-            auto &reg1 = _registers[codeOp.Arg1i()];
-            const auto arg_lit = codeOp.Arg2i();
+            auto &reg1 = _registers[codeOp->Arg1i()];
+            const auto arg_lit = codeOp->Arg2i();
             reg1.SetFloat(reg1.FValue - arg_lit); // arg2 was used as int here originally
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_FMULREG:
+        CC_OP(SCMD_FMULREG):
         {
-            auto       &reg1 = _registers[codeOp.Arg1i()];
-            const auto &reg2 = _registers[codeOp.Arg2i()];
+            auto       &reg1 = _registers[codeOp->Arg1i()];
+            const auto &reg2 = _registers[codeOp->Arg2i()];
             reg1.SetFloat(reg1.FValue * reg2.FValue);
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_FDIVREG:
+        CC_OP(SCMD_FDIVREG):
         {
-            auto       &reg1 = _registers[codeOp.Arg1i()];
-            const auto &reg2 = _registers[codeOp.Arg2i()];
+            auto       &reg1 = _registers[codeOp->Arg1i()];
+            const auto &reg2 = _registers[codeOp->Arg2i()];
             if (reg2.FValue == 0.0)
             {
                 cc_error("!Floating point divide by zero");
                 return kInstErr_Generic;
             }
             reg1.SetFloat(reg1.FValue / reg2.FValue);
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_FADDREG:
+        CC_OP(SCMD_FADDREG):
         {
-            auto       &reg1 = _registers[codeOp.Arg1i()];
-            const auto &reg2 = _registers[codeOp.Arg2i()];
+            auto       &reg1 = _registers[codeOp->Arg1i()];
+            const auto &reg2 = _registers[codeOp->Arg2i()];
             reg1.SetFloat(reg1.FValue + reg2.FValue);
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_FSUBREG:
+        CC_OP(SCMD_FSUBREG):
         {
-            auto       &reg1 = _registers[codeOp.Arg1i()];
-            const auto &reg2 = _registers[codeOp.Arg2i()];
+            auto       &reg1 = _registers[codeOp->Arg1i()];
+            const auto &reg2 = _registers[codeOp->Arg2i()];
             reg1.SetFloat(reg1.FValue - reg2.FValue);
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_FGREATER:
+        CC_OP(SCMD_FGREATER):
         {
-            auto       &reg1 = _registers[codeOp.Arg1i()];
-            const auto &reg2 = _registers[codeOp.Arg2i()];
+            auto       &reg1 = _registers[codeOp->Arg1i()];
+            const auto &reg2 = _registers[codeOp->Arg2i()];
             reg1.SetFloatAsBool(reg1.FValue > reg2.FValue);
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_FLESSTHAN:
+        CC_OP(SCMD_FLESSTHAN):
         {
-            auto       &reg1 = _registers[codeOp.Arg1i()];
-            const auto &reg2 = _registers[codeOp.Arg2i()];
+            auto       &reg1 = _registers[codeOp->Arg1i()];
+            const auto &reg2 = _registers[codeOp->Arg2i()];
             reg1.SetFloatAsBool(reg1.FValue < reg2.FValue);
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_FGTE:
+        CC_OP(SCMD_FGTE):
         {
-            auto       &reg1 = _registers[codeOp.Arg1i()];
-            const auto &reg2 = _registers[codeOp.Arg2i()];
+            auto       &reg1 = _registers[codeOp->Arg1i()];
+            const auto &reg2 = _registers[codeOp->Arg2i()];
             reg1.SetFloatAsBool(reg1.FValue >= reg2.FValue);
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_FLTE:
+        CC_OP(SCMD_FLTE):
         {
-            auto       &reg1 = _registers[codeOp.Arg1i()];
-            const auto &reg2 = _registers[codeOp.Arg2i()];
+            auto       &reg1 = _registers[codeOp->Arg1i()];
+            const auto &reg2 = _registers[codeOp->Arg2i()];
             reg1.SetFloatAsBool(reg1.FValue <= reg2.FValue);
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_ZEROMEMORY:
+        CC_OP(SCMD_ZEROMEMORY):
         {
-            const auto arg_size = codeOp.Arg1i();
+            const auto arg_size = codeOp->Arg1i();
             // Check if we are zeroing at stack tail
             if (_registers[SREG_MAR] == _registers[SREG_SP])
             {
@@ -1583,20 +1813,20 @@ ccInstError ccInstance::Run(int32_t curpc)
                     _registers[SREG_MAR].Type);
                 return kInstErr_Generic;
             }
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_CREATESTRING:
+        CC_OP(SCMD_CREATESTRING):
         {
-            auto &reg1 = _registers[codeOp.Arg1i()];
+            auto &reg1 = _registers[codeOp->Arg1i()];
             const char *ptr = reinterpret_cast<const char*>(reg1.GetDirectPtr());
             DynObjectRef ref = ScriptString::Create(ptr);
             reg1.SetScriptObject(ref.Obj(), &myScriptStringImpl);
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_STRINGSEQUAL:
+        CC_OP(SCMD_STRINGSEQUAL):
         {
-            auto       &reg1 = _registers[codeOp.Arg1i()];
-            const auto &reg2 = _registers[codeOp.Arg2i()];
+            auto       &reg1 = _registers[codeOp->Arg1i()];
+            const auto &reg2 = _registers[codeOp->Arg2i()];
             if ((reg1.IsNull()) || (reg2.IsNull()))
             {
                 cc_error("!Null pointer referenced");
@@ -1608,12 +1838,12 @@ ccInstError ccInstance::Run(int32_t curpc)
                 const char *ptr2 = reinterpret_cast<const char*>(reg2.GetDirectPtr());
                 reg1.SetInt32AsBool(strcmp(ptr1, ptr2) == 0);
             }
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_STRINGSNOTEQ:
+        CC_OP(SCMD_STRINGSNOTEQ):
         {
-            auto       &reg1 = _registers[codeOp.Arg1i()];
-            const auto &reg2 = _registers[codeOp.Arg2i()];
+            auto       &reg1 = _registers[codeOp->Arg1i()];
+            const auto &reg2 = _registers[codeOp->Arg2i()];
             if ((reg1.IsNull()) || (reg2.IsNull()))
             {
                 cc_error("!Null pointer referenced");
@@ -1625,20 +1855,140 @@ ccInstError ccInstance::Run(int32_t curpc)
                 const char *ptr2 = reinterpret_cast<const char*>(reg2.GetDirectPtr());
                 reg1.SetInt32AsBool(strcmp(ptr1, ptr2) != 0);
             }
-            break;
+            CC_NEXT_OP();
         }
-        case SCMD_LOOPCHECKOFF:
+        CC_OP(SCMD_LOOPCHECKOFF):
             if (loopIterationCheckDisabled == 0)
                 loopIterationCheckDisabled++;
-            break;
+            CC_NEXT_OP();
+        //---------------------------------------------------------------------
+        // Fused instructions: each performs the same actions as the sequence
+        // of instructions that it replaces.
+        CC_OP(SCMDX_LOADSPOFFS_MEMREAD):
+        {
+            _registers[SREG_MAR] = GetStackPtrOffsetRw(codeOp->Arg1i());
+            ASSERT_CC_ERROR();
+            auto &reg2 = _registers[codeOp->Arg2i()];
+            reg2 = _registers[SREG_MAR].ReadValue();
+            CC_NEXT_OP();
+        }
+        CC_OP(SCMDX_LOADSPOFFS_MEMWRITE):
+        {
+            _registers[SREG_MAR] = GetStackPtrOffsetRw(codeOp->Arg1i());
+            ASSERT_CC_ERROR();
+            const auto &reg2 = _registers[codeOp->Arg2i()];
+            _registers[SREG_MAR].WriteValue(reg2);
+            CC_NEXT_OP();
+        }
+        CC_OP(SCMDX_LITTOREG_MEMREAD):
+        {
+            auto &reg1 = _registers[codeOp->Arg1i()];
+            RuntimeScriptValue arg_value;
+            FixupArgument(arg_value, *codeOp, 1, resolvedArgs, _stackBegin);
+            ASSERT_CC_ERROR();
+            reg1 = arg_value;
+            auto &reg3 = _registers[codeOp->Arg3i()];
+            reg3 = _registers[SREG_MAR].ReadValue();
+            CC_NEXT_OP();
+        }
+        CC_OP(SCMDX_LITTOREG_MEMWRITE):
+        {
+            auto &reg1 = _registers[codeOp->Arg1i()];
+            RuntimeScriptValue arg_value;
+            FixupArgument(arg_value, *codeOp, 1, resolvedArgs, _stackBegin);
+            ASSERT_CC_ERROR();
+            reg1 = arg_value;
+            const auto &reg3 = _registers[codeOp->Arg3i()];
+            _registers[SREG_MAR].WriteValue(reg3);
+            CC_NEXT_OP();
+        }
+        CC_OP(SCMDX_REGTOREG_POPREG):
+        {
+            const auto &reg1 = _registers[codeOp->Arg1i()];
+            auto       &reg2 = _registers[codeOp->Arg2i()];
+            reg2 = reg1;
+            auto &reg3 = _registers[codeOp->Arg3i()];
+            ASSERT_STACK_SIZE(1);
+            reg3 = PopValueFromStack();
+            CC_NEXT_OP();
+        }
+        CC_OP(SCMDX_ISEQUAL_JZ):
+        {
+            auto       &reg1 = _registers[codeOp->Arg1i()];
+            const auto &reg2 = _registers[codeOp->Arg2i()];
+            reg1.SetInt32AsBool(reg1 == reg2);
+            if (_registers[SREG_AX].IsNull())
+                _pc += codeOp->Arg3i();
+            CC_NEXT_OP();
+        }
+        CC_OP(SCMDX_NOTEQUAL_JZ):
+        {
+            auto       &reg1 = _registers[codeOp->Arg1i()];
+            const auto &reg2 = _registers[codeOp->Arg2i()];
+            reg1.SetInt32AsBool(reg1 != reg2);
+            if (_registers[SREG_AX].IsNull())
+                _pc += codeOp->Arg3i();
+            CC_NEXT_OP();
+        }
+        CC_OP(SCMDX_GREATER_JZ):
+        {
+            auto       &reg1 = _registers[codeOp->Arg1i()];
+            const auto &reg2 = _registers[codeOp->Arg2i()];
+            reg1.SetInt32AsBool(reg1.IValue > reg2.IValue);
+            if (_registers[SREG_AX].IsNull())
+                _pc += codeOp->Arg3i();
+            CC_NEXT_OP();
+        }
+        CC_OP(SCMDX_LESSTHAN_JZ):
+        {
+            auto       &reg1 = _registers[codeOp->Arg1i()];
+            const auto &reg2 = _registers[codeOp->Arg2i()];
+            reg1.SetInt32AsBool(reg1.IValue < reg2.IValue);
+            if (_registers[SREG_AX].IsNull())
+                _pc += codeOp->Arg3i();
+            CC_NEXT_OP();
+        }
+        CC_OP(SCMDX_GTE_JZ):
+        {
+            auto       &reg1 = _registers[codeOp->Arg1i()];
+            const auto &reg2 = _registers[codeOp->Arg2i()];
+            reg1.SetInt32AsBool(reg1.IValue >= reg2.IValue);
+            if (_registers[SREG_AX].IsNull())
+                _pc += codeOp->Arg3i();
+            CC_NEXT_OP();
+        }
+        CC_OP(SCMDX_LTE_JZ):
+        {
+            auto       &reg1 = _registers[codeOp->Arg1i()];
+            const auto &reg2 = _registers[codeOp->Arg2i()];
+            reg1.SetInt32AsBool(reg1.IValue <= reg2.IValue);
+            if (_registers[SREG_AX].IsNull())
+                _pc += codeOp->Arg3i();
+            CC_NEXT_OP();
+        }
+        CC_OP(SCMDX_BADJUMP):
+        {
+            const int32_t jump_code = codeOp->Args[1];
+            if ((jump_code == SCMD_JMP) ||
+                ((jump_code == SCMD_JZ) == _registers[SREG_AX].IsNull()))
+            {
+                cc_error("invalid jump destination %d in code stream at %d",
+                    _pc + codeOp->ArgCount + 1 + codeOp->Arg1i(), _pc);
+                return kInstErr_Generic;
+            }
+            CC_NEXT_OP();
+        }
         default:
-            cc_error("instruction %d is not implemented", codeOp.Instruction.Code);
+#if (CC_THREADED_DISPATCH)
+        op_invalid:
+#endif
+            cc_error("invalid instruction found in code stream at %d", _pc);
             return kInstErr_Generic;
         }
         /* End perform operation */
         //=====================================================================
 
-        _pc += codeOp.ArgCount + 1;
+        _pc += codeOp->ArgCount + 1;
     }
     return kInstErr_None;
 }
@@ -1708,6 +2058,9 @@ bool ccInstance::_Create(PScript scri, const ccInstance *joined)
         {
             _scriptData->code.resize(scri->code.size());
             _scriptData->code_fixups.resize(scri->code.size());
+            // One extra invalid instruction is put past the end of code,
+            // so that running past the last instruction fails safely
+            _scriptData->code_ops.resize(scri->code.size() + 1);
             // 64 bit: Read code into 8 byte array, necessary for being able to perform
             // relocations on the references.
             for (size_t i = 0; i < scri->code.size(); ++i)
@@ -1737,6 +2090,7 @@ bool ccInstance::_Create(PScript scri, const ccInstance *joined)
     _code = _scriptData->code.data();
     _codesize = static_cast<int32_t>(_scriptData->code.size());
     _code_fixups = _scriptData->code_fixups.data();
+    _codeOps = _scriptData->code_ops.data();
 
     // If this is a primary script's instance:
     // * register it in the loadedInstances array,
@@ -1771,6 +2125,10 @@ bool ccInstance::_Create(PScript scri, const ccInstance *joined)
         {
             return false;
         }
+        if (!DecodeInstructions())
+        {
+            return false;
+        }
         if (!ResolveExports(scri.get()))
         {
             return false;
@@ -1811,6 +2169,8 @@ void ccInstance::Free()
         if (_instanceof->instances == 0)
         {
             simp.RemoveScriptExports(this);
+            if (_profiler)
+                _profiler->RemoveOwner(_instanceof.get());
         }
     }
 
@@ -1822,6 +2182,8 @@ void ccInstance::Free()
     _scriptData = nullptr;
     _code = nullptr;
     _codesize = 0;
+    _code_fixups = nullptr;
+    _codeOps = nullptr;
     _strings = nullptr;
     _stringsize = 0u;
 
@@ -2059,6 +2421,133 @@ bool ccInstance::CreateRuntimeCodeFixups(const ccScript *scri)
     return true;
 }
 
+bool ccInstance::DecodeInstructions()
+{
+    // NOTE: the instructions array is allocated once and never resized after,
+    // because the instance forks keep the pointer to it.
+    // The array has one more element than the code, which is always left
+    // invalid, and stops the execution that went past the last instruction.
+    auto &code_ops = _scriptData->code_ops;
+    auto &resolved_args = _scriptData->resolved_args;
+    assert(code_ops.size() == _codesize + 1);
+    resolved_args.clear();
+
+    // Decode instructions in sequence; any position which is not a start of
+    // a valid instruction gets an "invalid" code, and will fail if executed.
+    ScriptInstruction invalid_op;
+    invalid_op.Code = SCMD_INVALID;
+    std::fill(code_ops.begin(), code_ops.end(), invalid_op);
+    for (uint32_t pc = 0; pc < _codesize; ++pc)
+    {
+        const intptr_t instr = _code[pc];
+        const int32_t code = static_cast<int32_t>(instr & INSTANCE_ID_REMOVEMASK);
+        if (code <= 0 || code >= CC_NUM_SCCMDS)
+            continue; // not an instruction, try next position
+        const int arg_count = sccmd_info[code].ArgCount;
+        if (pc + arg_count >= _codesize)
+            break; // unexpected end of code data
+
+        ScriptInstruction &op = code_ops[pc];
+        op.Code = static_cast<uint8_t>(code);
+        op.InstanceId = static_cast<uint16_t>((instr >> INSTANCE_ID_SHIFT) & INSTANCE_ID_MASK);
+        op.ArgCount = static_cast<uint8_t>(arg_count);
+        for (int i = 0; i < arg_count; ++i)
+            op.Args[i] = static_cast<int32_t>(_code[pc + 1 + i]);
+
+        // Only literal arguments of these instructions may have fixups
+        if ((code == SCMD_LITTOREG) || (code == SCMD_WRITELIT))
+        {
+            const uint32_t arg_pc = pc + 2;
+            const intptr_t arg_code = _code[arg_pc];
+            switch (_code_fixups[arg_pc])
+            {
+            case FIXUP_GLOBALDATA:
+                {
+                    ScriptVariable *gl_var = (ScriptVariable*)arg_code;
+                    assert(gl_var->RValue.IsValid());
+                    op.Fixup = FIXUP_GLOBALDATA;
+                    op.Args[1] = static_cast<int32_t>(resolved_args.size());
+                    resolved_args.push_back(RuntimeScriptValue().SetGlobalVar(&gl_var->RValue));
+                }
+                break;
+            case FIXUP_STRING:
+                op.Fixup = FIXUP_STRING;
+                op.Args[1] = static_cast<int32_t>(resolved_args.size());
+                resolved_args.push_back(RuntimeScriptValue().SetStringLiteral(_strings + arg_code));
+                break;
+            case FIXUP_FUNCTION:
+                // originally commented -- CHECKME: could this be used in very old versions of AGS?
+                //      code[fixup] += (long)&code[0];
+                // This is a program counter value, presumably will be used as SCMD_CALL argument;
+                // so same as the plain integer literal.
+                break;
+            case FIXUP_IMPORT:
+            case FIXUP_STACK:
+                // These depend on the runtime state, and are applied when executed
+                op.Fixup = _code_fixups[arg_pc];
+                break;
+            default:
+                break;
+            }
+        }
+        pc += arg_count;
+    }
+
+    // Validate jump destinations: the threaded dispatch does not test
+    // the program counter, so each jump must land on an instruction.
+    // NOTE: CALL and RET addresses are only known at runtime, these
+    // are tested by Run() when the instruction is executed.
+    // NOTE: the jumps which do not land on an instruction are not an error
+    // here, as old games may have these in the code which is never run;
+    // such jump is replaced by SCMDX_BADJUMP, which fails if executed.
+    for (uint32_t pc = 0; pc < _codesize; ++pc)
+    {
+        ScriptInstruction &op = code_ops[pc];
+        if (op.Code == SCMD_INVALID)
+            continue;
+        if ((op.Code == SCMD_JMP) || (op.Code == SCMD_JZ) || (op.Code == SCMD_JNZ))
+        {
+            const int64_t dest_pc = static_cast<int64_t>(pc) + op.ArgCount + 1 + op.Args[0];
+            if ((dest_pc < 0) || (dest_pc >= _codesize) || (code_ops[dest_pc].Code == SCMD_INVALID))
+            {
+                op.Args[1] = op.Code;
+                op.Code = SCMDX_BADJUMP;
+            }
+        }
+        pc += op.ArgCount;
+    }
+
+#if !(PROFILE_CC_OPCODES)
+    // Replace common instruction sequences with the fused instructions;
+    // the replaced instructions are kept in their places too, in case
+    // there's a jump to any of them.
+    for (uint32_t pc = 0; pc < _codesize; ++pc)
+    {
+        ScriptInstruction &op = code_ops[pc];
+        if (op.Code == SCMD_INVALID)
+            continue;
+        const uint32_t next_pc = pc + op.ArgCount + 1;
+        if (next_pc >= _codesize)
+            break;
+        const ScriptInstruction &next_op = code_ops[next_pc];
+        for (const auto &fused : scfused_info)
+        {
+            if ((op.Code != fused.First) || (next_op.Code != fused.Second))
+                continue;
+            assert(op.ArgCount + next_op.ArgCount <= MAX_SCMD_ARGS);
+            std::copy(next_op.Args, next_op.Args + next_op.ArgCount, op.Args + op.ArgCount);
+            // NOTE: fused instruction's ArgCount is the full length of sequence
+            // minus one, this lets advance the program counter uniformly
+            op.ArgCount = static_cast<uint8_t>(op.ArgCount + 1 + next_op.ArgCount);
+            op.Code = static_cast<uint8_t>(fused.Code);
+            break;
+        }
+        pc = next_pc - 1;
+    }
+#endif
+    return true;
+}
+
 bool ccInstance::ResolveExports(const ccScript *scri)
 {
     auto &exports = _scriptData->exports;
@@ -2143,7 +2632,8 @@ bool ccInstance::ResolveImportFixups()
         if (import->InstancePtr != nullptr && (_code[fixup + 1] & INSTANCE_ID_REMOVEMASK) == SCMD_CALLEXT)
             _code[fixup + 1] = SCMD_CALLAS | (import->InstancePtr->_loadedInstanceId << INSTANCE_ID_SHIFT);
     }
-    return true;
+    // Imports are resolved now, and CALLAS instructions may be set, so decode again
+    return DecodeInstructions();
 }
 
 void ccInstance::CopyGlobalData(const std::vector<uint8_t> &data)
@@ -2152,6 +2642,47 @@ void ccInstance::CopyGlobalData(const std::vector<uint8_t> &data)
     std::copy(data.begin(), data.begin() + copy_sz, _scriptData->globaldata.begin());
 }
 
+void ccInstance::ProfileScriptFunction(const ccInstance *inst, int32_t start_pc)
+{
+    const ccScript *script = inst->_instanceof.get();
+    uint32_t fn_id = _profiler->GetFunctionId(script, start_pc);
+    if (fn_id == UINT32_MAX)
+    {
+        // Find the function's name among the script exports,
+        // export names have a number of arguments appended after '$'
+        String fn_name;
+        for (size_t i = 0; i < script->exports.size(); ++i)
+        {
+            const int32_t etype = (script->export_addr[i] >> 24L) & 0x000ff;
+            if ((etype == EXPORT_FUNCTION) && ((script->export_addr[i] & 0x00ffffff) == start_pc))
+            {
+                const std::string &exp_name = script->exports[i];
+                fn_name = String(exp_name.c_str(), exp_name.find('$'));
+                break;
+            }
+        }
+        if (fn_name.IsEmpty())
+            fn_name.Format("func@%d", start_pc);
+        fn_id = _profiler->AddFunction(script, start_pc,
+            String::FromFormat("%s:%s", script->GetScriptName().c_str(), fn_name.GetCStr()));
+    }
+    _profiler->Enter(fn_id);
+}
+
+void ccInstance::ProfileExternalFunction(const RuntimeScriptValue &fn)
+{
+    const intptr_t fn_addr = reinterpret_cast<intptr_t>(fn.Ptr);
+    uint32_t fn_id = _profiler->GetFunctionId(nullptr, fn_addr);
+    if (fn_id == UINT32_MAX)
+    {
+        String fn_name = simp.FindName(fn);
+        if (fn_name.IsEmpty())
+            fn_name.Format("extfunc@%p", fn.Ptr);
+        fn_id = _profiler->AddFunction(nullptr, fn_addr, fn_name);
+    }
+    _profiler->Enter(fn_id);
+}
+
 RuntimeScriptValue ccInstance::CallPluginFunction(void *fn_addr, const RuntimeScriptValue *object,
     const RuntimeScriptValue *params, int param_count)
 {
@@ -2394,7 +2925,7 @@ void ccInstance::WriteString(const String &text)
 const char *regnames[] = { "null", "sp", "mar", "ax", "bx", "cx", "op", "dx" };
 const char *fixupnames[] = { "null", "fix_gldata", "fix_func", "fix_string", "fix_import", "fix_datadata", "fix_stack" };
 
-void ccInstance::DumpInstruction(const ScriptOperation &op) const
+void ccInstance::DumpInstruction(const ScriptInstruction &op) const
 {
     assert(_execWriter);
     if (!_execWriter)
@@ -2403,15 +2934,41 @@ void ccInstance::DumpInstruction(const ScriptOperation &op) const
     // line_num local var should be shared between all the instances
     static int line_num = 0; // FIXME, don't use local static variable
 
-    if (op.Instruction.Code == SCMD_LINENUM)
+    if (op.Code == SCMD_LINENUM)
     {
-        line_num = op.Args[0].IValue;
+        line_num = op.Args[0];
         return;
     }
 
     _execWriter->WriteFormat("Line %3d, IP:%8d (SP:%p) ", line_num, _pc, _registers[SREG_SP].RValue);
 
-    const ScriptCommandInfo &cmd_info = sccmd_info[op.Instruction.Code];
+    if (op.Code == SCMD_INVALID)
+    {
+        _execWriter->WriteString("(invalid)");
+        _execWriter->WriteLineBreak();
+        return;
+    }
+
+    if (op.Code == SCMDX_BADJUMP)
+    {
+        _execWriter->WriteFormat("%s %d (invalid)", sccmd_info[op.Args[1]].CmdName, op.Args[0]);
+        _execWriter->WriteLineBreak();
+        return;
+    }
+
+    if (op.Code > SCMD_INVALID)
+    {
+        // For fused instructions only print raw arguments
+        const ScriptFusedInfo &fused_info = scfused_info[op.Code - SCMD_INVALID - 1];
+        _execWriter->WriteString(fused_info.CmdName);
+        const int arg_count = sccmd_info[fused_info.First].ArgCount + sccmd_info[fused_info.Second].ArgCount;
+        for (int i = 0; i < arg_count; ++i)
+            _execWriter->WriteFormat("%s %d", (i > 0) ? "," : "", op.Args[i]);
+        _execWriter->WriteLineBreak();
+        return;
+    }
+
+    const ScriptCommandInfo &cmd_info = sccmd_info[op.Code];
     _execWriter->WriteString(cmd_info.CmdName);
 
     String value_buf;
@@ -2422,10 +2979,10 @@ void ccInstance::DumpInstruction(const ScriptOperation &op) const
             _execWriter->WriteChar(',');
         }
 
-        RuntimeScriptValue arg = op.Args[i];
+        RuntimeScriptValue arg = RuntimeScriptValue().SetInt32(op.Args[i]);
         if (cmd_info.ArgIsReg[i])
         {
-            _execWriter->WriteFormat(" %s", regnames[op.Args[i].IValue]);
+            _execWriter->WriteFormat(" %s", regnames[op.Args[i]]);
             arg = _registers[arg.IValue];
         }
         
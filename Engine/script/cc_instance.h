@@ -29,6 +29,7 @@
 #include "util/string.h"
 #include "util/time_util.h"
 
+namespace AGS { namespace Engine { class ScriptProfiler; } }
 using namespace AGS;
 
 #define INSTF_SHAREDATA     1
@@ -40,6 +41,7 @@ using namespace AGS;
 #define CC_STACK_SIZE       256
 // Size of stack in bytes (raw data storage)
 #define CC_STACK_DATA_SIZE  (1024 * sizeof(int32_t))
+static_assert(CC_STACK_DATA_SIZE <= UINT16_MAX, "Stack data size must fit into RuntimeScriptValue::Size");
 #define MAX_CALL_STACK      128
 
 // We use 10 bits to hold instance IDs ORed with op-code
@@ -60,31 +62,34 @@ using namespace AGS;
 #include "util/textstreamwriter.h"
 #endif
 
+// Script opcode profiling: counts executed pairs of adjacent instructions,
+// and prints the statistics to the log when the script instances are freed.
+// Used for choosing instruction sequences to fuse; disables instruction fusion.
+#ifndef PROFILE_CC_OPCODES
+#define PROFILE_CC_OPCODES (0)
+#endif
 
-struct ScriptInstruction
-{
-    ScriptInstruction() = default;
-    ScriptInstruction(int code, int instid) : Code(code), InstanceId(instid) {}
 
-    int32_t	Code = 0;
-    int32_t	InstanceId = 0;
-};
-
-struct ScriptOperation
+// Pre-decoded script instruction.
+// The bytecode is decoded and validated once, when the script instance is
+// created, and decoded instructions are stored in an array parallel to the
+// bytecode, so that the program counter and jump offsets keep their meaning.
+struct ScriptInstruction
 {
-	ScriptInstruction   Instruction;
-	RuntimeScriptValue	Args[MAX_SCMD_ARGS];
-	int				    ArgCount = 0;
+    uint8_t     Code = 0;       // pure instruction code, without instance id
+    uint8_t     ArgCount = 0;   // number of arguments
+    uint8_t     Fixup = 0;      // runtime fixup type of the literal argument (FIXUP_*)
+    uint16_t    InstanceId = 0; // instance id, for the calls to another script
+    // Arguments, as written in the bytecode; if the literal argument
+    // has a fixup, then it's either an index of pre-resolved value,
+    // or a value to apply fixup to at runtime, depending on fixup type.
+    int32_t     Args[MAX_SCMD_ARGS]{};
 
     // Helper functions for clarity of intent:
-    // returns argN, 1-based
-    inline const RuntimeScriptValue &Arg1() const { return Args[0]; }
-    inline const RuntimeScriptValue &Arg2() const { return Args[1]; }
-    inline const RuntimeScriptValue &Arg3() const { return Args[2]; }
-    // returns argN as a integer literal
-    inline int Arg1i() const { return Args[0].IValue; }
-    inline int Arg2i() const { return Args[1].IValue; }
-    inline int Arg3i() const { return Args[2].IValue; }
+    // returns argN as a integer literal, 1-based
+    inline int Arg1i() const { return Args[0]; }
+    inline int Arg2i() const { return Args[1]; }
+    inline int Arg3i() const { return Args[2]; }
 };
 
 struct ScriptVariable
@@ -141,6 +146,8 @@ public:
     static std::unique_ptr<ccInstance> CreateFromScript(PScript script);
     static std::unique_ptr<ccInstance> CreateEx(PScript scri, const ccInstance * joined);
     static void SetExecTimeout(unsigned sys_poll_ms, unsigned abort_ms, unsigned abort_loops);
+    // Assigns the profiler, which receives the function calls; pass null to disable profiling
+    static void SetProfiler(AGS::Engine::ScriptProfiler *profiler);
 
     ccInstance() = default;
     ~ccInstance();
@@ -200,6 +207,10 @@ private:
     bool    AddGlobalVar(const ScriptVariable &glvar);
     ScriptVariable *FindGlobalVar(int32_t var_addr);
     bool    CreateRuntimeCodeFixups(const ccScript *scri);
+    // Decodes the bytecode into the array of ready instructions,
+    // resolves the fixups which do not depend on the runtime state;
+    // fails if any of the jumps has an invalid destination
+    bool    DecodeInstructions();
     bool    ResolveExports(const ccScript *scri);
     // Registers this script's resolved exports as imports in the symbol import table
     bool    ImportScriptExports(const ccScript *scri);
@@ -212,6 +223,11 @@ private:
     // Begin executing script starting from the given bytecode index
     ccInstError Run(int32_t curpc);
 
+    // Registers a call of the script function in the profiler
+    static void ProfileScriptFunction(const ccInstance *inst, int32_t start_pc);
+    // Registers a call of the engine API or plugin function in the profiler
+    static void ProfileExternalFunction(const RuntimeScriptValue &fn);
+
     // For calling exported plugin functions old-style
     RuntimeScriptValue CallPluginFunction(void *fn_addr, const RuntimeScriptValue *object, const RuntimeScriptValue *params, int param_count);
 
@@ -239,7 +255,7 @@ private:
     // Writes a arbitrary line of text into the log
     void    WriteString(const String &text);
     // Formats instruction into string output
-    void    DumpInstruction(const ScriptOperation &op) const;
+    void    DumpInstruction(const ScriptInstruction &op) const;
 #endif
 
     // Represented script object
@@ -259,6 +275,10 @@ private:
         // performing fixups.
         std::vector<intptr_t>   code;
         std::vector<uint8_t>    code_fixups;
+        // Pre-decoded instructions, parallel to the code array
+        std::vector<ScriptInstruction> code_ops;
+        // Argument values with the fixups resolved at load time
+        std::vector<RuntimeScriptValue> resolved_args;
         // Resolved global variables
         std::unordered_map<int32_t, ScriptVariable> globalvars;
         // This script's exports
@@ -273,6 +293,7 @@ private:
     intptr_t   *_code = nullptr;
     uint32_t    _codesize = 0; // size of code is limited under 32-bit due to bytecode format
     const uint8_t *_code_fixups = nullptr;
+    const ScriptInstruction *_codeOps = nullptr;
     const char *_strings = nullptr; // pointer to ccScript's string data
     size_t      _stringsize = 0u;
 
@@ -306,6 +327,8 @@ private:
     static unsigned _maxWhileLoops;
     // Last time the script was noted of being "alive"
     AGS::Engine::FastClock::time_point _lastAliveTs;
+    // Optional profiler, shared among all the ccInstances
+    static AGS::Engine::ScriptProfiler *_profiler;
 
 #if (DEBUG_CC_EXEC)
     // Execution logger, optional, shared among all the ccInstances
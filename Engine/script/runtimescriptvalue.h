@@ -23,7 +23,8 @@
 #include "script/script_api.h"
 #include "util/memory.h"
 
-enum ScriptValueType
+// NOTE: the type is stored in a single byte, to keep RuntimeScriptValue compact
+enum ScriptValueType : uint8_t
 {
     kScValUndefined,    // to detect errors
     kScValInteger,      // as strictly 32-bit integer (for integer math)
@@ -70,7 +71,20 @@ public:
         Size        = 4;
     }
 
+    // NOTE: the fields are ordered to avoid padding: Type and Size fit into
+    // the first 4 bytes, so that the whole struct takes 8 bytes + 2 pointers.
+    // These values are copied a lot by the script executor, so keeping
+    // them small reduces the memory traffic.
     ScriptValueType Type;
+    // The "real" size of data, either one stored in I/FValue,
+    // or the one referenced by Ptr. Used for calculating stack
+    // offsets.
+    // Original AGS scripts always assumed pointer is 32-bit.
+    // Therefore for stored pointers Size is always 4 both for x32
+    // and x64 builds, so that the script is interpreted correctly.
+    // Data sizes are limited by the script stack size, which is
+    // far below the 16-bit limit.
+    uint16_t        Size;
     // The 32-bit value used for integer/float math and for storing
     // variable/element offset relative to object (and array) address
     union
@@ -98,13 +112,6 @@ public:
         IScriptObject    *ObjMgr; // script object manager
         CCStaticArray    *ArrMgr; // static array manager
     };
-    // The "real" size of data, either one stored in I/FValue,
-    // or the one referenced by Ptr. Used for calculating stack
-    // offsets.
-    // Original AGS scripts always assumed pointer is 32-bit.
-    // Therefore for stored pointers Size is always 4 both for x32
-    // and x64 builds, so that the script is interpreted correctly.
-    int             Size;
 
     inline bool IsValid() const
     {
@@ -233,6 +240,7 @@ public:
 
     inline RuntimeScriptValue &SetData(void *data, int size)
     {
+        assert(size >= 0 && size <= UINT16_MAX);
         Type    = kScValData;
         IValue  = 0;
         Ptr     = data;
@@ -486,4 +494,7 @@ public:
     void *      GetDirectPtr() const;
 };
 
+static_assert(sizeof(RuntimeScriptValue) == sizeof(int32_t) * 2 + sizeof(void*) * 2,
+    "RuntimeScriptValue must not have any padding");
+
 #endif // __AGS_EE_SCRIPT__RUNTIMESCRIPTVALUE_H
@@ -0,0 +1,179 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2026 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include "script/script_profiler.h"
+#include <algorithm>
+
+using namespace AGS::Common;
+
+namespace AGS
+{
+namespace Engine
+{
+
+uint32_t ScriptProfiler::GetFunctionId(const void *owner, intptr_t addr) const
+{
+    FunctionKey key;
+    key.Owner = owner;
+    key.Addr = addr;
+    auto it = _fnByKey.find(key);
+    return it != _fnByKey.end() ? it->second : UINT32_MAX;
+}
+
+uint32_t ScriptProfiler::AddFunction(const void *owner, intptr_t addr, const String &name)
+{
+    uint32_t fn_id;
+    auto it_name = _fnByName.find(name);
+    if (it_name != _fnByName.end())
+    {
+        fn_id = it_name->second;
+    }
+    else
+    {
+        fn_id = static_cast<uint32_t>(_fnNames.size());
+        _fnNames.push_back(name);
+        _fnByName.insert(std::make_pair(name, fn_id));
+    }
+    FunctionKey key;
+    key.Owner = owner;
+    key.Addr = addr;
+    _fnByKey[key] = fn_id;
+    return fn_id;
+}
+
+void ScriptProfiler::RemoveOwner(const void *owner)
+{
+    for (auto it = _fnByKey.begin(); it != _fnByKey.end();)
+    {
+        if (it->first.Owner == owner)
+            it = _fnByKey.erase(it);
+        else
+            ++it;
+    }
+}
+
+void ScriptProfiler::Enter(uint32_t fn_id)
+{
+    const uint32_t parent = _frames.empty() ? UINT32_MAX : _frames.back().Node;
+    const uint64_t node_key = (static_cast<uint64_t>(parent) << 32) | fn_id;
+    uint32_t node;
+    auto it = _nodeLookup.find(node_key);
+    if (it != _nodeLookup.end())
+    {
+        node = it->second;
+    }
+    else
+    {
+        node = static_cast<uint32_t>(_nodes.size());
+        CallNode call_node;
+        call_node.FnId = fn_id;
+        call_node.Parent = parent;
+        _nodes.push_back(call_node);
+        _nodeLookup.insert(std::make_pair(node_key, node));
+    }
+
+    Frame frame;
+    frame.Node = node;
+    frame.Start = Clock::now();
+    _frames.push_back(frame);
+}
+
+void ScriptProfiler::Leave()
+{
+    if (_frames.empty())
+        return;
+
+    const Frame frame = _frames.back();
+    _frames.pop_back();
+    const Duration elapsed = Clock::now() - frame.Start;
+    CallNode &node = _nodes[frame.Node];
+    node.Calls++;
+    node.Inclusive += elapsed;
+    node.Exclusive += elapsed - frame.ChildTime;
+    if (!_frames.empty())
+        _frames.back().ChildTime += elapsed;
+}
+
+void ScriptProfiler::UnwindTo(size_t depth)
+{
+    while (_frames.size() > depth)
+        Leave();
+}
+
+void ScriptProfiler::Reset()
+{
+    _fnNames.clear();
+    _fnByName.clear();
+    _fnByKey.clear();
+    _nodes.clear();
+    _nodeLookup.clear();
+    _frames.clear();
+}
+
+std::vector<ScriptProfiler::FunctionStats> ScriptProfiler::GetFunctionStats() const
+{
+    std::vector<FunctionStats> stats(_fnNames.size());
+    for (size_t i = 0; i < _fnNames.size(); ++i)
+        stats[i].Name = _fnNames[i];
+
+    for (const auto &node : _nodes)
+    {
+        FunctionStats &fn_stats = stats[node.FnId];
+        fn_stats.Calls += node.Calls;
+        fn_stats.Exclusive += node.Exclusive;
+        // Only count inclusive time of the outermost call in recursion
+        bool is_recursive = false;
+        for (uint32_t parent = node.Parent; parent != UINT32_MAX && !is_recursive;
+             parent = _nodes[parent].Parent)
+        {
+            is_recursive = _nodes[parent].FnId == node.FnId;
+        }
+        if (!is_recursive)
+            fn_stats.Inclusive += node.Inclusive;
+    }
+
+    std::sort(stats.begin(), stats.end(),
+        [](const FunctionStats &a, const FunctionStats &b) { return a.Exclusive > b.Exclusive; });
+    return stats;
+}
+
+String ScriptProfiler::MakeNodePath(uint32_t node) const
+{
+    std::vector<uint32_t> path;
+    for (; node != UINT32_MAX; node = _nodes[node].Parent)
+        path.push_back(node);
+
+    String path_str;
+    for (auto it = path.rbegin(); it != path.rend(); ++it)
+    {
+        if (!path_str.IsEmpty())
+            path_str.AppendChar(';');
+        path_str.Append(_fnNames[_nodes[*it].FnId]);
+    }
+    return path_str;
+}
+
+void ScriptProfiler::WriteCollapsedStacks(TextWriter &out) const
+{
+    for (uint32_t node = 0; node < _nodes.size(); ++node)
+    {
+        if (_nodes[node].Calls == 0u)
+            continue; // not finished yet
+        const int64_t time_us =
+            std::chrono::duration_cast<std::chrono::microseconds>(_nodes[node].Exclusive).count();
+        out.WriteLineFormat("%s %lld", MakeNodePath(node).GetCStr(), static_cast<long long>(time_us));
+    }
+}
+
+} // namespace Engine
+} // namespace AGS
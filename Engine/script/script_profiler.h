@@ -0,0 +1,137 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2026 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+//
+// ScriptProfiler is an instrumenting profiler of the script functions.
+// The script interpreter reports entering and leaving functions, either
+// script's own or the engine API and plugin functions, and the profiler
+// builds a call tree with the call counts, inclusive and exclusive time.
+//
+// The results may be written as "collapsed stacks", one line per unique
+// call path, with the functions separated by semicolons, followed by the
+// exclusive time of the last function in this path, in microseconds:
+//     room1.asc:room_RepExec;Character::Walk^4 1234
+// This format is read by the flame graph tools.
+//
+//=============================================================================
+#ifndef __AGS_EE_SCRIPT__SCRIPTPROFILER_H
+#define __AGS_EE_SCRIPT__SCRIPTPROFILER_H
+
+#include <unordered_map>
+#include <vector>
+#include "util/string_types.h"
+#include "util/textwriter.h"
+#include "util/time_util.h"
+
+namespace AGS
+{
+namespace Engine
+{
+
+class ScriptProfiler
+{
+public:
+    using Duration = Clock::duration;
+
+    // Aggregated statistics of a single function
+    struct FunctionStats
+    {
+        Common::String Name;
+        uint64_t    Calls = 0u;
+        Duration    Inclusive = Duration::zero(); // recursive calls are not counted twice
+        Duration    Exclusive = Duration::zero();
+    };
+
+    // Looks up a function id by the key, which consists of an owner
+    // (e.g. a script) and an address; returns UINT32_MAX if not registered
+    uint32_t GetFunctionId(const void *owner, intptr_t addr) const;
+    // Registers a function key and assigns it a name; functions with
+    // the same name share the id. Returns the function's id.
+    uint32_t AddFunction(const void *owner, intptr_t addr, const Common::String &name);
+    // Forgets all the function keys with the given owner; this should be
+    // called when the owner is deleted and its address may be reused.
+    // The collected statistics remain.
+    void     RemoveOwner(const void *owner);
+
+    // Registers entering a function
+    void     Enter(uint32_t fn_id);
+    // Registers leaving the last entered function
+    void     Leave();
+    // Gets the number of currently entered functions
+    size_t   GetDepth() const { return _frames.size(); }
+    // Leaves the functions until the call stack is unwinded to the given depth;
+    // used to restore the profiler state after the script was aborted
+    void     UnwindTo(size_t depth);
+    // Clears all the collected data
+    void     Reset();
+
+    // Gets the aggregated statistics of all the called functions,
+    // sorted by exclusive time, in descending order
+    std::vector<FunctionStats> GetFunctionStats() const;
+    // Writes the collected call paths in the "collapsed stacks" format
+    void     WriteCollapsedStacks(Common::TextWriter &out) const;
+
+private:
+    // A node of the call tree: represents a function called by a particular path
+    struct CallNode
+    {
+        uint32_t    FnId = 0u;
+        uint32_t    Parent = UINT32_MAX;
+        uint64_t    Calls = 0u;
+        Duration    Inclusive = Duration::zero();
+        Duration    Exclusive = Duration::zero();
+    };
+
+    // An entered function
+    struct Frame
+    {
+        uint32_t    Node = 0u;
+        Clock::time_point Start;
+        Duration    ChildTime = Duration::zero();
+    };
+
+    struct FunctionKey
+    {
+        const void *Owner = nullptr;
+        intptr_t    Addr = 0;
+
+        bool operator==(const FunctionKey &other) const
+        {
+            return Owner == other.Owner && Addr == other.Addr;
+        }
+    };
+
+    struct FunctionKeyHash
+    {
+        size_t operator()(const FunctionKey &key) const
+        {
+            return std::hash<const void*>()(key.Owner) ^ (std::hash<intptr_t>()(key.Addr) * 31u);
+        }
+    };
+
+    // Builds a full path of function names for the given node
+    Common::String MakeNodePath(uint32_t node) const;
+
+    std::vector<Common::String> _fnNames;
+    std::unordered_map<Common::String, uint32_t> _fnByName;
+    std::unordered_map<FunctionKey, uint32_t, FunctionKeyHash> _fnByKey;
+    std::vector<CallNode> _nodes;
+    // Call tree nodes lookup, the key is a combination of parent node and function id
+    std::unordered_map<uint64_t, uint32_t> _nodeLookup;
+    std::vector<Frame> _frames;
+};
+
+} // namespace Engine
+} // namespace AGS
+
+#endif // __AGS_EE_SCRIPT__SCRIPTPROFILER_H
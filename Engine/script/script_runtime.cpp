@@ -12,12 +12,20 @@
 //
 //=============================================================================
 #include "script/script_runtime.h"
+#include <algorithm>
 #include <stdlib.h>
 #include <stdarg.h>
 #include <string.h>
 #include "ac/dynobj/cc_dynamicarray.h"
+#include "debug/out.h"
 #include "script/cc_common.h"
+#include "script/script_profiler.h"
 #include "script/systemimports.h"
+#include "util/file.h"
+#include "util/textstreamwriter.h"
+
+using namespace AGS::Common;
+using namespace AGS::Engine;
 
 
 SystemImports simp;
@@ -141,3 +149,50 @@ void ccSetDebugLogging(bool on)
 {
     ccSetOption(SCOPT_DEBUGRUN, on);
 }
+
+static std::unique_ptr<ScriptProfiler> ScProfiler;
+
+void ccStartScriptProfiler()
+{
+    if (!ScProfiler)
+        ScProfiler.reset(new ScriptProfiler());
+    ccInstance::SetProfiler(ScProfiler.get());
+    Debug::Printf(kDbgGroup_Script, kDbgMsg_Info, "Script profiler started");
+}
+
+void ccStopScriptProfiler(const String &out_file)
+{
+    if (!ScProfiler)
+        return;
+
+    ccInstance::SetProfiler(nullptr);
+    ScProfiler->UnwindTo(0u);
+
+    const auto stats = ScProfiler->GetFunctionStats();
+    const size_t max_entries = std::min<size_t>(stats.size(), 32u);
+    Debug::Printf(kDbgGroup_Script, kDbgMsg_Info, "Script profiler: %zu functions called, top %zu by exclusive time:",
+        stats.size(), max_entries);
+    Debug::Printf(kDbgGroup_Script, kDbgMsg_Info, "%12s %12s %12s  %s", "calls", "incl (ms)", "excl (ms)", "function");
+    for (size_t i = 0; i < max_entries; ++i)
+    {
+        Debug::Printf(kDbgGroup_Script, kDbgMsg_Info, "%12llu %12.3f %12.3f  %s",
+            static_cast<unsigned long long>(stats[i].Calls), ToMillisecondsF(stats[i].Inclusive),
+            ToMillisecondsF(stats[i].Exclusive), stats[i].Name.GetCStr());
+    }
+
+    if (!out_file.IsEmpty())
+    {
+        auto s = File::OpenFile(out_file, kFile_CreateAlways, kStream_Write);
+        if (s)
+        {
+            TextStreamWriter writer(std::move(s));
+            ScProfiler->WriteCollapsedStacks(writer);
+            Debug::Printf(kDbgGroup_Script, kDbgMsg_Info, "Script profile written to %s", out_file.GetCStr());
+        }
+        else
+        {
+            Debug::Printf(kDbgGroup_Script, kDbgMsg_Error, "Failed to write script profile to %s", out_file.GetCStr());
+        }
+    }
+    ScProfiler.reset();
+}
@@ -89,6 +89,11 @@ void *ccGetScriptObjectAddress(const String &name, const String &type);
 typedef void (*new_line_hook_type) (ccInstance *, int);
 void ccSetDebugHook(new_line_hook_type jibble);
 void ccSetDebugLogging(bool on);
+// Starts collecting the script function calls statistics
+void ccStartScriptProfiler();
+// Stops the script profiler, prints the summary to the log and writes
+// the collected call stacks into the file in "collapsed stacks" format
+void ccStopScriptProfiler(const String &out_file);
 
 // Set the script interpreter timeout values:
 // * sys_poll_timeout - defines the timeout (ms) at which the interpreter will run system events poll;
@@ -0,0 +1,165 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2026 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include <string.h>
+#include <memory>
+#include <vector>
+#include "gtest/gtest.h"
+#include "gfx/banded_render.h"
+#include "gfx/bitmap.h"
+#include "gfx/gfx_util.h"
+
+using namespace AGS::Common;
+using namespace AGS::Engine;
+
+namespace
+{
+
+uint32_t NextRandom(uint32_t &seed)
+{
+    seed = seed * 1103515245u + 12345u;
+    return (seed >> 16) | (seed << 16);
+}
+
+enum SceneSpriteKind
+{
+    kSceneSprite_Alpha,
+    kSceneSprite_TransAlpha,
+    kSceneSprite_Masked,
+    kSceneSprite_Opaque
+};
+
+struct SceneSprite
+{
+    const Bitmap *Bmp = nullptr;
+    int X = 0, Y = 0;
+    SceneSpriteKind Kind = kSceneSprite_Alpha;
+    int Alpha = 255;
+};
+
+// A scene made of hundreds of alpha sprites, with a few others in between
+struct TestScene
+{
+    std::vector<std::unique_ptr<Bitmap>> Images;
+    std::vector<SceneSprite> Sprites;
+
+    TestScene(int width, int height, size_t sprite_count)
+    {
+        uint32_t seed = 1;
+        for (int i = 0; i < 8; ++i)
+        {
+            const int size = 32 + 32 * i;
+            std::unique_ptr<Bitmap> bmp(BitmapHelper::CreateBitmap(size, size, 32));
+            for (int y = 0; y < size; ++y)
+            {
+                uint32_t *row = reinterpret_cast<uint32_t*>(bmp->GetScanLineForWriting(y));
+                for (int x = 0; x < size; ++x)
+                    row[x] = (NextRandom(seed) % 8 == 0) ? 0x00FF00FF : NextRandom(seed);
+            }
+            Images.push_back(std::move(bmp));
+        }
+        for (size_t i = 0; i < sprite_count; ++i)
+        {
+            SceneSprite spr;
+            spr.Bmp = Images[NextRandom(seed) % Images.size()].get();
+            // let some of the sprites cross the surface borders
+            spr.X = static_cast<int>(NextRandom(seed) % (width + spr.Bmp->GetWidth())) - spr.Bmp->GetWidth() / 2;
+            spr.Y = static_cast<int>(NextRandom(seed) % (height + spr.Bmp->GetHeight())) - spr.Bmp->GetHeight() / 2;
+            const uint32_t kind = NextRandom(seed) % 16;
+            spr.Kind = (kind < 12) ? kSceneSprite_Alpha :
+                (kind < 14) ? kSceneSprite_TransAlpha :
+                (kind < 15) ? kSceneSprite_Masked : kSceneSprite_Opaque;
+            spr.Alpha = (spr.Kind == kSceneSprite_TransAlpha) ? 1 + NextRandom(seed) % 254 : 255;
+            Sprites.push_back(spr);
+        }
+    }
+
+    // Draws the sprites same way as the software renderer does
+    void Draw(Bitmap *ds, int offx, int offy) const
+    {
+        for (const auto &spr : Sprites)
+        {
+            switch (spr.Kind)
+            {
+            case kSceneSprite_Alpha:
+                GfxUtil::DrawSpriteRowBlend(ds, spr.Bmp, spr.X + offx, spr.Y + offy, kRowBlend_Alpha);
+                break;
+            case kSceneSprite_TransAlpha:
+                GfxUtil::DrawSpriteRowBlend(ds, spr.Bmp, spr.X + offx, spr.Y + offy, kRowBlend_TransAlpha, spr.Alpha);
+                break;
+            case kSceneSprite_Masked:
+                ds->Blit(spr.Bmp, spr.X + offx, spr.Y + offy, kBitmap_Transparency);
+                break;
+            case kSceneSprite_Opaque:
+                ds->Blit(spr.Bmp, spr.X + offx, spr.Y + offy, kBitmap_Copy);
+                break;
+            }
+        }
+    }
+};
+
+void FillSurface(Bitmap *ds)
+{
+    uint32_t seed = 7;
+    for (int y = 0; y < ds->GetHeight(); ++y)
+    {
+        uint32_t *row = reinterpret_cast<uint32_t*>(ds->GetScanLineForWriting(y));
+        for (int x = 0; x < ds->GetWidth(); ++x)
+            row[x] = NextRandom(seed);
+    }
+}
+
+bool SurfacesEqual(const Bitmap *a, const Bitmap *b)
+{
+    for (int y = 0; y < a->GetHeight(); ++y)
+    {
+        if (memcmp(a->GetScanLine(y), b->GetScanLine(y), a->GetWidth() * a->GetBPP()) != 0)
+            return false;
+    }
+    return true;
+}
+
+} // namespace
+
+TEST(BandedRender, MatchSingleThread) {
+    const int width = 640, height = 400;
+    TestScene scene(width, height, 300);
+    std::unique_ptr<Bitmap> ref(BitmapHelper::CreateBitmap(width, height, 32));
+    std::unique_ptr<Bitmap> res(BitmapHelper::CreateBitmap(width, height, 32));
+    const Rect clips[] = {
+        RectWH(0, 0, width, height), RectWH(37, 51, 400, 263),
+        RectWH(0, 100, width, 3), RectWH(10, height - 20, 200, 100)
+    };
+
+    BandedRenderer renderer;
+    for (size_t threads : { 1u, 2u, 3u, 4u, 7u, 0u })
+    {
+        renderer.SetThreadCount(threads);
+        for (const Rect &clip : clips)
+        {
+            FillSurface(ref.get());
+            ref->SetClip(clip);
+            scene.Draw(ref.get(), 5, -3);
+            ref->ResetClip();
+
+            FillSurface(res.get());
+            res->SetClip(clip);
+            renderer.Draw(res.get(), [&scene](Bitmap *band, int band_y)
+                { scene.Draw(band, 5, -3 - band_y); });
+            res->ResetClip();
+
+            ASSERT_TRUE(SurfacesEqual(ref.get(), res.get())) << "threads " << renderer.GetThreadCount()
+                << ", clip " << clip.Left << "," << clip.Top << "," << clip.Right << "," << clip.Bottom;
+        }
+    }
+}
@@ -0,0 +1,105 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2026 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include <algorithm>
+#include <vector>
+#include "gtest/gtest.h"
+#include "gfx/blender.h"
+#include "gfx/blender_rows.h"
+
+using namespace AGS::Engine;
+
+extern "C" {
+    uint32_t _blender_trans24(uint32_t x, uint32_t y, uint32_t n);
+    uint32_t _blender_alpha32(uint32_t x, uint32_t y, uint32_t n);
+}
+
+typedef uint32_t (*PfnPixelBlend)(uint32_t x, uint32_t y, uint32_t n);
+
+// Per-pixel blenders matching each row blend operation
+static const PfnPixelBlend RefBlenders[kNumRowBlendOps] = {
+    _blender_alpha32, _trans_alpha_blender32, _argb2rgb_blender,
+    _argb2argb_blender, _blender_trans24, _additive_alpha_copysrc_blender
+};
+
+static const uint32_t MaskColor32 = 0x00FF00FF;
+
+static uint32_t NextRandom(uint32_t &seed)
+{
+    seed = seed * 1103515245u + 12345u;
+    return (seed >> 16) | (seed << 16);
+}
+
+// Blends the row with the per-pixel blender, same way as draw_trans_sprite does
+static void RefBlendRow(PfnPixelBlend blender, uint32_t *dst, const uint32_t *src, size_t count, uint32_t alpha)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (src[i] != MaskColor32)
+            dst[i] = blender(src[i], dst[i], alpha);
+    }
+}
+
+TEST(BlenderRows, MatchPerPixelBlenders) {
+    // Every combination of src and dst alpha, with random colors,
+    // and some mask color pixels
+    const size_t count = 256 * 256;
+    std::vector<uint32_t> src(count), dst(count);
+    uint32_t seed = 1;
+    for (size_t i = 0; i < count; ++i)
+    {
+        src[i] = (static_cast<uint32_t>(i & 0xFF) << 24) | (NextRandom(seed) & 0xFFFFFF);
+        dst[i] = (static_cast<uint32_t>(i >> 8) << 24) | (NextRandom(seed) & 0xFFFFFF);
+        if (NextRandom(seed) % 16 == 0)
+            src[i] = MaskColor32;
+    }
+    // Extreme colors
+    for (size_t i = 0; i < count; i += 7)
+    {
+        src[i] = (src[i] & 0xFF000000) | ((i % 2) ? 0xFFFFFF : 0x000000);
+        dst[i] = (dst[i] & 0xFF000000) | ((i % 3) ? 0x000000 : 0xFFFFFF);
+    }
+
+    const uint32_t alphas[] = { 0, 1, 2, 64, 127, 128, 200, 254, 255 };
+    std::vector<uint32_t> ref(count), res(count);
+    for (int impl = 0; impl < kNumRowBlendImpls; ++impl)
+    {
+        for (int op = 0; op < kNumRowBlendOps; ++op)
+        {
+            PfnRowBlend row_blend = GetRowBlender(static_cast<RowBlendOp>(op), static_cast<RowBlendImpl>(impl));
+            if (!row_blend)
+                continue; // not supported on this system
+            for (uint32_t alpha : alphas)
+            {
+                ref = dst;
+                RefBlendRow(RefBlenders[op], ref.data(), src.data(), count, alpha);
+                // Whole row, compared per pixel for the better failure report
+                res = dst;
+                row_blend(res.data(), src.data(), 0, alpha); // no-op
+                row_blend(res.data(), src.data(), count, alpha);
+                for (size_t i = 0; i < count; ++i)
+                {
+                    ASSERT_EQ(res[i], ref[i]) << "impl " << GetRowBlendImplName(static_cast<RowBlendImpl>(impl))
+                        << ", op " << op << ", alpha " << alpha << ", src 0x" << std::hex << src[i] << ", dst 0x" << dst[i];
+                }
+
+                // Short rows of varied length, to test the remaining pixels handling
+                res = dst;
+                for (size_t off = 0, len = 0; off < count; off += len, len = (len + 1) % 19)
+                    row_blend(res.data() + off, src.data() + off, std::min(len, count - off), alpha);
+                ASSERT_EQ(res, ref) << "impl " << GetRowBlendImplName(static_cast<RowBlendImpl>(impl))
+                    << ", op " << op << ", alpha " << alpha << " (short rows)";
+            }
+        }
+    }
+}
@@ -0,0 +1,144 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2026 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include <chrono>
+#include <memory>
+#include "gtest/gtest.h"
+#include "script/cc_common.h"
+#include "script/cc_instance.h"
+#include "script/cc_internal.h"
+
+// Makes a script with a single exported function "Loop", which sums
+// the numbers from 0 to (count - 1) in a loop, and returns the result
+static PScript MakeLoopScript(int32_t count, int32_t loop_jump = -19)
+{
+    PScript scri = std::make_shared<ccScript>("LoopScript");
+    scri->code = {
+        /*  0 */ SCMD_LOOPCHECKOFF,
+        /*  1 */ SCMD_LITTOREG, SREG_CX, 0,
+        /*  4 */ SCMD_LITTOREG, SREG_DX, 0,
+        /*  7 */ SCMD_ADDREG, SREG_CX, SREG_DX,
+        /* 10 */ SCMD_ADD, SREG_DX, 1,
+        /* 13 */ SCMD_LITTOREG, SREG_BX, count,
+        /* 16 */ SCMD_REGTOREG, SREG_DX, SREG_AX,
+        /* 19 */ SCMD_LESSTHAN, SREG_AX, SREG_BX,
+        /* 22 */ SCMD_JZ, 2,
+        /* 24 */ SCMD_JMP, loop_jump,
+        /* 26 */ SCMD_REGTOREG, SREG_CX, SREG_AX,
+        /* 29 */ SCMD_RET
+    };
+    scri->exports = { "Loop$0" };
+    scri->export_addr = { (EXPORT_FUNCTION << 24) | 0 };
+    return scri;
+}
+
+// Makes a script with the function "Loop", compiled from:
+//
+// int Loop(int count)
+// {
+//   int sum = 0;
+//   int i = 0;
+//   while (i < count)
+//   {
+//     if (i % 3 == 0)
+//       sum += i;
+//     else
+//       sum -= 1;
+//     i++;
+//   }
+//   return sum;
+// }
+static PScript MakeCompiledLoopScript()
+{
+    PScript scri = std::make_shared<ccScript>("CompiledLoopScript");
+    scri->code = {
+        38, 0, 6, 3, 0, 3, 1, 2,
+        8, 3, 1, 1, 4, 6, 3, 0,
+        3, 1, 2, 8, 3, 1, 1, 4,
+        51, 4, 7, 3, 29, 3, 51, 20,
+        7, 3, 30, 4, 18, 4, 3, 3,
+        4, 3, 28, 82, 51, 4, 7, 3,
+        29, 3, 6, 3, 3, 30, 4, 40,
+        4, 3, 3, 4, 3, 29, 3, 6,
+        3, 0, 30, 4, 15, 4, 3, 3,
+        4, 3, 28, 21, 51, 4, 7, 3,
+        29, 3, 51, 12, 7, 3, 30, 4,
+        11, 3, 4, 51, 8, 8, 3, 31,
+        18, 6, 3, 1, 29, 3, 51, 12,
+        7, 3, 30, 4, 12, 3, 4, 51,
+        8, 8, 3, 51, 4, 7, 3, 1,
+        3, 1, 8, 3, 31, -102, 51, 8,
+        7, 3, 2, 1, 8, 5, 6, 3,
+        0, 2, 1, 8, 5
+    };
+    scri->exports = { "Loop$1" };
+    scri->export_addr = { (EXPORT_FUNCTION << 24) | 0 };
+    return scri;
+}
+
+static int32_t CompiledLoopResult(int32_t count)
+{
+    int32_t sum = 0;
+    for (int32_t i = 0; i < count; ++i)
+        sum += (i % 3 == 0) ? i : -1;
+    return sum;
+}
+
+TEST(ScriptInstance, Run) {
+    auto inst = ccInstance::CreateFromScript(MakeLoopScript(100));
+    ASSERT_NE(inst, nullptr);
+    ASSERT_EQ(inst->CallScriptFunction("Loop", 0, nullptr), kInstErr_None);
+    ASSERT_EQ(inst->GetReturnValue(), 100 * 99 / 2);
+
+    inst = ccInstance::CreateFromScript(MakeCompiledLoopScript());
+    ASSERT_NE(inst, nullptr);
+    RuntimeScriptValue params[] = { RuntimeScriptValue().SetInt32(100) };
+    ASSERT_EQ(inst->CallScriptFunction("Loop", 1, params), kInstErr_None);
+    ASSERT_EQ(inst->GetReturnValue(), CompiledLoopResult(100));
+}
+
+TEST(ScriptInstance, InvalidJump) {
+    // Jumps past the code end, before the code start, and into
+    // the middle of an instruction fail when executed
+    for (int32_t loop_jump : { 10, -30, -18 })
+    {
+        auto inst = ccInstance::CreateFromScript(MakeLoopScript(100, loop_jump));
+        ASSERT_NE(inst, nullptr);
+        ASSERT_EQ(inst->CallScriptFunction("Loop", 0, nullptr), kInstErr_Generic);
+    }
+    // ...but not if they are never executed
+    auto inst = ccInstance::CreateFromScript(MakeLoopScript(0, 10));
+    ASSERT_NE(inst, nullptr);
+    ASSERT_EQ(inst->CallScriptFunction("Loop", 0, nullptr), kInstErr_None);
+    ASSERT_EQ(inst->GetReturnValue(), 0);
+    cc_clear_error();
+}
+
+TEST(ScriptInstance, DISABLED_Benchmark) {
+    // Runs a compiled script loop, mostly measuring the instruction dispatch
+    const int call_count = 200;
+    const int32_t loop_count = 10000;
+    auto inst = ccInstance::CreateFromScript(MakeCompiledLoopScript());
+    ASSERT_NE(inst, nullptr);
+    RuntimeScriptValue params[] = { RuntimeScriptValue().SetInt32(loop_count) };
+    auto t_start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < call_count; ++i)
+    {
+        ASSERT_EQ(inst->CallScriptFunction("Loop", 1, params), kInstErr_None);
+    }
+    auto t_end = std::chrono::high_resolution_clock::now();
+    ASSERT_EQ(inst->GetReturnValue(), CompiledLoopResult(loop_count));
+    printf("%lld loop iterations in %lld ms\n",
+        static_cast<long long>(call_count) * loop_count,
+        static_cast<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(t_end - t_start).count()));
+}
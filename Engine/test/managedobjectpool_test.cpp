@@ -0,0 +1,214 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2026 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include <algorithm>
+#include <algorithm>
+#include <vector>
+#include "gtest/gtest.h"
+#include "ac/dynobj/cc_agsdynamicobject.h"
+#include "ac/dynobj/managedobjectpool.h"
+
+namespace
+{
+
+// Test object manager, counts disposed objects, and may refuse disposal
+struct TestObjectManager final : CCBasicObject
+{
+    const char *GetType() override { return "TestObject"; }
+    int Dispose(void *address, bool force) override
+    {
+        if (!force && (refuseAll || address == refuseDispose))
+            return 0;
+        disposed++;
+        return 1;
+    }
+
+    void *refuseDispose = nullptr;
+    bool refuseAll = false;
+    int disposed = 0;
+};
+
+// Test manager of objects which keep their handle in a header
+struct TestHeaderObjectManager final : CCBasicObject
+{
+    // Object's memory, the header is followed by the object data
+    struct Object
+    {
+        int32_t Handle = 0;
+        int32_t Data = 0;
+    };
+
+    const char *GetType() override { return "TestHeaderObject"; }
+    int Dispose(void* /*address*/, bool /*force*/) override { return 1; }
+    int32_t *GetHandlePtr(void *address) override
+    {
+        return static_cast<int32_t*>(address) - 1;
+    }
+};
+
+} // namespace
+
+TEST(ManagedObjectPool, GarbageCollection) {
+    ManagedObjectPool objpool;
+    TestObjectManager mgr;
+    std::vector<char> data(4000);
+    std::vector<int32_t> handles;
+
+    // Every other object is referenced, and must survive the collection
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        handles.push_back(objpool.AddObject(&data[i], &mgr, kScValScriptObject));
+        if (i % 2 == 0)
+            objpool.AddRef(handles.back());
+    }
+    ASSERT_EQ(objpool.GetObjectCount(), data.size());
+    objpool.RunGarbageCollectionIfAppropriate();
+    ASSERT_EQ(objpool.GetObjectCount(), data.size() / 2);
+    ASSERT_EQ(mgr.disposed, static_cast<int>(data.size() / 2));
+    ASSERT_EQ(objpool.GetStats().RemovedGC, data.size() / 2);
+    for (size_t i = 0; i < data.size(); ++i)
+        ASSERT_EQ(objpool.HandleToAddress(handles[i]), (i % 2 == 0) ? &data[i] : nullptr);
+
+    // Object which lost its last reference while its disposal was disabled
+    // is collected later
+    objpool.disableDisposeForObject = &data[0];
+    ASSERT_EQ(objpool.SubRef(handles[0]), 0);
+    objpool.disableDisposeForObject = nullptr;
+    ASSERT_EQ(objpool.HandleToAddress(handles[0]), &data[0]);
+    // Object which refused disposal is checked again in the next pass
+    mgr.refuseDispose = &data[2];
+    ASSERT_EQ(objpool.SubRef(handles[2]), 0);
+    ASSERT_EQ(objpool.HandleToAddress(handles[2]), &data[2]);
+
+    mgr.disposed = 0;
+    // Create enough new garbage to trigger the next collection
+    std::vector<char> temp_data(1100);
+    for (auto &t : temp_data)
+        objpool.AddObject(&t, &mgr, kScValScriptObject);
+    objpool.RunGarbageCollectionIfAppropriate();
+    ASSERT_EQ(objpool.HandleToAddress(handles[0]), nullptr);
+    ASSERT_EQ(objpool.HandleToAddress(handles[2]), &data[2]);
+    ASSERT_EQ(mgr.disposed, static_cast<int>(temp_data.size() + 1));
+    mgr.refuseDispose = nullptr;
+    for (auto &t : temp_data)
+        objpool.AddObject(&t, &mgr, kScValScriptObject);
+    objpool.RunGarbageCollectionIfAppropriate();
+    ASSERT_EQ(objpool.HandleToAddress(handles[2]), nullptr);
+    ASSERT_EQ(objpool.GetObjectCount(), data.size() / 2 - 2);
+
+    // Referenced object gets collected after it lost all references
+    objpool.disableDisposeForObject = &data[4];
+    objpool.SubRef(handles[4]);
+    objpool.disableDisposeForObject = nullptr;
+    objpool.AddRef(handles[4]);
+    for (auto &t : temp_data)
+        objpool.AddObject(&t, &mgr, kScValScriptObject);
+    objpool.RunGarbageCollectionIfAppropriate();
+    ASSERT_EQ(objpool.HandleToAddress(handles[4]), &data[4]);
+    ASSERT_EQ(objpool.GetStats().GCPassesDone, 4u);
+
+    objpool.Reset();
+    ASSERT_EQ(objpool.GetObjectCount(), 0u);
+}
+
+TEST(ManagedObjectPool, GarbageCollectionTrigger) {
+    ManagedObjectPool objpool;
+    TestObjectManager mgr;
+    std::vector<char> data(2000);
+    std::vector<int32_t> handles;
+    for (auto &d : data)
+    {
+        handles.push_back(objpool.AddObject(&d, &mgr, kScValScriptObject));
+        objpool.AddRef(handles.back());
+    }
+    objpool.RunGarbageCollectionIfAppropriate();
+    ASSERT_EQ(objpool.GetStats().GCTimesRun, 1u);
+    ASSERT_EQ(objpool.GetObjectCount(), data.size());
+
+    // Objects which lost their references but refused disposal trigger
+    // the collection same as the new objects do
+    mgr.refuseAll = true;
+    for (auto h : handles)
+        ASSERT_EQ(objpool.SubRef(h), 0);
+    mgr.refuseAll = false;
+    ASSERT_EQ(objpool.GetObjectCount(), data.size());
+    objpool.RunGarbageCollectionIfAppropriate();
+    ASSERT_EQ(objpool.GetStats().GCTimesRun, 2u);
+    ASSERT_EQ(objpool.GetObjectCount(), 0u);
+    // Nothing new to collect
+    objpool.RunGarbageCollectionIfAppropriate();
+    ASSERT_EQ(objpool.GetStats().GCTimesRun, 2u);
+}
+
+TEST(ManagedObjectPool, ReuseHandles) {
+    ManagedObjectPool objpool;
+    TestObjectManager mgr;
+    std::vector<char> data(100);
+
+    // Handles of the removed objects are given to the new ones,
+    // so the pool does not grow past the number of objects alive
+    for (int pass = 0; pass < 3; ++pass)
+    {
+        std::vector<int32_t> handles;
+        for (auto &d : data)
+        {
+            handles.push_back(objpool.AddObject(&d, &mgr, kScValScriptObject));
+            objpool.AddRef(handles.back());
+        }
+        std::sort(handles.begin(), handles.end());
+        ASSERT_LE(handles.back(), static_cast<int32_t>(data.size()));
+        for (auto h : handles)
+            ASSERT_EQ(objpool.SubRef(h), 0);
+        ASSERT_EQ(objpool.GetObjectCount(), 0u);
+    }
+    ASSERT_EQ(mgr.disposed, static_cast<int>(data.size() * 3));
+    objpool.Reset();
+}
+
+TEST(ManagedObjectPool, AddressToHandle) {
+    ManagedObjectPool objpool;
+    TestObjectManager mgr;
+    TestHeaderObjectManager hdr_mgr;
+    std::vector<char> data(10);
+    std::vector<TestHeaderObjectManager::Object> hdr_data(10);
+
+    std::vector<int32_t> handles, hdr_handles;
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        handles.push_back(objpool.AddObject(&data[i], &mgr, kScValScriptObject));
+        hdr_handles.push_back(objpool.AddObject(&hdr_data[i].Data, &hdr_mgr, kScValScriptObject));
+        // The pool writes the handle into the object's header
+        ASSERT_EQ(hdr_data[i].Handle, hdr_handles[i]);
+    }
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        ASSERT_EQ(objpool.AddressToHandle(&data[i]), handles[i]);
+        ASSERT_EQ(objpool.AddressToHandle(&data[i], &mgr), handles[i]);
+        ASSERT_EQ(objpool.AddressToHandle(&hdr_data[i].Data, &hdr_mgr), hdr_handles[i]);
+    }
+    // Objects with header may be found without a manager too,
+    // as plugins pass only their addresses
+    ASSERT_EQ(objpool.AddressToHandle(&hdr_data[3].Data), hdr_handles[3]);
+    ASSERT_EQ(objpool.AddressToHandle(&hdr_data[0].Handle), 0);
+
+    // Removed objects are not found anymore, even if their header still has a handle
+    ASSERT_EQ(objpool.RemoveObject(&data[1]), 1);
+    ASSERT_EQ(objpool.RemoveObject(&hdr_data[1].Data), 1);
+    ASSERT_EQ(objpool.RemoveObject(&hdr_data[3].Data), 1);
+    ASSERT_EQ(objpool.AddressToHandle(&data[1]), 0);
+    ASSERT_EQ(objpool.AddressToHandle(&hdr_data[1].Data, &hdr_mgr), 0);
+    ASSERT_EQ(objpool.AddressToHandle(&hdr_data[3].Data), 0);
+    // Header with a handle of another object is not trusted
+    hdr_data[5].Handle = hdr_handles[6];
+    ASSERT_EQ(objpool.AddressToHandle(&hdr_data[5].Data, &hdr_mgr), hdr_handles[5]);
+}
@@ -0,0 +1,193 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2026 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include <algorithm>
+#include <vector>
+#include <allegro.h>
+#include "gtest/gtest.h"
+#include "gfx/pixel_convert.h"
+
+using namespace AGS::Engine;
+
+static const uint32_t MaskColor16 = 0xF81F;
+static const uint32_t MaskColor32 = 0x00FF00FF;
+
+// Video memory formats used by the renderers: OpenGL's RGBA and Direct3D's ARGB
+static const PixelFormat DstFormats[] = { PixelFormat(0, 8, 16, 24), PixelFormat(16, 8, 0, 24) };
+static const PixelConvertMode Modes[] = { kPxConvert_MaskToAlpha, kPxConvert_CopyAlpha, kPxConvert_Opaque };
+
+static uint32_t NextRandom(uint32_t &seed)
+{
+    seed = seed * 1103515245u + 12345u;
+    return (seed >> 16) | (seed << 16);
+}
+
+static uint32_t MakeVMemColor(const PixelFormat &fmt, int r, int g, int b, int a)
+{
+    return ((r & 0xFF) << fmt.RShift) | ((g & 0xFF) << fmt.GShift) |
+        ((b & 0xFF) << fmt.BShift) | ((a & 0xFF) << fmt.AShift);
+}
+
+// Converts a pixel same way as the per-pixel templates in gfxdriverbase do
+static uint32_t RefConvert(int depth, uint32_t c, const PixelFormat &dst, PixelConvertMode mode)
+{
+    switch (depth)
+    {
+    case 15:
+        if ((mode == kPxConvert_MaskToAlpha) && (c == MASK_COLOR_15))
+            return 0;
+        return MakeVMemColor(dst, getr15(c), getg15(c), getb15(c), 0xFF);
+    case 16:
+        if ((mode == kPxConvert_MaskToAlpha) && (c == MaskColor16))
+            return 0;
+        return MakeVMemColor(dst, getr16(c), getg16(c), getb16(c), 0xFF);
+    case 32:
+        if ((mode == kPxConvert_MaskToAlpha) && (c == MaskColor32))
+            return 0;
+        return MakeVMemColor(dst, getr32(c), getg32(c), getb32(c),
+            (mode == kPxConvert_CopyAlpha) ? geta32(c) : 0xFF);
+    default:
+        return 0;
+    }
+}
+
+static PixelConvertParams MakeParams(int depth, const PixelFormat &dst, PixelConvertMode mode)
+{
+    PixelConvertParams params;
+    params.Dst = dst;
+    params.Mode = mode;
+    switch (depth)
+    {
+    case 15:
+        params.Src = PixelFormat(_rgb_r_shift_15, _rgb_g_shift_15, _rgb_b_shift_15);
+        params.GreenBits = 5;
+        params.MaskColor = MASK_COLOR_15;
+        break;
+    case 16:
+        params.Src = PixelFormat(_rgb_r_shift_16, _rgb_g_shift_16, _rgb_b_shift_16);
+        params.GreenBits = 6;
+        params.MaskColor = MaskColor16;
+        break;
+    case 32:
+        params.Src = PixelFormat(_rgb_r_shift_32, _rgb_g_shift_32, _rgb_b_shift_32, _rgb_a_shift_32);
+        params.MaskColor = MaskColor32;
+        break;
+    }
+    return params;
+}
+
+// Tests converting the row as a whole, and as short rows of varied length
+template <typename T>
+static void TestConvertRows(int depth, const std::vector<T> &src)
+{
+    const size_t count = src.size();
+    std::vector<uint32_t> ref(count), res(count);
+    for (int impl = 0; impl < kNumPxConvertImpls; ++impl)
+    {
+        PfnConvertRow convert_row = GetRowConverter(depth, static_cast<PixelConvertImpl>(impl));
+        if (!convert_row)
+            continue; // not supported on this system
+        const char *impl_name = GetPixelConvertImplName(static_cast<PixelConvertImpl>(impl));
+        for (const auto &dst_fmt : DstFormats)
+        {
+            for (const auto mode : Modes)
+            {
+                if ((mode == kPxConvert_CopyAlpha) && (depth != 32))
+                    continue;
+                const PixelConvertParams params = MakeParams(depth, dst_fmt, mode);
+                for (size_t i = 0; i < count; ++i)
+                    ref[i] = RefConvert(depth, src[i], dst_fmt, mode);
+
+                std::fill(res.begin(), res.end(), 0xDEADBEEF);
+                convert_row(res.data(), src.data(), 0, params); // no-op
+                convert_row(res.data(), src.data(), count, params);
+                for (size_t i = 0; i < count; ++i)
+                {
+                    ASSERT_EQ(res[i], ref[i]) << "impl " << impl_name << ", depth " << depth
+                        << ", mode " << mode << ", dst r shift " << dst_fmt.RShift
+                        << ", src 0x" << std::hex << static_cast<uint32_t>(src[i]);
+                }
+
+                std::fill(res.begin(), res.end(), 0xDEADBEEF);
+                for (size_t off = 0, len = 0; off < count; off += len, len = (len + 1) % 19)
+                    convert_row(res.data() + off, src.data() + off, std::min(len, count - off), params);
+                ASSERT_EQ(res, ref) << "impl " << impl_name << ", depth " << depth
+                    << ", mode " << mode << " (short rows)";
+            }
+        }
+    }
+}
+
+TEST(PixelConvert, Convert8) {
+    // Random palette, with 6-bit components as Allegro has them
+    PALETTE pal;
+    uint32_t seed = 1;
+    for (int i = 0; i < 256; ++i)
+    {
+        pal[i].r = NextRandom(seed) % 64;
+        pal[i].g = NextRandom(seed) % 64;
+        pal[i].b = NextRandom(seed) % 64;
+    }
+    select_palette(pal);
+    for (const auto &dst_fmt : DstFormats)
+    {
+        uint32_t lut[256];
+        for (int i = 0; i < 256; ++i)
+            lut[i] = (i == MASK_COLOR_8) ? 0 : MakeVMemColor(dst_fmt, getr8(i), getg8(i), getb8(i), 0xFF);
+        PixelConvertParams params;
+        params.Dst = dst_fmt;
+        params.Palette = lut;
+        std::vector<uint8_t> src(1000);
+        for (auto &px : src)
+            px = static_cast<uint8_t>(NextRandom(seed));
+        for (int impl = 0; impl < kNumPxConvertImpls; ++impl)
+        {
+            PfnConvertRow convert_row = GetRowConverter(8, static_cast<PixelConvertImpl>(impl));
+            if (!convert_row)
+                continue;
+            std::vector<uint32_t> res(src.size());
+            convert_row(res.data(), src.data(), src.size(), params);
+            for (size_t i = 0; i < src.size(); ++i)
+                ASSERT_EQ(res[i], lut[src[i]]);
+        }
+    }
+    unselect_palette();
+}
+
+TEST(PixelConvert, Convert16) {
+    // Every 16-bit color
+    std::vector<uint16_t> src(0x10000);
+    for (size_t i = 0; i < src.size(); ++i)
+        src[i] = static_cast<uint16_t>(i);
+    TestConvertRows<uint16_t>(16, src);
+    // Same with 555 layout
+    for (size_t i = 0; i < src.size(); ++i)
+        src[i] = static_cast<uint16_t>(i & 0x7FFF);
+    TestConvertRows<uint16_t>(15, src);
+}
+
+TEST(PixelConvert, Convert32) {
+    // Random colors, with every alpha, extreme colors and some mask color pixels
+    const size_t count = 256 * 64;
+    std::vector<uint32_t> src(count);
+    uint32_t seed = 1;
+    for (size_t i = 0; i < count; ++i)
+    {
+        src[i] = (static_cast<uint32_t>(i & 0xFF) << 24) | (NextRandom(seed) & 0xFFFFFF);
+        if (i % 7 == 0)
+            src[i] = (src[i] & 0xFF000000) | ((i % 2) ? 0xFFFFFF : 0x000000);
+        if (NextRandom(seed) % 16 == 0)
+            src[i] = MaskColor32;
+    }
+    TestConvertRows<uint32_t>(32, src);
+}
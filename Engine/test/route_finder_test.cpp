@@ -0,0 +1,303 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2026 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include "gtest/gtest.h"
+#include "ac/route_finder_impl.h"
+#include "gfx/bitmap.h"
+
+using namespace AGS::Common;
+using namespace AGS::Engine;
+
+namespace
+{
+
+uint32_t NextRandom(uint32_t &seed)
+{
+    seed = seed * 1103515245u + 12345u;
+    return (seed >> 16) | (seed << 16);
+}
+
+void FillMaskRect(Bitmap *mask, int x0, int y0, int x1, int y1, int area)
+{
+    x0 = std::max(0, x0); y0 = std::max(0, y0);
+    x1 = std::min(mask->GetWidth() - 1, x1); y1 = std::min(mask->GetHeight() - 1, y1);
+    for (int y = y0; y <= y1; ++y)
+        memset(mask->GetScanLineForWriting(y) + x0, area, std::max(0, x1 - x0 + 1));
+}
+
+void FillMaskCircle(Bitmap *mask, int cx, int cy, int r, int area)
+{
+    for (int y = std::max(0, cy - r); y <= std::min(mask->GetHeight() - 1, cy + r); ++y)
+    {
+        uint8_t *row = mask->GetScanLineForWriting(y);
+        for (int x = std::max(0, cx - r); x <= std::min(mask->GetWidth() - 1, cx + r); ++x)
+            if ((x - cx) * (x - cx) + (y - cy) * (y - cy) <= r * r)
+                row[x] = static_cast<uint8_t>(area);
+    }
+}
+
+// Makes a mask that looks like a room's walkable areas: a floor with uneven
+// borders divided into several areas, with furniture-like obstacles,
+// and a few separate walkable islands
+std::unique_ptr<Bitmap> MakeRoomMask(int width, int height, uint32_t seed)
+{
+    std::unique_ptr<Bitmap> mask(BitmapHelper::CreateBitmap(width, height, 8));
+    mask->Clear(0);
+    const int floor_top = height / 3;
+    for (int y = floor_top; y < height - 2; ++y)
+    {
+        const int margin = (height - y) / 3 + NextRandom(seed) % 3;
+        for (int x = margin; x < width - margin; ++x)
+            mask->GetScanLineForWriting(y)[x] = static_cast<uint8_t>(1 + x * 4 / width);
+    }
+    const int obstacles = 10 + NextRandom(seed) % 20;
+    for (int i = 0; i < obstacles; ++i)
+    {
+        const int x = NextRandom(seed) % width, y = floor_top + NextRandom(seed) % (height - floor_top);
+        const int size = 2 + NextRandom(seed) % (width / 12);
+        if (NextRandom(seed) % 2)
+            FillMaskCircle(mask.get(), x, y, size / 2, 0);
+        else
+            FillMaskRect(mask.get(), x, y, x + size, y + size / 3, 0);
+    }
+    for (int i = 0; i < 3; ++i)
+    {
+        const int x = NextRandom(seed) % width, y = NextRandom(seed) % floor_top;
+        FillMaskCircle(mask.get(), x, y, 2 + NextRandom(seed) % 10, 5);
+    }
+    return mask;
+}
+
+// Copies the room mask and cuts out the blocking areas of the characters
+void PrepareMask(Bitmap *dst, const Bitmap *room_mask, const std::vector<Point> &chars, int block_w, int block_h)
+{
+    dst->Blit(room_mask, 0, 0, 0, 0, room_mask->GetWidth(), room_mask->GetHeight());
+    for (const auto &pt : chars)
+        FillMaskRect(dst, pt.X - block_w / 2, pt.Y - block_h / 2, pt.X + block_w / 2, pt.Y + block_h / 2, 0);
+}
+
+Point RandomWalkablePoint(const Bitmap *mask, uint32_t &seed)
+{
+    for (;;)
+    {
+        Point pt(NextRandom(seed) % mask->GetWidth(), NextRandom(seed) % mask->GetHeight());
+        if (mask->GetPixel(pt.X, pt.Y) > 0)
+            return pt;
+    }
+}
+
+struct RouteQuery
+{
+    Point From, To;
+};
+
+} // namespace
+
+// Tests that the navigation cache finds exactly same routes as the plain search,
+// while the mask changes as the characters move around
+TEST(RouteFinder, NavigationCache) {
+    const int sizes[][2] = { { 160, 100 }, { 320, 180 }, { 97, 61 } };
+    uint32_t seed = 7;
+    for (const auto &size : sizes)
+    {
+        std::unique_ptr<Bitmap> room_mask = MakeRoomMask(size[0], size[1], seed);
+        std::unique_ptr<Bitmap> mask(BitmapHelper::CreateBitmap(size[0], size[1], 8));
+        JPSRouteFinder ref_finder, finder;
+        ref_finder.EnableNavigationCache(false);
+        std::vector<Point> chars(6);
+        for (auto &pt : chars)
+            pt = RandomWalkablePoint(room_mask.get(), seed);
+
+        size_t found = 0u;
+        std::vector<Point> ref_path, path;
+        for (int i = 0; i < 100; ++i)
+        {
+            // Move one of the characters now and then, and sometimes repeat last query
+            if (NextRandom(seed) % 3 == 0)
+                chars[NextRandom(seed) % chars.size()] = RandomWalkablePoint(room_mask.get(), seed);
+            PrepareMask(mask.get(), room_mask.get(), chars, size[0] / 40, size[1] / 60);
+            ref_finder.SetWalkableArea(mask.get());
+            finder.SetWalkableArea(mask.get());
+
+            const Point from = RandomWalkablePoint(mask.get(), seed);
+            const Point to(NextRandom(seed) % size[0], NextRandom(seed) % size[1]);
+            const bool exact = NextRandom(seed) % 4 == 0;
+            const bool ref_res = ref_finder.FindRoute(ref_path, from.X, from.Y, to.X, to.Y, exact);
+            const bool res = finder.FindRoute(path, from.X, from.Y, to.X, to.Y, exact);
+            ASSERT_EQ(res, ref_res) << "query " << i;
+            if (ref_res)
+            {
+                ASSERT_EQ(path, ref_path) << "query " << i;
+            }
+            found += ref_res;
+            // Same query again must give same result from the cache
+            ASSERT_EQ(finder.FindRoute(path, from.X, from.Y, to.X, to.Y, exact), ref_res);
+            if (ref_res)
+            {
+                ASSERT_EQ(path, ref_path) << "query " << i << " (repeated)";
+            }
+        }
+        ASSERT_GT(found, 20u);
+    }
+}
+
+// Toggles walkability of all the pixels of the given area index,
+// returns the changed part of the mask
+static Rect ToggleMaskArea(Bitmap *mask, const Bitmap *orig_mask, int area, bool on)
+{
+    int x0 = INT32_MAX, y0 = INT32_MAX, x1 = -1, y1 = -1;
+    for (int y = 0; y < mask->GetHeight(); ++y)
+    {
+        const uint8_t *orig_line = orig_mask->GetScanLine(y);
+        uint8_t *line = mask->GetScanLineForWriting(y);
+        for (int x = 0; x < mask->GetWidth(); ++x)
+        {
+            if (orig_line[x] != area)
+                continue;
+            line[x] = on ? orig_line[x] : 0;
+            x0 = std::min(x0, x); x1 = std::max(x1, x);
+            y0 = std::min(y0, y); y1 = y;
+        }
+    }
+    return Rect(x0, y0, x1, y1);
+}
+
+// Tests that the distance field finds exactly same nearest walkable points as the scan
+TEST(RouteFinder, NearestWalkablePoint) {
+    const int sizes[][2] = { { 320, 200 }, { 97, 61 } };
+    uint32_t seed = 13;
+    for (const auto &size : sizes)
+    {
+        std::unique_ptr<Bitmap> room_mask = MakeRoomMask(size[0], size[1], seed);
+        std::unique_ptr<Bitmap> mask(BitmapHelper::CreateBitmapCopy(room_mask.get()));
+        MaskDistanceField field;
+        field.SetMask(mask.get());
+
+        // Check the distances against the brute force search
+        for (int i = 0; i < 200; ++i)
+        {
+            const Point pt(NextRandom(seed) % size[0], NextRandom(seed) % size[1]);
+            uint32_t nearest = UINT32_MAX;
+            for (int y = 0; y < size[1]; ++y)
+                for (int x = 0; x < size[0]; ++x)
+                    if (mask->GetPixel(x, y) > 0)
+                        nearest = std::min<uint32_t>(nearest, (x - pt.X) * (x - pt.X) + (y - pt.Y) * (y - pt.Y));
+            ASSERT_EQ(field.GetSqDistance(pt.X, pt.Y), nearest) << "point " << pt.X << "," << pt.Y;
+        }
+
+        for (int i = 0; i < 2000; ++i)
+        {
+            // Toggle walkable areas now and then
+            if (i % 50 == 0)
+            {
+                const int area = 1 + NextRandom(seed) % 5;
+                field.Invalidate(ToggleMaskArea(mask.get(), room_mask.get(), area, NextRandom(seed) % 2 == 0));
+                // Sometimes update the distances right away, otherwise they are
+                // updated after a number of searches
+                if (NextRandom(seed) % 2 == 0)
+                    field.GetSqDistance(0, 0);
+            }
+
+            const Point from(NextRandom(seed) % (size[0] + 20) - 10, NextRandom(seed) % (size[1] + 20) - 10);
+            Rect limits = RectWH(mask->GetSize());
+            if (NextRandom(seed) % 3 == 0)
+            {
+                limits.Left = NextRandom(seed) % (size[0] / 2);
+                limits.Top = NextRandom(seed) % (size[1] / 2);
+                limits.Right = size[0] / 2 + NextRandom(seed) % (size[0] / 2);
+                limits.Bottom = size[1] / 2 + NextRandom(seed) % (size[1] / 2);
+            }
+            const int range = (NextRandom(seed) % 4 == 0) ? NextRandom(seed) % 40 : 0;
+            const int step = (NextRandom(seed) % 8 == 0) ? 2 : 1;
+            Point ref_pt(-1, -1), pt(-1, -1);
+            const bool ref_res = Pathfinding::FindNearestWalkablePoint(mask.get(), from, ref_pt, limits, range, step);
+            const bool res = field.FindNearestWalkablePoint(from, pt, limits, range, step);
+            ASSERT_EQ(res, ref_res) << "query " << i;
+            ASSERT_EQ(pt, ref_pt) << "query " << i;
+        }
+
+        // No walkable pixels at all
+        mask->Clear(0);
+        field.Invalidate();
+        Point pt;
+        ASSERT_EQ(field.GetSqDistance(0, 0), UINT32_MAX);
+        ASSERT_FALSE(field.FindNearestWalkablePoint(Point(size[0] / 2, size[1] / 2), pt, RectWH(mask->GetSize())));
+    }
+}
+
+// Measures the nearest walkable point search on a large mask, with and without
+// the distance field, the way the engine uses it: the field is only calculated
+// by the searches, and walkable areas are toggled now and then.
+TEST(RouteFinder, DISABLED_NearestWalkablePointBenchmark) {
+    using namespace std::chrono;
+    const int width = 3840, height = 2160;
+    const int queries_per_toggle = 100;
+    uint32_t seed = 17;
+    std::unique_ptr<Bitmap> room_mask = MakeRoomMask(width, height, seed);
+    // Characters pushed off the walkable areas, both close to the edge and far from it
+    std::vector<Point> queries;
+    for (int i = 0; i < 2000; ++i)
+    {
+        Point pt(NextRandom(seed) % width, NextRandom(seed) % height);
+        if (room_mask->GetPixel(pt.X, pt.Y) == 0)
+            queries.push_back(pt);
+    }
+    const Rect limits = RectWH(room_mask->GetSize());
+
+    // Runs the queries, toggling an area after each batch, returns the time
+    // spent in the search and in reporting the changes
+    const auto run = [&](MaskDistanceField *field, std::vector<Point> &results)
+    {
+        std::unique_ptr<Bitmap> mask(BitmapHelper::CreateBitmapCopy(room_mask.get()));
+        uint32_t toggle_seed = 19;
+        steady_clock::duration spent(0);
+        auto tp_start = steady_clock::now();
+        if (field)
+            field->SetMask(mask.get());
+        for (size_t i = 0; i < queries.size(); ++i)
+        {
+            if ((i > 0) && (i % queries_per_toggle == 0))
+            {
+                spent += steady_clock::now() - tp_start;
+                const int area = 1 + NextRandom(toggle_seed) % 5;
+                const Rect changed = ToggleMaskArea(mask.get(), room_mask.get(), area, NextRandom(toggle_seed) % 2 == 0);
+                tp_start = steady_clock::now();
+                if (field)
+                    field->Invalidate(changed);
+            }
+            Point pt(-1, -1);
+            if (field)
+                field->FindNearestWalkablePoint(queries[i], pt, limits, 0, 1);
+            else
+                Pathfinding::FindNearestWalkablePoint(mask.get(), queries[i], pt, limits, 0, 1);
+            results.push_back(pt);
+        }
+        spent += steady_clock::now() - tp_start;
+        return duration_cast<duration<double>>(spent).count();
+    };
+
+    std::vector<Point> scan_results, field_results;
+    const double scan_secs = run(nullptr, scan_results);
+    MaskDistanceField field;
+    const double field_secs = run(&field, field_results);
+    ASSERT_EQ(field_results, scan_results);
+
+    printf("%dx%d, %u queries, area toggle per %d: scan %.2f ms, distance field %.2f ms (x%.1f)\n",
+        width, height, static_cast<unsigned>(queries.size()), queries_per_toggle,
+        scan_secs * 1000.0, field_secs * 1000.0, scan_secs / field_secs);
+}
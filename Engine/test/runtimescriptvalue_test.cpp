@@ -0,0 +1,38 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2026 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include <vector>
+#include "gtest/gtest.h"
+#include "script/runtimescriptvalue.h"
+
+TEST(RuntimeScriptValue, StackPtr) {
+    std::vector<uint8_t> data(8);
+    RuntimeScriptValue stack_data, int_value;
+    stack_data.SetData(data.data(), static_cast<int>(data.size()));
+    int_value.SetInt32(0);
+
+    // Values referenced by the stack pointer are read and written
+    // either in the data buffer, or in the value itself
+    RuntimeScriptValue ptr;
+    ptr.SetStackPtr(&stack_data);
+    ptr.IValue = 4;
+    ptr.WriteInt32(0x12345678);
+    ASSERT_EQ(ptr.ReadInt32(), 0x12345678);
+    ASSERT_EQ(data[4], 0x78);
+    ASSERT_EQ(ptr.Size, 4);
+    ptr.SetStackPtr(&int_value);
+    ptr.WriteInt16(-2);
+    ASSERT_EQ(int_value.IValue, -2);
+    ASSERT_EQ(int_value.Size, 2);
+    ASSERT_EQ(ptr.ReadInt16(), -2);
+}
@@ -0,0 +1,201 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2026 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include <memory>
+#include <vector>
+#include "gtest/gtest.h"
+#include "gfx/gfxdriverbase.h"
+#include "gfx/scene_tracker.h"
+
+using namespace AGS::Common;
+using namespace AGS::Engine;
+
+namespace
+{
+
+struct TestTexture : Texture
+{
+    TestTexture(int width, int height)
+        : Texture(GraphicResolution(width, height, 32), false) {}
+    size_t GetMemSize() const override { return 0u; }
+};
+
+class TestDDB final : public BaseDDB
+{
+public:
+    TestDDB(std::shared_ptr<Texture> txdata) { AttachData(txdata, 0); }
+
+    uint32_t GetRefID() const override { return UINT32_MAX; }
+    bool IsValid() const override { return _data != nullptr; }
+    void AttachData(std::shared_ptr<Texture> txdata, int txflags) override
+    {
+        _data = txdata;
+        _size = _data->Res;
+        _scaledSize = _size;
+        _colDepth = _data->Res.ColorDepth;
+        _txFlags = txflags;
+    }
+    void DetachData() override { _data = nullptr; }
+
+    Texture *GetTexture() const { return _data.get(); }
+
+private:
+    std::shared_ptr<Texture> _data;
+};
+
+// A simple scene: a room batch with a few sprites, and a GUI batch on top
+struct TestScene
+{
+    std::vector<std::unique_ptr<TestDDB>> DDBs;
+    std::vector<SpriteBatchDesc> Batches;
+    std::vector<SpriteDrawListEntry<TestDDB>> Sprites;
+
+    TestScene()
+    {
+        for (int i = 0; i < 4; ++i)
+            DDBs.emplace_back(new TestDDB(std::make_shared<TestTexture>(16 + i, 16)));
+        Batches.push_back(SpriteBatchDesc(UINT32_MAX, RectWH(0, 0, 320, 200), SpriteTransform(0, 0)));
+        Batches.push_back(SpriteBatchDesc(UINT32_MAX, RectWH(0, 0, 320, 200), SpriteTransform(0, 0)));
+        Sprites.emplace_back(DDBs[0].get(), 0, 10, 20);
+        Sprites.emplace_back(DDBs[1].get(), 0, 30, 40);
+        Sprites.emplace_back(DDBs[2].get(), 0, 50, 60);
+        Sprites.emplace_back(DDBs[3].get(), 1, 0, 180);
+    }
+
+    // Records the scene same way as the renderer does
+    bool Track(SceneChangeTracker &tracker) const
+    {
+        tracker.BeginFrame();
+        for (const auto &desc : Batches)
+            tracker.AddBatch(SceneBatchRecord(desc));
+        for (const auto &e : Sprites)
+        {
+            if (e.ddb)
+                tracker.AddSprite(SceneSpriteRecord(e.node, e.x, e.y, e.ddb, e.ddb->GetTexture()));
+            else
+                tracker.AddEvent();
+        }
+        return tracker.EndFrame();
+    }
+};
+
+} // namespace
+
+TEST(SceneTracker, SameSceneUnchanged) {
+    SceneChangeTracker tracker;
+    TestScene scene;
+    ASSERT_TRUE(scene.Track(tracker)); // first frame is always changed
+    ASSERT_FALSE(scene.Track(tracker));
+    ASSERT_FALSE(scene.Track(tracker));
+    tracker.Invalidate();
+    ASSERT_TRUE(scene.Track(tracker));
+    ASSERT_FALSE(scene.Track(tracker));
+}
+
+TEST(SceneTracker, SpriteChanges) {
+    SceneChangeTracker tracker;
+    TestScene scene;
+    scene.Track(tracker);
+
+    scene.Sprites[1].x++; // moved
+    ASSERT_TRUE(scene.Track(tracker));
+    ASSERT_FALSE(scene.Track(tracker));
+    std::swap(scene.Sprites[0], scene.Sprites[1]); // reordered
+    ASSERT_TRUE(scene.Track(tracker));
+    scene.Sprites[2].ddb = scene.DDBs[3].get(); // another sprite
+    ASSERT_TRUE(scene.Track(tracker));
+    scene.Sprites.pop_back(); // removed
+    ASSERT_TRUE(scene.Track(tracker));
+    scene.Sprites.emplace_back(scene.DDBs[3].get(), 1, 0, 180); // added
+    ASSERT_TRUE(scene.Track(tracker));
+    ASSERT_FALSE(scene.Track(tracker));
+}
+
+TEST(SceneTracker, DDBParamChanges) {
+    SceneChangeTracker tracker;
+    TestScene scene;
+    TestDDB *ddb = scene.DDBs[2].get();
+    scene.Track(tracker);
+
+    ddb->SetAlpha(100);
+    ASSERT_TRUE(scene.Track(tracker));
+    ASSERT_FALSE(scene.Track(tracker));
+    ddb->SetStretch(40, 40, false);
+    ASSERT_TRUE(scene.Track(tracker));
+    ddb->SetFlip(kFlip_Horizontal);
+    ASSERT_TRUE(scene.Track(tracker));
+    ddb->SetTint(255, 0, 0, 50);
+    ASSERT_TRUE(scene.Track(tracker));
+    ddb->SetLightLevel(10);
+    ASSERT_TRUE(scene.Track(tracker));
+    ddb->SetHasAlpha(true);
+    ASSERT_TRUE(scene.Track(tracker));
+    ASSERT_FALSE(scene.Track(tracker));
+    // Setting same values is not a change
+    ddb->SetAlpha(100);
+    ddb->SetTint(255, 0, 0, 50);
+    ASSERT_FALSE(scene.Track(tracker));
+}
+
+TEST(SceneTracker, TextureChanges) {
+    SceneChangeTracker tracker;
+    TestScene scene;
+    TestDDB *ddb = scene.DDBs[0].get();
+    scene.Track(tracker);
+
+    ddb->GetTexture()->MarkModified(); // pixels updated
+    ASSERT_TRUE(scene.Track(tracker));
+    ASSERT_FALSE(scene.Track(tracker));
+    // New texture of the same size, attached to the same DDB
+    ddb->AttachData(std::make_shared<TestTexture>(16, 16), 0);
+    ASSERT_TRUE(scene.Track(tracker));
+    ASSERT_FALSE(scene.Track(tracker));
+}
+
+TEST(SceneTracker, BatchChanges) {
+    SceneChangeTracker tracker;
+    TestScene scene;
+    scene.Track(tracker);
+
+    scene.Batches[0].Transform.X = 5; // e.g. camera moved, or screen shake
+    ASSERT_TRUE(scene.Track(tracker));
+    ASSERT_FALSE(scene.Track(tracker));
+    scene.Batches[0].Transform.ScaleX = 2.f;
+    ASSERT_TRUE(scene.Track(tracker));
+    scene.Batches[1].Transform.Color.Alpha = 128;
+    ASSERT_TRUE(scene.Track(tracker));
+    scene.Batches[1].Viewport = RectWH(0, 0, 320, 100);
+    ASSERT_TRUE(scene.Track(tracker));
+    scene.Batches[1].Flip = kFlip_Vertical;
+    ASSERT_TRUE(scene.Track(tracker));
+    ASSERT_FALSE(scene.Track(tracker));
+    scene.Batches.push_back(SpriteBatchDesc(0, RectWH(0, 0, 10, 10), SpriteTransform()));
+    ASSERT_TRUE(scene.Track(tracker));
+    ASSERT_FALSE(scene.Track(tracker));
+}
+
+TEST(SceneTracker, RenderEvents) {
+    SceneChangeTracker tracker;
+    TestScene scene;
+    scene.Track(tracker);
+    ASSERT_FALSE(scene.Track(tracker));
+
+    // Frames with render callbacks are always changed
+    scene.Sprites.emplace_back(nullptr, 1, 0, 0);
+    ASSERT_TRUE(scene.Track(tracker));
+    ASSERT_TRUE(scene.Track(tracker));
+    // ...and so is the first frame after them
+    scene.Sprites.pop_back();
+    ASSERT_TRUE(scene.Track(tracker));
+    ASSERT_FALSE(scene.Track(tracker));
+}
@@ -0,0 +1,136 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2026 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include <memory>
+#include <vector>
+#include "gtest/gtest.h"
+#include "script/script_profiler.h"
+#include "util/memory_compat.h"
+#include "util/memorystream.h"
+#include "util/textstreamwriter.h"
+
+using namespace AGS::Common;
+using namespace AGS::Engine;
+
+// Collects collapsed stacks as lines, with the time values cut off
+static std::vector<String> GetCollapsedPaths(const ScriptProfiler &profiler)
+{
+    std::vector<uint8_t> membuf;
+    {
+        TextStreamWriter writer(std::make_unique<Stream>(
+            std::make_unique<VectorStream>(membuf, kStream_Write)));
+        profiler.WriteCollapsedStacks(writer);
+    }
+    String text(reinterpret_cast<const char*>(membuf.data()), membuf.size());
+    text.Replace("\r", "");
+    std::vector<String> paths;
+    for (const auto &line : text.Split('\n'))
+    {
+        if (line.IsEmpty())
+            continue;
+        const size_t space_at = line.FindCharReverse(' ');
+        paths.push_back(line.Left(space_at));
+    }
+    return paths;
+}
+
+TEST(ScriptProfiler, FunctionIds) {
+    ScriptProfiler profiler;
+    const int owner1 = 0, owner2 = 0;
+    ASSERT_EQ(profiler.GetFunctionId(&owner1, 10), UINT32_MAX);
+    const uint32_t fn1 = profiler.AddFunction(&owner1, 10, "script1:func1");
+    const uint32_t fn2 = profiler.AddFunction(&owner1, 20, "script1:func2");
+    ASSERT_NE(fn1, fn2);
+    ASSERT_EQ(profiler.GetFunctionId(&owner1, 10), fn1);
+    ASSERT_EQ(profiler.GetFunctionId(&owner1, 20), fn2);
+    ASSERT_EQ(profiler.GetFunctionId(&owner2, 10), UINT32_MAX);
+    // Same name under a different key shares the function id
+    ASSERT_EQ(profiler.AddFunction(&owner2, 30, "script1:func1"), fn1);
+    // Removed owner's keys are no longer found
+    profiler.RemoveOwner(&owner1);
+    ASSERT_EQ(profiler.GetFunctionId(&owner1, 10), UINT32_MAX);
+    ASSERT_EQ(profiler.GetFunctionId(&owner2, 30), fn1);
+}
+
+TEST(ScriptProfiler, CallTree) {
+    ScriptProfiler profiler;
+    const uint32_t fn_main = profiler.AddFunction(nullptr, 1, "main");
+    const uint32_t fn_a = profiler.AddFunction(nullptr, 2, "a");
+    const uint32_t fn_b = profiler.AddFunction(nullptr, 3, "b");
+
+    // main -> a -> b (x2); main -> b
+    profiler.Enter(fn_main);
+    profiler.Enter(fn_a);
+    profiler.Enter(fn_b);
+    profiler.Leave();
+    profiler.Enter(fn_b);
+    profiler.Leave();
+    profiler.Leave();
+    profiler.Enter(fn_b);
+    ASSERT_EQ(profiler.GetDepth(), 2u);
+    profiler.Leave();
+    profiler.Leave();
+    ASSERT_EQ(profiler.GetDepth(), 0u);
+
+    const auto paths = GetCollapsedPaths(profiler);
+    ASSERT_EQ(paths.size(), 4u);
+    ASSERT_STREQ(paths[0].GetCStr(), "main");
+    ASSERT_STREQ(paths[1].GetCStr(), "main;a");
+    ASSERT_STREQ(paths[2].GetCStr(), "main;a;b");
+    ASSERT_STREQ(paths[3].GetCStr(), "main;b");
+
+    const auto stats = profiler.GetFunctionStats();
+    ASSERT_EQ(stats.size(), 3u);
+    for (const auto &fn : stats)
+    {
+        if (fn.Name == "main")
+            ASSERT_EQ(fn.Calls, 1u);
+        else if (fn.Name == "a")
+            ASSERT_EQ(fn.Calls, 1u);
+        else if (fn.Name == "b")
+            ASSERT_EQ(fn.Calls, 3u);
+        else
+            FAIL();
+        ASSERT_GE(fn.Inclusive, fn.Exclusive);
+    }
+}
+
+TEST(ScriptProfiler, UnwindAndRecursion) {
+    ScriptProfiler profiler;
+    const uint32_t fn_main = profiler.AddFunction(nullptr, 1, "main");
+    const uint32_t fn_rec = profiler.AddFunction(nullptr, 2, "rec");
+
+    profiler.Enter(fn_main);
+    profiler.Enter(fn_rec);
+    profiler.Enter(fn_rec);
+    profiler.Enter(fn_rec);
+    // Simulate script abort: the functions did not return
+    profiler.UnwindTo(0u);
+    ASSERT_EQ(profiler.GetDepth(), 0u);
+
+    const auto paths = GetCollapsedPaths(profiler);
+    ASSERT_EQ(paths.size(), 4u);
+    ASSERT_STREQ(paths[3].GetCStr(), "main;rec;rec;rec");
+
+    const auto stats = profiler.GetFunctionStats();
+    ASSERT_EQ(stats.size(), 2u);
+    for (const auto &fn : stats)
+    {
+        if (fn.Name == "rec")
+        {
+            ASSERT_EQ(fn.Calls, 3u);
+            // recursive calls' time is counted only once
+            ASSERT_LE(fn.Inclusive, stats[0].Name == "main" ? stats[0].Inclusive : stats[1].Inclusive);
+        }
+    }
+}
@@ -0,0 +1,101 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2026 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include <memory>
+#include "gtest/gtest.h"
+#include "ac/gamesetupstruct.h"
+#include "ac/textcache.h"
+#include "font/fonts.h"
+#include "gfx/bitmap.h"
+
+using namespace AGS::Common;
+
+extern GameSetupStruct game;
+
+TEST(TextCache, Lines) {
+    textcache_clear();
+    game.options[OPT_RIGHTLEFTWRITE] = 0;
+    SplitLines lines;
+    int longest = 0;
+    ASSERT_FALSE(textcache_get_lines("Hello there world", true, 100, 0, -1, lines, longest));
+
+    lines.Add("Hello there");
+    lines.Add("world");
+    textcache_put_lines("Hello there world", true, 100, 0, -1, lines, 60);
+    lines.Reset();
+    ASSERT_TRUE(textcache_get_lines("Hello there world", true, 100, 0, -1, lines, longest));
+    ASSERT_EQ(lines.Count(), 2u);
+    ASSERT_STREQ(lines[0].GetCStr(), "Hello there");
+    ASSERT_STREQ(lines[1].GetCStr(), "world");
+    ASSERT_EQ(longest, 60);
+
+    // Any different parameter is a different layout
+    ASSERT_FALSE(textcache_get_lines("Hello there world", true, 101, 0, -1, lines, longest));
+    ASSERT_FALSE(textcache_get_lines("Hello there world", true, 100, 1, -1, lines, longest));
+    ASSERT_FALSE(textcache_get_lines("Hello there world", false, 100, 0, -1, lines, longest));
+    ASSERT_FALSE(textcache_get_lines("Hello there world", true, 100, 0, 1, lines, longest));
+    ASSERT_FALSE(textcache_get_lines("Hello there", true, 100, 0, -1, lines, longest));
+
+    // Changing the text direction invalidates everything
+    game.options[OPT_RIGHTLEFTWRITE] = 1;
+    ASSERT_FALSE(textcache_get_lines("Hello there world", true, 100, 0, -1, lines, longest));
+    game.options[OPT_RIGHTLEFTWRITE] = 0;
+    ASSERT_FALSE(textcache_get_lines("Hello there world", true, 100, 0, -1, lines, longest));
+
+    uint32_t lines_hits, lines_misses, image_hits, image_misses;
+    size_t image_size;
+    textcache_get_stats(lines_hits, lines_misses, image_hits, image_misses, image_size);
+    ASSERT_GE(lines_hits, 1u);
+    ASSERT_GE(lines_misses, 8u);
+}
+
+TEST(TextCache, Images) {
+    textcache_clear();
+    TextImageParams params;
+    params.Width = 40;
+    params.Height = 20;
+    params.WrapWidth = 34;
+    params.TextColor = 15;
+    ASSERT_EQ(textcache_get_image("Hi", params), nullptr);
+
+    std::unique_ptr<Bitmap> image(BitmapHelper::CreateBitmap(40, 20, 8));
+    image->Clear(0);
+    image->PutPixel(5, 7, 15);
+    textcache_put_image("Hi", params, *image);
+    // The cache must keep its own copy
+    image->Clear(0);
+
+    std::unique_ptr<Bitmap> cached = textcache_get_image("Hi", params);
+    ASSERT_NE(cached, nullptr);
+    ASSERT_NE(cached.get(), image.get());
+    ASSERT_EQ(cached->GetWidth(), 40);
+    ASSERT_EQ(cached->GetHeight(), 20);
+    ASSERT_EQ(cached->GetPixel(5, 7), 15);
+    ASSERT_EQ(cached->GetPixel(6, 7), 0);
+
+    params.TextColor = 14;
+    ASSERT_EQ(textcache_get_image("Hi", params), nullptr);
+    params.TextColor = 15;
+    params.Align = kHAlignCenter;
+    ASSERT_EQ(textcache_get_image("Hi", params), nullptr);
+    params.Align = kHAlignNone;
+    ASSERT_NE(textcache_get_image("Hi", params), nullptr);
+
+    uint32_t lines_hits, lines_misses, image_hits, image_misses;
+    size_t image_size;
+    textcache_get_stats(lines_hits, lines_misses, image_hits, image_misses, image_size);
+    ASSERT_EQ(image_size, 40u * 20);
+
+    textcache_clear();
+    ASSERT_EQ(textcache_get_image("Hi", params), nullptr);
+}
@@ -0,0 +1,194 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2026 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include <vector>
+#include "gtest/gtest.h"
+#include "gfx/texture_atlas.h"
+
+using namespace AGS::Engine;
+
+namespace
+{
+
+uint32_t NextRandom(uint32_t &seed)
+{
+    seed = seed * 1103515245u + 12345u;
+    return (seed >> 16) | (seed << 16);
+}
+
+bool Overlap(const Rect &a, const Rect &b)
+{
+    return a.Left <= b.Right && b.Left <= a.Right && a.Top <= b.Bottom && b.Top <= a.Bottom;
+}
+
+// Tests that the regions are inside the page and do not touch each other
+void AssertRegionsValid(const std::vector<AtlasRegion> &regions, int page_w, int page_h, int padding)
+{
+    for (size_t i = 0; i < regions.size(); ++i)
+    {
+        const Rect &r = regions[i].Area;
+        ASSERT_GE(r.Left, padding);
+        ASSERT_GE(r.Top, padding);
+        ASSERT_LT(r.Right, page_w - padding);
+        ASSERT_LT(r.Bottom, page_h - padding);
+        const Rect padded(r.Left - padding, r.Top - padding, r.Right + padding, r.Bottom + padding);
+        for (size_t j = i + 1; j < regions.size(); ++j)
+        {
+            if (regions[i].Page != regions[j].Page)
+                continue;
+            ASSERT_FALSE(Overlap(padded, regions[j].Area)) << "regions " << i << " and " << j;
+        }
+    }
+}
+
+} // namespace
+
+TEST(TextureAtlas, SkylinePacking) {
+    SkylinePacker packer(256, 256);
+    uint32_t seed = 1;
+    std::vector<Rect> placed;
+    uint64_t area = 0u;
+    for (;;)
+    {
+        const int w = 4 + NextRandom(seed) % 29, h = 4 + NextRandom(seed) % 29;
+        Point pos;
+        if (!packer.Insert(w, h, pos))
+            break;
+        const Rect r = RectWH(pos.X, pos.Y, w, h);
+        ASSERT_GE(r.Left, 0);
+        ASSERT_GE(r.Top, 0);
+        ASSERT_LT(r.Right, 256);
+        ASSERT_LT(r.Bottom, 256);
+        for (const auto &other : placed)
+            ASSERT_FALSE(Overlap(r, other));
+        placed.push_back(r);
+        area += w * h;
+    }
+    ASSERT_EQ(packer.GetUsedArea(), area);
+    // Random small rectangles should fill most of the page
+    ASSERT_GT(area * 100 / (256 * 256), 70u);
+
+    packer.Reset();
+    Point pos;
+    ASSERT_TRUE(packer.Insert(256, 256, pos));
+    ASSERT_EQ(pos.X, 0);
+    ASSERT_EQ(pos.Y, 0);
+    ASSERT_FALSE(packer.Insert(1, 1, pos));
+}
+
+TEST(TextureAtlas, AllocateAndFree) {
+    TextureAtlas atlas(128, 128, 2, 32);
+    ASSERT_TRUE(atlas.CanPlace(32, 32));
+    ASSERT_FALSE(atlas.CanPlace(33, 8));
+    ASSERT_FALSE(atlas.CanPlace(0, 8));
+
+    std::vector<uint32_t> handles;
+    std::vector<AtlasRegion> regions;
+    for (;;)
+    {
+        AtlasRegion region;
+        const uint32_t handle = atlas.Allocate(30, 20, region);
+        if (handle == UINT32_MAX)
+            break;
+        ASSERT_TRUE(region.IsValid());
+        ASSERT_EQ(region.Area.GetWidth(), 30);
+        ASSERT_EQ(region.Area.GetHeight(), 20);
+        handles.push_back(handle);
+        regions.push_back(region);
+    }
+    // 32x22 cells with padding: 4 across and 5 down on each of 2 pages
+    ASSERT_EQ(handles.size(), 40u);
+    AssertRegionsValid(regions, 128, 128, 1);
+    AtlasStats stats = atlas.GetStats();
+    ASSERT_EQ(stats.Pages, 2u);
+    ASSERT_EQ(stats.Regions, 40u);
+    ASSERT_EQ(stats.LiveArea, 40u * 32 * 22);
+    ASSERT_EQ(stats.PageArea, 2u * 128 * 128);
+
+    // Freed regions stay dead until the whole page is freed
+    for (size_t i = 0; i < handles.size(); i += 2)
+        atlas.Free(handles[i]);
+    AtlasRegion region;
+    ASSERT_EQ(atlas.Allocate(30, 20, region), UINT32_MAX);
+    ASSERT_EQ(atlas.GetPageStats(0).Regions, 10u);
+    ASSERT_EQ(atlas.GetPageStats(0).UsedArea, 20u * 32 * 22);
+
+    // Free the rest of the first page, and it may be used again
+    for (uint32_t handle : atlas.GetPageRegions(0))
+        atlas.Free(handle);
+    ASSERT_EQ(atlas.GetPageStats(0).Regions, 0u);
+    ASSERT_EQ(atlas.GetPageStats(0).UsedArea, 0u);
+    ASSERT_NE(atlas.Allocate(30, 20, region), UINT32_MAX);
+    ASSERT_EQ(region.Page, 0u);
+    ASSERT_EQ(atlas.GetStats().Pages, 2u);
+}
+
+TEST(TextureAtlas, SparsestPage) {
+    TextureAtlas atlas(64, 64, 4, 16);
+    std::vector<uint32_t> handles;
+    AtlasRegion region;
+    for (uint32_t handle; (handle = atlas.Allocate(14, 14, region)) != UINT32_MAX;)
+        handles.push_back(handle);
+    ASSERT_EQ(handles.size(), 64u); // 16 per page
+    ASSERT_EQ(atlas.GetSparsestPage(100), UINT32_MAX); // all full
+
+    // Leave 2 regions on page 2, and 8 on page 1
+    for (uint32_t handle : atlas.GetPageRegions(2))
+        if (handle % 8 != 0)
+            atlas.Free(handle);
+    for (uint32_t handle : atlas.GetPageRegions(1))
+        if (handle % 2 != 0)
+            atlas.Free(handle);
+    ASSERT_EQ(atlas.GetPageStats(2).Regions, 2u);
+    ASSERT_EQ(atlas.GetPageStats(1).Regions, 8u);
+    ASSERT_EQ(atlas.GetPageStats(2).GetOccupancy(), 12u);
+    ASSERT_EQ(atlas.GetSparsestPage(50), 2u);
+    ASSERT_EQ(atlas.GetSparsestPage(10), UINT32_MAX);
+
+    // Relocating regions off the sparsest page resets it
+    for (uint32_t handle : atlas.GetPageRegions(2))
+        atlas.Free(handle);
+    ASSERT_EQ(atlas.GetStats().Pages, 3u);
+    ASSERT_EQ(atlas.GetSparsestPage(100), 1u);
+
+    atlas.Clear();
+    ASSERT_EQ(atlas.GetPageCount(), 0u);
+    ASSERT_EQ(atlas.GetStats().Regions, 0u);
+}
+
+TEST(TextureAtlas, RandomChurn) {
+    TextureAtlas atlas(256, 256, 8, 64);
+    uint32_t seed = 5;
+    std::vector<uint32_t> handles;
+    std::vector<AtlasRegion> regions;
+    for (int step = 0; step < 5000; ++step)
+    {
+        if (!handles.empty() && (NextRandom(seed) % 3 == 0))
+        {
+            const size_t i = NextRandom(seed) % handles.size();
+            atlas.Free(handles[i]);
+            handles.erase(handles.begin() + i);
+            regions.erase(regions.begin() + i);
+            continue;
+        }
+        const int w = 1 + NextRandom(seed) % 64, h = 1 + NextRandom(seed) % 64;
+        AtlasRegion region;
+        const uint32_t handle = atlas.Allocate(w, h, region);
+        if (handle == UINT32_MAX)
+            continue;
+        handles.push_back(handle);
+        regions.push_back(region);
+    }
+    AssertRegionsValid(regions, 256, 256, 1);
+    ASSERT_EQ(atlas.GetStats().Regions, handles.size());
+}
@@ -0,0 +1,145 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2026 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include <string.h>
+#include <memory>
+#include "gtest/gtest.h"
+#include "ac/roomstatus.h"
+#include "ac/walkbehind.h"
+#include "game/roomstruct.h"
+#include "gfx/bitmap.h"
+
+using namespace AGS::Common;
+
+extern RoomStruct thisroom;
+extern RoomStatus *croom;
+
+namespace
+{
+
+uint32_t NextRandom(uint32_t &seed)
+{
+    seed = seed * 1103515245u + 12345u;
+    return (seed >> 16) | (seed << 16);
+}
+
+// Per-pixel reference: tests each sprite pixel against the mask
+bool RefCropout(Bitmap *sprit, int sprx, int spry, int basel)
+{
+    const Bitmap *mask = thisroom.WalkBehindMask.get();
+    bool pixels_changed = false;
+    for (int y = 0; y < sprit->GetHeight(); ++y)
+    {
+        for (int x = 0; x < sprit->GetWidth(); ++x)
+        {
+            const int mx = x + sprx, my = y + spry;
+            if (mx < 0 || my < 0 || mx >= mask->GetWidth() || my >= mask->GetHeight())
+                continue;
+            const int wb = mask->GetScanLine(my)[mx];
+            if ((wb < 1) || (wb >= MAX_WALK_BEHINDS) || (croom->walkbehind_base[wb] <= basel))
+                continue;
+            sprit->PutPixel(x, y, sprit->GetMaskColor());
+            pixels_changed = true;
+        }
+    }
+    return pixels_changed;
+}
+
+// Fills the mask with overlapping rectangles and circles of WB areas
+void MakeMask(Bitmap *mask, int shape_count, uint32_t seed)
+{
+    mask->Clear(0);
+    for (int i = 0; i < shape_count; ++i)
+    {
+        const int wb = NextRandom(seed) % MAX_WALK_BEHINDS;
+        const int x = NextRandom(seed) % mask->GetWidth();
+        const int y = NextRandom(seed) % mask->GetHeight();
+        const int size = 4 + NextRandom(seed) % (mask->GetHeight() / 4);
+        if (i % 2)
+            mask->FillRect(RectWH(x, y, size, size / 2 + 1), wb);
+        else
+            mask->FillCircle(Circle(x, y, size / 2), wb);
+    }
+}
+
+void FillSprite(Bitmap *sprit, uint32_t seed)
+{
+    for (int y = 0; y < sprit->GetHeight(); ++y)
+    {
+        uint8_t *line = sprit->GetScanLineForWriting(y);
+        for (int i = 0; i < sprit->GetWidth() * sprit->GetBPP(); ++i)
+            line[i] = static_cast<uint8_t>(NextRandom(seed));
+    }
+}
+
+bool BitmapsEqual(const Bitmap *a, const Bitmap *b)
+{
+    for (int y = 0; y < a->GetHeight(); ++y)
+    {
+        if (memcmp(a->GetScanLine(y), b->GetScanLine(y), a->GetWidth() * a->GetBPP()) != 0)
+            return false;
+    }
+    return true;
+}
+
+// Sets up the room's walk-behind mask and baselines for the test
+class WalkBehindRoom
+{
+public:
+    WalkBehindRoom(int width, int height, int shape_count)
+    {
+        _oldRoom = croom;
+        croom = &_room;
+        for (int wb = 0; wb < MAX_WALK_BEHINDS; ++wb)
+            _room.walkbehind_base[wb] = static_cast<short>(wb * 20);
+        thisroom.WalkBehindMask.reset(BitmapHelper::CreateBitmap(width, height, 8));
+        MakeMask(thisroom.WalkBehindMask.get(), shape_count, 1);
+        walkbehinds_recalc();
+    }
+
+    ~WalkBehindRoom()
+    {
+        thisroom.WalkBehindMask.reset();
+        croom = _oldRoom;
+    }
+
+private:
+    RoomStatus _room;
+    RoomStatus *_oldRoom = nullptr;
+};
+
+} // namespace
+
+TEST(WalkBehind, CropoutMatchesPerPixel) {
+    WalkBehindRoom room(320, 200, 60);
+    uint32_t seed = 3;
+    for (int depth : { 8, 16, 32 })
+    {
+        for (int i = 0; i < 100; ++i)
+        {
+            const int w = 1 + NextRandom(seed) % 120, h = 1 + NextRandom(seed) % 120;
+            const int x = static_cast<int>(NextRandom(seed) % 400) - 60;
+            const int y = static_cast<int>(NextRandom(seed) % 280) - 60;
+            const int basel = NextRandom(seed) % (MAX_WALK_BEHINDS * 20);
+            std::unique_ptr<Bitmap> ref(BitmapHelper::CreateBitmap(w, h, depth));
+            std::unique_ptr<Bitmap> res(BitmapHelper::CreateBitmap(w, h, depth));
+            FillSprite(ref.get(), i);
+            FillSprite(res.get(), i);
+            const bool ref_changed = RefCropout(ref.get(), x, y, basel);
+            const bool res_changed = walkbehinds_cropout(res.get(), x, y, basel);
+            ASSERT_EQ(res_changed, ref_changed);
+            ASSERT_TRUE(BitmapsEqual(ref.get(), res.get())) << "depth " << depth
+                << ", sprite " << w << "x" << h << " at " << x << "," << y << ", baseline " << basel;
+        }
+    }
+}
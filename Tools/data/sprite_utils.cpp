@@ -27,7 +27,7 @@ namespace DataUtil
 static const String DefaultPattern = "spr%06d";
 static const String DefaultRegexPattern = "spr\\d{6}";
 static const String DefaultExtension = "png";
-static const CstrArr<kNumSprCompressTypes> CompressionNames = {{"none", "rle", "lzw", "deflate"}};
+static const CstrArr<kNumSprCompressTypes> CompressionNames = {{"none", "rle", "lzw", "deflate", "lz4"}};
 
 String GetCompressionName(SpriteCompression compress)
 {
@@ -75,6 +75,7 @@ const char *HELP_STRING = "Usage:\n"
 "                     * rle\n"
 "                     * lzw\n"
 "                     * deflate\n"
+"                     * lz4\n"
 "                   Default is \"deflate\".\n"
 "\n"
 "Other options:\n"